@@ -46,31 +46,89 @@ namespace FluidS {
  * - dsp_buf: Output buffer of floating point values (FLUID_BUFSIZE in length)
  */
 
-inline bool Voice::updateAmpInc(unsigned int &nextNewAmpInc, std::map<int, qreal>::iterator &curSample2AmpInc, qreal &dsp_amp_incr, unsigned int &dsp_i)
+inline bool Voice::updateAmpInc(unsigned int &nextNewAmpInc, const AmpRamp* &curAmpRamp, qreal &dsp_amp_incr, unsigned int &dsp_i)
       {
       if (positionToTurnOff > 0 && dsp_i >= (unsigned int) positionToTurnOff)
             return false;
 
+      const AmpRamp* ampRampsEnd = &ampRamps.back();     // the sentinel
+
       // if volume is zero skip all phases that do not change that!
       if (amp == 0.0f) {
-            while (dsp_amp_incr == 0.0f && curSample2AmpInc != Sample2AmpInc.end()) {
-                  dsp_i = curSample2AmpInc->first;
-                  curSample2AmpInc++;
-                  nextNewAmpInc = curSample2AmpInc->first;
-                  dsp_amp_incr = curSample2AmpInc->second;
+            while (dsp_amp_incr == 0.0f && curAmpRamp != ampRampsEnd) {
+                  dsp_i = curAmpRamp->pos;
+                  curAmpRamp++;
+                  nextNewAmpInc = curAmpRamp->pos;
+                  dsp_amp_incr = curAmpRamp->incr;
                   }
-            if (curSample2AmpInc == Sample2AmpInc.end())
+            if (curAmpRamp == ampRampsEnd)
                   return false;
             }
 
       if (dsp_i >= nextNewAmpInc) {
-            curSample2AmpInc++;
-            nextNewAmpInc = curSample2AmpInc->first;
-            dsp_amp_incr = curSample2AmpInc->second;
+            curAmpRamp++;
+            nextNewAmpInc = curAmpRamp->pos;
+            dsp_amp_incr = curAmpRamp->incr;
             }
       return true;
       }
 
+//---------------------------------------------------------
+//   dspBlockFrames
+//    number of frames starting at dsp_i which can be
+//    interpolated as one block: all of them lie within the
+//    sequence of sample points up to end_index, within the
+//    current amplitude ramp and before the voice turns off,
+//    so updateAmpInc() would do nothing for them.
+//    Returns 0 if the next frame needs the per sample path.
+//---------------------------------------------------------
+
+inline unsigned Voice::dspBlockFrames(unsigned n, unsigned dsp_i, Phase dsp_phase, Phase dsp_phase_incr, unsigned end_index,
+   unsigned nextNewAmpInc, const AmpRamp* curAmpRamp, qreal dsp_amp_incr) const
+      {
+      if (amp == 0.0f && (dsp_amp_incr == 0.0f || curAmpRamp == &ampRamps.back()))
+            return 0;
+      if (dsp_phase.data < 0 || dsp_phase_incr.data <= 0 || end_index >= unsigned(INT_MAX))
+            return 0;
+      unsigned last = qMin(n, nextNewAmpInc);
+      if (positionToTurnOff > 0)
+            last = qMin(last, unsigned(positionToTurnOff));
+      if (last <= dsp_i)
+            return 0;
+      qint64 frames = qMin(last - dsp_i, unsigned(DSP_BLOCK));
+      qint64 endPhase = ((qint64(end_index) + 1) << 32) - 1;
+      return unsigned(qMin(frames, (endPhase - dsp_phase.data) / dsp_phase_incr.data + 1));
+      }
+
+//---------------------------------------------------------
+//   dspPrepareBlock
+//    advance phase and amplitude over frames, recording
+//    what the kernel needs; first is the offset of the
+//    first sample point used relative to the phase index
+//---------------------------------------------------------
+
+inline void Voice::dspPrepareBlock(DspBlock& block, Phase& dsp_phase, Phase dsp_phase_incr, qreal dsp_amp_incr,
+   int taps, int first, unsigned frames)
+      {
+      for (unsigned k = 0; k < frames; ++k) {
+            block.index[k] = dsp_phase.index() - first;
+            block.row[k]   = fluid_phase_fract_to_tablerow(dsp_phase) * taps;
+            dsp_phase += dsp_phase_incr;
+            }
+      // the amplitude has to be summed up frame by frame to get
+      // the same rounding as the per sample path; a constant one
+      // (sustain) avoids that dependency chain
+      if (dsp_amp_incr == 0.0) {
+            for (unsigned k = 0; k < frames; ++k)
+                  block.amp[k] = amp;
+            }
+      else {
+            for (unsigned k = 0; k < frames; ++k) {
+                  block.amp[k] = amp;
+                  amp += dsp_amp_incr;
+                  }
+            }
+      }
 
 /* Interpolation (find a value between two samples of the original waveform) */
 
@@ -83,6 +141,9 @@ float Voice::interp_coeff[FLUID_INTERP_MAX][4];
 /* 7th order interpolation (7 coefficients centered on 3rd) */
 float Voice::sinc_table7[FLUID_INTERP_MAX][7];
 
+/* Block kernels for the sequence of sample points */
+const DspKernels* Voice::dspKernels;
+
 #define SINC_INTERP_ORDER 7	/* 7th order constant */
 
 //---------------------------------------------------------
@@ -130,6 +191,19 @@ void Voice::dsp_float_config()
                   }
             }
       fluid_check_fpe("interpolation table calculation");
+
+      setDspIsa(dspBestIsa());
+      }
+
+//---------------------------------------------------------
+//   setDspIsa
+//    select the block kernels; all of them give the same
+//    results
+//---------------------------------------------------------
+
+void Voice::setDspIsa(DspIsa isa)
+      {
+      dspKernels = &FluidS::dspKernels(isa);
       }
 
 //-------------------------------------------------------------------
@@ -145,10 +219,10 @@ int Voice::dsp_float_interpolate_none(unsigned n)
 
       Phase dsp_phase = voice->phase;
       Phase dsp_phase_incr; //  end_phase;
-      short int *dsp_data = voice->sample->data;
-      auto curSample2AmpInc = Sample2AmpInc.begin();
-      qreal dsp_amp_incr = curSample2AmpInc->second;
-      unsigned int nextNewAmpInc = curSample2AmpInc->first;
+      const short* dsp_data = voice->sample->data;
+      const AmpRamp* curAmpRamp = &ampRamps.front();
+      qreal dsp_amp_incr = curAmpRamp->incr;
+      unsigned int nextNewAmpInc = curAmpRamp->pos;
       unsigned int dsp_i = 0;
       unsigned int dsp_phase_index;
       unsigned int end_index;
@@ -174,7 +248,7 @@ int Voice::dsp_float_interpolate_none(unsigned n)
                   /* increment phase and amplitude */
                   dsp_phase += dsp_phase_incr;
                   dsp_phase_index = dsp_phase.index_round();	/* round to nearest point */
-                  if (!updateAmpInc(nextNewAmpInc, curSample2AmpInc, dsp_amp_incr, dsp_i))
+                  if (!updateAmpInc(nextNewAmpInc, curAmpRamp, dsp_amp_incr, dsp_i))
                         return dsp_i;
                   amp += dsp_amp_incr;
                   }
@@ -210,16 +284,17 @@ int Voice::dsp_float_interpolate_linear(unsigned n)
       Voice* voice = this;
       Phase dsp_phase = voice->phase;
       Phase dsp_phase_incr; // end_phase;
-      short int *dsp_data = voice->sample->data;
-      auto curSample2AmpInc = Sample2AmpInc.begin();
-      qreal dsp_amp_incr = curSample2AmpInc->second;
-      unsigned int nextNewAmpInc = curSample2AmpInc->first;
+      const short* dsp_data = voice->sample->data;
+      const AmpRamp* curAmpRamp = &ampRamps.front();
+      qreal dsp_amp_incr = curAmpRamp->incr;
+      unsigned int nextNewAmpInc = curAmpRamp->pos;
       unsigned int dsp_i = 0;
       unsigned int dsp_phase_index;
       unsigned int end_index;
       short int point;
       float *coeffs;
       int looping;
+      DspBlock block;
 
       /* Convert playback "speed" floating point value to phase index/fract */
       dsp_phase_incr.setFloat(voice->phase_incr);
@@ -242,7 +317,16 @@ int Voice::dsp_float_interpolate_linear(unsigned n)
             dsp_phase_index = dsp_phase.index();
 
             /* interpolate the sequence of sample points */
-            for ( ; dsp_i < n && dsp_phase_index <= end_index; dsp_i++) {
+            while (dsp_i < n && dsp_phase_index <= end_index) {
+                  unsigned frames = dspBlockFrames(n, dsp_i, dsp_phase, dsp_phase_incr, end_index,
+                     nextNewAmpInc, curAmpRamp, dsp_amp_incr);
+                  if (frames) {
+                        dspPrepareBlock(block, dsp_phase, dsp_phase_incr, dsp_amp_incr, 2, 0, frames);
+                        dspKernels->linear(&dsp_buf[dsp_i], dsp_data, &interp_coeff_linear[0][0], block, frames);
+                        dsp_i += frames;
+                        dsp_phase_index = dsp_phase.index();
+                        continue;
+                        }
                   coeffs = interp_coeff_linear[fluid_phase_fract_to_tablerow (dsp_phase)];
                   dsp_buf[dsp_i] = amp * (coeffs[0] * dsp_data[dsp_phase_index]
 				  + coeffs[1] * dsp_data[dsp_phase_index+1]);
@@ -250,9 +334,10 @@ int Voice::dsp_float_interpolate_linear(unsigned n)
                   /* increment phase and amplitude */
                   dsp_phase += dsp_phase_incr;
                   dsp_phase_index = dsp_phase.index();
-                  if (!updateAmpInc(nextNewAmpInc, curSample2AmpInc, dsp_amp_incr, dsp_i))
+                  if (!updateAmpInc(nextNewAmpInc, curAmpRamp, dsp_amp_incr, dsp_i))
                         return dsp_i;
                   amp += dsp_amp_incr;
+                  dsp_i++;
                   }
 
             /* break out if buffer filled */
@@ -270,7 +355,7 @@ int Voice::dsp_float_interpolate_linear(unsigned n)
                   /* increment phase and amplitude */
                   dsp_phase += dsp_phase_incr;
                   dsp_phase_index = dsp_phase.index();
-                  if (!updateAmpInc(nextNewAmpInc, curSample2AmpInc, dsp_amp_incr, dsp_i))
+                  if (!updateAmpInc(nextNewAmpInc, curAmpRamp, dsp_amp_incr, dsp_i))
                         return dsp_i;
                   amp += dsp_amp_incr;	/* increment amplitude */
                   }
@@ -304,15 +389,16 @@ int Voice::dsp_float_interpolate_linear(unsigned n)
 int Voice::dsp_float_interpolate_4th_order(unsigned n)
       {
       Phase dsp_phase_incr; // end_phase;
-      short int* dsp_data = sample->data;
-      auto curSample2AmpInc = Sample2AmpInc.begin();
-      qreal dsp_amp_incr = curSample2AmpInc->second;
-      unsigned int nextNewAmpInc = curSample2AmpInc->first;
+      const short* dsp_data = sample->data;
+      const AmpRamp* curAmpRamp = &ampRamps.front();
+      qreal dsp_amp_incr = curAmpRamp->incr;
+      unsigned int nextNewAmpInc = curAmpRamp->pos;
       unsigned int dsp_i  = 0;
       unsigned int dsp_phase_index;
       unsigned int start_index;
       short int start_point, end_point1, end_point2;
       float *coeffs;
+      DspBlock block;
 
       /* Convert playback "speed" floating point value to phase index/fract */
       dsp_phase_incr.setFloat(phase_incr);
@@ -359,13 +445,22 @@ int Voice::dsp_float_interpolate_4th_order(unsigned n)
                   /* increment phase and amplitude */
                   phase += dsp_phase_incr;
                   dsp_phase_index = phase.index();
-                  if (!updateAmpInc(nextNewAmpInc, curSample2AmpInc, dsp_amp_incr, dsp_i))
+                  if (!updateAmpInc(nextNewAmpInc, curAmpRamp, dsp_amp_incr, dsp_i))
                         return dsp_i;
                   amp += dsp_amp_incr;
                   }
 
             /* interpolate the sequence of sample points */
-            for ( ; dsp_i < n && dsp_phase_index <= end_index; dsp_i++) {
+            while (dsp_i < n && dsp_phase_index <= end_index) {
+                  unsigned frames = dspBlockFrames(n, dsp_i, phase, dsp_phase_incr, end_index,
+                     nextNewAmpInc, curAmpRamp, dsp_amp_incr);
+                  if (frames) {
+                        dspPrepareBlock(block, phase, dsp_phase_incr, dsp_amp_incr, 4, 1, frames);
+                        dspKernels->cubic(&dsp_buf[dsp_i], dsp_data, &interp_coeff[0][0], block, frames);
+                        dsp_i += frames;
+                        dsp_phase_index = phase.index();
+                        continue;
+                        }
                   coeffs = interp_coeff[fluid_phase_fract_to_tablerow (phase)];
                   auto val = amp * (coeffs[0] * dsp_data[dsp_phase_index-1]
                                    + coeffs[1] * dsp_data[dsp_phase_index]
@@ -376,9 +471,10 @@ int Voice::dsp_float_interpolate_4th_order(unsigned n)
                   /* increment phase and amplitude */
                   phase += dsp_phase_incr;
                   dsp_phase_index = phase.index();
-                  if (!updateAmpInc(nextNewAmpInc, curSample2AmpInc, dsp_amp_incr, dsp_i))
+                  if (!updateAmpInc(nextNewAmpInc, curAmpRamp, dsp_amp_incr, dsp_i))
                         return dsp_i;
                   amp += dsp_amp_incr;
+                  dsp_i++;
                   }
 
             /* break out if buffer filled */
@@ -399,7 +495,7 @@ int Voice::dsp_float_interpolate_4th_order(unsigned n)
                   /* increment phase and amplitude */
                   phase += dsp_phase_incr;
                   dsp_phase_index = phase.index();
-                  if (!updateAmpInc(nextNewAmpInc, curSample2AmpInc, dsp_amp_incr, dsp_i))
+                  if (!updateAmpInc(nextNewAmpInc, curAmpRamp, dsp_amp_incr, dsp_i))
                         return dsp_i;
                   amp += dsp_amp_incr;
                   }
@@ -418,7 +514,7 @@ int Voice::dsp_float_interpolate_4th_order(unsigned n)
                   /* increment phase and amplitude */
                   phase += dsp_phase_incr;
                   dsp_phase_index = phase.index();
-                  if (!updateAmpInc(nextNewAmpInc, curSample2AmpInc, dsp_amp_incr, dsp_i))
+                  if (!updateAmpInc(nextNewAmpInc, curAmpRamp, dsp_amp_incr, dsp_i))
                         return dsp_i;
                   amp += dsp_amp_incr;
                   }
@@ -456,10 +552,10 @@ int Voice::dsp_float_interpolate_7th_order(unsigned n)
 
       Phase dsp_phase = voice->phase;
       Phase dsp_phase_incr; // end_phase;
-      short int *dsp_data = voice->sample->data;
-      auto curSample2AmpInc = Sample2AmpInc.begin();
-      qreal dsp_amp_incr = curSample2AmpInc->second;
-      unsigned int nextNewAmpInc = curSample2AmpInc->first;
+      const short* dsp_data = voice->sample->data;
+      const AmpRamp* curAmpRamp = &ampRamps.front();
+      qreal dsp_amp_incr = curAmpRamp->incr;
+      unsigned int nextNewAmpInc = curAmpRamp->pos;
       unsigned int dsp_i = 0;
       unsigned int dsp_phase_index;
       unsigned int start_index, end_index;
@@ -467,6 +563,7 @@ int Voice::dsp_float_interpolate_7th_order(unsigned n)
       short int end_points[3];
       float *coeffs;
       int looping;
+      DspBlock block;
 
       /* Convert playback "speed" floating point value to phase index/fract */
       dsp_phase_incr.setFloat(voice->phase_incr);
@@ -526,7 +623,7 @@ int Voice::dsp_float_interpolate_7th_order(unsigned n)
                   /* increment phase and amplitude */
                   dsp_phase += dsp_phase_incr;
                   dsp_phase_index = dsp_phase.index();
-                  if (!updateAmpInc(nextNewAmpInc, curSample2AmpInc, dsp_amp_incr, dsp_i))
+                  if (!updateAmpInc(nextNewAmpInc, curAmpRamp, dsp_amp_incr, dsp_i))
                         return dsp_i;
                   amp += dsp_amp_incr;
                   }
@@ -548,7 +645,7 @@ int Voice::dsp_float_interpolate_7th_order(unsigned n)
                   /* increment phase and amplitude */
                   dsp_phase += dsp_phase_incr;
                   dsp_phase_index = dsp_phase.index();
-                  if (!updateAmpInc(nextNewAmpInc, curSample2AmpInc, dsp_amp_incr, dsp_i))
+                  if (!updateAmpInc(nextNewAmpInc, curAmpRamp, dsp_amp_incr, dsp_i))
                         return dsp_i;
                   amp += dsp_amp_incr;
                   }
@@ -570,7 +667,7 @@ int Voice::dsp_float_interpolate_7th_order(unsigned n)
                   /* increment phase and amplitude */
                   dsp_phase += dsp_phase_incr;
                   dsp_phase_index = dsp_phase.index();
-                  if (!updateAmpInc(nextNewAmpInc, curSample2AmpInc, dsp_amp_incr, dsp_i))
+                  if (!updateAmpInc(nextNewAmpInc, curAmpRamp, dsp_amp_incr, dsp_i))
                         return dsp_i;
                   amp += dsp_amp_incr;
                   }
@@ -578,7 +675,16 @@ int Voice::dsp_float_interpolate_7th_order(unsigned n)
             start_index -= 2;	/* set back to original start index */
 
             /* interpolate the sequence of sample points */
-            for ( ; dsp_i < n && dsp_phase_index <= end_index; dsp_i++) {
+            while (dsp_i < n && dsp_phase_index <= end_index) {
+                  unsigned frames = dspBlockFrames(n, dsp_i, dsp_phase, dsp_phase_incr, end_index,
+                     nextNewAmpInc, curAmpRamp, dsp_amp_incr);
+                  if (frames) {
+                        dspPrepareBlock(block, dsp_phase, dsp_phase_incr, dsp_amp_incr, 7, 3, frames);
+                        dspKernels->sinc7(&dsp_buf[dsp_i], dsp_data, &sinc_table7[0][0], block, frames);
+                        dsp_i += frames;
+                        dsp_phase_index = dsp_phase.index();
+                        continue;
+                        }
                   coeffs = sinc_table7[fluid_phase_fract_to_tablerow (dsp_phase)];
 
                   dsp_buf[dsp_i] = amp * (coeffs[0] * (float)dsp_data[dsp_phase_index-3]
@@ -592,9 +698,10 @@ int Voice::dsp_float_interpolate_7th_order(unsigned n)
                   /* increment phase and amplitude */
                   dsp_phase += dsp_phase_incr;
                   dsp_phase_index = dsp_phase.index();
-                  if (!updateAmpInc(nextNewAmpInc, curSample2AmpInc, dsp_amp_incr, dsp_i))
+                  if (!updateAmpInc(nextNewAmpInc, curAmpRamp, dsp_amp_incr, dsp_i))
                         return dsp_i;
                   amp += dsp_amp_incr;
+                  dsp_i++;
                   }
 
             /* break out if buffer filled */
@@ -618,7 +725,7 @@ int Voice::dsp_float_interpolate_7th_order(unsigned n)
                   /* increment phase and amplitude */
                   dsp_phase += dsp_phase_incr;
                   dsp_phase_index = dsp_phase.index();
-                  if (!updateAmpInc(nextNewAmpInc, curSample2AmpInc, dsp_amp_incr, dsp_i))
+                  if (!updateAmpInc(nextNewAmpInc, curAmpRamp, dsp_amp_incr, dsp_i))
                         return dsp_i;
                   amp += dsp_amp_incr;
                   }
@@ -640,7 +747,7 @@ int Voice::dsp_float_interpolate_7th_order(unsigned n)
                   /* increment phase and amplitude */
                   dsp_phase += dsp_phase_incr;
                   dsp_phase_index = dsp_phase.index();
-                  if (!updateAmpInc(nextNewAmpInc, curSample2AmpInc, dsp_amp_incr, dsp_i))
+                  if (!updateAmpInc(nextNewAmpInc, curAmpRamp, dsp_amp_incr, dsp_i))
                         return dsp_i;
                   amp += dsp_amp_incr;
                   }
@@ -662,7 +769,7 @@ int Voice::dsp_float_interpolate_7th_order(unsigned n)
                   /* increment phase and amplitude */
                   dsp_phase += dsp_phase_incr;
                   dsp_phase_index = dsp_phase.index();
-                  if (!updateAmpInc(nextNewAmpInc, curSample2AmpInc, dsp_amp_incr, dsp_i))
+                  if (!updateAmpInc(nextNewAmpInc, curAmpRamp, dsp_amp_incr, dsp_i))
                         return dsp_i;
                   amp += dsp_amp_incr;
                   }
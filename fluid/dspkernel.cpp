@@ -0,0 +1,323 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <cstring>
+#include "dspkernel.h"
+
+//    The vector kernels do the same float multiplications and
+//    additions in the same order as the scalar code. They are only
+//    built where the scalar code uses SSE math too (no x87 excess
+//    precision) and never with FMA, which would round differently.
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__SSE2_MATH__))
+#define FLUID_DSP_SIMD
+#include <immintrin.h>
+#endif
+
+namespace FluidS {
+
+//---------------------------------------------------------
+//   scalar kernels
+//    same expressions as the per sample loops in dsp.cpp;
+//    the range versions also do the frames left over by
+//    the vector kernels
+//---------------------------------------------------------
+
+static void linearRange(float* out, const short* data, const float* table, const DspBlock& b, int from, int frames)
+      {
+      for (int k = from; k < frames; ++k) {
+            const float* c = table + b.row[k];
+            const short* d = data + b.index[k];
+            out[k] = b.amp[k] * (c[0] * d[0] + c[1] * d[1]);
+            }
+      }
+
+static void cubicRange(float* out, const short* data, const float* table, const DspBlock& b, int from, int frames)
+      {
+      for (int k = from; k < frames; ++k) {
+            const float* c = table + b.row[k];
+            const short* d = data + b.index[k];
+            out[k] = b.amp[k] * (c[0] * d[0] + c[1] * d[1] + c[2] * d[2] + c[3] * d[3]);
+            }
+      }
+
+static void sinc7Range(float* out, const short* data, const float* table, const DspBlock& b, int from, int frames)
+      {
+      for (int k = from; k < frames; ++k) {
+            const float* c = table + b.row[k];
+            const short* d = data + b.index[k];
+            out[k] = b.amp[k] * (c[0] * (float)d[0]
+               + c[1] * (float)d[1]
+               + c[2] * (float)d[2]
+               + c[3] * (float)d[3]
+               + c[4] * (float)d[4]
+               + c[5] * (float)d[5]
+               + c[6] * (float)d[6]);
+            }
+      }
+
+static void linearScalar(float* out, const short* data, const float* table, const DspBlock& b, int frames)
+      {
+      linearRange(out, data, table, b, 0, frames);
+      }
+
+static void cubicScalar(float* out, const short* data, const float* table, const DspBlock& b, int frames)
+      {
+      cubicRange(out, data, table, b, 0, frames);
+      }
+
+static void sinc7Scalar(float* out, const short* data, const float* table, const DspBlock& b, int frames)
+      {
+      sinc7Range(out, data, table, b, 0, frames);
+      }
+
+#ifdef FLUID_DSP_SIMD
+
+//    The vector kernels load the points and the coefficient row
+//    of one frame as a vector, multiply them and transpose the
+//    products of four frames, so that the taps are summed up
+//    across frames in the same order as in the scalar code.
+//    Points are loaded as 64 bit words of four points, the
+//    7 taps kernel uses two overlapping words, so nothing
+//    outside the points of a frame is read.
+
+static inline __m128i load4(const short* d)
+      {
+      return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(d));
+      }
+
+static inline __m128 points4(const short* d)
+      {
+      __m128i p = load4(d);
+      return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(p, p), 16));
+      }
+
+static inline __m128 points2(const short* d0, const short* d1)
+      {
+      int w0, w1;
+      memcpy(&w0, d0, sizeof(int));
+      memcpy(&w1, d1, sizeof(int));
+      __m128i p = _mm_unpacklo_epi32(_mm_cvtsi32_si128(w0), _mm_cvtsi32_si128(w1));
+      return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(p, p), 16));
+      }
+
+static inline __m128 coeffs2(const float* c0, const float* c1)
+      {
+      __m128 c = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(c0));
+      return _mm_loadh_pi(c, reinterpret_cast<const __m64*>(c1));
+      }
+
+//---------------------------------------------------------
+//   linearSse2
+//---------------------------------------------------------
+
+static void linearSse2(float* out, const short* data, const float* table, const DspBlock& b, int frames)
+      {
+      int k = 0;
+      for (; k + 4 <= frames; k += 4) {
+            __m128 p01 = _mm_mul_ps(coeffs2(table + b.row[k], table + b.row[k + 1]),
+               points2(data + b.index[k], data + b.index[k + 1]));
+            __m128 p23 = _mm_mul_ps(coeffs2(table + b.row[k + 2], table + b.row[k + 3]),
+               points2(data + b.index[k + 2], data + b.index[k + 3]));
+            __m128 t0 = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 t1 = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(3, 1, 3, 1));
+            _mm_storeu_ps(out + k, _mm_mul_ps(_mm_load_ps(b.amp + k), _mm_add_ps(t0, t1)));
+            }
+      linearRange(out, data, table, b, k, frames);
+      }
+
+//---------------------------------------------------------
+//   cubicSse2
+//---------------------------------------------------------
+
+static void cubicSse2(float* out, const short* data, const float* table, const DspBlock& b, int frames)
+      {
+      int k = 0;
+      for (; k + 4 <= frames; k += 4) {
+            __m128 t0 = _mm_mul_ps(_mm_loadu_ps(table + b.row[k]),     points4(data + b.index[k]));
+            __m128 t1 = _mm_mul_ps(_mm_loadu_ps(table + b.row[k + 1]), points4(data + b.index[k + 1]));
+            __m128 t2 = _mm_mul_ps(_mm_loadu_ps(table + b.row[k + 2]), points4(data + b.index[k + 2]));
+            __m128 t3 = _mm_mul_ps(_mm_loadu_ps(table + b.row[k + 3]), points4(data + b.index[k + 3]));
+            _MM_TRANSPOSE4_PS(t0, t1, t2, t3);
+            __m128 v = _mm_add_ps(_mm_add_ps(_mm_add_ps(t0, t1), t2), t3);
+            _mm_storeu_ps(out + k, _mm_mul_ps(_mm_load_ps(b.amp + k), v));
+            }
+      cubicRange(out, data, table, b, k, frames);
+      }
+
+//---------------------------------------------------------
+//   sinc7Sse2
+//    taps 0-3 and 3-6 of a frame as two vectors; tap 3 of
+//    the second one is not used
+//---------------------------------------------------------
+
+static void sinc7Sse2(float* out, const short* data, const float* table, const DspBlock& b, int frames)
+      {
+      int k = 0;
+      for (; k + 4 <= frames; k += 4) {
+            __m128 l[4], h[4];
+            for (int i = 0; i < 4; ++i) {
+                  const float* c = table + b.row[k + i];
+                  const short* d = data + b.index[k + i];
+                  l[i] = _mm_mul_ps(_mm_loadu_ps(c),     points4(d));
+                  h[i] = _mm_mul_ps(_mm_loadu_ps(c + 3), points4(d + 3));
+                  }
+            _MM_TRANSPOSE4_PS(l[0], l[1], l[2], l[3]);
+            _MM_TRANSPOSE4_PS(h[0], h[1], h[2], h[3]);
+            __m128 v = _mm_add_ps(_mm_add_ps(_mm_add_ps(l[0], l[1]), l[2]), l[3]);
+            v = _mm_add_ps(_mm_add_ps(_mm_add_ps(v, h[1]), h[2]), h[3]);
+            _mm_storeu_ps(out + k, _mm_mul_ps(_mm_load_ps(b.amp + k), v));
+            }
+      sinc7Range(out, data, table, b, k, frames);
+      }
+
+//---------------------------------------------------------
+//   AVX2 kernels
+//    eight frames at a time: frame i and i + 4 share a
+//    register, the in lane transpose then gives frames
+//    0-3 in the low and 4-7 in the high lane
+//---------------------------------------------------------
+
+__attribute__((target("avx2")))
+static inline __m256 products4(const float* c0, const short* d0, const float* c1, const short* d1)
+      {
+      __m256 c = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(c0)), _mm_loadu_ps(c1), 1);
+      __m128i p = _mm_unpacklo_epi64(load4(d0), load4(d1));
+      return _mm256_mul_ps(c, _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(p)));
+      }
+
+__attribute__((target("avx2")))
+static inline void transpose4(__m256& r0, __m256& r1, __m256& r2, __m256& r3)
+      {
+      __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+      __m256 t1 = _mm256_unpacklo_ps(r2, r3);
+      __m256 t2 = _mm256_unpackhi_ps(r0, r1);
+      __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+      r0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+      r1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+      r2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+      r3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+      }
+
+__attribute__((target("avx2")))
+static void cubicAvx2(float* out, const short* data, const float* table, const DspBlock& b, int frames)
+      {
+      int k = 0;
+      for (; k + 8 <= frames; k += 8) {
+            const int* r = b.row + k;
+            const int* i = b.index + k;
+            __m256 t0 = products4(table + r[0], data + i[0], table + r[4], data + i[4]);
+            __m256 t1 = products4(table + r[1], data + i[1], table + r[5], data + i[5]);
+            __m256 t2 = products4(table + r[2], data + i[2], table + r[6], data + i[6]);
+            __m256 t3 = products4(table + r[3], data + i[3], table + r[7], data + i[7]);
+            transpose4(t0, t1, t2, t3);
+            __m256 v = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(t0, t1), t2), t3);
+            _mm256_storeu_ps(out + k, _mm256_mul_ps(_mm256_load_ps(b.amp + k), v));
+            }
+      _mm256_zeroupper();     // the rest is SSE code
+      cubicRange(out, data, table, b, k, frames);
+      }
+
+__attribute__((target("avx2")))
+static void sinc7Avx2(float* out, const short* data, const float* table, const DspBlock& b, int frames)
+      {
+      int k = 0;
+      for (; k + 8 <= frames; k += 8) {
+            const int* r = b.row + k;
+            const int* i = b.index + k;
+            __m256 l0 = products4(table + r[0], data + i[0], table + r[4], data + i[4]);
+            __m256 l1 = products4(table + r[1], data + i[1], table + r[5], data + i[5]);
+            __m256 l2 = products4(table + r[2], data + i[2], table + r[6], data + i[6]);
+            __m256 l3 = products4(table + r[3], data + i[3], table + r[7], data + i[7]);
+            transpose4(l0, l1, l2, l3);
+            __m256 v = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(l0, l1), l2), l3);
+            __m256 h0 = products4(table + r[0] + 3, data + i[0] + 3, table + r[4] + 3, data + i[4] + 3);
+            __m256 h1 = products4(table + r[1] + 3, data + i[1] + 3, table + r[5] + 3, data + i[5] + 3);
+            __m256 h2 = products4(table + r[2] + 3, data + i[2] + 3, table + r[6] + 3, data + i[6] + 3);
+            __m256 h3 = products4(table + r[3] + 3, data + i[3] + 3, table + r[7] + 3, data + i[7] + 3);
+            transpose4(h0, h1, h2, h3);
+            v = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(v, h1), h2), h3);
+            _mm256_storeu_ps(out + k, _mm256_mul_ps(_mm256_load_ps(b.amp + k), v));
+            }
+      _mm256_zeroupper();
+      sinc7Range(out, data, table, b, k, frames);
+      }
+#endif
+
+static const DspKernels scalarKernels = {
+      linearScalar, cubicScalar, sinc7Scalar
+      };
+#ifdef FLUID_DSP_SIMD
+static const DspKernels sse2Kernels = {
+      linearSse2, cubicSse2, sinc7Sse2
+      };
+// two taps do not fill a 256 bit register, linear stays with SSE2
+static const DspKernels avx2Kernels = {
+      linearSse2, cubicAvx2, sinc7Avx2
+      };
+#endif
+
+//---------------------------------------------------------
+//   dspIsaSupported
+//---------------------------------------------------------
+
+bool dspIsaSupported(DspIsa isa)
+      {
+      switch (isa) {
+            case DspIsa::SCALAR:
+                  return true;
+#ifdef FLUID_DSP_SIMD
+            case DspIsa::SSE2:
+                  return true;
+            case DspIsa::AVX2:
+                  __builtin_cpu_init();
+                  return __builtin_cpu_supports("avx2");
+#endif
+            default:
+                  return false;
+            }
+      }
+
+//---------------------------------------------------------
+//   dspBestIsa
+//---------------------------------------------------------
+
+DspIsa dspBestIsa()
+      {
+      if (dspIsaSupported(DspIsa::AVX2))
+            return DspIsa::AVX2;
+      if (dspIsaSupported(DspIsa::SSE2))
+            return DspIsa::SSE2;
+      return DspIsa::SCALAR;
+      }
+
+//---------------------------------------------------------
+//   dspKernels
+//    kernels for isa, the scalar ones if it is not
+//    supported
+//---------------------------------------------------------
+
+const DspKernels& dspKernels(DspIsa isa)
+      {
+#ifdef FLUID_DSP_SIMD
+      if (dspIsaSupported(isa)) {
+            if (isa == DspIsa::AVX2)
+                  return avx2Kernels;
+            if (isa == DspIsa::SSE2)
+                  return sse2Kernels;
+            }
+#endif
+      return scalarKernels;
+      }
+
+}     // namespace FluidS
+
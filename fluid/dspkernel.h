@@ -0,0 +1,61 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __FLUID_DSPKERNEL_H__
+#define __FLUID_DSPKERNEL_H__
+
+namespace FluidS {
+
+//---------------------------------------------------------
+//   DspBlock
+//    up to DSP_BLOCK output frames of one voice which
+//    need no amplitude envelope bookkeeping. For every
+//    frame: the first sample point used, the offset of its
+//    coefficient row in the interpolation table and the
+//    amplitude.
+//---------------------------------------------------------
+
+static const int DSP_BLOCK = 64;
+
+struct DspBlock {
+      alignas(32) int index[DSP_BLOCK];
+      alignas(32) int row[DSP_BLOCK];
+      alignas(32) float amp[DSP_BLOCK];
+      };
+
+//---------------------------------------------------------
+//   DspKernel
+//    out[k] = amp[k] * (c[0] * d[0] + ... + c[taps-1] * d[taps-1])
+//    with c = table + row[k] and d = data + index[k], summed
+//    in this order so that all kernels give bit identical
+//    results
+//---------------------------------------------------------
+
+typedef void (*DspKernel)(float* out, const short* data, const float* table, const DspBlock& block, int frames);
+
+enum class DspIsa : char {
+      SCALAR, SSE2, AVX2
+      };
+
+struct DspKernels {
+      DspKernel linear;       // 2 taps
+      DspKernel cubic;        // 4 taps
+      DspKernel sinc7;        // 7 taps
+      };
+
+extern bool dspIsaSupported(DspIsa);
+extern DspIsa dspBestIsa();
+extern const DspKernels& dspKernels(DspIsa);
+
+}     // namespace FluidS
+#endif
+
@@ -20,6 +20,7 @@
 
 #include "synthesizer/event.h"
 #include "synthesizer/msynthesizer.h"
+#include "synthesizer/renderpool.h"
 #include "mscore/preferences.h"
 
 #include "fluid.h"
@@ -120,6 +121,10 @@ Fluid::~Fluid()
 
 void Fluid::freeVoice(Voice* v)
       {
+      if (_parallelWrite) {         // see processParallel()
+            v->freePending = true;
+            return;
+            }
       if (activeVoices.removeOne(v))
             freeVoices.append(v);
       }
@@ -398,12 +403,104 @@ void Fluid::update_presets()
 void Fluid::process(unsigned len, float* out, float* effect1, float* effect2)
       {
       if (mutex.tryLock()) {
-            foreach (Voice* v, activeVoices)
-                  v->write(len, out, effect1, effect2);
+            if (_renderPool && activeVoices.size() >= 2 * VOICES_PER_BUS)
+                  processParallel(len, out, effect1, effect2);
+            else {
+                  foreach (Voice* v, activeVoices)
+                        v->write(len, out, effect1, effect2);
+                  }
             mutex.unlock();
             }
       }
 
+//---------------------------------------------------------
+//   setRenderPool
+//---------------------------------------------------------
+
+void Fluid::setRenderPool(RenderPool* pool)
+      {
+      _renderPool = pool;
+      if (pool)
+            _busBuffer.resize(MAX_BUSES * 3 * MasterSynthesizer::MAX_BUFFERSIZE);
+      else
+            std::vector<float>().swap(_busBuffer);
+      }
+
+//---------------------------------------------------------
+//   bus
+//    buffer 0 - out, 1 - reverb, 2 - chorus
+//---------------------------------------------------------
+
+float* Fluid::bus(int idx, int buffer)
+      {
+      return _busBuffer.data() + (idx * 3 + buffer) * MasterSynthesizer::MAX_BUFFERSIZE;
+      }
+
+//---------------------------------------------------------
+//   renderBus
+//    called by the render pool; renders a fixed slice of
+//    the active voices into the buffers of bus idx
+//---------------------------------------------------------
+
+void Fluid::renderBus(void* fluid, int idx)
+      {
+      Fluid* f    = static_cast<Fluid*>(fluid);
+      unsigned n  = f->_busFrames;
+      int voices  = f->activeVoices.size();
+      int first   = idx * voices / f->_buses;
+      int last    = (idx + 1) * voices / f->_buses;
+      float* out    = f->bus(idx, 0);
+      float* reverb = f->bus(idx, 1);
+      float* chorus = f->bus(idx, 2);
+      memset(out,    0, n * 2 * sizeof(float));
+      memset(reverb, 0, n * 2 * sizeof(float));
+      memset(chorus, 0, n * 2 * sizeof(float));
+      for (int i = first; i < last; ++i)
+            f->activeVoices.at(i)->write(n, out, reverb, chorus);
+      }
+
+//---------------------------------------------------------
+//   processParallel
+//    The slices only depend on the number of active voices
+//    and the buses are summed in fixed order, so the output
+//    does not depend on which thread rendered a bus.
+//    Voices turning off while rendering are only marked by
+//    freeVoice() and moved to freeVoices afterwards, in list
+//    order like the serial path does.
+//---------------------------------------------------------
+
+void Fluid::processParallel(unsigned len, float* out, float* effect1, float* effect2)
+      {
+      int voices = activeVoices.size();
+      _buses     = qMin(MAX_BUSES, (voices + VOICES_PER_BUS - 1) / VOICES_PER_BUS);
+      _busFrames = len;
+      _parallelWrite = true;
+      _renderPool->run(_buses, renderBus, this);
+      _parallelWrite = false;
+
+      for (int idx = 0; idx < _buses; ++idx) {
+            const float* o = bus(idx, 0);
+            const float* r = bus(idx, 1);
+            const float* c = bus(idx, 2);
+            for (unsigned i = 0; i < len * 2; ++i) {
+                  out[i]     += o[i];
+                  effect1[i] += r[i];
+                  effect2[i] += c[i];
+                  }
+            }
+
+      for (int i = 0; i < activeVoices.size();) {
+            Voice* v = activeVoices.at(i);
+            if (v->freePending) {
+                  v->freePending = false;
+                  activeVoices.removeAt(i);
+                  freeVoices.append(v);
+                  }
+            else
+                  ++i;
+            }
+      }
+
 /*
  * fluid_synth_free_voice_by_kill
  *
@@ -904,4 +1001,15 @@ QFileInfoList Fluid::sfFiles()
             }
       return l;
       }
+
+//---------------------------------------------------------
+//   setSampleCacheSize
+//    memory budget in MB for decompressed samples of SF3
+//    files, shared by all synthesizer instances
+//---------------------------------------------------------
+
+void Fluid::setSampleCacheSize(int mb)
+      {
+      SampleCache::instance()->setBudget(qint64(mb) * 1024 * 1024);
+      }
 }
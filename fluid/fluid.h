@@ -22,6 +22,7 @@
 #ifndef __FLUID_S_H__
 #define __FLUID_S_H__
 
+#include <vector>
 #include "synthesizer/synthesizer.h"
 #include "synthesizer/midipatch.h"
 
@@ -302,6 +303,21 @@ class Fluid : public Synthesizer {
       QList<Voice*> activeVoices;         // active synthesis processes
       QString _error;                     // last error message
 
+      // parallel rendering: active voices are split into buses which
+      // are rendered by the pool and summed in bus order
+      static const int MAX_BUSES      = 16;
+      static const int VOICES_PER_BUS = 8;
+      RenderPool* _renderPool { 0 };
+      std::vector<float> _busBuffer;      // out, reverb and chorus for every bus
+      unsigned _busFrames     { 0 };
+      int _buses              { 0 };
+      bool _parallelWrite     { false };  // voices turning off are freed after rendering
+      bool _offline           { false };  // noteon() may wait for sample data
+
+      float* bus(int idx, int buffer);
+      static void renderBus(void* fluid, int idx);
+      void processParallel(unsigned len, float* out, float* effect1, float* effect2);
+
       static bool initialized;
 
       double sample_rate;                 // The sample rate
@@ -342,6 +358,7 @@ class Fluid : public Synthesizer {
 
       virtual void allSoundsOff(int);
       virtual void allNotesOff(int);
+      virtual int voiceCount() const { return activeVoices.size(); }
 
       Preset* get_preset(unsigned int sfontnum, unsigned int banknum, unsigned int prognum);
       Preset* find_preset(unsigned int banknum, unsigned int prognum);
@@ -378,6 +395,9 @@ class Fluid : public Synthesizer {
       void free_voice_by_kill();
 
       virtual void process(unsigned len, float* out, float* effect1, float* effect2);
+      virtual void setRenderPool(RenderPool*);
+      virtual void setOffline(bool val) { _offline = val; }
+      bool offline() const              { return _offline; }
 
       bool program_select(int chan, unsigned sfont_id, unsigned bank_num, unsigned preset_num);
       void get_program(int chan, unsigned* sfont_id, unsigned* bank_num, unsigned* preset_num);
@@ -404,6 +424,7 @@ class Fluid : public Synthesizer {
       virtual SynthesizerGui* gui();
 
       static QFileInfoList sfFiles();
+      static void setSampleCacheSize(int mb);
 
       friend class Voice;
       friend class Preset;
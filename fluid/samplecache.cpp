@@ -0,0 +1,193 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "samplecache.h"
+
+namespace FluidS {
+
+//---------------------------------------------------------
+//   SampleFile
+//---------------------------------------------------------
+
+SampleFile::~SampleFile()
+      {
+      if (_data)
+            _file.unmap(const_cast<uchar*>(_data));
+      }
+
+//---------------------------------------------------------
+//   open
+//    return the mapping of path, create it if the file is
+//    not mapped yet; returns a null pointer if the file
+//    cannot be mapped
+//---------------------------------------------------------
+
+QSharedPointer<SampleFile> SampleFile::open(const QString& path)
+      {
+      static std::mutex mutex;
+      static QHash<QString, QWeakPointer<SampleFile>> files;
+
+      std::lock_guard<std::mutex> lock(mutex);
+      QSharedPointer<SampleFile> sf = files.value(path).toStrongRef();
+      if (sf)
+            return sf;
+      sf = QSharedPointer<SampleFile>(new SampleFile(path));
+      if (!sf->_file.open(QIODevice::ReadOnly)) {
+            qDebug("SampleFile: cannot open <%s>", qPrintable(path));
+            return QSharedPointer<SampleFile>();
+            }
+      sf->_data = sf->_file.map(0, sf->_file.size());
+      if (!sf->_data) {
+            qDebug("SampleFile: cannot map <%s>", qPrintable(path));
+            return QSharedPointer<SampleFile>();
+            }
+      files.insert(path, sf);
+      return sf;
+      }
+
+//---------------------------------------------------------
+//   SampleCache
+//---------------------------------------------------------
+
+SampleCache* SampleCache::instance()
+      {
+      static SampleCache cache;
+      return &cache;
+      }
+
+//---------------------------------------------------------
+//   find
+//---------------------------------------------------------
+
+DecodedSamplePtr SampleCache::find(const QString& file, unsigned pos)
+      {
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto i = _index.find(Key(file, pos));
+      if (i == _index.end())
+            return DecodedSamplePtr();
+      _lru.splice(_lru.begin(), _lru, i.value());
+      return _lru.front().sample;
+      }
+
+//---------------------------------------------------------
+//   insert
+//    returns the cached sample, which is not the inserted
+//    one if another thread was faster
+//---------------------------------------------------------
+
+DecodedSamplePtr SampleCache::insert(const QString& file, unsigned pos, DecodedSamplePtr sample)
+      {
+      std::lock_guard<std::mutex> lock(_mutex);
+      Key key(file, pos);
+      auto i = _index.find(key);
+      if (i != _index.end()) {
+            _lru.splice(_lru.begin(), _lru, i.value());
+            return _lru.front().sample;
+            }
+      _lru.push_front({ key, sample });
+      _index.insert(key, _lru.begin());
+      _size += sample->bytes();
+      evict();
+      return sample;
+      }
+
+//---------------------------------------------------------
+//   evict
+//    drop least recently used samples which are not in
+//    use until the cache is within budget
+//---------------------------------------------------------
+
+void SampleCache::evict()
+      {
+      for (auto i = _lru.end(); _size > _budget && i != _lru.begin();) {
+            --i;
+            if (i->sample.use_count() > 1)
+                  continue;
+            _size -= i->sample->bytes();
+            _index.remove(i->key);
+            i = _lru.erase(i);
+            }
+      }
+
+//---------------------------------------------------------
+//   setBudget
+//---------------------------------------------------------
+
+void SampleCache::setBudget(qint64 bytes)
+      {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _budget = bytes;
+      evict();
+      }
+
+qint64 SampleCache::budget() const
+      {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _budget;
+      }
+
+//---------------------------------------------------------
+//   size
+//    bytes of all decoded samples, in use or not
+//---------------------------------------------------------
+
+qint64 SampleCache::size() const
+      {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _size;
+      }
+
+//---------------------------------------------------------
+//   unusedSize
+//    bytes of the decoded samples no sound font uses,
+//    i.e. those which may be evicted
+//---------------------------------------------------------
+
+qint64 SampleCache::unusedSize() const
+      {
+      std::lock_guard<std::mutex> lock(_mutex);
+      qint64 n = 0;
+      for (const Entry& e : _lru) {
+            if (e.sample.use_count() == 1)
+                  n += e.sample->bytes();
+            }
+      return n;
+      }
+
+//---------------------------------------------------------
+//   trim
+//    apply the budget to samples released since the last
+//    insert
+//---------------------------------------------------------
+
+void SampleCache::trim()
+      {
+      std::lock_guard<std::mutex> lock(_mutex);
+      evict();
+      }
+
+//---------------------------------------------------------
+//   clear
+//    drop all samples which are not in use
+//---------------------------------------------------------
+
+void SampleCache::clear()
+      {
+      std::lock_guard<std::mutex> lock(_mutex);
+      qint64 budget = _budget;
+      _budget = 0;
+      evict();
+      _budget = budget;
+      }
+
+}     // namespace FluidS
+
@@ -0,0 +1,100 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __FLUID_SAMPLECACHE_H__
+#define __FLUID_SAMPLECACHE_H__
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace FluidS {
+
+//---------------------------------------------------------
+//   SampleFile
+//    a sound font file mapped into memory. All SFont
+//    instances of the same file share one mapping; SF2
+//    sample data is used in place.
+//---------------------------------------------------------
+
+class SampleFile {
+      QFile _file;
+      const uchar* _data { 0 };
+
+      SampleFile(const QString& path) : _file(path) {}
+
+   public:
+      ~SampleFile();
+      static QSharedPointer<SampleFile> open(const QString& path);
+
+      const uchar* data() const { return _data; }
+      qint64 size() const       { return _file.size(); }
+      };
+
+//---------------------------------------------------------
+//   DecodedSample
+//    a decompressed SF3 sample and its sample points
+//---------------------------------------------------------
+
+struct DecodedSample {
+      std::vector<short> data;
+      unsigned end       { 0 };
+      unsigned loopstart { 0 };
+      unsigned loopend   { 0 };
+      bool valid         { false };
+
+      qint64 bytes() const { return qint64(data.size() * sizeof(short)); }
+      };
+
+typedef std::shared_ptr<const DecodedSample> DecodedSamplePtr;
+
+//---------------------------------------------------------
+//   SampleCache
+//    decoded SF3 samples shared by all synthesizer
+//    instances, keyed by file and position in the file.
+//
+//    Samples in use by an SFont stay in memory; of the
+//    others, the least recently used are dropped when the
+//    cache grows beyond its budget.
+//---------------------------------------------------------
+
+class SampleCache {
+      typedef QPair<QString, unsigned> Key;
+      struct Entry {
+            Key key;
+            DecodedSamplePtr sample;
+            };
+      std::list<Entry> _lru;                    // most recently used first
+      QHash<Key, std::list<Entry>::iterator> _index;
+      qint64 _budget { 256 * 1024 * 1024 };
+      qint64 _size   { 0 };
+      mutable std::mutex _mutex;
+
+      void evict();
+
+   public:
+      static SampleCache* instance();
+
+      DecodedSamplePtr find(const QString& file, unsigned pos);
+      DecodedSamplePtr insert(const QString& file, unsigned pos, DecodedSamplePtr sample);
+      void setBudget(qint64 bytes);
+      qint64 budget() const;
+      qint64 size() const;
+      qint64 unusedSize() const;
+      void trim();
+      void clear();
+      };
+
+}     // namespace FluidS
+#endif
+
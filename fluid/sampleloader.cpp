@@ -0,0 +1,191 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "sampleloader.h"
+#include "samplecache.h"
+#include "sfont.h"
+
+namespace FluidS {
+
+static const int URGENT_POLL = 5;         // ms
+
+//---------------------------------------------------------
+//   SampleLoader
+//---------------------------------------------------------
+
+SampleLoader::SampleLoader()
+      {
+      for (std::atomic<Sample*>& slot : _urgent)
+            slot.store(0, std::memory_order_relaxed);
+      // the loader thread uses the cache: construct it first so
+      // that it is destroyed only after this loader is stopped
+      SampleCache::instance();
+      _thread = std::thread(&SampleLoader::run, this);
+      }
+
+SampleLoader::~SampleLoader()
+      {
+      stop();
+      }
+
+SampleLoader* SampleLoader::instance()
+      {
+      static SampleLoader loader;
+      return &loader;
+      }
+
+//---------------------------------------------------------
+//   stop
+//    join the loader thread; queued samples are dropped
+//---------------------------------------------------------
+
+void SampleLoader::stop()
+      {
+      {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _quit = true;
+      _queue.clear();
+      }
+      _wakeup.notify_one();
+      if (_thread.joinable())
+            _thread.join();
+      }
+
+//---------------------------------------------------------
+//   run
+//---------------------------------------------------------
+
+void SampleLoader::run()
+      {
+      std::unique_lock<std::mutex> lock(_mutex);
+      for (;;) {
+            // urgent requests are not notified, see request()
+            _wakeup.wait_for(lock, std::chrono::milliseconds(URGENT_POLL),
+               [this] { return _quit || !_queue.empty() || urgentPending(); });
+            if (_quit)
+                  return;
+            bool urgent = true;
+            _current = takeUrgent();
+            if (!_current) {
+                  if (_queue.empty())
+                        continue;
+                  urgent   = false;
+                  _current = _queue.front();
+                  _queue.pop_front();
+                  }
+            lock.unlock();
+
+            SampleCache* cache = SampleCache::instance();
+            if (urgent || !_current->compressed() || cache->unusedSize() < cache->budget())
+                  _current->load();
+
+            lock.lock();
+            _current = 0;
+            _done.notify_all();
+            }
+      }
+
+//---------------------------------------------------------
+//   enqueue
+//---------------------------------------------------------
+
+void SampleLoader::enqueue(Sample* s)
+      {
+      if (s->loaded())
+            return;
+      {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _queue.push_back(s);
+      }
+      _wakeup.notify_one();
+      }
+
+//---------------------------------------------------------
+//   request
+//    called by noteon() on the audio thread: never blocks
+//    or allocates. If all slots are taken the request is
+//    dropped; the next note on asks again.
+//---------------------------------------------------------
+
+void SampleLoader::request(Sample* s)
+      {
+      for (const std::atomic<Sample*>& slot : _urgent) {
+            if (slot.load(std::memory_order_relaxed) == s)
+                  return;
+            }
+      for (std::atomic<Sample*>& slot : _urgent) {
+            Sample* expected = 0;
+            if (slot.compare_exchange_strong(expected, s))
+                  return;
+            }
+      }
+
+//---------------------------------------------------------
+//   urgentPending
+//---------------------------------------------------------
+
+bool SampleLoader::urgentPending() const
+      {
+      for (const std::atomic<Sample*>& slot : _urgent) {
+            if (slot.load(std::memory_order_acquire))
+                  return true;
+            }
+      return false;
+      }
+
+//---------------------------------------------------------
+//   takeUrgent
+//    called with _mutex held, so that cancel() sees the
+//    sample either in its slot or as _current
+//---------------------------------------------------------
+
+Sample* SampleLoader::takeUrgent()
+      {
+      for (std::atomic<Sample*>& slot : _urgent) {
+            Sample* s = slot.exchange(0, std::memory_order_acq_rel);
+            if (s)
+                  return s;
+            }
+      return 0;
+      }
+
+//---------------------------------------------------------
+//   cancel
+//    forget the samples of sf; called before sf is
+//    deleted
+//---------------------------------------------------------
+
+void SampleLoader::cancel(SFont* sf)
+      {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _queue.remove_if([sf](Sample* s) { return s->sf == sf; });
+      for (std::atomic<Sample*>& slot : _urgent) {
+            Sample* s = slot.load(std::memory_order_acquire);
+            if (s && s->sf == sf)
+                  slot.compare_exchange_strong(s, 0);
+            }
+      _done.wait(lock, [this, sf] { return !_current || _current->sf != sf; });
+      }
+
+//---------------------------------------------------------
+//   wait
+//    until all queued samples are processed
+//---------------------------------------------------------
+
+void SampleLoader::wait()
+      {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _done.wait(lock, [this] { return _queue.empty() && !urgentPending() && !_current; });
+      }
+
+}     // namespace FluidS
+
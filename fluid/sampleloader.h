@@ -0,0 +1,72 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __FLUID_SAMPLELOADER_H__
+#define __FLUID_SAMPLELOADER_H__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <thread>
+
+namespace FluidS {
+
+class SFont;
+class Sample;
+
+//---------------------------------------------------------
+//   SampleLoader
+//    loads the samples of presets in the background so
+//    that they are ready before the first note on.
+//    Compressed samples are only loaded ahead while the
+//    decoded samples no sound font uses are within the
+//    cache budget.
+//
+//    A note on for a sample which is not loaded yet only
+//    puts it into one of the urgent slots, without
+//    locking; the loader polls them and loads them before
+//    the queue.
+//---------------------------------------------------------
+
+class SampleLoader {
+      static const int URGENT_SLOTS = 64;
+
+      std::list<Sample*> _queue;
+      std::atomic<Sample*> _urgent[URGENT_SLOTS];
+      Sample* _current { 0 };
+      bool _quit       { false };
+      std::mutex _mutex;
+      std::condition_variable _wakeup;
+      std::condition_variable _done;
+      std::thread _thread;
+
+      void run();
+      bool urgentPending() const;
+      Sample* takeUrgent();
+
+   public:
+      SampleLoader();
+      ~SampleLoader();
+      static SampleLoader* instance();
+
+      void enqueue(Sample*);
+      void request(Sample*);
+      void cancel(SFont*);
+      void wait();
+      void stop();
+      };
+
+}     // namespace FluidS
+#endif
+
@@ -57,6 +57,7 @@ SFont::SFont(Fluid* f)
 
 SFont::~SFont()
       {
+      SampleLoader::instance()->cancel(this);
       foreach(Sample* s, sample)
             delete s;
       foreach(Preset* p, presets)
@@ -79,6 +80,7 @@ bool SFont::read(const QString& s)
       f.setFileName(s);
       if (!load())
             return false;
+      _sampleFile = SampleFile::open(s);
 
       foreach(Instrument* i, instruments) {
             if (!i->import_sfont())
@@ -132,29 +134,43 @@ Preset::~Preset()
 //---------------------------------------------------------
 //   loadSamples
 //    this is called if the preset is associated with a
-//    channel
+//    channel; the samples are loaded in the background
 //---------------------------------------------------------
 
 void Preset::loadSamples()
       {
-      bool locked = sfont->synth->mutex.tryLock();
+      SampleLoader* loader = SampleLoader::instance();
       if (_global_zone && _global_zone->instrument) {
             Instrument* i = _global_zone->instrument;
             if (i->global_zone && i->global_zone->sample)
-                  i->global_zone->sample->load();
+                  loader->enqueue(i->global_zone->sample);
             foreach(Zone* iz, i->zones)
-                  iz->sample->load();
+                  loader->enqueue(iz->sample);
             }
 
       foreach(Zone* z, zones) {
             Instrument* i = z->instrument;
             if (i->global_zone && i->global_zone->sample)
-                  i->global_zone->sample->load();
+                  loader->enqueue(i->global_zone->sample);
             foreach(Zone* iz, i->zones)
-                  iz->sample->load();
+                  loader->enqueue(iz->sample);
             }
-      if (locked)
-            sfont->synth->mutex.unlock();
+      }
+
+//---------------------------------------------------------
+//   sampleReady
+//    noteon() runs on the audio thread and must neither
+//    decode nor wait for another thread decoding: a sample
+//    which is not loaded yet is requested from the loader
+//    and the zone stays silent for this note
+//---------------------------------------------------------
+
+static bool sampleReady(Fluid* synth, Sample* sample)
+      {
+      if (sample->loaded() || synth->offline())
+            return sample->load();
+      SampleLoader::instance()->request(sample);
+      return false;
       }
 
 //---------------------------------------------------------
@@ -184,8 +200,8 @@ bool Preset::noteon(Fluid* synth, unsigned id, int chan, int key, int vel, doubl
                         if (sample == 0 || sample->inRom())
                               continue;
                         /* check if the note falls into the key and velocity range of this
-                           instrument */
-                        if (inst_zone->inside_range(key, vel) && (sample != 0)) {
+                           instrument and the sample data is there */
+                        if (inst_zone->inside_range(key, vel) && sampleReady(synth, sample)) {
 
                               /* this is a good zone. allocate a new synthesis process and
                                  initialize it */
@@ -575,6 +591,7 @@ bool Zone::importZone()
 //---------------------------------------------------------
 
 Sample::Sample(SFont* s)
+   : _loaded(false)
       {
       sf          = s;
       _valid      = false;
@@ -597,67 +614,125 @@ Sample::Sample(SFont* s)
 
 Sample::~Sample()
       {
-      delete[] data;
       }
 
 //---------------------------------------------------------
 //   load
+//    make the sample data available; called by the
+//    background loader, and by noteon() when rendering
+//    offline. Returns false if the sample has no data.
 //---------------------------------------------------------
 
-void Sample::load()
+bool Sample::load()
       {
-      if (!_valid || data)
-            return;
-      QFile fd(sf->get_name());
-      if (!fd.open(QIODevice::ReadOnly))
-            return;
-      if (sampletype & FLUID_SAMPLETYPE_OGG_VORBIS) {
-            if (!fd.seek(sf->samplePos() + start))
-                  return;
+      if (_loaded.load(std::memory_order_acquire))
+            return data != 0;
+      QMutexLocker locker(&_loadMutex);
+      if (!_loaded.load(std::memory_order_relaxed)) {
+            if (_valid && read())
+                  optimize();
+            _loaded.store(true, std::memory_order_release);
             }
-      else {
-            if (!fd.seek(sf->samplePos() + start * sizeof(short)))
-                  return;
+      return data != 0;
+      }
+
+//---------------------------------------------------------
+//   readFile
+//    read size bytes at pos of the sound font file
+//---------------------------------------------------------
+
+bool Sample::readFile(unsigned pos, char* dst, unsigned size) const
+      {
+      QFile fd(sf->get_name());
+      if (!fd.open(QIODevice::ReadOnly) || !fd.seek(pos))
+            return false;
+      if (fd.read(dst, size) != size) {
+            printf("  read %d failed\n", size);
+            return false;
             }
+      return true;
+      }
+
+//---------------------------------------------------------
+//   read
+//    PCM data of SF2 files is used in place in the file
+//    mapping; decompressed SF3 data comes from the sample
+//    cache shared by all sound fonts
+//---------------------------------------------------------
+
+bool Sample::read()
+      {
+      SampleFile* file = sf->sampleFile();
       unsigned int size = end - start;
 
-      if (sampletype & FLUID_SAMPLETYPE_OGG_VORBIS) {
+      if (compressed()) {
 #ifdef SOUNDFONT3
-            char* p = new char[size];
-            if (fd.read(p, size) != size) {
-                  printf("  read %d failed\n", size);
-                  delete[] p;
-                  return;
+            QString path = sf->get_name();
+            unsigned pos = sf->samplePos() + start;
+            DecodedSamplePtr ds = SampleCache::instance()->find(path, pos);
+            if (!ds) {
+                  QByteArray src;
+                  if (file && pos + size <= file->size())
+                        src = QByteArray::fromRawData((const char*)file->data() + pos, size);
+                  else {
+                        src.resize(size);
+                        if (!readFile(pos, src.data(), size))
+                              return false;
+                        }
+                  DecodedSample* d = new DecodedSample;
+                  decompressOggVorbis(src, d);
+                  ds = SampleCache::instance()->insert(path, pos, DecodedSamplePtr(d));
                   }
-            decompressOggVorbis(p, size);
-            delete[] p;
+            _decoded  = ds;
+            start     = 0;
+            end       = ds->end;
+            loopstart = ds->loopstart;
+            loopend   = ds->loopend;
+            if (!ds->valid)
+                  setValid(false);
+            data = ds->data.empty() ? 0 : ds->data.data();
 #endif
+            return data != 0;
             }
-      else {
-            data = new short[size];
-            size *= sizeof(short);
-
-            if (fd.read((char*)data, size) != size)
-                  return;
 
+      unsigned pos = sf->samplePos() + start * sizeof(short);
+      const uchar* p = file ? file->data() + pos : 0;
+      if (QSysInfo::ByteOrder == QSysInfo::LittleEndian && p
+         && pos + size * sizeof(short) <= file->size() && !(quintptr(p) & 1)) {
+            data = (const short*)p;
+            }
+      else {
+            _buffer.resize(size);
+            if (!readFile(pos, (char*)_buffer.data(), size * sizeof(short)))
+                  return false;
             if (QSysInfo::ByteOrder == QSysInfo::BigEndian) {
                   unsigned char hi, lo;
                   unsigned int i, j;
                   short s;
-                  uchar* cbuf = (uchar*) data;
-                  for (i = 0, j = 0; j < size; i++) {
+                  uchar* cbuf = (uchar*) _buffer.data();
+                  for (i = 0, j = 0; j < size * sizeof(short); i++) {
                         lo = cbuf[j++];
                         hi = cbuf[j++];
                         s = (hi << 8) | lo;
-                        data[i] = s;
+                        _buffer[i] = s;
                         }
                   }
-            end       -= (start + 1);       // marks last sample, contrary to SF spec.
-            loopstart -= start;
-            loopend   -= start;
-            start      = 0;
+            data = _buffer.data();
             }
-      optimize();
+      end       -= (start + 1);       // marks last sample, contrary to SF spec.
+      loopstart -= start;
+      loopend   -= start;
+      start      = 0;
+      return true;
+      }
+
+//---------------------------------------------------------
+//   compressed
+//---------------------------------------------------------
+
+bool Sample::compressed() const
+      {
+      return sampletype & FLUID_SAMPLETYPE_OGG_VORBIS;
       }
 
 //---------------------------------------------------------
@@ -23,8 +23,11 @@
 #ifndef _FLUID_DEFSFONT_H
 #define _FLUID_DEFSFONT_H
 
+#include <atomic>
 #include "config.h"
 #include "fluid.h"
+#include "samplecache.h"
+#include "sampleloader.h"
 
 namespace FluidS {
 
@@ -52,6 +55,7 @@ struct SFVersion {            // version structure
 class SFont {
       Fluid* synth;
       QFile f;
+      QSharedPointer<SampleFile> _sampleFile;
       unsigned samplepos;           // the position in the file at which the sample data starts
       unsigned samplesize;          // the size of the sample data
 
@@ -104,6 +108,7 @@ class SFont {
       virtual ~SFont();
 
       QString get_name()  const                 { return f.fileName(); }
+      SampleFile* sampleFile() const            { return _sampleFile.data(); }
       Preset* get_preset(int bank, int prenum);
 
       bool read(const QString& file);
@@ -128,6 +133,13 @@ class SFont {
 
 class Sample {
       bool _valid;
+      std::atomic<bool> _loaded;
+      QMutex _loadMutex;
+      std::vector<short> _buffer;   // sample data if it cannot be used in place
+      DecodedSamplePtr _decoded;    // decompressed SF3 sample data
+
+      bool read();
+      bool readFile(unsigned pos, char* dst, unsigned size) const;
 
    public:
       SFont* sf;
@@ -140,7 +152,7 @@ class Sample {
       int pitchadj;
       int sampletype;
 
-      short* data;
+      const short* data;
 
       /** The amplitude, that will lower the level of the sample's loop to
           the noise floor. Needed for note turnoff optimization, will be
@@ -154,12 +166,14 @@ class Sample {
       ~Sample();
 
       bool inRom() const;
+      bool compressed() const;
       void optimize();
-      void load();
+      bool load();
+      bool loaded() const   { return _loaded.load(std::memory_order_acquire); }
       bool valid() const    { return _valid; }
       void setValid(bool v) { _valid = v; }
 #ifdef SOUNDFONT3
-      bool decompressOggVorbis(char* p, int size);
+      bool decompressOggVorbis(const QByteArray& src, DecodedSample* ds) const;
 #endif
       };
 
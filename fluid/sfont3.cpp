@@ -8,43 +8,46 @@ namespace FluidS {
 
 //---------------------------------------------------------
 //   decompressOggVorbis
+//    decode src into ds; the loop points of this sample
+//    are fixed up for the decoded data
 //---------------------------------------------------------
 
-bool Sample::decompressOggVorbis(char* src, int size)
+bool Sample::decompressOggVorbis(const QByteArray& src, DecodedSample* ds) const
       {
       AudioFile af;
-      QByteArray ba(src, size);
 
-      start = 0;
-      end   = 0;
-      if (!af.open(ba)) {
+      ds->end   = 0;
+      ds->valid = false;
+      if (!af.open(src)) {
             qDebug("Sample::decompressOggVorbis: open failed: %s", af.error());
             return false;
             }
       int frames = af.frames();
-      data = new short[frames * af.channels()];
-      if (frames != af.read(data, frames)) {
+      ds->data.resize(frames * af.channels());
+      if (frames <= 0 || frames != af.read(ds->data.data(), frames)) {
             qDebug("Sample read failed: %s", af.error());
-            delete[] data;
-            data = 0;
+            ds->data.clear();
+            return false;
             }
-      end = frames - 1;
+      ds->end       = frames - 1;
+      ds->loopstart = loopstart;
+      ds->loopend   = loopend;
 
-      if (loopend > end ||loopstart >= loopend || loopstart <= start) {
+      if (ds->loopend > ds->end || ds->loopstart >= ds->loopend || ds->loopstart == 0) {
             /* can pad loop by 8 samples and ensure at least 4 for loop (2*8+4) */
-            if ((end - start) >= 20) {
-                  loopstart = start + 8;
-                  loopend = end - 8;
+            if (ds->end >= 20) {
+                  ds->loopstart = 8;
+                  ds->loopend   = ds->end - 8;
                   }
             else { // loop is fowled, sample is tiny (can't pad 8 samples)
-                  loopstart = start + 1;
-                  loopend = end - 1;
+                  ds->loopstart = 1;
+                  ds->loopend   = ds->end - 1;
                   }
             }
-      if ((end - start) < 8) {
+      if (ds->end < 8)
             qDebug("invalid sample");
-            setValid(false);
-            }
+      else
+            ds->valid = true;
 
       return true;
       }
@@ -271,9 +271,9 @@ bool Voice::generateDataForDSPChain(unsigned framesBufCount)
             /******************* vol env **********************/
             
             fluid_env_data_t* env_data = &volenv_data[volenv_section];
-            Sample2AmpInc.clear();
-            std::map<int, int> sample2VolEnvSection;
-            std::set<int> volumeChanges;
+            ampRamps.clear();
+            volEnvSections.clear();
+            volumeChanges.clear();
             
             if (volenv_section >= FLUID_VOICE_ENVFINISHED) {
                   off();
@@ -286,8 +286,9 @@ bool Voice::generateDataForDSPChain(unsigned framesBufCount)
             while (curVolEnvCount + restN >= env_data->count) {
                   restN -= env_data->count - curVolEnvCount;
                   
-                  sample2VolEnvSection.insert(std::pair<int, int>(framesBufCount - restN, volenv_section));
-                  volumeChanges.insert(framesBufCount-restN);
+                  if (volEnvSections.empty() || volEnvSections.back().first != int(framesBufCount - restN))
+                        volEnvSections.push_back(std::pair<int, int>(framesBufCount - restN, volenv_section));
+                  volumeChanges.push_back(framesBufCount-restN);
                   
                   curVolEnvCount = 0;
                   volenv_section++;
@@ -295,8 +296,9 @@ bool Voice::generateDataForDSPChain(unsigned framesBufCount)
                   env_data = &volenv_data[volenv_section];
                   }
             
-            sample2VolEnvSection.insert(std::pair<int, int>(framesBufCount, volenv_section));
-            volumeChanges.insert(framesBufCount);
+            if (volEnvSections.empty() || volEnvSections.back().first != int(framesBufCount))
+                  volEnvSections.push_back(std::pair<int, int>(framesBufCount, volenv_section));
+            volumeChanges.push_back(framesBufCount);
             
             fluid_check_fpe ("voice_write vol env");
             
@@ -350,18 +352,21 @@ bool Voice::generateDataForDSPChain(unsigned framesBufCount)
                   
                   if (modLfoStart >= 0) {
                         if (modLfoStart > 0)
-                              volumeChanges.insert(modLfoStart);
+                              volumeChanges.push_back(modLfoStart);
                         
                         unsigned int modLfoNextTurn = samplesToNextTurningPoint(modlfo_dur, modlfo_pos);
                         
                         while (modLfoNextTurn+modLfoStart < framesBufCount) {
-                              volumeChanges.insert(modLfoNextTurn+modLfoStart);
+                              volumeChanges.push_back(modLfoNextTurn+modLfoStart);
                               modLfoNextTurn++;
                               modLfoNextTurn += samplesToNextTurningPoint(modlfo_dur, modLfoNextTurn);
                               }
                         }
                   }
             
+            std::sort(volumeChanges.begin(), volumeChanges.end());
+            volumeChanges.erase(std::unique(volumeChanges.begin(), volumeChanges.end()), volumeChanges.end());
+
             fluid_check_fpe ("voice_write mod LFO");
             
             /******************* vib lfo **********************/
@@ -389,11 +394,12 @@ bool Voice::generateDataForDSPChain(unsigned framesBufCount)
             
             qreal oldTargetAmp = amp;
             int lastPos = 0;
-            auto oldVolEnvSection = sample2VolEnvSection.begin();
+            auto oldVolEnvSection = volEnvSections.begin();
             auto curVolEnvSection = oldVolEnvSection;
             
-            for (auto curPos : volumeChanges)
+            for (size_t i = 0; i < volumeChanges.size(); ++i)
             {
+                  int curPos = volumeChanges[i];
                   if (modLfoStart >= 0 && curPos >= modLfoStart)
                         modlfo_val = triangle(modlfo_dur, modlfo_pos+curPos-modLfoStart);
                   else
@@ -407,8 +413,8 @@ bool Voice::generateDataForDSPChain(unsigned framesBufCount)
                         
                         // if we should calculate for position 1 already make sure we don't do it twice
                         // could lead to curPos==lastPos which causes devision by zero
-                        if (volumeChanges.find(1) != volumeChanges.end())
-                              volumeChanges.erase(volumeChanges.find(1));
+                        if (i + 1 < volumeChanges.size() && volumeChanges[i + 1] == 1)
+                              volumeChanges.erase(volumeChanges.begin() + i + 1);
                         }
                   
                   // just go to the next volume section if we're below last volume point
@@ -481,7 +487,7 @@ bool Voice::generateDataForDSPChain(unsigned framesBufCount)
                   /* Volume increment to go from voice->amp to target_amp in FLUID_BUFSIZE steps */
                   amp_incr = (target_amp - oldTargetAmp) / (curPos - lastPos);
                   lastPos = curPos;
-                  Sample2AmpInc.insert(std::pair<int, qreal>(curPos, amp_incr));
+                  ampRamps.push_back({ unsigned(curPos), amp_incr });
                   
                   // if voice is turned off after this no need to calculate any more values
                   if (positionToTurnOff > 0)
@@ -490,6 +496,8 @@ bool Voice::generateDataForDSPChain(unsigned framesBufCount)
                   oldTargetAmp = target_amp;
             }
             
+            ampRamps.push_back({ UINT_MAX, 0.0 });
+
             if (modLfoStart >= 0) {
                   modlfo_pos += framesBufCount - modLfoStart;
                   modlfo_val = triangle(modlfo_dur, modlfo_pos-modLfoStart);
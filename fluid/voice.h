@@ -23,6 +23,7 @@
 
 #include "fluid.h"
 #include "gen.h"
+#include "dspkernel.h"
 
 namespace FluidS {
 
@@ -45,6 +46,17 @@ struct fluid_env_data_t {
 	float max;
       };
 
+//---------------------------------------------------------
+//   AmpRamp
+//    from the end of the previous ramp up to frame pos the
+//    amplitude changes by incr per frame
+//---------------------------------------------------------
+
+struct AmpRamp {
+      unsigned pos;
+      qreal incr;
+      };
+
 /* Indices for envelope tables */
 enum fluid_voice_envelope_index_t {
 	FLUID_VOICE_ENVDELAY,
@@ -66,6 +78,7 @@ class Voice
       static float interp_coeff_linear[FLUID_INTERP_MAX][2];
       static float interp_coeff[FLUID_INTERP_MAX][4];
       static float sinc_table7[FLUID_INTERP_MAX][7];
+      static const DspKernels* dspKernels;
 
       Fluid* _fluid;
       double _noteTuning;             // +/- in midicent
@@ -106,6 +119,7 @@ public:
 	unsigned char chan;             // the channel number, quick access for channel messages
 	unsigned char key;              // the key, quick acces for noteoff
 	unsigned char vel;              // the velocity
+      bool freePending { false };     // turned off during parallel rendering
 
 	Channel* channel;
 	Generator gen[GEN_LAST];
@@ -143,7 +157,12 @@ public:
 	fluid_env_data_t volenv_data[FLUID_VOICE_ENVLAST];
 	unsigned int volenv_count;
 	int volenv_section;
-   std::map<int, qreal> Sample2AmpInc;
+      // amplitude ramps of the frames generated by the last
+      // generateDataForDSPChain(), terminated by a sentinel;
+      // kept as flat arrays which are reused from call to call
+      std::vector<AmpRamp> ampRamps;
+      std::vector<int> volumeChanges;
+      std::vector<std::pair<int, int>> volEnvSections;
 	float volenv_val;
 	float amplitude_that_reaches_noise_floor_nonloop;
 	float amplitude_that_reaches_noise_floor_loop;
@@ -263,7 +282,12 @@ public:
       void add_mod(const Mod* mod, int mode);
 
       static void dsp_float_config();
-      bool updateAmpInc(unsigned int &nextNewAmpInc, std::map<int, qreal>::iterator &curSample2AmpInc, qreal &dsp_amp_incr, unsigned int &dsp_i);
+      static void setDspIsa(DspIsa);
+      bool updateAmpInc(unsigned int &nextNewAmpInc, const AmpRamp* &curAmpRamp, qreal &dsp_amp_incr, unsigned int &dsp_i);
+      unsigned dspBlockFrames(unsigned n, unsigned dsp_i, Phase dsp_phase, Phase dsp_phase_incr, unsigned end_index,
+         unsigned nextNewAmpInc, const AmpRamp* curAmpRamp, qreal dsp_amp_incr) const;
+      void dspPrepareBlock(DspBlock& block, Phase& dsp_phase, Phase dsp_phase_incr, qreal dsp_amp_incr,
+         int taps, int first, unsigned frames);
       int dsp_float_interpolate_none(unsigned);
       int dsp_float_interpolate_linear(unsigned);
       int dsp_float_interpolate_4th_order(unsigned);
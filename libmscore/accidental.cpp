@@ -19,6 +19,7 @@
 #include "staff.h"
 #include "undo.h"
 #include "xml.h"
+#include "elementpool.h"
 
 namespace Ms {
 
@@ -70,6 +71,20 @@ static Acc accList[] = {
       Acc("koron",               QT_TRANSLATE_NOOP("accidental", "Koron"),               AccidentalVal::NATURAL, -50,  SymId::accidentalKoron)
       };
 
+//---------------------------------------------------------
+//   operator new
+//---------------------------------------------------------
+
+void* Accidental::operator new(size_t size)
+      {
+      return elementPool<Accidental>()->alloc(size);
+      }
+
+void Accidental::operator delete(void* p, size_t size)
+      {
+      elementPool<Accidental>()->free(p, size);
+      }
+
 //---------------------------------------------------------
 //   Accidental
 //---------------------------------------------------------
@@ -150,6 +150,8 @@ class Accidental : public Element {
 
    public:
       Accidental(Score* s = 0);
+      static void* operator new(size_t);
+      static void operator delete(void*, size_t);
       virtual Accidental* clone() const override  { return new Accidental(*this); }
       virtual Element::Type type() const override { return Element::Type::ACCIDENTAL; }
 
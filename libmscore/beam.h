@@ -104,7 +104,7 @@ class Beam : public Element {
       void layoutGraceNotes();
       void layout();
 
-      const QList<ChordRest*>& elements() { return _elements;  }
+      const QList<ChordRest*>& elements() const { return _elements;  }
       void clear()                        { _elements.clear(); }
       bool isEmpty() const                { return _elements.isEmpty(); }
 
@@ -51,6 +51,7 @@
 #include "sym.h"
 #include "stringdata.h"
 #include "beam.h"
+#include "elementpool.h"
 
 namespace Ms {
 
@@ -178,6 +179,20 @@ int Chord::downString() const
       return line;
       }
 
+//---------------------------------------------------------
+//   operator new
+//---------------------------------------------------------
+
+void* Chord::operator new(size_t size)
+      {
+      return elementPool<Chord>()->alloc(size);
+      }
+
+void Chord::operator delete(void* p, size_t size)
+      {
+      elementPool<Chord>()->free(p, size);
+      }
+
 //---------------------------------------------------------
 //   Chord
 //---------------------------------------------------------
@@ -111,6 +111,8 @@ class Chord : public ChordRest {
       ~Chord();
       Chord &operator=(const Chord&) = delete;
 
+      static void* operator new(size_t);
+      static void operator delete(void*, size_t);
       virtual Chord* clone() const       { return new Chord(*this, false); }
       virtual Element* linkedClone()     { return new Chord(*this, true); }
       virtual void undoUnlink() override;
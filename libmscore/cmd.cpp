@@ -120,10 +120,23 @@ void Score::endCmd(bool rollback)
             undo()->current()->unwind();
             }
 
+      // if all changes of this command are in a known tick range,
+      // only this range is laid out again. The range is shared by
+      // the main score and its parts: they use one undo stack, so
+      // it covers the changes of every score, and the measures of
+      // a part have the same ticks as those of the main score.
+      // Each score finds its own changed systems from there, see
+      // layoutSystemsRange().
+      int stick, etick;
+      bool layoutRange = MScore::incrementalLayout && undo()->layoutRange(&stick, &etick);
+
       for (Score* s : scoreList()) {
             if (s->layoutAll()) {
                   s->_updateAll  = true;
-                  s->doLayout();
+                  if (layoutRange)
+                        s->doLayoutRange(stick, etick);
+                  else
+                        s->doLayout();
                   if (s != this)
                         s->deselectAll();
                   }
@@ -913,8 +913,57 @@ void StaffLines::layout()
 
       lw = score()->styleS(StyleIdx::staffLineWidth).val() * _spatium;
       bbox().setRect(0.0, -lw*.5, width(), lines * dist + lw);
+#ifndef DISABLE_UTPIANO
+      _utWidth = -1.0;
+#endif
       }
 
+#ifndef DISABLE_UTPIANO
+//---------------------------------------------------------
+//   layoutUtPiano
+//    build the keyboard background: grey bands for the
+//    black keys, every other band divided by white dashes
+//    every 1.75 line distances; lines 1, 4, 8, 11 (right
+//    hand) or 3, 6, 10 (left hand) are not drawn
+//---------------------------------------------------------
+
+void StaffLines::layoutUtPiano(StaffType* st) const
+      {
+      qreal x1 = 0.0;
+      qreal x2 = x1 + width();
+      bool left = st->group() == StaffGroup::UTPIANO_LEFT_HAND;
+
+      _bands = QPainterPath();
+      _keys  = QPainterPath();
+      qreal spaceX = dist * 1.75;
+      int numX     = (int) ((x2 + spaceX) / spaceX);
+      int delta    = 0;
+      bool skip    = false;
+      for (int j = left ? 2 : 0; j < lines; j += delta) {
+            int y = (int)(((qreal)j * dist) + 0.5);
+            _bands.addRect(QRect(x1, y + lw, x2, dist + lw));
+            if (delta == 3) {
+                  // a line of width 3*lw with flat caps
+                  for (int x = 1; x < numX; x++) {
+                        qreal dx = x1 + ((qreal)x * spaceX);
+                        _keys.addRect(QRectF(dx - lw * 1.5, y + (dist * 0.25), lw * 3, dist * 0.5));
+                        }
+                  }
+            delta = skip ? 4 : 3;
+            skip  = !skip;
+            }
+
+      _utLines.clear();
+      for (int i = 0; i < lines; ++i) {
+            if ((left && i != 3 && i != 6 && i != 10) || (!left && i != 1 && i != 4 && i != 8 && i != 11)) {
+                  qreal y = (qreal)i * dist;
+                  _utLines.append(QLineF(x1, y, x2, y));
+                  }
+            }
+      _utWidth = width();
+      }
+#endif
+
 //---------------------------------------------------------
 //   draw
 //---------------------------------------------------------
@@ -926,68 +975,20 @@ void StaffLines::draw(QPainter* painter) const
       qreal x1 = _pos.x();
       qreal x2 = x1 + width();
 
-      QVector<QLineF> ll(lines);
-      qreal y = _pos.y();
 #ifndef DISABLE_UTPIANO
       StaffType* st = staff() ? staff()->staffType() : 0;
-      if (st!=0 && (st->group() == StaffGroup::UTPIANO_RIGHT_HAND || st->group() == StaffGroup::UTPIANO_LEFT_HAND ))
-      {
-           painter->save();
-           int j = 0;
-           int delta = 0;
-           int x = 0;
-           qreal spaceX = dist * 1.75;
-           int numX = (int) ((x2+spaceX) / spaceX);
-           bool skip = false;
-           y = 0;
-
-           if (st->group() == StaffGroup::UTPIANO_LEFT_HAND)
-           {
-                // skip to line 2
-                j = 2;
-           }
-
-           while (j<lines)
-           {
-                y = (int)(((qreal)j*dist) + 0.5);
-                painter->setBrush(QBrush(QColor(200, 200, 200)));
-                painter->setPen(Qt::NoPen);
-                painter->drawRect(QRect(x1, y + lw, x2, dist + lw));
-                painter->setPen(Qt::SolidLine );
-                painter->setPen(Qt::black);
-                if (delta == 3)
-                {
-                     painter->setPen(QPen(QColor(255, 255, 255), lw*3, Qt::SolidLine, Qt::FlatCap));
-                     qreal dx = 0.0;
-                     for (x=1; x<numX;x++)
-                     {
-                         dx =  x1+((qreal)x*spaceX);
-                         painter->drawLine(QLineF(dx, y + (dist * 0.25), dx, y + (dist * 0.75)));
-                     }
-                }
-                delta = (!skip)?3:4;
-                skip = !skip;
-                j += delta;
-           }
-           painter->restore();
-
-           // Need to remove lines 1,4,8,11
-           y = 0.0;
-           int i = 0;
-           while(i<lines)
-           {
-               y = ((qreal)i*dist);
-               if ((st->group() == StaffGroup::UTPIANO_LEFT_HAND && i!=3 && i!=6 && i!=10) ||
-                   (st->group() == StaffGroup::UTPIANO_RIGHT_HAND && i!= 1 && i!=4 && i!=8 && i!=11))
-               {
-                 ll[i].setLine(x1, y, x2, y);
-               }
-               i++;
-           }
-      }
-      else
+      if (st && (st->group() == StaffGroup::UTPIANO_RIGHT_HAND || st->group() == StaffGroup::UTPIANO_LEFT_HAND)) {
+            if (_utWidth != width())
+                  layoutUtPiano(st);
+            painter->fillPath(_bands, QColor(200, 200, 200));
+            painter->fillPath(_keys, QColor(255, 255, 255));
+            painter->setPen(QPen(curColor(), lw, Qt::SolidLine, Qt::FlatCap));
+            painter->drawLines(_utLines);
+            return;
+            }
 #endif
-      {
+      QVector<QLineF> ll(lines);
+      qreal y = _pos.y();
       for (int i = 0; i < lines; ++i) {
             ll[i].setLine(x1, y, x2, y);
             y += dist;
@@ -1011,7 +1012,6 @@ void StaffLines::draw(QPainter* painter) const
             y = _pos.y() + (lines+4) * dist;
             painter->drawLine(QLineF(x1, y, x2, y));
             }
- }
       painter->setPen(QPen(curColor(), lw, Qt::SolidLine, Qt::FlatCap));
       painter->drawLines(ll);
       }
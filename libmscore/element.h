@@ -621,6 +621,16 @@ class StaffLines : public Element {
       qreal dist;
       qreal lw;
       int lines;
+#ifndef DISABLE_UTPIANO
+      // keyboard background of UT-piano staves, built on
+      // first draw after layout
+      mutable QPainterPath _bands;        // grey bands
+      mutable QPainterPath _keys;         // white dashes on every other band
+      mutable QVector<QLineF> _utLines;
+      mutable qreal _utWidth { -1.0 };    // width the background was built for
+
+      void layoutUtPiano(StaffType*) const;
+#endif
 
    public:
       StaffLines(Score*);
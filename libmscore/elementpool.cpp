@@ -0,0 +1,132 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "elementpool.h"
+
+namespace Ms {
+
+static const size_t SLAB_SIZE = 64 * 1024;
+
+//---------------------------------------------------------
+//   poolList
+//---------------------------------------------------------
+
+static std::mutex poolListMutex;
+
+static std::vector<ElementPool*>& poolList()
+      {
+      static std::vector<ElementPool*>* list = new std::vector<ElementPool*>;
+      return *list;
+      }
+
+//---------------------------------------------------------
+//   ElementPool
+//---------------------------------------------------------
+
+ElementPool::ElementPool(size_t size, const char* name)
+      {
+      const size_t align = alignof(std::max_align_t);
+      _name       = name;
+      _objectSize = size;
+      _blockSize  = (qMax(size, sizeof(Block)) + align - 1) & ~(align - 1);
+      _slabBlocks = qMax(16, int(SLAB_SIZE / _blockSize));
+      std::lock_guard<std::mutex> lock(poolListMutex);
+      poolList().push_back(this);
+      }
+
+//---------------------------------------------------------
+//   pools
+//    all pools created so far
+//---------------------------------------------------------
+
+std::vector<ElementPool*> ElementPool::pools()
+      {
+      std::lock_guard<std::mutex> lock(poolListMutex);
+      return poolList();
+      }
+
+//---------------------------------------------------------
+//   addSlab
+//---------------------------------------------------------
+
+void ElementPool::addSlab()
+      {
+      char* slab = static_cast<char*>(::operator new(_slabBlocks * _blockSize));
+      _slabs.push_back(slab);
+      for (int i = _slabBlocks - 1; i >= 0; --i) {
+            Block* b = reinterpret_cast<Block*>(slab + i * _blockSize);
+            b->next = _free;
+            _free   = b;
+            }
+      }
+
+//---------------------------------------------------------
+//   alloc
+//---------------------------------------------------------
+
+void* ElementPool::alloc(size_t size)
+      {
+      if (size != _objectSize)
+            return ::operator new(size);
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (!_free)
+            addSlab();
+      Block* b = _free;
+      _free = b->next;
+      ++_allocations;
+      ++_used;
+      return b;
+      }
+
+//---------------------------------------------------------
+//   free
+//---------------------------------------------------------
+
+void ElementPool::free(void* p, size_t size)
+      {
+      if (!p)
+            return;
+      if (size != _objectSize) {
+            ::operator delete(p);
+            return;
+            }
+      std::lock_guard<std::mutex> lock(_mutex);
+      Block* b = static_cast<Block*>(p);
+      b->next = _free;
+      _free   = b;
+      --_used;
+      }
+
+//---------------------------------------------------------
+//   statistics
+//---------------------------------------------------------
+
+qint64 ElementPool::allocations() const
+      {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _allocations;
+      }
+
+int ElementPool::used() const
+      {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _used;
+      }
+
+qint64 ElementPool::bytes() const
+      {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return qint64(_slabs.size()) * _slabBlocks * _blockSize;
+      }
+
+}     // namespace Ms
+
@@ -0,0 +1,78 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __ELEMENTPOOL_H__
+#define __ELEMENTPOOL_H__
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   ElementPool
+//    memory for the objects of one element class, which
+//    are created and deleted in large numbers. Objects are
+//    carved out of slabs of fixed size blocks; freed blocks
+//    are reused, slabs are never returned.
+//
+//    Objects of derived classes have another size and are
+//    passed on to the global operator new/delete.
+//---------------------------------------------------------
+
+class ElementPool {
+      struct Block {
+            Block* next;
+            };
+      const char* _name;
+      size_t _objectSize;
+      size_t _blockSize;
+      int _slabBlocks;
+      Block* _free { 0 };
+      std::vector<char*> _slabs;
+      qint64 _allocations { 0 };
+      int _used           { 0 };
+      mutable std::mutex _mutex;
+
+      void addSlab();
+
+   public:
+      ElementPool(size_t size, const char* name);
+
+      void* alloc(size_t size);
+      void free(void* p, size_t size);
+
+      const char* name() const { return _name; }
+      qint64 allocations() const;         ///< number of objects allocated so far
+      int used() const;                   ///< number of objects alive
+      qint64 bytes() const;               ///< memory held by the slabs
+
+      static std::vector<ElementPool*> pools();
+      };
+
+//---------------------------------------------------------
+//   elementPool
+//    the pool for class T; it is never destroyed, elements
+//    may be deleted during program exit
+//---------------------------------------------------------
+
+template <class T>
+ElementPool* elementPool()
+      {
+      static ElementPool* pool = new ElementPool(sizeof(T), T::staticMetaObject.className());
+      return pool;
+      }
+
+}     // namespace Ms
+#endif
+
@@ -0,0 +1,267 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "eventcache.h"
+#include "score.h"
+#include "staff.h"
+#include "part.h"
+#include "instrument.h"
+#include "measure.h"
+#include "tempo.h"
+#include "undo.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   firstChange
+//    the tick from which on the values of two tick maps
+//    may differ, -1 if they are equal; ramps between two
+//    entries depend on both, so the entry before the
+//    first difference is returned
+//---------------------------------------------------------
+
+template <class T, class Eq>
+static int firstChange(const QMap<int, T>& a, const QMap<int, T>& b, Eq equal)
+      {
+      int prev = 0;
+      auto i1 = a.begin();
+      auto i2 = b.begin();
+      for (; i1 != a.end() && i2 != b.end(); ++i1, ++i2) {
+            if (i1.key() != i2.key() || !equal(i1.value(), i2.value()))
+                  return prev;
+            prev = i1.key();
+            }
+      if (i1 != a.end() || i2 != b.end())
+            return prev;
+      return -1;
+      }
+
+//---------------------------------------------------------
+//   clear
+//---------------------------------------------------------
+
+void EventCache::clear()
+      {
+      _staves.clear();
+      _state.clear();
+      _tempo.clear();
+      }
+
+//---------------------------------------------------------
+//   invalidate
+//    drop the events of all measures starting in the
+//    range stick - etick
+//---------------------------------------------------------
+
+void EventCache::invalidate(int stick, int etick)
+      {
+      for (auto& staff : _staves) {
+            for (auto i = staff.begin(); i != staff.end();) {
+                  if (i->tick >= stick && i->tick < etick)
+                        i = staff.erase(i);
+                  else
+                        ++i;
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   invalidate
+//    drop the events of the measures changed by a command
+//    and of their neighbours: notes tied into a measure
+//    are rendered with the first note of the tie
+//---------------------------------------------------------
+
+void EventCache::invalidate(Score* score, int stick, int etick)
+      {
+      Measure* sm = score->tick2measure(stick);
+      Measure* em = score->tick2measure(etick);
+      if (!sm || !em) {
+            invalidate(0, INT_MAX);
+            return;
+            }
+      if (sm->prevMeasure())
+            sm = sm->prevMeasure();
+      if (em->nextMeasure())
+            em = em->nextMeasure();
+      invalidate(sm->tick(), em->endTick());
+      }
+
+//---------------------------------------------------------
+//   invalidateStaff
+//    drop the events of a staff from tick on
+//---------------------------------------------------------
+
+void EventCache::invalidateStaff(int staffIdx, int tick)
+      {
+      if (staffIdx >= _staves.size())
+            return;
+      auto& staff = _staves[staffIdx];
+      for (auto i = staff.begin(); i != staff.end();) {
+            if (i->endTick > tick)
+                  i = staff.erase(i);
+            else
+                  ++i;
+            }
+      }
+
+//---------------------------------------------------------
+//   update
+//    drop the events of the tick ranges changed since the
+//    last update, then compare velocities, swing, channels
+//    and tempo with the values the cached events were
+//    rendered with and drop the events which depend on
+//    changed values; called after these values were
+//    computed for a rendering
+//---------------------------------------------------------
+
+void EventCache::update(Score* score)
+      {
+      UndoStack* undo = score->undo();
+      QList<QPair<int,int>> ranges;
+      if (_stamp == -1 || !undo->changes(_stamp, &ranges))
+            clear();
+      else {
+            for (const QPair<int,int>& r : ranges) {
+                  if (r.first == -1) {
+                        invalidate(0, INT_MAX);
+                        break;
+                        }
+                  invalidate(score, r.first, r.second);
+                  }
+            }
+      _stamp = undo->changeStamp();
+
+      int n = score->nstaves();
+      if (_state.size() != n) {
+            clear();
+            _staves.resize(n);
+            _state.resize(n);
+            }
+
+      // the length of acciaccaturas depends on the tempo
+      QMap<int,qreal> tempo;
+      for (const auto& i : *score->tempomap())
+            tempo.insert(i.first, i.second.tempo);
+      int tick = firstChange(_tempo, tempo, [](qreal a, qreal b) { return a == b; });
+      if (tick != -1) {
+            for (int staffIdx = 0; staffIdx < n; ++staffIdx)
+                  invalidateStaff(staffIdx, tick);
+            _tempo = tempo;
+            }
+
+      for (int staffIdx = 0; staffIdx < n; ++staffIdx) {
+            Staff* staff = score->staff(staffIdx);
+            StaffState& state = _state[staffIdx];
+
+            QVector<int> channels;
+            for (const auto& i : *staff->part()->instruments()) {
+                  for (const Channel* c : i.second->channel())
+                        channels.append(c->channel);
+                  }
+            if (channels != state.channels) {
+                  invalidateStaff(staffIdx, 0);
+                  state.channels = channels;
+                  }
+
+            tick = firstChange(state.velocities, staff->velocities(), [](const VeloEvent& a, const VeloEvent& b) {
+                  return a.type == b.type && a.val == b.val;
+                  });
+            if (tick != -1) {
+                  invalidateStaff(staffIdx, tick);
+                  state.velocities = staff->velocities();
+                  }
+            tick = firstChange(state.swing, *staff->swingList(), [](const SwingParameters& a, const SwingParameters& b) {
+                  return a.swingUnit == b.swingUnit && a.swingRatio == b.swingRatio;
+                  });
+            if (tick != -1) {
+                  invalidateStaff(staffIdx, tick);
+                  state.swing = *staff->swingList();
+                  }
+            for (int voice = 0; voice < VOICES; ++voice) {
+                  tick = firstChange(state.channelList[voice], *staff->channelList(voice), [](int a, int b) {
+                        return a == b;
+                        });
+                  if (tick != -1) {
+                        invalidateStaff(staffIdx, tick);
+                        state.channelList[voice] = *staff->channelList(voice);
+                        }
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   find
+//    the cached events of a staff of measure m, 0 if they
+//    have to be rendered
+//---------------------------------------------------------
+
+const MeasureEvents* EventCache::find(const Measure* m, int staffIdx) const
+      {
+      if (staffIdx >= _staves.size())
+            return 0;
+      auto i = _staves[staffIdx].find(m);
+      if (i == _staves[staffIdx].end() || i->tick != m->tick() || i->endTick != m->endTick())
+            return 0;
+      return &i.value();
+      }
+
+//---------------------------------------------------------
+//   use
+//    like find(), for rendering; counts the hits
+//---------------------------------------------------------
+
+const MeasureEvents* EventCache::use(const Measure* m, int staffIdx)
+      {
+      const MeasureEvents* me = find(m, staffIdx);
+      if (me)
+            ++_hitCount;
+      return me;
+      }
+
+//---------------------------------------------------------
+//   insert
+//---------------------------------------------------------
+
+const MeasureEvents* EventCache::insert(const Measure* m, int staffIdx, MeasureEvents& events)
+      {
+      ++_renderCount;
+      auto i = _staves[staffIdx].insert(m, MeasureEvents());
+      std::swap(*i, events);
+      return &i.value();
+      }
+
+//---------------------------------------------------------
+//   remove
+//---------------------------------------------------------
+
+void EventCache::remove(const Measure* m, int staffIdx)
+      {
+      if (staffIdx < _staves.size())
+            _staves[staffIdx].remove(m);
+      }
+
+//---------------------------------------------------------
+//   size
+//    number of cached measure and staff entries
+//---------------------------------------------------------
+
+int EventCache::size() const
+      {
+      int n = 0;
+      for (const auto& staff : _staves)
+            n += staff.size();
+      return n;
+      }
+
+}     // namespace Ms
+
@@ -0,0 +1,82 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __EVENTCACHE_H__
+#define __EVENTCACHE_H__
+
+#include "staff.h"
+#include "synthesizer/event.h"
+
+namespace Ms {
+
+class Measure;
+class Score;
+
+//---------------------------------------------------------
+//   MeasureEvents
+//    the events of one staff of one measure, rendered
+//    for the first pass through the measure; repeats
+//    add the offset of their pass
+//---------------------------------------------------------
+
+struct MeasureEvents {
+      int tick;                           // measure position when rendered
+      int endTick;
+      int highestChannel { -1 };
+      std::vector<std::pair<int, NPlayEvent>> events;       // in map order
+      };
+
+//---------------------------------------------------------
+//   EventCache
+//    rendered playback events per measure and staff.
+//    The undo stack tells the cache which tick ranges
+//    were changed since its last update; changes of
+//    velocities, swing, channels and tempo are found by
+//    comparing with the values the events were rendered
+//    with.
+//---------------------------------------------------------
+
+class EventCache {
+      struct StaffState {
+            VeloList velocities;
+            QMap<int,SwingParameters> swing;
+            QMap<int,int> channelList[VOICES];
+            QVector<int> channels;        // midi channels of the instruments of the part
+            };
+      QVector<QHash<const Measure*, MeasureEvents>> _staves;
+      QVector<StaffState> _state;
+      QMap<int,qreal> _tempo;
+      int _stamp       { -1 };          // UndoStack::changeStamp() of the last update
+      int _renderCount { 0 };
+      int _hitCount    { 0 };
+
+      void invalidate(int stick, int etick);
+      void invalidate(Score*, int stick, int etick);
+      void invalidateStaff(int staffIdx, int tick);
+
+   public:
+      void clear();
+      void update(Score*);
+
+      const MeasureEvents* find(const Measure*, int staffIdx) const;
+      const MeasureEvents* use(const Measure*, int staffIdx);
+      const MeasureEvents* insert(const Measure*, int staffIdx, MeasureEvents&);
+      void remove(const Measure*, int staffIdx);
+
+      int size() const;
+      int renderCount() const       { return _renderCount; }      ///< measures rendered so far
+      int hitCount() const          { return _hitCount; }         ///< measures taken from the cache so far
+      };
+
+}     // namespace Ms
+#endif
+
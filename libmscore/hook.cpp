@@ -15,9 +15,24 @@
 #include "chord.h"
 #include "stem.h"
 #include "score.h"
+#include "elementpool.h"
 
 namespace Ms {
 
+//---------------------------------------------------------
+//   operator new
+//---------------------------------------------------------
+
+void* Hook::operator new(size_t size)
+      {
+      return elementPool<Hook>()->alloc(size);
+      }
+
+void Hook::operator delete(void* p, size_t size)
+      {
+      elementPool<Hook>()->free(p, size);
+      }
+
 //---------------------------------------------------------
 //   Hook
 //---------------------------------------------------------
@@ -30,6 +30,8 @@ class Hook : public Symbol {
 
    public:
       Hook(Score* = 0);
+      static void* operator new(size_t);
+      static void operator delete(void*, size_t);
       virtual Hook* clone() const override        { return new Hook(*this); }
       virtual qreal mag() const override          { return parent()->mag(); }
       virtual Element::Type type() const override { return Element::Type::HOOK; }
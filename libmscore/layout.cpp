@@ -195,7 +195,7 @@ void Score::layoutChords1(Segment* segment, int staffIdx)
             }
 
 #ifndef DISABLE_UTPIANO
-      layoutChords2a(segment->measure());
+      layoutChords2a(segment, staffIdx);
 #endif
       qreal sp                      = staff->spatium();
       qreal upOffset                = 0.0;      // offset to apply to upstem chords
@@ -528,6 +528,66 @@ void Score::layoutChords1(Segment* segment, int staffIdx)
 
       }
 
+#ifndef DISABLE_UTPIANO
+//---------------------------------------------------------
+//   layoutChords2a
+//    - mirror noteheads of staffIdx in segment which
+//      conflict with a note of a lower track, including
+//      the tracks of staves above
+//    - a note conflicts with a visible note a semitone
+//      or less away; auto mirrored notes get mirrored,
+//      left mirrored notes get unmirrored if the other
+//      note is left mirrored too
+//---------------------------------------------------------
+
+struct PitchEntry {
+      int pitch;
+      int track;
+      bool left;
+      bool operator<(const PitchEntry& e) const { return pitch < e.pitch; }
+      };
+
+void Score::layoutChords2a(Segment* segment, int staffIdx)
+      {
+      int startTrack = staffIdx * VOICES;
+      int endTrack   = startTrack + VOICES;
+
+      // visible notes of all tracks which may conflict, sorted by pitch
+      std::vector<PitchEntry> pitches;
+      for (int track = 0; track < endTrack - 1; ++track) {
+            Element* e = segment->element(track);
+            if (!e || !e->isChord())
+                  continue;
+            for (Note* note : static_cast<Chord*>(e)->notes()) {
+                  if (note->visible())
+                        pitches.push_back({ note->pitch(), track, note->userMirror() == MScore::DirectionH::LEFT });
+                  }
+            }
+      if (pitches.empty())
+            return;
+      std::sort(pitches.begin(), pitches.end());
+
+      for (int track = qMax(startTrack, 1); track < endTrack; ++track) {
+            Element* e = segment->element(track);
+            if (!e || !e->isChord())
+                  continue;
+            for (Note* note : static_cast<Chord*>(e)->notes()) {
+                  if (!note->visible() || note->userMirror() == MScore::DirectionH::RIGHT)
+                        continue;
+                  bool left  = note->userMirror() == MScore::DirectionH::LEFT;
+                  int pitch  = note->pitch();
+                  auto i     = std::lower_bound(pitches.begin(), pitches.end(), PitchEntry { pitch - 1, 0, false });
+                  for (; i != pitches.end() && i->pitch <= pitch + 1; ++i) {
+                        if (i->track >= track || (left && !i->left))
+                              continue;
+                        note->setMirror(!left);
+                        break;
+                        }
+                  }
+            }
+      }
+#endif
+
 //---------------------------------------------------------
 //   layoutChords2
 //    - determine which notes need mirroring
@@ -536,67 +596,6 @@ void Score::layoutChords1(Segment* segment, int staffIdx)
 //      with all notes combined and sorted to resemble one chord
 //    - return maximum non-mirrored notehead width
 //---------------------------------------------------------
-#ifndef DISABLE_UTPIANO
-void Score::layoutChords2a(Measure* measure)
-{
-     for (Segment* seg1 = measure->first(); seg1; seg1 = seg1->next())
-     {
-         if (seg1->isChordRest())
-         {
-             Element* e1;
-             Element* e2;
-             Chord* chord1;
-             Chord* chord2;
-             int sz1, sz2;
-             int sz = seg1->elist().size();
-             for (int i = 0;i < sz - 1; i++)
-             {
-                 for(int j = i+1; j < sz; j++)
-                 {
-                    e1 = seg1->element(i);
-                    e2 = seg1->element(j);
-                    if (e1 && e2 && e1->isChord() && e2->isChord())
-                    {
-                        chord1 = static_cast<Chord*>(e1);
-                        chord2 = static_cast<Chord*>(e2);
-                        sz1 = chord1->notes().size();
-                        sz2 = chord2->notes().size();
-                        QList<Note*>& notes1 = chord1->notes();
-                        QList<Note*>& notes2 = chord2->notes();
-                        for(int l=0; l<sz1;l++)
-                        {
-                            Note* note1   = notes1[l];
-                            bool lvisible = note1->visible();
-                            int pitch1    = note1->pitch();
-                            for(int k=0; k<sz2;k++)
-                            {
-                                Note* note2   = notes2[k];
-                                int pitch2    = note2->pitch();
-
-                                bool conflict = (qAbs(pitch1 - pitch2) < 2) && note2->visible() && lvisible;
-                                if (conflict)
-                                {
-                                    if (note2->userMirror() == MScore::DirectionH::AUTO)
-                                    {
-                                         note2->setMirror(true);
-                                    }
-                                    else if (note2->userMirror() == MScore::DirectionH::LEFT)
-                                    {
-                                        if (note1->userMirror() == note2->userMirror())
-                                        {
-                                           note2->setMirror(false);
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                 }
-             }
-         }
-     }
-}
-#endif
 
 qreal Score::layoutChords2(QList<Note*>& notes, bool up)
       {
@@ -1257,9 +1256,12 @@ void Score::beamGraceNotes(Chord* mainNote, bool after)
 //    auto - beamer
 //---------------------------------------------------------
 
-void Score::layoutStage2()
+void Score::layoutStage2(Measure* sm, Measure* em)
       {
+      if (!sm)
+            return;
       int tracks = nstaves() * VOICES;
+      int etick  = em->endTick();
       bool crossMeasure = styleB(StyleIdx::crossMeasureValues);
 
       for (int track = 0; track < tracks; ++track) {
@@ -1280,7 +1282,10 @@ void Score::layoutStage2()
             Fraction stretch = 1;
             QHash<int, TDuration> beatSubdivision;
 
-            for (Segment* segment = firstSegment(st); segment; segment = segment->next1(st)) {
+            Segment* fs = sm->first();
+            if (fs && fs->segmentType() != st)
+                  fs = fs->next1(st);
+            for (Segment* segment = fs; segment && segment->tick() < etick; segment = segment->next1(st)) {
                   ChordRest* cr = static_cast<ChordRest*>(segment->element(track));
                   if (cr == 0)
                         continue;
@@ -1437,62 +1442,33 @@ void Score::layoutStage2()
 //   layoutStage3
 //---------------------------------------------------------
 
-void Score::layoutStage3()
+void Score::layoutStage3(Measure* sm, Measure* em)
       {
+      if (!sm)
+            return;
       Segment::Type st = Segment::Type::ChordRest;
+      int etick        = em->endTick();
+      Segment* fs      = sm->first();
+      if (fs && fs->segmentType() != st)
+            fs = fs->next1(st);
       for (int staffIdx = 0; staffIdx < nstaves(); ++staffIdx) {
             if (!staff(staffIdx)->show())
                   continue;
-            for (Segment* segment = firstSegment(st); segment; segment = segment->next1(st))
+            for (Segment* segment = fs; segment && segment->tick() < etick; segment = segment->next1(st))
                   layoutChords1(segment, staffIdx);
             }
       }
 
 //---------------------------------------------------------
-//   layout
-//    - measures are akkumulated into systems
-//    - systems are akkumulated into pages
-//   already existent systems and pages are reused
+//   layoutStage1
+//    set layout breaks and measure numbers for all
+//    measures; do the first layout stage for the
+//    measures in the tick range stick - etick only
 //---------------------------------------------------------
 
-void Score::doLayout()
+void Score::layoutStage1(int stick, int etick)
       {
-// printf("doLayout %p cmd %d undo empty %d\n", this, undo()->active(), undo()->isEmpty());
-
-      if (!undo()->active() && !undo()->isEmpty() && !undoRedo()) {
-            qDebug("layout outside cmd and dirty undo");
-            // _layoutAll = false;
-            // abort();
-            // return;
-            }
-      if (_staves.isEmpty() || first() == 0) {
-            // score is empty
-            // qDeleteAll(_pages);
-            _pages.clear();
-
-            Page* page = addPage();
-            page->layout();
-            page->setNo(0);
-            page->setPos(0.0, 0.0);
-            page->rebuildBspTree();
-            qDebug("layout: empty score");
-            _layoutAll = false;
-            return;
-            }
-
-      _scoreFont = ScoreFont::fontFactory(_style.value(StyleIdx::MusicalSymbolFont).toString());
-      _noteHeadWidth = _scoreFont->width(SymId::noteheadBlack, spatium() / SPATIUM20);
-
-      if (layoutFlags & LayoutFlag::FIX_TICKS)
-            fixTicks();
-      if (layoutFlags & LayoutFlag::FIX_PITCH_VELO)
-            updateVelo();
-      if (layoutFlags & LayoutFlag::PLAY_EVENTS)
-            createPlayEvents();
-      layoutFlags = 0;
-
       int measureNo = 0;
-      int nstaves = _staves.size();
       for (MeasureBase* m = first(); m; m = m->next()) {      // set layout break
             m->setPageBreak(false);
             m->setLineBreak(false);
@@ -1520,30 +1496,26 @@ void Score::doLayout()
                   measure->setNo(measureNo);
                   if (!measure->irregular())      // dont count measure
                         ++measureNo;
-                  measure->layoutStage1();
+                  if (measure->endTick() > stick && measure->tick() < etick)
+                        measure->layoutStage1();
                   }
             if (m->sectionBreak() && m->sectionBreak()->startWithMeasureOne())
                   measureNo = 0;
             }
+      }
 
-      if (styleB(StyleIdx::createMultiMeasureRests))
-            createMMRests();
-
-      layoutStage2();   // beam notes, finally decide if chord is up/down
-      layoutStage3();   // compute note head horizontal positions
-
-      if (layoutMode() == LayoutMode::LINE)
-            layoutLinear();
-      else
-            layoutSystems();  // create list of systems
-
-      //---------------------------------------------------
-      //   place Spanner & beams
-      //---------------------------------------------------
+//---------------------------------------------------------
+//   layoutElements
+//    place beams, articulations, ties and note
+//    spanners of all segments from fs up to the
+//    measure starting at etick
+//---------------------------------------------------------
 
-      int tracks = nstaves * VOICES;
+void Score::layoutElements(Segment* fs, int etick)
+      {
+      int tracks = nstaves() * VOICES;
       for (int track = 0; track < tracks; ++track) {
-            for (Segment* segment = firstSegmentMM(); segment; segment = segment->next1MM()) {
+            for (Segment* segment = fs; segment && segment->measure()->tick() < etick; segment = segment->next1MM()) {
                   if (track == tracks-1) {
                         for (Element* e : segment->annotations())
                               e->layout();
@@ -1592,6 +1564,69 @@ void Score::doLayout()
                         e->layout();
                   }
             }
+      }
+
+//---------------------------------------------------------
+//   layout
+//    - measures are akkumulated into systems
+//    - systems are akkumulated into pages
+//   already existent systems and pages are reused
+//---------------------------------------------------------
+
+void Score::doLayout()
+      {
+// printf("doLayout %p cmd %d undo empty %d\n", this, undo()->active(), undo()->isEmpty());
+
+      if (!undo()->active() && !undo()->isEmpty() && !undoRedo()) {
+            qDebug("layout outside cmd and dirty undo");
+            // _layoutAll = false;
+            // abort();
+            // return;
+            }
+      if (_staves.isEmpty() || first() == 0) {
+            // score is empty
+            // qDeleteAll(_pages);
+            _pages.clear();
+
+            Page* page = addPage();
+            page->layout();
+            page->setNo(0);
+            page->setPos(0.0, 0.0);
+            page->rebuildBspTree();
+            qDebug("layout: empty score");
+            _layoutAll = false;
+            return;
+            }
+
+      _scoreFont = ScoreFont::fontFactory(_style.value(StyleIdx::MusicalSymbolFont).toString());
+      _noteHeadWidth = _scoreFont->width(SymId::noteheadBlack, spatium() / SPATIUM20);
+
+      if (layoutFlags & LayoutFlag::FIX_TICKS)
+            fixTicks();
+      if (layoutFlags & LayoutFlag::FIX_PITCH_VELO)
+            updateVelo();
+      if (layoutFlags & LayoutFlag::PLAY_EVENTS)
+            createPlayEvents();
+      layoutFlags = 0;
+
+      layoutStage1(0, last()->endTick());
+
+      if (styleB(StyleIdx::createMultiMeasureRests))
+            createMMRests();
+
+      layoutStage2(firstMeasure(), lastMeasure());    // beam notes, finally decide if chord is up/down
+      layoutStage3(firstMeasure(), lastMeasure());    // compute note head horizontal positions
+
+      if (layoutMode() == LayoutMode::LINE)
+            layoutLinear();
+      else
+            layoutSystems();  // create list of systems
+
+      //---------------------------------------------------
+      //   place Spanner & beams
+      //---------------------------------------------------
+
+      layoutElements(firstSegmentMM(), last()->endTick());
 
       if (lastSegment())
             checkSpanner(0, lastSegment()->tick());
@@ -1649,6 +1684,161 @@ void Score::doLayout()
             }
       }
 
+//---------------------------------------------------------
+//   beamCrossesMeasure
+//    return true if a beam starts before measure m
+//    (before == true) or ends after m (before == false)
+//---------------------------------------------------------
+
+static bool beamCrossesMeasure(Measure* m, bool before)
+      {
+      Segment::Type st = Segment::Type::ChordRest;
+      Segment* s = before ? m->first(st) : m->last();
+      if (s && s->segmentType() != st)
+            s = s->prev(st);
+      if (!s)
+            return false;
+      for (Element* e : s->elist()) {
+            if (!e || !e->isChordRest())
+                  continue;
+            Beam* b = static_cast<ChordRest*>(e)->beam();
+            if (!b || b->elements().isEmpty())
+                  continue;
+            ChordRest* cr = before ? b->elements().front() : b->elements().back();
+            if (cr->measure() != m)
+                  return true;
+            }
+      return false;
+      }
+
+//---------------------------------------------------------
+//   doLayoutRange
+//    relayout after an edit which only touched the
+//    tick range stick - etick: only the measures in this
+//    range and the systems containing them are laid out
+//    again; following systems are reflowed until the
+//    line breaks are the same as before.
+//    Falls back to doLayout() if this is not possible.
+//---------------------------------------------------------
+
+void Score::doLayoutRange(int stick, int etick)
+      {
+      if (_staves.isEmpty() || first() == 0 || !firstMeasure() || _systems.isEmpty() || _pages.isEmpty()
+         || layoutMode() == LayoutMode::LINE
+         || styleB(StyleIdx::createMultiMeasureRests)
+         || (layoutFlags & LayoutFlag::FIX_TICKS)) {
+            doLayout();
+            return;
+            }
+      Measure* sm = tick2measure(stick);
+      Measure* em = tick2measure(etick);
+      if (!sm || !em || !sm->system() || !em->system()) {
+            doLayout();
+            return;
+            }
+
+      if (layoutFlags & LayoutFlag::FIX_PITCH_VELO)
+            updateVelo();
+      if (layoutFlags & LayoutFlag::PLAY_EVENTS)
+            createPlayEvents();
+      layoutFlags = 0;
+
+      // accidentals and ties depend on the neighbour measures;
+      // beams must not be broken at the range boundaries
+      if (sm->prevMeasure())
+            sm = sm->prevMeasure();
+      if (em->nextMeasure())
+            em = em->nextMeasure();
+      while (sm->prevMeasure() && beamCrossesMeasure(sm, true))
+            sm = sm->prevMeasure();
+      while (em->nextMeasure() && beamCrossesMeasure(em, false))
+            em = em->nextMeasure();
+
+      layoutStage1(sm->tick(), em->endTick());
+      layoutStage2(sm, em);
+      layoutStage3(sm, em);
+
+      int firstSystem, lastSystem;
+      if (!layoutSystemsRange(sm, em, &firstSystem, &lastSystem)) {
+            doLayout();
+            return;
+            }
+
+      //---------------------------------------------------
+      //   place Spanner & beams of all relayouted systems
+      //---------------------------------------------------
+
+      MeasureBase* fmb = _systems[firstSystem]->measures().front();
+      MeasureBase* lmb = _systems[lastSystem]->measures().back();
+      int rstick = fmb->tick();
+      int retick = lmb->endTick();
+      Measure* fm = fmb->isMeasure() ? static_cast<Measure*>(fmb) : fmb->nextMeasure();
+      if (fm && fm->tick() < retick)
+            layoutElements(fm->first(), retick);
+
+      checkSpanner(rstick, retick);
+
+      QList<Spanner*> sl;
+      for (const auto& i : _spanner.findOverlapping(rstick, retick))
+            sl.append(i.value);
+      for (Spanner* sp : sl) {
+            if (sp->type() != Element::Type::TIE && sp->tick() != -1)
+                  sp->layout();
+            }
+
+      for (int i = firstSystem; i <= lastSystem; ++i) {
+            if (!_systems[i]->isVbox())
+                  _systems[i]->layout2();
+            }
+
+      // remember the system positions to find the pages
+      // whose bsp tree must be rebuilt
+      QList<QList<QPair<System*, QPointF>>> oldPages;
+      for (Page* page : _pages) {
+            QList<QPair<System*, QPointF>> pl;
+            for (System* system : *page->systems())
+                  pl.append(qMakePair(system, system->pos()));
+            oldPages.append(pl);
+            }
+      layoutPages();
+
+      for (Measure* m = fm; m && m->tick() < retick; m = m->nextMeasure())
+            m->layout2();
+
+      for (Spanner* s : _unmanagedSpanner)
+            s->layout();
+
+      for (Spanner* sp : sl) {
+            if (sp->type() == Element::Type::SLUR)
+                  sp->layout();
+            }
+
+      for (int pageIdx = 0; pageIdx < _pages.size(); ++pageIdx) {
+            Page* page = _pages[pageIdx];
+            bool dirty = pageIdx >= oldPages.size() || oldPages[pageIdx].size() != page->systems()->size();
+            for (int i = 0; !dirty && i < page->systems()->size(); ++i) {
+                  System* system = page->systems()->at(i);
+                  int idx = _systems.indexOf(system);
+                  dirty = oldPages[pageIdx][i].first != system
+                     || oldPages[pageIdx][i].second != system->pos()
+                     || (idx >= firstSystem && idx <= lastSystem);
+                  }
+            if (dirty)
+                  page->rebuildBspTree();
+            }
+
+      for (MuseScoreView* v : viewer)
+            v->layoutChanged();
+
+      _layoutAll = false;
+
+      if (_layoutMode == LayoutMode::SYSTEM) {
+            Page* page = _pages.front();
+            System* system = _systems.back();
+            page->setHeight(system->abbox().bottom());
+            }
+      }
+
 //---------------------------------------------------------
 //   layoutSpanner
 //    called after dragging a staff
@@ -3282,6 +3472,115 @@ void Score::layoutSystems()
             _systems.takeLast();
       }
 
+//---------------------------------------------------------
+//   layoutSystemsRange
+//    relayout the system rows containing the measures
+//    sm - em; continue with the following rows until a
+//    row ends with the same measure as before.
+//    Return the index of the first and last relayouted
+//    system or false if a complete layout is needed.
+//---------------------------------------------------------
+
+bool Score::layoutSystemsRange(Measure* sm, Measure* em, int* firstSystem, int* lastSystem)
+      {
+      int idx = _systems.indexOf(sm->system());
+      if (idx < 0)
+            return false;
+      // courtesy elements at the end of the previous system
+      // depend on the first measure of the next system
+      if (idx > 0)
+            --idx;
+      // restart at the beginning of a row
+      while (idx > 0 && (_systems[idx]->sameLine() || _systems[idx]->isVbox()))
+            --idx;
+
+      bool isFirstSystem      = true;
+      bool startWithLongNames = true;
+      if (idx == 0)
+            curMeasure = _showVBox ? firstMM() : firstMeasureMM();
+      else {
+            if (_systems[idx]->measures().isEmpty())
+                  return false;
+            curMeasure = _systems[idx]->measures().front();
+            for (int i = idx - 1; i >= 0; --i) {
+                  if (_systems[i]->isVbox())
+                        continue;
+                  Measure* lm = _systems[i]->lastMeasure();
+                  isFirstSystem = lm && lm->sectionBreak() && _layoutMode != LayoutMode::FLOAT;
+                  startWithLongNames = isFirstSystem && lm->sectionBreak()->startWithLongNames();
+                  break;
+                  }
+            }
+
+      // remember the old line breaks; system objects are reused
+      QList<MeasureBase*> oldLast;
+      QList<bool> oldSameLine;
+      for (int i = idx; i < _systems.size(); ++i) {
+            System* system = _systems[i];
+            oldLast.append(system->measures().isEmpty() ? 0 : system->measures().back());
+            oldSameLine.append(system->sameLine());
+            }
+      int oldSystems = _systems.size();
+      int etick      = em->endTick();
+
+      curSystem  = idx;
+      bool stable = false;
+      qreal w    = pageFormat()->printableWidth() * DPI;
+
+      while (curMeasure) {
+            Element::Type t = curMeasure->type();
+            if (t == Element::Type::VBOX || t == Element::Type::TBOX || t == Element::Type::FBOX) {
+                  System* system = getNextSystem(false, true);
+                  system->setSameLine(false);
+                  system->setWidth(w);
+                  VBox* vbox = static_cast<VBox*>(curMeasure);
+                  vbox->setParent(system);
+                  vbox->layout();
+                  system->setHeight(vbox->height());
+                  system->rxpos() = 0.0;
+                  system->setPageBreak(vbox->pageBreak());
+                  system->measures().push_back(vbox);
+                  curMeasure = curMeasure->nextMM();
+                  ++curSystem;
+                  }
+            else {
+                  QList<System*> sl  = layoutSystemRow(w, isFirstSystem, startWithLongNames);
+                  for (int i = 0; i < sl.size(); ++i)
+                        sl[i]->setSameLine(i != 0);
+                  isFirstSystem = false;
+                  startWithLongNames = false;
+                  if (!sl.isEmpty()) {
+                        Measure* lm = sl.back()->lastMeasure();
+                        isFirstSystem = lm && lm->sectionBreak() && _layoutMode != LayoutMode::FLOAT;
+                        startWithLongNames = isFirstSystem && lm->sectionBreak()->startWithLongNames();
+                        }
+                  else
+                        qDebug("empty system!");
+                  }
+            // line breaks are stable if the last system ends with the
+            // same measure as before and the next row was not touched
+            int k = curSystem - 1;
+            if (curMeasure && curMeasure->tick() >= etick && curSystem < oldSystems
+               && k >= idx && !_systems[k]->measures().isEmpty()
+               && _systems[k]->measures().back() == oldLast[k - idx]
+               && !oldSameLine[curSystem - idx]) {
+                  stable = true;
+                  break;
+                  }
+            }
+      *firstSystem = idx;
+      *lastSystem  = curSystem - 1;
+      if (stable)
+            curSystem = oldSystems;
+      else {
+            // systems are layout data, not part of the score; undo
+            // and redo lay out the whole score again (endUndoRedo())
+            while (_systems.size() > curSystem)
+                  _systems.takeLast();
+            }
+      return *lastSystem >= *firstSystem;
+      }
+
 //---------------------------------------------------------
 //   layoutSystems2
 //    update distanceUp, distanceDown
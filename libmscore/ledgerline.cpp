@@ -17,10 +17,25 @@
 #include "system.h"
 #include "score.h"
 #include "utils.h"
+#include "elementpool.h"
 
 
 namespace Ms {
 
+//---------------------------------------------------------
+//   operator new
+//---------------------------------------------------------
+
+void* LedgerLine::operator new(size_t size)
+      {
+      return elementPool<LedgerLine>()->alloc(size);
+      }
+
+void LedgerLine::operator delete(void* p, size_t size)
+      {
+      elementPool<LedgerLine>()->free(p, size);
+      }
+
 //---------------------------------------------------------
 //   LedgerLine
 //---------------------------------------------------------
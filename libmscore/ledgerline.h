@@ -37,6 +37,8 @@ class LedgerLine : public Line {
    public:
       LedgerLine(Score*);
       LedgerLine &operator=(const LedgerLine&) = delete;
+      static void* operator new(size_t);
+      static void operator delete(void*, size_t);
       virtual LedgerLine* clone() const override { return new LedgerLine(*this); }
       virtual Element::Type type() const override { return Element::Type::LEDGER_LINE; }
       virtual QPointF pagePos() const override;      ///< position in page coordinates
@@ -1831,540 +1831,578 @@ void Measure::read(XmlReader& e, int staffIdx)
       while (e.readNextStartElement()) {
             const QStringRef& tag(e.name());
 
-            if (tag == "tick") {
-                  e.initTick(score()->fileDivision(e.readInt()));
-                  lastTick = e.tick();
-                  }
-            else if (tag == "BarLine") {
-                  BarLine* barLine = new BarLine(score());
-                  barLine->setTrack(e.track());
-                  barLine->read(e);
-                  Segment::Type st;
+            switch (e.tagId()) {
+                  case XmlTag::TICK: {
+                        e.initTick(score()->fileDivision(e.readInt()));
+                        lastTick = e.tick();
+                        }
+                        break;
+                  case XmlTag::BAR_LINE: {
+                        BarLine* barLine = new BarLine(score());
+                        barLine->setTrack(e.track());
+                        barLine->read(e);
+                        Segment::Type st;
 
-                  //
-                  //  SegStartRepeatBarLine: always at the beginning tick of a measure
-                  //  SegBarLine:            in the middle of a measure, has no semantic
-                  //  SegEndBarLine:         at the end tick of a measure
-
-                  if ((e.tick() != tick()) && (e.tick() != endTick()))
-                        st = Segment::Type::BarLine;
-                  else if (barLine->barLineType() == BarLineType::START_REPEAT && e.tick() == tick())
-                        st = Segment::Type::StartRepeatBarLine;
-                  else
-                        st = Segment::Type::EndBarLine;
-
-                  segment = getSegment(st, e.tick()); // let the bar line know it belongs to a Segment,
-                  segment->add(barLine);              // before setting its flags
-                  if (st == Segment::Type::EndBarLine) {
-                        if (!barLine->customSubtype()) {
-                              BarLineType blt = barLine->barLineType();
-                              // Measure::_endBarLineGenerated is true if the bar line is of a type which can
-                              // be reconstructed from measure flags
-                              bool endBarLineGenerated = (blt == BarLineType::NORMAL || blt == BarLineType::END_REPEAT
-                                    || blt == BarLineType::END_START_REPEAT || blt == BarLineType::START_REPEAT);
-                              setEndBarLineType(blt, endBarLineGenerated, true);
-                              }
-                        if (!barLine->customSpan()) {
-                              Staff* staff = score()->staff(staffIdx);
-                              barLine->setSpan(staff->barLineSpan());
-                              barLine->setSpanFrom(staff->barLineFrom());
-                              barLine->setSpanTo(staff->barLineTo());
+                        //
+                        //  SegStartRepeatBarLine: always at the beginning tick of a measure
+                        //  SegBarLine:            in the middle of a measure, has no semantic
+                        //  SegEndBarLine:         at the end tick of a measure
+
+                        if ((e.tick() != tick()) && (e.tick() != endTick()))
+                              st = Segment::Type::BarLine;
+                        else if (barLine->barLineType() == BarLineType::START_REPEAT && e.tick() == tick())
+                              st = Segment::Type::StartRepeatBarLine;
+                        else
+                              st = Segment::Type::EndBarLine;
+
+                        segment = getSegment(st, e.tick()); // let the bar line know it belongs to a Segment,
+                        segment->add(barLine);              // before setting its flags
+                        if (st == Segment::Type::EndBarLine) {
+                              if (!barLine->customSubtype()) {
+                                    BarLineType blt = barLine->barLineType();
+                                    // Measure::_endBarLineGenerated is true if the bar line is of a type which can
+                                    // be reconstructed from measure flags
+                                    bool endBarLineGenerated = (blt == BarLineType::NORMAL || blt == BarLineType::END_REPEAT
+                                          || blt == BarLineType::END_START_REPEAT || blt == BarLineType::START_REPEAT);
+                                    setEndBarLineType(blt, endBarLineGenerated, true);
+                                    }
+                              if (!barLine->customSpan()) {
+                                    Staff* staff = score()->staff(staffIdx);
+                                    barLine->setSpan(staff->barLineSpan());
+                                    barLine->setSpanFrom(staff->barLineFrom());
+                                    barLine->setSpanTo(staff->barLineTo());
+                                    }
                               }
                         }
-                  }
-            else if (tag == "Chord") {
-                  Chord* chord = new Chord(score());
-                  chord->setTrack(e.track());
-                  chord->read(e);
-                  segment = getSegment(Segment::Type::ChordRest, e.tick());
-                  if (chord->noteType() != NoteType::NORMAL) {
-                        graceNotes.push_back(chord);
-                        if (chord->tremolo() && chord->tremolo()->tremoloType() < TremoloType::R8) {
-                              // old style tremolo found
-                              Tremolo* tremolo = chord->tremolo();
-                              TremoloType st;
-                              switch (tremolo->tremoloType()) {
-                                    default:
-                                    case TremoloType::OLD_R8:  st = TremoloType::R8;  break;
-                                    case TremoloType::OLD_R16: st = TremoloType::R16; break;
-                                    case TremoloType::OLD_R32: st = TremoloType::R32; break;
-                                    case TremoloType::OLD_C8:  st = TremoloType::C8;  break;
-                                    case TremoloType::OLD_C16: st = TremoloType::C16; break;
-                                    case TremoloType::OLD_C32: st = TremoloType::C32; break;
+                        break;
+                  case XmlTag::CHORD: {
+                        Chord* chord = new Chord(score());
+                        chord->setTrack(e.track());
+                        chord->read(e);
+                        segment = getSegment(Segment::Type::ChordRest, e.tick());
+                        if (chord->noteType() != NoteType::NORMAL) {
+                              graceNotes.push_back(chord);
+                              if (chord->tremolo() && chord->tremolo()->tremoloType() < TremoloType::R8) {
+                                    // old style tremolo found
+                                    Tremolo* tremolo = chord->tremolo();
+                                    TremoloType st;
+                                    switch (tremolo->tremoloType()) {
+                                          default:
+                                          case TremoloType::OLD_R8:  st = TremoloType::R8;  break;
+                                          case TremoloType::OLD_R16: st = TremoloType::R16; break;
+                                          case TremoloType::OLD_R32: st = TremoloType::R32; break;
+                                          case TremoloType::OLD_C8:  st = TremoloType::C8;  break;
+                                          case TremoloType::OLD_C16: st = TremoloType::C16; break;
+                                          case TremoloType::OLD_C32: st = TremoloType::C32; break;
+                                          }
+                                    tremolo->setTremoloType(st);
                                     }
-                              tremolo->setTremoloType(st);
                               }
-                        }
-                  else {
-                        segment->add(chord);
-                        Q_ASSERT(segment->segmentType() == Segment::Type::ChordRest);
+                        else {
+                              segment->add(chord);
+                              Q_ASSERT(segment->segmentType() == Segment::Type::ChordRest);
 
-                        for (int i = 0; i < graceNotes.size(); ++i) {
-                              Chord* gc = graceNotes[i];
-                              gc->setGraceIndex(i);
-                              chord->add(gc);
-                              }
-                        graceNotes.clear();
-                        int crticks = chord->actualTicks();
-
-                        if (chord->tremolo() && chord->tremolo()->tremoloType() < TremoloType::R8) {
-                              // old style tremolo found
-
-                              Tremolo* tremolo = chord->tremolo();
-                              TremoloType st;
-                              switch (tremolo->tremoloType()) {
-                                    default:
-                                    case TremoloType::OLD_R8:  st = TremoloType::R8;  break;
-                                    case TremoloType::OLD_R16: st = TremoloType::R16; break;
-                                    case TremoloType::OLD_R32: st = TremoloType::R32; break;
-                                    case TremoloType::OLD_C8:  st = TremoloType::C8;  break;
-                                    case TremoloType::OLD_C16: st = TremoloType::C16; break;
-                                    case TremoloType::OLD_C32: st = TremoloType::C32; break;
+                              for (int i = 0; i < graceNotes.size(); ++i) {
+                                    Chord* gc = graceNotes[i];
+                                    gc->setGraceIndex(i);
+                                    chord->add(gc);
                                     }
-                              tremolo->setTremoloType(st);
-                              if (tremolo->twoNotes()) {
-                                    int track = chord->track();
-                                    Segment* ss = 0;
-                                    for (Segment* ps = first(Segment::Type::ChordRest); ps; ps = ps->next(Segment::Type::ChordRest)) {
-                                          if (ps->tick() >= e.tick())
-                                                break;
-                                          if (ps->element(track))
-                                                ss = ps;
-                                          }
-                                    Chord* pch = 0;       // previous chord
-                                    if (ss) {
-                                          ChordRest* cr = static_cast<ChordRest*>(ss->element(track));
-                                          if (cr && cr->type() == Element::Type::CHORD)
-                                                pch = static_cast<Chord*>(cr);
+                              graceNotes.clear();
+                              int crticks = chord->actualTicks();
+
+                              if (chord->tremolo() && chord->tremolo()->tremoloType() < TremoloType::R8) {
+                                    // old style tremolo found
+
+                                    Tremolo* tremolo = chord->tremolo();
+                                    TremoloType st;
+                                    switch (tremolo->tremoloType()) {
+                                          default:
+                                          case TremoloType::OLD_R8:  st = TremoloType::R8;  break;
+                                          case TremoloType::OLD_R16: st = TremoloType::R16; break;
+                                          case TremoloType::OLD_R32: st = TremoloType::R32; break;
+                                          case TremoloType::OLD_C8:  st = TremoloType::C8;  break;
+                                          case TremoloType::OLD_C16: st = TremoloType::C16; break;
+                                          case TremoloType::OLD_C32: st = TremoloType::C32; break;
                                           }
-                                    if (pch) {
-                                          tremolo->setParent(pch);
-                                          pch->setTremolo(tremolo);
-                                          chord->setTremolo(0);
-                                          // force duration to half
-                                          Fraction pts(timeStretch * pch->globalDuration());
-                                          int pcrticks = pts.ticks();
-                                          pch->setDuration(Fraction::fromTicks(pcrticks / 2));
-                                          chord->setDuration(Fraction::fromTicks(crticks / 2));
+                                    tremolo->setTremoloType(st);
+                                    if (tremolo->twoNotes()) {
+                                          int track = chord->track();
+                                          Segment* ss = 0;
+                                          for (Segment* ps = first(Segment::Type::ChordRest); ps; ps = ps->next(Segment::Type::ChordRest)) {
+                                                if (ps->tick() >= e.tick())
+                                                      break;
+                                                if (ps->element(track))
+                                                      ss = ps;
+                                                }
+                                          Chord* pch = 0;       // previous chord
+                                          if (ss) {
+                                                ChordRest* cr = static_cast<ChordRest*>(ss->element(track));
+                                                if (cr && cr->type() == Element::Type::CHORD)
+                                                      pch = static_cast<Chord*>(cr);
+                                                }
+                                          if (pch) {
+                                                tremolo->setParent(pch);
+                                                pch->setTremolo(tremolo);
+                                                chord->setTremolo(0);
+                                                // force duration to half
+                                                Fraction pts(timeStretch * pch->globalDuration());
+                                                int pcrticks = pts.ticks();
+                                                pch->setDuration(Fraction::fromTicks(pcrticks / 2));
+                                                chord->setDuration(Fraction::fromTicks(crticks / 2));
+                                                }
+                                          else {
+                                                qDebug("tremolo: first note not found");
+                                                }
+                                          crticks /= 2;
                                           }
                                     else {
-                                          qDebug("tremolo: first note not found");
+                                          tremolo->setParent(chord);
                                           }
-                                    crticks /= 2;
-                                    }
-                              else {
-                                    tremolo->setParent(chord);
                                     }
+                              lastTick = e.tick();
+                              e.incTick(crticks);
                               }
-                        lastTick = e.tick();
-                        e.incTick(crticks);
                         }
-                  }
-            else if (tag == "Rest") {
-                  Rest* rest = new Rest(score());
-                  rest->setDurationType(TDuration::DurationType::V_MEASURE);
-                  rest->setDuration(timesig()/timeStretch);
-                  rest->setTrack(e.track());
-                  rest->read(e);
-                  segment = getSegment(rest, e.tick());
-                  segment->add(rest);
-
-                  if (!rest->duration().isValid())     // hack
+                        break;
+                  case XmlTag::REST: {
+                        Rest* rest = new Rest(score());
+                        rest->setDurationType(TDuration::DurationType::V_MEASURE);
                         rest->setDuration(timesig()/timeStretch);
+                        rest->setTrack(e.track());
+                        rest->read(e);
+                        segment = getSegment(rest, e.tick());
+                        segment->add(rest);
 
-                  lastTick = e.tick();
-                  e.incTick(rest->actualTicks());
-                  }
-            else if (tag == "Breath") {
-                  Breath* breath = new Breath(score());
-                  breath->setTrack(e.track());
-                  int tick = e.tick();
-                  breath->read(e);
-                  if (score()->mscVersion() < 205) {
-                        // older scores placed the breath segment right after the chord to which it applies
-                        // rather than before the next chordrest segment with an element for the staff
-                        // result would be layout too far left if there are other segments due to notes in other staves
-                        // we need to find tick of chord to which this applies, and add its duration
-                        int prevTick;
-                        if (e.tick() < tick)
-                              prevTick = e.tick();    // use our own tick if we explicitly reset to earlier position
-                        else
-                              prevTick = lastTick;    // otherwise use tick of previous tick/chord/rest tag
-                        // find segment
-                        Segment* prev = findSegment(Segment::Type::ChordRest, prevTick);
-                        if (prev) {
-                              // find chordrest
-                              ChordRest* lastCR = static_cast<ChordRest*>(prev->element(e.track()));
-                              if (lastCR)
-                                    tick = prevTick + lastCR->actualTicks();
-                              }
-                        }
-                  segment = getSegment(Segment::Type::Breath, tick);
-                  segment->add(breath);
-                  }
-            else if (tag == "endSpanner") {
-                  int id = e.attribute("id").toInt();
-                  Spanner* spanner = e.findSpanner(id);
-                  if (spanner) {
-                        spanner->setTicks(e.tick() - spanner->tick());
-                        // if (spanner->track2() == -1)
-                              // the absence of a track tag [?] means the
-                              // track is the same as the beginning of the slur
-                        if (spanner->track2() == -1)
-                              spanner->setTrack2(spanner->track() ? spanner->track() : e.track());
+                        if (!rest->duration().isValid())     // hack
+                              rest->setDuration(timesig()/timeStretch);
+
+                        lastTick = e.tick();
+                        e.incTick(rest->actualTicks());
                         }
-                  else {
-                        // remember "endSpanner" values
-                        SpannerValues sv;
-                        sv.spannerId = id;
-                        sv.track2    = e.track();
-                        sv.tick2     = e.tick();
-                        e.addSpannerValues(sv);
+                        break;
+                  case XmlTag::BREATH: {
+                        Breath* breath = new Breath(score());
+                        breath->setTrack(e.track());
+                        int tick = e.tick();
+                        breath->read(e);
+                        if (score()->mscVersion() < 205) {
+                              // older scores placed the breath segment right after the chord to which it applies
+                              // rather than before the next chordrest segment with an element for the staff
+                              // result would be layout too far left if there are other segments due to notes in other staves
+                              // we need to find tick of chord to which this applies, and add its duration
+                              int prevTick;
+                              if (e.tick() < tick)
+                                    prevTick = e.tick();    // use our own tick if we explicitly reset to earlier position
+                              else
+                                    prevTick = lastTick;    // otherwise use tick of previous tick/chord/rest tag
+                              // find segment
+                              Segment* prev = findSegment(Segment::Type::ChordRest, prevTick);
+                              if (prev) {
+                                    // find chordrest
+                                    ChordRest* lastCR = static_cast<ChordRest*>(prev->element(e.track()));
+                                    if (lastCR)
+                                          tick = prevTick + lastCR->actualTicks();
+                                    }
+                              }
+                        segment = getSegment(Segment::Type::Breath, tick);
+                        segment->add(breath);
                         }
-                  e.readNext();
-                  }
-            else if (tag == "Slur") {
-                  Slur *sl = new Slur(score());
-                  sl->setTick(e.tick());
-                  sl->read(e);
-                  //
-                  // check if we already saw "endSpanner"
-                  //
-                  int id = e.spannerId(sl);
-                  const SpannerValues* sv = e.spannerValues(id);
-                  if (sv) {
-                        sl->setTick2(sv->tick2);
-                        sl->setTrack2(sv->track2);
+                        break;
+                  case XmlTag::END_SPANNER: {
+                        int id = e.attribute("id").toInt();
+                        Spanner* spanner = e.findSpanner(id);
+                        if (spanner) {
+                              spanner->setTicks(e.tick() - spanner->tick());
+                              // if (spanner->track2() == -1)
+                                    // the absence of a track tag [?] means the
+                                    // track is the same as the beginning of the slur
+                              if (spanner->track2() == -1)
+                                    spanner->setTrack2(spanner->track() ? spanner->track() : e.track());
+                              }
+                        else {
+                              // remember "endSpanner" values
+                              SpannerValues sv;
+                              sv.spannerId = id;
+                              sv.track2    = e.track();
+                              sv.tick2     = e.tick();
+                              e.addSpannerValues(sv);
+                              }
+                        e.readNext();
                         }
-                  score()->addSpanner(sl);
-                  }
-            else if (tag == "HairPin"
-               || tag == "Pedal"
-               || tag == "Ottava"
-               || tag == "Trill"
-               || tag == "TextLine"
-               || tag == "Volta") {
-                  Spanner* sp = static_cast<Spanner*>(Element::name2Element(tag, score()));
-                  sp->setTrack(e.track());
-                  sp->setTick(e.tick());
-                  // ?? sp->setAnchor(Spanner::Anchor::SEGMENT);
-                  sp->read(e);
-                  score()->addSpanner(sp);
-                  //
-                  // check if we already saw "endSpanner"
-                  //
-                  int id = e.spannerId(sp);
-                  const SpannerValues* sv = e.spannerValues(id);
-                  if (sv) {
-                        sp->setTicks(sv->tick2 - sp->tick());
-                        sp->setTrack2(sv->track2);
+                        break;
+                  case XmlTag::SLUR: {
+                        Slur *sl = new Slur(score());
+                        sl->setTick(e.tick());
+                        sl->read(e);
+                        //
+                        // check if we already saw "endSpanner"
+                        //
+                        int id = e.spannerId(sl);
+                        const SpannerValues* sv = e.spannerValues(id);
+                        if (sv) {
+                              sl->setTick2(sv->tick2);
+                              sl->setTrack2(sv->track2);
+                              }
+                        score()->addSpanner(sl);
                         }
-                  }
-            else if (tag == "RepeatMeasure") {
-                  RepeatMeasure* rm = new RepeatMeasure(score());
-                  rm->setTrack(e.track());
-                  rm->read(e);
-                  segment = getSegment(Segment::Type::ChordRest, e.tick());
-                  segment->add(rm);
-                  if (rm->actualDuration().isZero()) { // might happen with 1.3 scores
-                        rm->setDuration(len());
+                        break;
+                  case XmlTag::HAIR_PIN:
+                  case XmlTag::PEDAL:
+                  case XmlTag::OTTAVA:
+                  case XmlTag::TRILL:
+                  case XmlTag::TEXT_LINE:
+                  case XmlTag::VOLTA: {
+                        Spanner* sp = static_cast<Spanner*>(Element::name2Element(tag, score()));
+                        sp->setTrack(e.track());
+                        sp->setTick(e.tick());
+                        // ?? sp->setAnchor(Spanner::Anchor::SEGMENT);
+                        sp->read(e);
+                        score()->addSpanner(sp);
+                        //
+                        // check if we already saw "endSpanner"
+                        //
+                        int id = e.spannerId(sp);
+                        const SpannerValues* sv = e.spannerValues(id);
+                        if (sv) {
+                              sp->setTicks(sv->tick2 - sp->tick());
+                              sp->setTrack2(sv->track2);
+                              }
                         }
-                  lastTick = e.tick();
-                  e.incTick(ticks());
-                  }
-            else if (tag == "Clef") {
-                  Clef* clef = new Clef(score());
-                  clef->setTrack(e.track());
-                  clef->read(e);
-                  clef->setGenerated(false);
-                  // in some 1.3 scores, clefs can be in score but not in cleflist
-                  // if (score()->mscVersion() > 114)
-                  //      staff->setClef(e.tick(), clef->clefTypeList());
-
-                  // there may be more than one clef segment for same tick position
-                  if (!segment) {
-                        // this is the first segment of measure
-                        segment = getSegment(Segment::Type::Clef, e.tick());
+                        break;
+                  case XmlTag::REPEAT_MEASURE: {
+                        RepeatMeasure* rm = new RepeatMeasure(score());
+                        rm->setTrack(e.track());
+                        rm->read(e);
+                        segment = getSegment(Segment::Type::ChordRest, e.tick());
+                        segment->add(rm);
+                        if (rm->actualDuration().isZero()) { // might happen with 1.3 scores
+                              rm->setDuration(len());
+                              }
+                        lastTick = e.tick();
+                        e.incTick(ticks());
                         }
-                  else {
-                        bool firstSegment = false;
-                        // the first clef may be missing and is added later in layout
-                        for (Segment* s = _segments.first(); s && s->tick() == e.tick(); s = s->next()) {
-                              if (s->segmentType() == Segment::Type::Clef
-                                    // hack: there may be other segment types which should
-                                    // generate a clef at current position
-                                 || s->segmentType() == Segment::Type::StartRepeatBarLine
-                                 ) {
-                                    firstSegment = true;
-                                    break;
-                                    }
+                        break;
+                  case XmlTag::CLEF: {
+                        Clef* clef = new Clef(score());
+                        clef->setTrack(e.track());
+                        clef->read(e);
+                        clef->setGenerated(false);
+                        // in some 1.3 scores, clefs can be in score but not in cleflist
+                        // if (score()->mscVersion() > 114)
+                        //      staff->setClef(e.tick(), clef->clefTypeList());
+
+                        // there may be more than one clef segment for same tick position
+                        if (!segment) {
+                              // this is the first segment of measure
+                              segment = getSegment(Segment::Type::Clef, e.tick());
                               }
-                        if (firstSegment) {
-                              Segment* ns = 0;
-                              if (segment->next()) {
-                                    ns = segment->next();
-                                    while (ns && ns->tick() < e.tick())
-                                          ns = ns->next();
-                                    }
-                              segment = 0;
-                              for (Segment* s = ns; s && s->tick() == e.tick(); s = s->next()) {
-                                    if (s->segmentType() == Segment::Type::Clef) {
-                                          segment = s;
+                        else {
+                              bool firstSegment = false;
+                              // the first clef may be missing and is added later in layout
+                              for (Segment* s = _segments.first(); s && s->tick() == e.tick(); s = s->next()) {
+                                    if (s->segmentType() == Segment::Type::Clef
+                                          // hack: there may be other segment types which should
+                                          // generate a clef at current position
+                                       || s->segmentType() == Segment::Type::StartRepeatBarLine
+                                       ) {
+                                          firstSegment = true;
                                           break;
                                           }
                                     }
-                              if (!segment) {
-                                    segment = new Segment(this, Segment::Type::Clef, e.tick());
-                                    _segments.insert(segment, ns);
+                              if (firstSegment) {
+                                    Segment* ns = 0;
+                                    if (segment->next()) {
+                                          ns = segment->next();
+                                          while (ns && ns->tick() < e.tick())
+                                                ns = ns->next();
+                                          }
+                                    segment = 0;
+                                    for (Segment* s = ns; s && s->tick() == e.tick(); s = s->next()) {
+                                          if (s->segmentType() == Segment::Type::Clef) {
+                                                segment = s;
+                                                break;
+                                                }
+                                          }
+                                    if (!segment) {
+                                          segment = new Segment(this, Segment::Type::Clef, e.tick());
+                                          _segments.insert(segment, ns);
+                                          }
+                                    }
+                              else {
+                                    // this is the first clef: move to left
+                                    segment = getSegment(Segment::Type::Clef, e.tick());
                                     }
                               }
-                        else {
-                              // this is the first clef: move to left
-                              segment = getSegment(Segment::Type::Clef, e.tick());
-                              }
-                        }
-                  if (e.tick() != tick())
-                        clef->setSmall(true);         // layout does this ?
-                  segment->add(clef);
-                  }
-            else if (tag == "TimeSig") {
-                  TimeSig* ts = new TimeSig(score());
-                  ts->setTrack(e.track());
-                  ts->read(e);
-                  // if time sig not at begining of measure => courtesy time sig
-                  int currTick = e.tick();
-                  bool courtesySig = (currTick > tick());
-                  if (courtesySig) {
-                        // if courtesy sig., just add it without map processing
-                        segment = getSegment(Segment::Type::TimeSigAnnounce, currTick);
-                        segment->add(ts);
+                        if (e.tick() != tick())
+                              clef->setSmall(true);         // layout does this ?
+                        segment->add(clef);
                         }
-                  else {
-                        // if 'real' time sig., do full process
-                        segment = getSegment(Segment::Type::TimeSig, currTick);
-                        segment->add(ts);
+                        break;
+                  case XmlTag::TIME_SIG: {
+                        TimeSig* ts = new TimeSig(score());
+                        ts->setTrack(e.track());
+                        ts->read(e);
+                        // if time sig not at begining of measure => courtesy time sig
+                        int currTick = e.tick();
+                        bool courtesySig = (currTick > tick());
+                        if (courtesySig) {
+                              // if courtesy sig., just add it without map processing
+                              segment = getSegment(Segment::Type::TimeSigAnnounce, currTick);
+                              segment->add(ts);
+                              }
+                        else {
+                              // if 'real' time sig., do full process
+                              segment = getSegment(Segment::Type::TimeSig, currTick);
+                              segment->add(ts);
 
-                        timeStretch = ts->stretch().reduced();
-                        _timesig    = ts->sig() / timeStretch;
+                              timeStretch = ts->stretch().reduced();
+                              _timesig    = ts->sig() / timeStretch;
 
-                        if (score()->mscVersion() > 114) {
-                              if (irregular) {
-                                    score()->sigmap()->add(tick(), SigEvent(_len, _timesig));
-                                    score()->sigmap()->add(tick() + ticks(), SigEvent(_timesig));
-                                    }
-                              else {
-                                    _len = _timesig;
-                                    score()->sigmap()->add(tick(), SigEvent(_timesig));
+                              if (score()->mscVersion() > 114) {
+                                    if (irregular) {
+                                          score()->sigmap()->add(tick(), SigEvent(_len, _timesig));
+                                          score()->sigmap()->add(tick() + ticks(), SigEvent(_timesig));
+                                          }
+                                    else {
+                                          _len = _timesig;
+                                          score()->sigmap()->add(tick(), SigEvent(_timesig));
+                                          }
                                     }
                               }
                         }
-                  }
-            else if (tag == "KeySig") {
-                  KeySig* ks = new KeySig(score());
-                  ks->setTrack(e.track());
-                  ks->read(e);
-                  int curTick = e.tick();
-                  if (!ks->isCustom() && !ks->isAtonal() && ks->key() == Key::C && curTick == 0) {
-                        // ignore empty key signature
-                        qDebug("remove keysig c at tick 0");
-                        delete ks;
-                        }
-                  else {
-                        // if key sig not at beginning of measure => courtesy key sig
-                        bool courtesySig = (curTick > tick());
-                        segment = getSegment(courtesySig ? Segment::Type::KeySigAnnounce : Segment::Type::KeySig, curTick);
-                        segment->add(ks);
-                        if (!courtesySig)
-                              staff->setKey(curTick, ks->keySigEvent());
+                        break;
+                  case XmlTag::KEY_SIG: {
+                        KeySig* ks = new KeySig(score());
+                        ks->setTrack(e.track());
+                        ks->read(e);
+                        int curTick = e.tick();
+                        if (!ks->isCustom() && !ks->isAtonal() && ks->key() == Key::C && curTick == 0) {
+                              // ignore empty key signature
+                              qDebug("remove keysig c at tick 0");
+                              delete ks;
+                              }
+                        else {
+                              // if key sig not at beginning of measure => courtesy key sig
+                              bool courtesySig = (curTick > tick());
+                              segment = getSegment(courtesySig ? Segment::Type::KeySigAnnounce : Segment::Type::KeySig, curTick);
+                              segment->add(ks);
+                              if (!courtesySig)
+                                    staff->setKey(curTick, ks->keySigEvent());
+                              }
                         }
-                  }
-            else if (tag == "Lyrics") {       // obsolete, keep for compatibility with version 114
-                  Element* element = Element::name2Element(tag, score());
-                  element->setTrack(e.track());
-                  element->read(e);
-                  segment       = getSegment(Segment::Type::ChordRest, e.tick());
-                  ChordRest* cr = static_cast<ChordRest*>(segment->element(element->track()));
-                  if (!cr)
-                        cr = static_cast<ChordRest*>(segment->element(e.track())); // in case lyric itself has bad track info
-                  if (!cr)
-                        qDebug("Internal error: no chord/rest for lyrics");
-                  else
-                        cr->add(element);
-                  }
-            else if (tag == "Text") {
-                  Text* t = new StaffText(score());
-                  t->setTrack(e.track());
-                  t->read(e);
-                  // previous versions stored measure number, delete it
-                  if ((score()->mscVersion() <= 114) && (t->textStyleType() == TextStyleType::MEASURE_NUMBER))
-                        delete t;
-                  else if (t->isEmpty()) {
-                        qDebug("reading empty text: deleted");
-                        delete t;
+                        break;
+                  case XmlTag::LYRICS: {      // obsolete, keep for compatibility with version 114
+                        Element* element = Element::name2Element(tag, score());
+                        element->setTrack(e.track());
+                        element->read(e);
+                        segment       = getSegment(Segment::Type::ChordRest, e.tick());
+                        ChordRest* cr = static_cast<ChordRest*>(segment->element(element->track()));
+                        if (!cr)
+                              cr = static_cast<ChordRest*>(segment->element(e.track())); // in case lyric itself has bad track info
+                        if (!cr)
+                              qDebug("Internal error: no chord/rest for lyrics");
+                        else
+                              cr->add(element);
                         }
-                  else if ((score()->mscVersion() <= 114) && t->textStyleType() == TextStyleType::REHEARSAL_MARK) {
-                        RehearsalMark* rh = new RehearsalMark(score());
-                        rh->setXmlText(t->xmlText());
-                        rh->setTrack(t->track());
-                        segment = getSegment(Segment::Type::ChordRest, e.tick());
-                        segment->add(rh);
-                        delete t;
+                        break;
+                  case XmlTag::TEXT: {
+                        Text* t = new StaffText(score());
+                        t->setTrack(e.track());
+                        t->read(e);
+                        // previous versions stored measure number, delete it
+                        if ((score()->mscVersion() <= 114) && (t->textStyleType() == TextStyleType::MEASURE_NUMBER))
+                              delete t;
+                        else if (t->isEmpty()) {
+                              qDebug("reading empty text: deleted");
+                              delete t;
+                              }
+                        else if ((score()->mscVersion() <= 114) && t->textStyleType() == TextStyleType::REHEARSAL_MARK) {
+                              RehearsalMark* rh = new RehearsalMark(score());
+                              rh->setXmlText(t->xmlText());
+                              rh->setTrack(t->track());
+                              segment = getSegment(Segment::Type::ChordRest, e.tick());
+                              segment->add(rh);
+                              delete t;
+                              }
+                        else {
+                              segment = getSegment(Segment::Type::ChordRest, e.tick());
+                              segment->add(t);
+                              }
                         }
-                  else {
+                        break;
+
+                  //----------------------------------------------------
+                  // Annotation
+
+                  case XmlTag::DYNAMIC: {
+                        Dynamic* dyn = new Dynamic(score());
+                        dyn->setTrack(e.track());
+                        dyn->read(e);
+                        if (score()->mscVersion() <= 114)
+                              dyn->setDynamicType(dyn->xmlText());
                         segment = getSegment(Segment::Type::ChordRest, e.tick());
-                        segment->add(t);
+                        segment->add(dyn);
                         }
-                  }
-
-            //----------------------------------------------------
-            // Annotation
-
-            else if (tag == "Dynamic") {
-                  Dynamic* dyn = new Dynamic(score());
-                  dyn->setTrack(e.track());
-                  dyn->read(e);
-                  if (score()->mscVersion() <= 114)
-                        dyn->setDynamicType(dyn->xmlText());
-                  segment = getSegment(Segment::Type::ChordRest, e.tick());
-                  segment->add(dyn);
-                  }
-            else if (tag == "Harmony"
-               || tag == "FretDiagram"
-               || tag == "TremoloBar"
-               || tag == "Symbol"
-               || tag == "Tempo"
-               || tag == "StaffText"
-               || tag == "RehearsalMark"
-               || tag == "InstrumentChange"
-               || tag == "StaffState"
-               || tag == "FiguredBass"
-               ) {
-                  Element* el = Element::name2Element(tag, score());
-                  // hack - needed because tick tags are unreliable in 1.3 scores
-                  // for symbols attached to anything but a measure
-                  if (score()->mscVersion() <= 114 && el->type() == Element::Type::SYMBOL)
-                        el->setParent(this);    // this will get reset when adding to segment
-                  el->setTrack(e.track());
-                  el->read(e);
-                  segment = getSegment(Segment::Type::ChordRest, e.tick());
-                  segment->add(el);
-                  }
-            else if (tag == "Marker"
-               || tag == "Jump"
-               ) {
-                  Element* el = Element::name2Element(tag, score());
-                  el->setTrack(e.track());
-                  el->read(e);
-                  add(el);
-                  }
-            else if (tag == "Image") {
-                  if (MScore::noImages)
-                        e.skipCurrentElement();
-                  else {
+                        break;
+                  case XmlTag::HARMONY:
+                  case XmlTag::FRET_DIAGRAM:
+                  case XmlTag::TREMOLO_BAR:
+                  case XmlTag::SYMBOL:
+                  case XmlTag::TEMPO:
+                  case XmlTag::STAFF_TEXT:
+                  case XmlTag::REHEARSAL_MARK:
+                  case XmlTag::INSTRUMENT_CHANGE:
+                  case XmlTag::STAFF_STATE:
+                  case XmlTag::FIGURED_BASS: {
                         Element* el = Element::name2Element(tag, score());
+                        // hack - needed because tick tags are unreliable in 1.3 scores
+                        // for symbols attached to anything but a measure
+                        if (score()->mscVersion() <= 114 && el->type() == Element::Type::SYMBOL)
+                              el->setParent(this);    // this will get reset when adding to segment
                         el->setTrack(e.track());
                         el->read(e);
                         segment = getSegment(Segment::Type::ChordRest, e.tick());
                         segment->add(el);
                         }
-                  }
-            //----------------------------------------------------
-            else if (tag == "stretch") {
-                  double val = e.readDouble();
-                  if (val < 0.0)
-                        val = 0;
-                  setUserStretch(val);
-                  }
-            else if (tag == "LayoutBreak") {
-                  LayoutBreak* lb = new LayoutBreak(score());
-                  lb->read(e);
-                  add(lb);
-                  }
-            else if (tag == "noOffset")
-                  _noOffset = e.readInt();
-            else if (tag == "measureNumberMode")
-                  setMeasureNumberMode(MeasureNumberMode(e.readInt()));
-            else if (tag == "irregular")
-                  _irregular = e.readBool();
-            else if (tag == "breakMultiMeasureRest")
-                  _breakMultiMeasureRest = e.readBool();
-            else if (tag == "sysInitBarLineType") {
-                  _systemInitialBarLineType = BarLineType(Ms::getProperty(P_ID::SYSTEM_INITIAL_BARLINE_TYPE, e).toInt());
-                  }
-            else if (tag == "Tuplet") {
-                  Tuplet* tuplet = new Tuplet(score());
-                  tuplet->setTrack(e.track());
-                  tuplet->setTick(e.tick());
-                  tuplet->setParent(this);
-                  tuplet->read(e);
-                  e.addTuplet(tuplet);
-                  }
-            else if (tag == "startRepeat") {
-                  _repeatFlags = _repeatFlags | Repeat::START;
-                  e.readNext();
-                  }
-            else if (tag == "endRepeat") {
-                  _repeatCount = e.readInt();
-                  _repeatFlags = _repeatFlags | Repeat::END;
-                  }
-            else if (tag == "vspacer" || tag == "vspacerDown") {
-                  if (staves[staffIdx]->_vspacerDown == 0) {
-                        Spacer* spacer = new Spacer(score());
-                        spacer->setSpacerType(SpacerType::DOWN);
-                        spacer->setTrack(staffIdx * VOICES);
-                        add(spacer);
+                        break;
+                  case XmlTag::MARKER:
+                  case XmlTag::JUMP: {
+                        Element* el = Element::name2Element(tag, score());
+                        el->setTrack(e.track());
+                        el->read(e);
+                        add(el);
                         }
-                  staves[staffIdx]->_vspacerDown->setGap(e.readDouble() * _spatium);
-                  }
-            else if (tag == "vspacer" || tag == "vspacerUp") {
-                  if (staves[staffIdx]->_vspacerUp == 0) {
-                        Spacer* spacer = new Spacer(score());
-                        spacer->setSpacerType(SpacerType::UP);
-                        spacer->setTrack(staffIdx * VOICES);
-                        add(spacer);
+                        break;
+                  case XmlTag::IMAGE: {
+                        if (MScore::noImages)
+                              e.skipCurrentElement();
+                        else {
+                              Element* el = Element::name2Element(tag, score());
+                              el->setTrack(e.track());
+                              el->read(e);
+                              segment = getSegment(Segment::Type::ChordRest, e.tick());
+                              segment->add(el);
+                              }
                         }
-                  staves[staffIdx]->_vspacerUp->setGap(e.readDouble() * _spatium);
-                  }
-            else if (tag == "visible")
-                  staves[staffIdx]->_visible = e.readInt();
-            else if (tag == "slashStyle")
-                  staves[staffIdx]->_slashStyle = e.readInt();
-            else if (tag == "Beam") {
-                  Beam* beam = new Beam(score());
-                  beam->setTrack(e.track());
-                  beam->read(e);
-                  beam->setParent(0);
-                  e.addBeam(beam);
-                  }
-            else if (tag == "Segment")
-                  segment->read(e);
-            else if (tag == "MeasureNumber") {
-                  Text* noText = new Text(score());
-                  noText->read(e);
-                  noText->setFlag(ElementFlag::ON_STAFF, true);
-                  // noText->setFlag(ElementFlag::MOVABLE, false); ??
-                  noText->setTrack(e.track());
-                  noText->setParent(this);
-                  staves[noText->staffIdx()]->setNoText(noText);
-                  }
-            else if (tag == "Ambitus") {
-                  Ambitus* range = new Ambitus(score());
-                  range->read(e);
-                  segment = getSegment(Segment::Type::Ambitus, e.tick());
-                  range->setParent(segment);          // a parent segment is needed for setTrack() to work
-                  range->setTrack(trackZeroVoice(e.track()));
-                  segment->add(range);
-                  }
-            else if (tag == "multiMeasureRest") {
-                  _mmRestCount = e.readInt();
-                  // set tick to previous measure
-                  setTick(e.lastMeasure()->tick());
-                  e.initTick(e.lastMeasure()->tick());
+                        break;
+                  //----------------------------------------------------
+                  case XmlTag::STRETCH: {
+                        double val = e.readDouble();
+                        if (val < 0.0)
+                              val = 0;
+                        setUserStretch(val);
+                        }
+                        break;
+                  case XmlTag::LAYOUT_BREAK: {
+                        LayoutBreak* lb = new LayoutBreak(score());
+                        lb->read(e);
+                        add(lb);
+                        }
+                        break;
+                  case XmlTag::NO_OFFSET:
+                        _noOffset = e.readInt();
+                        break;
+                  case XmlTag::MEASURE_NUMBER_MODE:
+                        setMeasureNumberMode(MeasureNumberMode(e.readInt()));
+                        break;
+                  case XmlTag::IRREGULAR:
+                        _irregular = e.readBool();
+                        break;
+                  case XmlTag::BREAK_MULTI_MEASURE_REST:
+                        _breakMultiMeasureRest = e.readBool();
+                        break;
+                  case XmlTag::SYS_INIT_BAR_LINE_TYPE: {
+                        _systemInitialBarLineType = BarLineType(Ms::getProperty(P_ID::SYSTEM_INITIAL_BARLINE_TYPE, e).toInt());
+                        }
+                        break;
+                  case XmlTag::TUPLET: {
+                        Tuplet* tuplet = new Tuplet(score());
+                        tuplet->setTrack(e.track());
+                        tuplet->setTick(e.tick());
+                        tuplet->setParent(this);
+                        tuplet->read(e);
+                        e.addTuplet(tuplet);
+                        }
+                        break;
+                  case XmlTag::START_REPEAT: {
+                        _repeatFlags = _repeatFlags | Repeat::START;
+                        e.readNext();
+                        }
+                        break;
+                  case XmlTag::END_REPEAT: {
+                        _repeatCount = e.readInt();
+                        _repeatFlags = _repeatFlags | Repeat::END;
+                        }
+                        break;
+                  case XmlTag::VSPACER:
+                  case XmlTag::VSPACER_DOWN: {
+                        if (staves[staffIdx]->_vspacerDown == 0) {
+                              Spacer* spacer = new Spacer(score());
+                              spacer->setSpacerType(SpacerType::DOWN);
+                              spacer->setTrack(staffIdx * VOICES);
+                              add(spacer);
+                              }
+                        staves[staffIdx]->_vspacerDown->setGap(e.readDouble() * _spatium);
+                        }
+                        break;
+                  case XmlTag::VSPACER_UP: {
+                        if (staves[staffIdx]->_vspacerUp == 0) {
+                              Spacer* spacer = new Spacer(score());
+                              spacer->setSpacerType(SpacerType::UP);
+                              spacer->setTrack(staffIdx * VOICES);
+                              add(spacer);
+                              }
+                        staves[staffIdx]->_vspacerUp->setGap(e.readDouble() * _spatium);
+                        }
+                        break;
+                  case XmlTag::VISIBLE:
+                        staves[staffIdx]->_visible = e.readInt();
+                        break;
+                  case XmlTag::SLASH_STYLE:
+                        staves[staffIdx]->_slashStyle = e.readInt();
+                        break;
+                  case XmlTag::BEAM: {
+                        Beam* beam = new Beam(score());
+                        beam->setTrack(e.track());
+                        beam->read(e);
+                        beam->setParent(0);
+                        e.addBeam(beam);
+                        }
+                        break;
+                  case XmlTag::SEGMENT:
+                        segment->read(e);
+                        break;
+                  case XmlTag::MEASURE_NUMBER: {
+                        Text* noText = new Text(score());
+                        noText->read(e);
+                        noText->setFlag(ElementFlag::ON_STAFF, true);
+                        // noText->setFlag(ElementFlag::MOVABLE, false); ??
+                        noText->setTrack(e.track());
+                        noText->setParent(this);
+                        staves[noText->staffIdx()]->setNoText(noText);
+                        }
+                        break;
+                  case XmlTag::AMBITUS: {
+                        Ambitus* range = new Ambitus(score());
+                        range->read(e);
+                        segment = getSegment(Segment::Type::Ambitus, e.tick());
+                        range->setParent(segment);          // a parent segment is needed for setTrack() to work
+                        range->setTrack(trackZeroVoice(e.track()));
+                        segment->add(range);
+                        }
+                        break;
+                  case XmlTag::MULTI_MEASURE_REST: {
+                        _mmRestCount = e.readInt();
+                        // set tick to previous measure
+                        setTick(e.lastMeasure()->tick());
+                        e.initTick(e.lastMeasure()->tick());
+                        }
+                        break;
+                  default:
+                        if (!Element::readProperties(e))
+                              e.unknown();
+                        break;
                   }
-            else if (Element::readProperties(e))
-                  ;
-            else
-                  e.unknown();
             }
       if (staffIdx == 0) {
             Segment* s = last();
@@ -91,6 +91,11 @@ int     MScore::defaultPlayDuration;
 // QString MScore::partStyle;
 QString MScore::lastError;
 bool    MScore::layoutDebug = false;
+bool    MScore::incrementalLayout = false;
+bool    MScore::incrementalPlayback = false;
+int     MScore::undoLimit         = 0;
+qint64  MScore::undoMemoryLimit   = 0;
+int     MScore::undoMergeInterval = 0;
 int     MScore::division    = 480; // 3840;   // pulses per quarter note (PPQ) // ticks per beat
 int     MScore::sampleRate  = 44100;
 int     MScore::mtcType;
@@ -449,6 +449,11 @@ class MScore : public QObject {
       static int defaultPlayDuration;
       static QString lastError;
       static bool layoutDebug;
+      static bool incrementalLayout;      ///< relayout only the range touched by a command
+      static bool incrementalPlayback;    ///< render playback events only for changed measures
+      static int undoLimit;               ///< max. number of undo steps, 0: no limit
+      static qint64 undoMemoryLimit;      ///< max. memory held by undo steps in bytes, 0: no limit
+      static int undoMergeInterval;       ///< ms in which property changes are merged into one undo step
 
       static int division;
       static int sampleRate;
@@ -251,6 +251,8 @@ class Note : public Element {
       ~Note();
 
       Note& operator=(const Note&) = delete;
+      static void* operator new(size_t);
+      static void operator delete(void*, size_t);
       virtual Note* clone() const override  { return new Note(*this, false); }
       Element::Type type() const override   { return Element::Type::NOTE; }
 
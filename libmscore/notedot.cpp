@@ -15,9 +15,24 @@
 #include "staff.h"
 #include "sym.h"
 #include "xml.h"
+#include "elementpool.h"
 
 namespace Ms {
 
+//---------------------------------------------------------
+//   operator new
+//---------------------------------------------------------
+
+void* NoteDot::operator new(size_t size)
+      {
+      return elementPool<NoteDot>()->alloc(size);
+      }
+
+void NoteDot::operator delete(void* p, size_t size)
+      {
+      elementPool<NoteDot>()->free(p, size);
+      }
+
 //---------------------------------------------------------
 //   NoteDot
 //---------------------------------------------------------
@@ -30,6 +30,8 @@ class NoteDot : public Element {
 
    public:
       NoteDot(Score* = 0);
+      static void* operator new(size_t);
+      static void operator delete(void*, size_t);
       virtual NoteDot* clone() const override     { return new NoteDot(*this); }
       virtual Element::Type type() const override { return Element::Type::NOTEDOT; }
       int idx() const                    { return _idx; }
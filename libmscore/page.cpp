@@ -127,7 +127,8 @@ Page::Page(Score* s)
    _no(0)
       {
       setFlags(0);
-      bspTreeValid = false;
+      bspTreeValid  = false;
+      drawListValid = false;
       }
 
 Page::~Page()
@@ -814,6 +815,23 @@ QList<const Element*> Page::elements()
       return el;
       }
 
+//---------------------------------------------------------
+//   drawList
+//    the elements of the page sorted by z; the list is
+//    kept until the page is laid out again, so that
+//    repeated exports of a page need not sort it again
+//---------------------------------------------------------
+
+const QList<const Element*>& Page::drawList()
+      {
+      if (!drawListValid) {
+            _drawList = elements();
+            qStableSort(_drawList.begin(), _drawList.end(), elementLessThan);
+            drawListValid = true;
+            }
+      return _drawList;
+      }
+
 //---------------------------------------------------------
 //   tm
 //---------------------------------------------------------
@@ -865,8 +883,7 @@ QRectF Page::tbbox()
       qreal x2 = 0.0;
       qreal y1 = height();
       qreal y2 = 0.0;
-      const QList<const Element*> el = elements();
-      for (const Element* e : el) {
+      for (const Element* e : drawList()) {
             if (e == this || !e->isPrintable())
                   continue;
             QRectF ebbox = e->pageBoundingRect();
@@ -49,6 +49,7 @@
 #include "segment.h"
 #include "undo.h"
 #include "utils.h"
+#include "eventcache.h"
 
 namespace Ms {
 
@@ -405,7 +406,7 @@ static void collectMeasureEvents(EventMap* events, Measure* m, Staff* staff, int
                   const StaffText* st = static_cast<const StaffText*>(e);
                   int tick = s->tick() + tickOffset;
 
-                  Instrument* instr = e->part()->instrument(tick);
+                  Instrument* instr = e->part()->instrument(s->tick());
                   for (const ChannelActions& ca : *st->channelActions()) {
                         int channel = instr->channel().at(ca.channel)->channel;
                         for(const QString& ma : ca.midiActionNames) {
@@ -426,7 +427,7 @@ static void collectMeasureEvents(EventMap* events, Measure* m, Staff* staff, int
                   if (st->setAeolusStops()) {
                         Staff* staff = st->staff();
                         int voice   = 0;
-                        int channel = staff->channel(tick, voice);
+                        int channel = staff->channel(s->tick(), voice);
 
                         for (int i = 0; i < 4; ++i) {
                               static int num[4] = { 12, 13, 16, 16 };
@@ -648,6 +649,48 @@ void Score::renderStaff(EventMap* events, Staff* staff)
             }
       }
 
+//---------------------------------------------------------
+//   renderStaff
+//    like renderStaff() above, but take the events of a
+//    measure from the cache if they are there; they are
+//    rendered with tick offset 0 and added in the same
+//    order as renderStaff() adds them
+//---------------------------------------------------------
+
+void Score::renderStaff(EventMap* events, int staffIdx, EventCache* cache)
+      {
+      Staff* staff = _staves[staffIdx];
+      Measure* lastMeasure = 0;
+      foreach (const RepeatSegment* rs, *repeatList()) {
+            int startTick  = rs->tick;
+            int endTick    = startTick + rs->len();
+            int tickOffset = rs->utick - rs->tick;
+            for (Measure* m = tick2measure(startTick); m; m = m->nextMeasure()) {
+                  int offset = tickOffset;
+                  if (lastMeasure && m->isRepeatMeasure(staff))
+                        offset += m->tick() - lastMeasure->tick();
+                  else
+                        lastMeasure = m;
+                  const MeasureEvents* me = cache->use(lastMeasure, staffIdx);
+                  if (!me) {
+                        EventMap el;
+                        collectMeasureEvents(&el, lastMeasure, staff, 0);
+                        MeasureEvents nme;
+                        nme.tick           = lastMeasure->tick();
+                        nme.endTick        = lastMeasure->endTick();
+                        nme.highestChannel = el.highestChannel();
+                        nme.events.assign(el.begin(), el.end());
+                        me = cache->insert(lastMeasure, staffIdx, nme);
+                        }
+                  events->registerChannel(me->highestChannel);
+                  for (const auto& e : me->events)
+                        events->insert(std::pair<int, NPlayEvent>(e.first + offset, e.second));
+                  if (m->tick() + m->ticks() >= endTick)
+                        break;
+                  }
+            }
+      }
+
 //---------------------------------------------------------
 //   renderSpanners
 //---------------------------------------------------------
@@ -1519,6 +1562,57 @@ void Score::createPlayEvents(Chord* chord)
       // dont change event list if type is PlayEventType::User
       }
 
+//---------------------------------------------------------
+//   updateEventCache
+//    drop the outdated events of the cache and create the
+//    play events of the chords which are rendered again
+//---------------------------------------------------------
+
+void Score::updateEventCache(EventCache* cache)
+      {
+      cache->update(this);
+
+      const Segment::Type st = Segment::Type::ChordRest;
+      // a note tied into a measure which is rendered again is
+      // rendered with the first note of the tie
+      for (int staffIdx = 0; staffIdx < nstaves(); ++staffIdx) {
+            for (Measure* m = firstMeasure(); m; m = m->nextMeasure()) {
+                  if (cache->find(m, staffIdx))
+                        continue;
+                  for (Segment* seg = m->first(st); seg; seg = seg->next(st)) {
+                        for (int track = staffIdx * VOICES; track < (staffIdx + 1) * VOICES; ++track) {
+                              Element* el = seg->element(track);
+                              if (el == 0 || el->type() != Element::Type::CHORD)
+                                    continue;
+                              for (Note* note : static_cast<Chord*>(el)->notes()) {
+                                    Note* n = note;
+                                    while (n->tieBack() && n->tieBack()->startNote() && n->tieBack()->startNote() != note)
+                                          n = n->tieBack()->startNote();
+                                    if (n != note)
+                                          cache->remove(n->chord()->measure(), staffIdx);
+                                    }
+                              }
+                        }
+                  }
+            }
+      for (int staffIdx = 0; staffIdx < nstaves(); ++staffIdx) {
+            // skip linked staves, except primary
+            if (!staff(staffIdx)->primaryStaff())
+                  continue;
+            for (Measure* m = firstMeasure(); m; m = m->nextMeasure()) {
+                  if (cache->find(m, staffIdx))
+                        continue;
+                  for (Segment* seg = m->first(st); seg; seg = seg->next(st)) {
+                        for (int track = staffIdx * VOICES; track < (staffIdx + 1) * VOICES; ++track) {
+                              Element* el = seg->element(track);
+                              if (el && el->type() == Element::Type::CHORD)
+                                    createPlayEvents(static_cast<Chord*>(el));
+                              }
+                        }
+                  }
+            }
+      }
+
 void Score::createPlayEvents()
       {
       int etrack = nstaves() * VOICES;
@@ -1574,21 +1668,47 @@ void Score::renderMetronome(EventMap* events, Measure* m, int tickOffset)
 
 void Score::renderMidi(EventMap* events)
       {
-      renderMidi(events, true, MScore::playRepeats);
+      if (!MScore::incrementalPlayback) {
+            delete _eventCache;
+            _eventCache = 0;
+            renderMidi(events, true, MScore::playRepeats, 0);
+            return;
+            }
+      if (!_eventCache)
+            _eventCache = new EventCache;
+      renderMidi(events, true, MScore::playRepeats, _eventCache);
       }
 
 void Score::renderMidi(EventMap* events, bool metronome, bool expandRepeats)
+      {
+      renderMidi(events, metronome, expandRepeats, 0);
+      }
+
+//---------------------------------------------------------
+//   renderMidi
+//    with a cache, only the measures changed since the
+//    last rendering are rendered again
+//---------------------------------------------------------
+
+void Score::renderMidi(EventMap* events, bool metronome, bool expandRepeats, EventCache* cache)
       {
       updateSwing();
-      createPlayEvents();
+      if (!cache)
+            createPlayEvents();
 
       updateRepeatList(expandRepeats);
       updateChannel();
       updateVelo();
+      if (cache)
+            updateEventCache(cache);
 
       // create note & other events
-      foreach (Staff* part, _staves)
-            renderStaff(events, part);
+      for (int staffIdx = 0; staffIdx < nstaves(); ++staffIdx) {
+            if (cache)
+                  renderStaff(events, staffIdx, cache);
+            else
+                  renderStaff(events, _staves[staffIdx]);
+            }
       events->fixupMIDI();
 
       // create sustain pedal events
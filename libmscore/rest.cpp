@@ -30,9 +30,24 @@
 #include "stafftype.h"
 #include "icon.h"
 #include "image.h"
+#include "elementpool.h"
 
 namespace Ms {
 
+//---------------------------------------------------------
+//   operator new
+//---------------------------------------------------------
+
+void* Rest::operator new(size_t size)
+      {
+      return elementPool<Rest>()->alloc(size);
+      }
+
+void Rest::operator delete(void* p, size_t size)
+      {
+      elementPool<Rest>()->free(p, size);
+      }
+
 //---------------------------------------------------------
 //    Rest
 //--------------------------------------------------------
@@ -53,6 +53,8 @@ class Rest : public ChordRest {
       virtual Element::Type type() const override { return Element::Type::REST; }
       Rest &operator=(const Rest&) = delete;
 
+      static void* operator new(size_t);
+      static void operator delete(void*, size_t);
       virtual Rest* clone() const override        { return new Rest(*this, false); }
       virtual Element* linkedClone()              { return new Rest(*this, true); }
       virtual Measure* measure() const override   { return parent() ? (Measure*)(parent()->parent()) : 0; }
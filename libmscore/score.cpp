@@ -16,6 +16,7 @@
 */
 
 #include <assert.h>
+#include <algorithm>
 #include "score.h"
 #include "key.h"
 #include "sig.h"
@@ -70,6 +71,7 @@
 #include "rehearsalmark.h"
 #include "breath.h"
 #include "instrchange.h"
+#include "eventcache.h"
 
 namespace Ms {
 
@@ -111,6 +113,8 @@ void MeasureBaseList::push_back(MeasureBase* e)
             e->setNext(0);
             }
       _last = e;
+      if (e->type() == Element::Type::MEASURE)
+            _index.push_back(static_cast<Measure*>(e));
       }
 
 //---------------------------------------------------------
@@ -131,6 +135,8 @@ void MeasureBaseList::push_front(MeasureBase* e)
             e->setNext(0);
             }
       _first = e;
+      if (e->type() == Element::Type::MEASURE)
+            _index.insert(_index.begin(), static_cast<Measure*>(e));
       }
 
 //---------------------------------------------------------
@@ -153,6 +159,7 @@ void MeasureBaseList::add(MeasureBase* e)
       e->setPrev(el->prev());
       el->prev()->setNext(e);
       el->setPrev(e);
+      rebuildIndex();
       }
 
 //---------------------------------------------------------
@@ -170,6 +177,9 @@ void MeasureBaseList::remove(MeasureBase* el)
             el->next()->setPrev(el->prev());
       else
             _last = el->prev();
+      auto i = std::find(_index.begin(), _index.end(), el);
+      if (i != _index.end())
+            _index.erase(i);
       }
 
 //---------------------------------------------------------
@@ -191,6 +201,7 @@ void MeasureBaseList::insert(MeasureBase* fm, MeasureBase* lm)
             nm->setPrev(lm);
       else
             _last = lm;
+      rebuildIndex();
       }
 
 //---------------------------------------------------------
@@ -212,6 +223,39 @@ void MeasureBaseList::remove(MeasureBase* fm, MeasureBase* lm)
             nm->setPrev(pm);
       else
             _last = pm;
+      rebuildIndex();
+      }
+
+//---------------------------------------------------------
+//   rebuildIndex
+//---------------------------------------------------------
+
+void MeasureBaseList::rebuildIndex()
+      {
+      _index.clear();
+      _index.reserve(_size);
+      for (MeasureBase* mb = _first; mb; mb = mb->next()) {
+            if (mb->type() == Element::Type::MEASURE)
+                  _index.push_back(static_cast<Measure*>(mb));
+            }
+      }
+
+//---------------------------------------------------------
+//   tick2measure
+//    binary search for the last measure starting at or
+//    before tick; return 0 if tick is before the first
+//    measure.
+//    Measure ticks change without notifying the list
+//    (insert time, change measure len) but keep their order.
+//---------------------------------------------------------
+
+Measure* MeasureBaseList::tick2measure(int tick) const
+      {
+      auto i = std::upper_bound(_index.begin(), _index.end(), tick,
+         [](int t, const Measure* m) { return t < m->tick(); });
+      if (i == _index.begin())
+            return 0;
+      return *(i - 1);
       }
 
 //---------------------------------------------------------
@@ -235,6 +279,7 @@ void MeasureBaseList::change(MeasureBase* ob, MeasureBase* nb)
             nb->setSystem(ob->system());
       foreach(Element* e, nb->el())
             e->setParent(nb);
+      rebuildIndex();
       }
 
 //---------------------------------------------------------
@@ -428,6 +473,7 @@ Score::~Score()
       delete _tempomap;
       delete _sigmap;
       delete _repeatList;
+      delete _eventCache;
       }
 
 //---------------------------------------------------------
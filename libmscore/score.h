@@ -29,6 +29,7 @@
 #include "layoutbreak.h"
 #include "rehearsalmark.h"
 #include <set>
+#include <vector>
 
 class QPainter;
 
@@ -47,6 +48,7 @@ class Cursor;
 class Dynamic;
 class ElementList;
 class EventMap;
+class EventCache;
 class Excerpt;
 class FiguredBass;
 class Fingering;
@@ -142,20 +144,25 @@ class MeasureBaseList {
       MeasureBase* _first;
       MeasureBase* _last;
 
+      std::vector<Measure*> _index;       ///< measures in list order, kept up to date by every change
+                                          ///< so that concurrent readers never write it
+
       void push_back(MeasureBase* e);
       void push_front(MeasureBase* e);
+      void rebuildIndex();
 
    public:
       MeasureBaseList();
       MeasureBase* first() const { return _first; }
       MeasureBase* last()  const { return _last; }
-      void clear()               { _first = _last = 0; _size = 0; }
+      void clear()               { _first = _last = 0; _size = 0; _index.clear(); }
       void add(MeasureBase*);
       void remove(MeasureBase*);
       void insert(MeasureBase*, MeasureBase*);
       void remove(MeasureBase*, MeasureBase*);
       void change(MeasureBase* o, MeasureBase* n);
       int size() const { return _size; }
+      Measure* tick2measure(int tick) const;
       };
 
 //---------------------------------------------------------
@@ -381,6 +388,7 @@ class Score : public QObject, public ScoreElement {
 
       bool _printing;   ///< True if we are drawing to a printer
       bool _playlistDirty;
+      EventCache* _eventCache     { 0 };          ///< rendered playback events, see renderMidi()
       bool _autosaveDirty;
       bool _savedCapture          { false };      ///< True if we saved an image capture
 
@@ -458,8 +466,11 @@ class Score : public QObject, public ScoreElement {
       System* getNextSystem(bool, bool);
       bool doReLayout();
 
-      void layoutStage2();
-      void layoutStage3();
+      void layoutStage1(int stick, int etick);
+      void layoutStage2(Measure* sm, Measure* em);
+      void layoutStage3(Measure* sm, Measure* em);
+      void layoutElements(Segment* fs, int etick);
+      bool layoutSystemsRange(Measure* sm, Measure* em, int* firstSystem, int* lastSystem);
       void beamGraceNotes(Chord*, bool);
 
       void hideEmptyStaves(System* system, bool isFirstSystem);
@@ -491,6 +502,9 @@ class Score : public QObject, public ScoreElement {
       FileError read1(XmlReader&, bool ignoreVersionError);
 
       void renderStaff(EventMap* events, Staff*);
+      void renderStaff(EventMap* events, int staffIdx, EventCache*);
+      void renderMidi(EventMap* events, bool metronome, bool expandRepeats, EventCache*);
+      void updateEventCache(EventCache*);
       void renderSpanners(EventMap* events);
       void renderMetronome(EventMap* events, Measure* m, int tickOffset);
 
@@ -755,6 +769,7 @@ class Score : public QObject, public ScoreElement {
       bool autosaveDirty() const     { return _autosaveDirty; }
       bool playlistDirty()           { return _playlistDirty; }
       void setPlaylistDirty()        { _playlistDirty = true; }
+      const EventCache* eventCache() const { return _eventCache; }
 
       void spell();
       void spell(int startStaff, int endStaff, Segment* startSegment, Segment* endSegment);
@@ -940,6 +955,7 @@ class Score : public QObject, public ScoreElement {
 
       //@ ??
       Q_INVOKABLE void doLayout();
+      void doLayoutRange(int stick, int etick);
       void layoutSystems();
       void layoutSystems2();
       void layoutLinear();
@@ -950,7 +966,7 @@ class Score : public QObject, public ScoreElement {
 
       void layoutChords1(Segment* segment, int staffIdx);
 #ifndef DISABLE_UTPIANO
-      void layoutChords2a(Measure* mesure);
+      void layoutChords2a(Segment* segment, int staffIdx);
 #endif
       qreal layoutChords2(QList<Note*>& notes, bool up);
       void layoutChords3(QList<Note*>& notes, Staff* staff, Segment* segment);
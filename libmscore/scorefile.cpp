@@ -1275,11 +1275,7 @@ void Score::print(QPainter* painter, int pageNo)
       _printing  = true;
       MScore::pdfPrinting = true;
       Page* page = pages().at(pageNo);
-      QRectF fr  = page->abbox();
-
-      QList<Element*> ell = page->items(fr);
-      qStableSort(ell.begin(), ell.end(), elementLessThan);
-      foreach(const Element* e, ell) {
+      for (const Element* e : page->drawList()) {
             if (!e->visible())
                   continue;
             painter->save();
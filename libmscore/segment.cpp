@@ -37,6 +37,7 @@
 #include "system.h"
 #include "xml.h"
 #include "undo.h"
+#include "elementpool.h"
 
 namespace Ms {
 
@@ -104,6 +105,20 @@ void Segment::removeElement(int track)
             }
       }
 
+//---------------------------------------------------------
+//   operator new
+//---------------------------------------------------------
+
+void* Segment::operator new(size_t size)
+      {
+      return elementPool<Segment>()->alloc(size);
+      }
+
+void Segment::operator delete(void* p, size_t size)
+      {
+      elementPool<Segment>()->free(p, size);
+      }
+
 //---------------------------------------------------------
 //   Segment
 //---------------------------------------------------------
@@ -110,6 +110,8 @@ public:
       Segment(const Segment&);
       ~Segment();
 
+      static void* operator new(size_t);
+      static void operator delete(void*, size_t);
       virtual Segment* clone() const     { return new Segment(*this); }
       virtual Element::Type type() const { return Element::Type::SEGMENT; }
 
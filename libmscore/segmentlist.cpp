@@ -14,6 +14,8 @@
 #include "segment.h"
 #include "score.h"
 
+#include <algorithm>
+
 namespace Ms {
 
 //---------------------------------------------------------
@@ -33,6 +35,28 @@ SegmentList SegmentList::clone() const
       return dl;
       }
 
+//---------------------------------------------------------
+//   lowerBound
+//    return the first segment at or after the measure
+//    relative tick position rtick or 0
+//---------------------------------------------------------
+
+Segment* SegmentList::lowerBound(int rtick) const
+      {
+      auto i = std::lower_bound(_index.begin(), _index.end(), rtick,
+         [](const Segment* s, int t) { return s->rtick() < t; });
+      Segment* s = (i == _index.end()) ? 0 : *i;
+
+      // segment ticks are changed without notifying the list;
+      // they keep their order, but make sure:
+      Segment* ps = s ? s->prev() : _last;
+      if ((s && s->rtick() < rtick) || (ps && ps->rtick() >= rtick)) {
+            for (s = _first; s && s->rtick() < rtick; s = s->next())
+                  ;
+            }
+      return s;
+      }
+
 //---------------------------------------------------------
 //   check
 //---------------------------------------------------------
@@ -106,6 +130,7 @@ void SegmentList::insert(Segment* e, Segment* el)
             e->setPrev(el->prev());
             el->prev()->setNext(e);
             el->setPrev(e);
+            _index.insert(std::find(_index.begin(), _index.end(), el), e);
             check();
             }
       }
@@ -133,6 +158,9 @@ void SegmentList::remove(Segment* el)
             el->prev()->setNext(el->next());
             el->next()->setPrev(el->prev());
             }
+      auto i = std::find(_index.begin(), _index.end(), el);
+      if (i != _index.end())
+            _index.erase(i);
       check();
       }
 
@@ -150,6 +178,7 @@ void SegmentList::push_back(Segment* e)
             _first = e;
       e->setPrev(_last);
       _last = e;
+      _index.push_back(e);
       check();
       }
 
@@ -167,6 +196,7 @@ void SegmentList::push_front(Segment* e)
             _last = e;
       e->setNext(_first);
       _first = e;
+      _index.insert(_index.begin(), e);
       check();
       }
 
@@ -214,6 +244,7 @@ void SegmentList::insert(Segment* seg)
             seg->next()->setPrev(seg);
       else
             _last = seg;
+      _index.insert(seg->next() ? std::find(_index.begin(), _index.end(), seg->next()) : _index.end(), seg);
       ++_size;
       check();
       }
@@ -14,6 +14,7 @@
 #define __SEGMENTLIST_H__
 
 #include <libmscore/segment.h>
+#include <vector>
 
 namespace Ms {
 
@@ -26,9 +27,12 @@ class SegmentList {
       Segment* _last;         ///< Last item of segment list
       int _size;              ///< Number of items in segment list
 
+      std::vector<Segment*> _index;       ///< segments in list order for binary search by tick;
+                                          ///< updated by every insert and remove, only read by lookups
+
    public:
       SegmentList()                        { clear(); }
-      void clear()                         { _first = _last = 0; _size = 0; }
+      void clear()                         { _first = _last = 0; _size = 0; _index.clear(); }
 #ifndef NDEBUG
       void check();
 #else
@@ -42,6 +46,7 @@ class SegmentList {
 
       Segment* last() const                { return _last;        }
       Segment* firstCRSegment() const;
+      Segment* lowerBound(int rtick) const;
       void remove(Segment*);
       void push_back(Segment*);
       void push_front(Segment*);
@@ -19,6 +19,7 @@
 #include "tremolo.h"
 #include "note.h"
 #include "xml.h"
+#include "elementpool.h"
 
 // TEMPORARY HACK!!
 #include "sym.h"
@@ -26,6 +27,20 @@
 
 namespace Ms {
 
+//---------------------------------------------------------
+//   operator new
+//---------------------------------------------------------
+
+void* Stem::operator new(size_t size)
+      {
+      return elementPool<Stem>()->alloc(size);
+      }
+
+void Stem::operator delete(void* p, size_t size)
+      {
+      elementPool<Stem>()->free(p, size);
+      }
+
 //---------------------------------------------------------
 //   Stem
 //    Notenhals
@@ -39,6 +39,8 @@ class Stem : public Element {
       Stem(Score* = 0);
       Stem &operator=(const Stem&) = delete;
 
+      static void* operator new(size_t);
+      static void operator delete(void*, size_t);
       virtual Stem* clone() const        { return new Stem(*this); }
       virtual Element::Type type() const { return Element::Type::STEM; }
       virtual void draw(QPainter*) const;
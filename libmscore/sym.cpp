@@ -5297,71 +5297,129 @@ SymId Sym::userName2id(const QString& s)
 bool GlyphKey::operator==(const GlyphKey& k) const
       {
       return (face == k.face) && (id == k.id)
-         && (mag == k.mag) && (worldScale == k.worldScale) && (color == k.color);
+         && (scale16 == k.scale16) && (worldScale == k.worldScale) && (color == k.color);
       }
 
 //---------------------------------------------------------
-//   draw
+//   GlyphPixmap::draw
 //---------------------------------------------------------
 
-void ScoreFont::draw(SymId id, QPainter* painter, qreal mag, const QPointF& pos) const
+void GlyphPixmap::draw(QPainter* painter, const QPointF& pos) const
       {
-      qreal worldScale = painter->worldTransform().m11();
-      draw(id, painter, mag, pos, worldScale);
+      if (pixmap.isNull())
+            painter->drawImage(target(pos), image, QRectF(rect));
+      else
+            painter->drawPixmap(target(pos), pixmap, QRectF(rect));
       }
 
-void ScoreFont::draw(SymId id, QPainter* painter, qreal mag, const QPointF& pos, qreal worldScale) const
+//---------------------------------------------------------
+//   GlyphAtlas::find
+//---------------------------------------------------------
+
+bool GlyphAtlas::find(const GlyphKey& k, GlyphPixmap* gp) const
       {
-      if (!sym(id).symList().isEmpty()) {  // is this a compound symbol?
-            draw(sym(id).symList(), painter, mag, pos);
-            return;
-            }
-      if (!isValid(id)) {
-            qDebug("ScoreFont::draw: invalid sym %d\n", int(id));
-            return;
+      auto i = _glyphs.find(k);
+      if (i == _glyphs.end())
+            return false;
+      *gp = i.value();
+      return true;
+      }
+
+//---------------------------------------------------------
+//   GlyphAtlas::insert
+//    place img on a page: glyphs are put into rows, a
+//    glyph larger than a page gets a page of its own
+//---------------------------------------------------------
+
+GlyphPixmap GlyphAtlas::insert(const GlyphKey& k, const QImage& img, const QPointF& offset)
+      {
+      if (_pages.size() >= MAX_PAGES)
+            clear();
+      int w = img.width() + 1;                  // keep a transparent pixel between glyphs
+      int h = img.height() + 1;
+      Page* page = _pages.isEmpty() ? 0 : &_pages.last();
+      if (page && page->x + w > page->image.width()) {
+            page->x = 0;
+            page->y += page->rowHeight;
+            page->rowHeight = 0;
             }
-      int rv = FT_Load_Glyph(face, sym(id).index(), FT_LOAD_DEFAULT);
-      if (rv) {
-            qDebug("load glyph id %d, failed: 0x%x", int(id), rv);
-            return;
+      if (!page || page->y + h > page->image.height()) {
+            _pages.append(Page());
+            page = &_pages.last();
+            page->image = QImage(qMax(w, int(PAGE_SIZE)), qMax(h, int(PAGE_SIZE)), QImage::Format_ARGB32_Premultiplied);
+            page->image.fill(Qt::transparent);
             }
+      page->image.detach();                     // painters on other threads may draw from a copy
+      QPainter p(&page->image);
+      p.setCompositionMode(QPainter::CompositionMode_Source);
+      p.drawImage(page->x, page->y, img);
+      p.end();
 
-      if (MScore::pdfPrinting) {
-            if (font == 0) {
-                  QString s(_fontPath+_filename);
-                  if (-1 == QFontDatabase::addApplicationFont(s)) {
-                        qDebug("Mscore: fatal error: cannot load internal font <%s>", qPrintable(s));
-                        return;
-                        }
-                  font = new QFont;
-                  font->setWeight(QFont::Normal);
-                  font->setItalic(false);
-                  font->setFamily(_family);
-                  font->setStyleStrategy(QFont::NoFontMerging);
-                  font->setHintingPreference(QFont::PreferVerticalHinting);
-                  qreal size = 20.0;
-                  font->setPixelSize(lrint(size));
+      GlyphPixmap gp;
+      gp.page       = _pages.size() - 1;
+      gp.rect       = QRect(page->x, page->y, img.width(), img.height());
+      gp.offset     = offset;
+      gp.worldScale = k.worldScale;
+      page->x        += w;
+      page->rowHeight = qMax(page->rowHeight, h);
+      page->dirty     = true;
+      _glyphs.insert(k, gp);
+      return gp;
+      }
+
+//---------------------------------------------------------
+//   GlyphAtlas::setPage
+//    give gp a copy of its page; pixmaps can only be made
+//    on the gui thread
+//---------------------------------------------------------
+
+void GlyphAtlas::setPage(GlyphPixmap* gp)
+      {
+      Page& page = _pages[gp->page];
+      QCoreApplication* app = QCoreApplication::instance();
+      if (app && QThread::currentThread() == app->thread()) {
+            if (page.dirty) {
+                  page.pixmap = QPixmap::fromImage(page.image);
+                  page.dirty  = false;
                   }
-            qreal imag = 1.0 / mag;
-            painter->scale(mag, mag);
-            painter->setFont(*font);
-            painter->drawText(pos * imag, toString(id));
-            painter->scale(imag, imag);
-            return;
+            gp->pixmap = page.pixmap;
             }
+      else
+            gp->image = page.image;
+      }
 
-      QColor color(painter->pen().color());
+//---------------------------------------------------------
+//   GlyphAtlas::clear
+//---------------------------------------------------------
 
-      int pr           = painter->device()->devicePixelRatio();
-      qreal pixelRatio = qreal(pr > 0 ? pr : 1);
-      worldScale      *= pixelRatio;
-//      if (worldScale < 1.0)
-//            worldScale = 1.0;
-      int scale16      = lrint(worldScale * 6553.6 * mag);
+void GlyphAtlas::clear()
+      {
+      _glyphs.clear();
+      _pages.clear();
+      }
 
-      GlyphKey gk(face, id, mag, worldScale, color);
-      GlyphPixmap* pm = cache->object(gk);
-      if (!pm) {
+//---------------------------------------------------------
+//   glyph
+//    find the glyph in the atlas, render it if it is not
+//    there. The result holds a copy of the atlas page, so
+//    it stays valid when the atlas is cleared; it is null
+//    if the glyph cannot be rendered. FreeType is only used
+//    for new glyphs.
+//---------------------------------------------------------
+
+GlyphPixmap ScoreFont::glyph(SymId id, qreal mag, qreal worldScale, QRgb color) const
+      {
+      int scale16 = lrint(worldScale * 6553.6 * mag);
+      GlyphKey gk(face, id, scale16, worldScale, color);
+
+      QMutexLocker locker(&atlas->mutex);
+      GlyphPixmap gp;
+      if (!atlas->find(gk, &gp)) {
+            int rv = FT_Load_Glyph(face, sym(id).index(), FT_LOAD_DEFAULT);
+            if (rv) {
+                  qDebug("load glyph id %d, failed: 0x%x", int(id), rv);
+                  return GlyphPixmap();
+                  }
             FT_Matrix matrix {
                   scale16, 0,
                   0,       scale16
@@ -5373,7 +5431,7 @@ void ScoreFont::draw(SymId id, QPainter* painter, qreal mag, const QPointF& pos,
             rv = FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, 0, 1);
             if (rv) {
                   qDebug("glyph to bitmap failed: 0x%x", rv);
-                  return;
+                  return GlyphPixmap();
                   }
 
             FT_BitmapGlyph gb = (FT_BitmapGlyph)glyph;
@@ -5381,29 +5439,108 @@ void ScoreFont::draw(SymId id, QPainter* painter, qreal mag, const QPointF& pos,
 
             if (bm->width == 0 || bm->rows == 0) {
                   qDebug("zero glyph");
-                  return;
+                  FT_Done_Glyph(glyph);
+                  return GlyphPixmap();
                   }
             QImage img(QSize(bm->width, bm->rows), QImage::Format_ARGB32);
             img.fill(Qt::transparent);
 
+            QColor c(QColor::fromRgba(color));
             for (int y = 0; y < int(bm->rows); ++y) {
                   unsigned* dst      = (unsigned*)img.scanLine(y);
                   unsigned char* src = (unsigned char*)(bm->buffer) + bm->pitch * y;
                   for (int x = 0; x < int(bm->width); ++x) {
                         unsigned val = *src++;
-                        color.setAlpha(val);
-                        *dst++ = color.rgba();
+                        c.setAlpha(val);
+                        *dst++ = c.rgba();
                         }
                   }
-            pm = new GlyphPixmap;
-            pm->pm = QPixmap::fromImage(img, Qt::NoFormatConversion);
-            pm->pm.setDevicePixelRatio(worldScale);
-            pm->offset = QPointF(qreal(gb->left), -qreal(gb->top)) / worldScale;
-            if (!cache->insert(gk, pm))
-                  qDebug("cannot cache glyph");
+            QPointF offset = QPointF(qreal(gb->left), -qreal(gb->top)) / worldScale;
             FT_Done_Glyph(glyph);
+            gp = atlas->insert(gk, img, offset);
+            }
+      atlas->setPage(&gp);
+      return gp;
+      }
+
+//---------------------------------------------------------
+//   clearGlyphCache
+//---------------------------------------------------------
+
+void ScoreFont::clearGlyphCache() const
+      {
+      if (atlas) {
+            QMutexLocker locker(&atlas->mutex);
+            atlas->clear();
             }
-      painter->drawPixmap(pos + pm->offset, pm->pm);
+      }
+
+//---------------------------------------------------------
+//   drawText
+//    draw symbol with the font engine, used for pdf
+//---------------------------------------------------------
+
+void ScoreFont::drawText(SymId id, QPainter* painter, qreal mag, const QPointF& pos) const
+      {
+      static QMutex mutex;          // pages may be exported in parallel
+      QMutexLocker locker(&mutex);
+      if (font == 0) {
+            QString s(_fontPath+_filename);
+            if (-1 == QFontDatabase::addApplicationFont(s)) {
+                  qDebug("Mscore: fatal error: cannot load internal font <%s>", qPrintable(s));
+                  return;
+                  }
+            font = new QFont;
+            font->setWeight(QFont::Normal);
+            font->setItalic(false);
+            font->setFamily(_family);
+            font->setStyleStrategy(QFont::NoFontMerging);
+            font->setHintingPreference(QFont::PreferVerticalHinting);
+            qreal size = 20.0;
+            font->setPixelSize(lrint(size));
+            }
+      locker.unlock();
+      qreal imag = 1.0 / mag;
+      painter->scale(mag, mag);
+      painter->setFont(*font);
+      painter->drawText(pos * imag, toString(id));
+      painter->scale(imag, imag);
+      }
+
+//---------------------------------------------------------
+//   draw
+//---------------------------------------------------------
+
+void ScoreFont::draw(SymId id, QPainter* painter, qreal mag, const QPointF& pos) const
+      {
+      qreal worldScale = painter->worldTransform().m11();
+      draw(id, painter, mag, pos, worldScale);
+      }
+
+void ScoreFont::draw(SymId id, QPainter* painter, qreal mag, const QPointF& pos, qreal worldScale) const
+      {
+      if (!sym(id).symList().isEmpty()) {  // is this a compound symbol?
+            draw(sym(id).symList(), painter, mag, pos);
+            return;
+            }
+      if (!isValid(id)) {
+            qDebug("ScoreFont::draw: invalid sym %d\n", int(id));
+            return;
+            }
+      if (MScore::pdfPrinting) {
+            drawText(id, painter, mag, pos);
+            return;
+            }
+
+      int pr           = painter->device()->devicePixelRatio();
+      qreal pixelRatio = qreal(pr > 0 ? pr : 1);
+      worldScale      *= pixelRatio;
+//      if (worldScale < 1.0)
+//            worldScale = 1.0;
+
+      GlyphPixmap gp = glyph(id, mag, worldScale, painter->pen().color().rgba());
+      if (!gp.isNull())
+            gp.draw(painter, pos);
       }
 
 void ScoreFont::draw(SymId id, QPainter* painter, qreal mag, const QPointF& pos, int n) const
@@ -5414,14 +5551,61 @@ void ScoreFont::draw(SymId id, QPainter* painter, qreal mag, const QPointF& pos,
       draw(d, painter, mag, pos);
       }
 
+//---------------------------------------------------------
+//   draw
+//    a row of symbols; glyphs from the same atlas page are
+//    drawn with one drawPixmapFragments() call
+//---------------------------------------------------------
+
 void ScoreFont::draw(const QList<SymId>& ids, QPainter* p, qreal mag, const QPointF& _pos, qreal scale) const
       {
       QPointF pos(_pos);
+      if (MScore::pdfPrinting) {
+            for (SymId id : ids) {
+                  draw(id, p, mag, pos, scale);
+                  pos.rx() += (sym(id).advance() * mag);
+                  }
+            return;
+            }
+      int pr            = p->device()->devicePixelRatio();
+      qreal worldScale  = scale * qreal(pr > 0 ? pr : 1);
+      QRgb color        = p->pen().color().rgba();
+
+      QVarLengthArray<QPainter::PixmapFragment, 16> fragments;
+      QPixmap page;
+      auto flush = [&]() {
+            if (!fragments.isEmpty())
+                  p->drawPixmapFragments(fragments.constData(), fragments.size(), page);
+            fragments.clear();
+            };
+
       for (SymId id : ids) {
-            draw(id, p, mag, pos, scale);
+            if (!sym(id).symList().isEmpty() || !isValid(id)) {
+                  flush();
+                  draw(id, p, mag, pos, scale);
+                  }
+            else {
+                  GlyphPixmap gp = glyph(id, mag, worldScale, color);
+                  if (gp.pixmap.isNull()) {         // off the gui thread
+                        flush();
+                        if (!gp.isNull())
+                              gp.draw(p, pos);
+                        }
+                  else {
+                        if (gp.pixmap.cacheKey() != page.cacheKey()) {
+                              flush();
+                              page = gp.pixmap;
+                              }
+                        QRectF r(gp.target(pos));
+                        fragments.append(QPainter::PixmapFragment::create(r.center(), QRectF(gp.rect),
+                           1.0 / gp.worldScale, 1.0 / gp.worldScale));
+                        }
+                  }
             pos.rx() += (sym(id).advance() * mag);
             }
+      flush();
       }
+
 void ScoreFont::draw(const QList<SymId>& ids, QPainter* p, qreal mag, const QPointF& _pos) const
       {
       qreal scale = p->worldTransform().m11();
@@ -5524,7 +5708,7 @@ void ScoreFont::load()
             qDebug("freetype: cannot create face <%s>: %d", qPrintable(facePath), rval);
             return;
             }
-      cache = new QCache<GlyphKey, GlyphPixmap>(100);
+      atlas = new GlyphAtlas;
 
       qreal pixelSize = 200.0;
       FT_Set_Pixel_Sizes(face, 0, int(pixelSize+.5));
@@ -5865,12 +6049,12 @@ ScoreFont::ScoreFont(const ScoreFont& f)
       _filename = f._filename;
 
       // fontImage;
-      cache = 0;
+      atlas = 0;
       }
 
 ScoreFont::~ScoreFont()
       {
-      delete cache;
+      delete atlas;
       }
 }
 
@@ -2589,31 +2589,86 @@ class Sym {
 
 //---------------------------------------------------------
 //   GlyphKey
+//    scale16 is the FreeType scale the glyph is rendered
+//    with; magnifications giving the same scale16 share
+//    the glyph. worldScale is its device pixel ratio.
 //---------------------------------------------------------
 
 struct GlyphKey {
       FT_Face face;
       SymId id;
-      qreal mag;
+      int scale16;
       qreal worldScale;
-      QColor color;
+      QRgb color;
 
    public:
-      GlyphKey(FT_Face _f, SymId _id, float m, float s, QColor c)
-         : face(_f), id(_id), mag(m), worldScale(s), color(c) {}
+      GlyphKey(FT_Face _f, SymId _id, int sc, qreal s, QRgb c)
+         : face(_f), id(_id), scale16(sc), worldScale(s), color(c) {}
       bool operator==(const GlyphKey&) const;
       };
 
+inline uint qHash(const GlyphKey& k, uint seed = 0)
+      {
+      uint h = qHash(quintptr(k.face), seed);
+      h = h * 31 + uint(k.id);
+      h = h * 31 + uint(k.scale16);
+      h = h * 31 + qHash(k.worldScale);
+      return h * 31 + k.color;
+      }
+
+//---------------------------------------------------------
+//   GlyphPixmap
+//    a glyph in the atlas. As returned by ScoreFont::glyph()
+//    it also holds a copy of its atlas page: a pixmap on
+//    the gui thread, an image on other threads.
+//---------------------------------------------------------
 
 struct GlyphPixmap {
-      QPixmap pm;
+      int page { -1 };
+      QRect rect;             // in the atlas page
       QPointF offset;
+      qreal worldScale { 1.0 };
+      QPixmap pixmap;
+      QImage image;
+
+      bool isNull() const { return page < 0; }
+      QRectF target(const QPointF& pos) const {
+            return QRectF(pos + offset, QSizeF(rect.size()) / worldScale);
+            }
+      void draw(QPainter* painter, const QPointF& pos) const;
       };
 
-inline uint qHash(const GlyphKey& k)
-      {
-      return (int(k.id) << 16) + k.mag;
-      }
+//---------------------------------------------------------
+//   GlyphAtlas
+//    rendered glyphs of a score font packed into a few
+//    images. Pages are only appended to; the pixmap of a
+//    page is made on the gui thread, when glyphs were added
+//    to it since. Other threads draw from the page image.
+//---------------------------------------------------------
+
+class GlyphAtlas {
+      struct Page {
+            QImage image;
+            QPixmap pixmap;
+            bool dirty = false;
+            int x = 0, y = 0, rowHeight = 0;
+            };
+      QHash<GlyphKey, GlyphPixmap> _glyphs;
+      QList<Page> _pages;
+
+   public:
+      static const int PAGE_SIZE = 256;
+      static const int MAX_PAGES = 64;
+
+      QMutex mutex;           // also guards the FreeType face
+
+      bool find(const GlyphKey& k, GlyphPixmap* gp) const;
+      GlyphPixmap insert(const GlyphKey& k, const QImage& img, const QPointF& offset);
+      void setPage(GlyphPixmap* gp);
+      void clear();
+      int pages() const       { return _pages.size(); }
+      int glyphs() const      { return _glyphs.size(); }
+      };
 
 //---------------------------------------------------------
 //   ScoreFont
@@ -2627,13 +2682,15 @@ class ScoreFont {
       QString _fontPath;
       QString _filename;
       QByteArray fontImage;
-      QCache<GlyphKey, GlyphPixmap>* cache { 0 };
+      GlyphAtlas* atlas { 0 };
       mutable QFont* font { 0 };
 
       static QVector<ScoreFont> _scoreFonts;
       const Sym& sym(SymId id) const { return _symbols[int(id)]; }
       void load();
       void computeMetrics(Sym* sym, int code);
+      GlyphPixmap glyph(SymId id, qreal mag, qreal worldScale, QRgb color) const;
+      void drawText(SymId id, QPainter* painter, qreal mag, const QPointF& pos) const;
 
    public:
       ScoreFont() {}
@@ -2662,6 +2719,7 @@ class ScoreFont {
       void draw(const QList<SymId>&, QPainter*, qreal mag, const QPointF& pos) const;
       void draw(const QList<SymId>&, QPainter*, qreal mag, const QPointF& pos, qreal scale) const;
       void draw(SymId id, QPainter* painter, qreal mag, const QPointF& pos, int n) const;
+      void clearGlyphCache() const;
 
       qreal height(SymId id, qreal mag) const         { return sym(id).bbox().height() * mag; }
       qreal width(SymId id, qreal mag) const          { return sym(id).bbox().width() * mag;  }
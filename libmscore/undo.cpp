@@ -74,6 +74,8 @@
 #include "sym.h"
 #include "utils.h"
 #include "glissando.h"
+#include "stem.h"
+#include "hook.h"
 
 namespace Ms {
 
@@ -112,6 +114,82 @@ void updateNoteLines(Segment* segment, int track)
             }
       }
 
+//---------------------------------------------------------
+//   elementLayoutRange
+//    compute the tick range an element change may affect;
+//    return false if the change can affect the whole score
+//---------------------------------------------------------
+
+static bool elementLayoutRange(const Element* e, int* stick, int* etick)
+      {
+      if (!e)
+            return false;
+      switch (e->type()) {
+            case Element::Type::MEASURE:
+            case Element::Type::HBOX:
+            case Element::Type::VBOX:
+            case Element::Type::TBOX:
+            case Element::Type::FBOX:
+            case Element::Type::CLEF:
+            case Element::Type::KEYSIG:
+            case Element::Type::TIMESIG:
+            case Element::Type::BAR_LINE:
+            case Element::Type::INSTRUMENT_CHANGE:
+            case Element::Type::LAYOUT_BREAK:
+            case Element::Type::SPACER:
+            case Element::Type::SYSTEM:
+            case Element::Type::PAGE:
+                  return false;
+            case Element::Type::TIE: {
+                  const Tie* tie = static_cast<const Tie*>(e);
+                  if (!tie->startNote())
+                        return false;
+                  *stick = tie->startNote()->chord()->tick();
+                  *etick = tie->endNote() ? tie->endNote()->chord()->tick() : *stick;
+                  return true;
+                  }
+            case Element::Type::BEAM: {
+                  const Beam* beam = static_cast<const Beam*>(e);
+                  if (beam->elements().isEmpty())
+                        return false;
+                  *stick = beam->elements().front()->tick();
+                  *etick = beam->elements().back()->tick();
+                  return true;
+                  }
+            case Element::Type::TUPLET:
+                  *stick = static_cast<const Tuplet*>(e)->tick();
+                  *etick = *stick + static_cast<const Tuplet*>(e)->actualTicks();
+                  return true;
+            default:
+                  break;
+            }
+      if (e->isSpannerSegment())
+            return elementLayoutRange(static_cast<const SpannerSegment*>(e)->spanner(), stick, etick);
+      if (e->isSpanner()) {
+            const Spanner* sp = static_cast<const Spanner*>(e);
+            *stick = sp->tick();
+            *etick = sp->tick2();
+            return true;
+            }
+      for (const Element* p = e->parent(); p; p = p->parent()) {
+            if (p->type() == Element::Type::SEGMENT) {
+                  *stick = static_cast<const Segment*>(p)->tick();
+                  *etick = *stick;
+                  return true;
+                  }
+            if (p->type() == Element::Type::TUPLET || p->type() == Element::Type::BEAM)
+                  return elementLayoutRange(p, stick, etick);
+            // elements of a measure or frame itself (breaks, spacers)
+            // can change system and page breaks after it
+            if (p->type() == Element::Type::MEASURE || p->type() == Element::Type::HBOX
+               || p->type() == Element::Type::VBOX || p->type() == Element::Type::TBOX
+               || p->type() == Element::Type::FBOX) {
+                  return false;
+                  }
+            }
+      return false;
+      }
+
 //---------------------------------------------------------
 //   UndoCommand
 //---------------------------------------------------------
@@ -164,6 +242,21 @@ void UndoCommand::redo()
       flip();
       }
 
+//---------------------------------------------------------
+//   memoryUsage
+//    estimated bytes held by the command and its children;
+//    commands owning score elements add them, see
+//    elementMemoryUsage()
+//---------------------------------------------------------
+
+int UndoCommand::memoryUsage() const
+      {
+      int n = objectSize() + childList.size() * int(sizeof(UndoCommand*));
+      for (auto c : childList)
+            n += c->memoryUsage();
+      return n;
+      }
+
 //---------------------------------------------------------
 //   unwind
 //---------------------------------------------------------
@@ -186,6 +279,11 @@ UndoStack::UndoStack()
       curCmd   = 0;
       curIdx   = 0;
       cleanIdx = 0;
+      _memoryUsage = 0;
+      _layoutStartTick = -1;
+      _layoutEndTick   = -1;
+      _layoutRangeAll  = false;
+      _changeStamp     = 0;
       }
 
 //---------------------------------------------------------
@@ -211,6 +309,9 @@ void UndoStack::beginMacro()
             return;
             }
       curCmd = new UndoCommand();
+      _layoutStartTick = -1;
+      _layoutEndTick   = -1;
+      _layoutRangeAll  = false;
       if (MScore::debugMode)
             qDebug("UndoStack::beginMacro %p, UndoStack %p", curCmd, this);
       }
@@ -227,21 +328,104 @@ void UndoStack::endMacro(bool rollback)
             qDebug("UndoStack:endMacro(): not active");
             return;
             }
+      // a rolled back macro may have executed commands too
+      if (curCmd->childCount())
+            addMacroChange();
       if (rollback)
             delete curCmd;
       else {
             // remove redo stack
-            while (list.size() > curIdx) {
-                  UndoCommand* cmd = list.takeLast();
-                  cmd->cleanup(false);  // delete elements for which UndoCommand() holds ownership
-                  delete cmd;
+            while (list.size() > curIdx)
+                  removeLast();
+            if (cleanIdx > curIdx)
+                  cleanIdx = -1;          // the saved state is gone
+            if (!mergeMacro()) {
+                  int size = curCmd->memoryUsage();
+                  list.append(curCmd);
+                  sizeList.append(size);
+                  _memoryUsage += size;
+                  ++curIdx;
+                  trim();
                   }
-            list.append(curCmd);
-            ++curIdx;
+            _lastMacro.start();
             }
       curCmd = 0;
       }
 
+//---------------------------------------------------------
+//   mergeMacro
+//    merge the current macro into the previous one if both
+//    change the same properties of the same elements and
+//    follow each other within MScore::undoMergeInterval,
+//    as for instance when dragging; the previous macro
+//    keeps the values to undo to
+//---------------------------------------------------------
+
+bool UndoStack::mergeMacro()
+      {
+      if (MScore::undoMergeInterval <= 0 || curIdx == 0 || cleanIdx == curIdx
+         || !_lastMacro.isValid() || _lastMacro.elapsed() > MScore::undoMergeInterval)
+            return false;
+      const QList<UndoCommand*>& pl = list[curIdx-1]->commands();
+      const QList<UndoCommand*>& cl = curCmd->commands();
+      if (pl.size() != cl.size())
+            return false;
+      for (int i = 0; i < cl.size(); ++i) {
+            if (!cl[i]->canMerge(pl[i]))
+                  return false;
+            }
+      for (int i = 0; i < cl.size(); ++i)
+            pl[i]->merge(cl[i]);
+      delete curCmd;
+      return true;
+      }
+
+//---------------------------------------------------------
+//   removeFirst
+//    drop the oldest undo step
+//---------------------------------------------------------
+
+void UndoStack::removeFirst()
+      {
+      UndoCommand* cmd = list.takeFirst();
+      _memoryUsage -= sizeList.takeFirst();
+      cmd->cleanup(true);
+      delete cmd;
+      --curIdx;
+      if (cleanIdx > 0)
+            --cleanIdx;
+      else
+            cleanIdx = -1;
+      }
+
+//---------------------------------------------------------
+//   removeLast
+//    drop the newest redo step
+//---------------------------------------------------------
+
+void UndoStack::removeLast()
+      {
+      UndoCommand* cmd = list.takeLast();
+      _memoryUsage -= sizeList.takeLast();
+      cmd->cleanup(false);  // delete elements for which UndoCommand() holds ownership
+      delete cmd;
+      }
+
+//---------------------------------------------------------
+//   trim
+//    drop the oldest undo steps until the stack is within
+//    MScore::undoLimit and MScore::undoMemoryLimit; the
+//    last step is always kept
+//---------------------------------------------------------
+
+void UndoStack::trim()
+      {
+      while (curIdx > 1
+         && ((MScore::undoLimit > 0 && list.size() > MScore::undoLimit)
+            || (MScore::undoMemoryLimit > 0 && _memoryUsage > MScore::undoMemoryLimit)))
+            removeFirst();
+      }
+
 //---------------------------------------------------------
 //   push
 //---------------------------------------------------------
@@ -254,6 +438,7 @@ void UndoStack::push(UndoCommand* cmd)
 
             cmd->redo();
             delete cmd;
+            addChange(-1, -1);
             return;
             }
 #ifdef DEBUG_UNDO
@@ -265,8 +450,16 @@ void UndoStack::push(UndoCommand* cmd)
             qDebug("UndoStack::push <%s> %p", cmd->name(), cmd);
             }
 #endif
+      addLayoutRange(cmd);
       curCmd->appendChild(cmd);
       cmd->redo();
+
+      // a command which can be merged with the previous one
+      // of the macro is not needed once it is done
+      const QList<UndoCommand*>& cl = curCmd->commands();
+      int n = cl.size();
+      if (n > 1 && cl[n-1] == cmd && cmd->canMerge(cl[n-2]))
+            delete curCmd->removeChild();
       }
 
 //---------------------------------------------------------
@@ -275,12 +468,113 @@ void UndoStack::push(UndoCommand* cmd)
 
 void UndoStack::push1(UndoCommand* cmd)
       {
-      if (curCmd)
+      if (curCmd) {
+            addLayoutRange(cmd);
             curCmd->appendChild(cmd);
+            }
       else
             qDebug("UndoStack:push1(): no active command, UndoStack %p", this);
       }
 
+//---------------------------------------------------------
+//   addLayoutRange
+//    extend the dirty tick range of the current macro;
+//    a command which cannot tell its range forces a
+//    complete relayout
+//---------------------------------------------------------
+
+void UndoStack::addLayoutRange(const UndoCommand* cmd)
+      {
+      if (_layoutRangeAll)
+            return;
+      int stick, etick;
+      if (!cmd->layoutTickRange(&stick, &etick) || stick < 0) {
+            _layoutRangeAll = true;
+            return;
+            }
+      if (etick < stick)
+            etick = stick;
+      if (_layoutStartTick == -1 || stick < _layoutStartTick)
+            _layoutStartTick = stick;
+      if (etick > _layoutEndTick)
+            _layoutEndTick = etick;
+      }
+
+//---------------------------------------------------------
+//   setLayoutRange
+//    the tick range of all commands of an undone or
+//    redone macro
+//---------------------------------------------------------
+
+void UndoStack::setLayoutRange(const UndoCommand* macro)
+      {
+      _layoutStartTick = -1;
+      _layoutEndTick   = -1;
+      _layoutRangeAll  = false;
+      for (const UndoCommand* cmd : macro->commands())
+            addLayoutRange(cmd);
+      }
+
+//---------------------------------------------------------
+//   addChange
+//    append to the list of changed tick ranges; only the
+//    last ones are kept, a cache which missed more of them
+//    has to be rebuilt
+//---------------------------------------------------------
+
+void UndoStack::addChange(int stick, int etick)
+      {
+      _changes.append(qMakePair(stick, etick));
+      if (_changes.size() > 64)
+            _changes.removeFirst();
+      ++_changeStamp;
+      }
+
+//---------------------------------------------------------
+//   addMacroChange
+//    add the tick range of the current, undone or redone
+//    macro
+//---------------------------------------------------------
+
+void UndoStack::addMacroChange()
+      {
+      int stick, etick;
+      if (layoutRange(&stick, &etick))
+            addChange(stick, etick);
+      else
+            addChange(-1, -1);
+      }
+
+//---------------------------------------------------------
+//   changes
+//    the tick ranges changed since changeStamp() returned
+//    stamp; return false if they are not known anymore
+//---------------------------------------------------------
+
+bool UndoStack::changes(int stamp, QList<QPair<int,int>>* ranges) const
+      {
+      int n = _changeStamp - stamp;
+      if (n < 0 || n > _changes.size())
+            return false;
+      *ranges = _changes.mid(_changes.size() - n);
+      return true;
+      }
+
+//---------------------------------------------------------
+//   layoutRange
+//    return true if all commands of the current macro
+//    reported their tick range
+//---------------------------------------------------------
+
+bool UndoStack::layoutRange(int* stick, int* etick) const
+      {
+      if (_layoutRangeAll || _layoutStartTick == -1)
+            return false;
+      *stick = _layoutStartTick;
+      *etick = _layoutEndTick;
+      return true;
+      }
+
 //---------------------------------------------------------
 //   pop
 //---------------------------------------------------------
@@ -304,6 +598,7 @@ void UndoStack::setClean()
       if (cleanIdx != curIdx) {
             cleanIdx = curIdx;
             }
+      _lastMacro.invalidate();
       }
 
 //---------------------------------------------------------
@@ -318,7 +613,10 @@ void UndoStack::undo()
             if (MScore::debugMode)
                   qDebug("--undo index %d", curIdx);
             list[curIdx]->undo();
+            setLayoutRange(list[curIdx]);
+            addMacroChange();
             }
+      _lastMacro.invalidate();
       }
 
 //---------------------------------------------------------
@@ -330,8 +628,11 @@ void UndoStack::redo()
       if (canRedo()) {
             if (MScore::debugMode)
                   qDebug("--redo index %d", curIdx);
-            list[curIdx++]->redo();
+            list[curIdx]->redo();
+            setLayoutRange(list[curIdx++]);
+            addMacroChange();
             }
+      _lastMacro.invalidate();
       }
 
 //---------------------------------------------------------
@@ -361,6 +662,32 @@ void SaveState::redo()
       score->setSelection(redoSelection);
       }
 
+//---------------------------------------------------------
+//   SaveState::memoryUsage
+//    the input states and selections are held by value
+//    and counted by objectSize(); the lists of selected
+//    elements are not
+//---------------------------------------------------------
+
+int SaveState::memoryUsage() const
+      {
+      return UndoCommand::memoryUsage()
+         + (undoSelection.elements().size() + redoSelection.elements().size()) * int(sizeof(Element*));
+      }
+
+//---------------------------------------------------------
+//   SaveState::merge
+//    redoing the merged macro restores the state after
+//    the last of its parts
+//---------------------------------------------------------
+
+void SaveState::merge(const UndoCommand* c)
+      {
+      const SaveState* s = static_cast<const SaveState*>(c);
+      redoInputState = s->redoInputState;
+      redoSelection  = s->redoSelection;
+      }
+
 //---------------------------------------------------------
 //   undoChangeProperty
 //---------------------------------------------------------
@@ -1534,6 +1861,15 @@ AddElement::AddElement(Element* e)
       element = e;
       }
 
+//---------------------------------------------------------
+//   AddElement::layoutTickRange
+//---------------------------------------------------------
+
+bool AddElement::layoutTickRange(int* stick, int* etick) const
+      {
+      return elementLayoutRange(element, stick, etick);
+      }
+
 //---------------------------------------------------------
 //   AddElement::cleanup
 //---------------------------------------------------------
@@ -1573,6 +1909,99 @@ static void undoAddTuplet(DurationElement* cr)
             }
       }
 
+//---------------------------------------------------------
+//   elementSize
+//    the size of the most common element classes, others
+//    are counted as Element
+//---------------------------------------------------------
+
+static int elementSize(const Element* e)
+      {
+      switch (e->type()) {
+            case Element::Type::NOTE:         return sizeof(Note);
+            case Element::Type::CHORD:        return sizeof(Chord);
+            case Element::Type::REST:         return sizeof(Rest);
+            case Element::Type::STEM:         return sizeof(Stem);
+            case Element::Type::HOOK:         return sizeof(Hook);
+            case Element::Type::ACCIDENTAL:   return sizeof(Accidental);
+            case Element::Type::ARTICULATION: return sizeof(Articulation);
+            case Element::Type::SEGMENT:      return sizeof(Segment);
+            case Element::Type::MEASURE:      return sizeof(Measure);
+            default:                          return sizeof(Element);
+            }
+      }
+
+//---------------------------------------------------------
+//   elementMemoryUsage
+//    estimated bytes of e and the elements it owns; used
+//    for commands which own an element while it is not
+//    part of the score
+//---------------------------------------------------------
+
+static int elementMemoryUsage(const Element* e)
+      {
+      int n = elementSize(e);
+      switch (e->type()) {
+            case Element::Type::CHORD: {
+                  const Chord* c = static_cast<const Chord*>(e);
+                  for (const Note* note : c->notes())
+                        n += elementMemoryUsage(note);
+                  for (const Chord* gc : c->graceNotes())
+                        n += elementMemoryUsage(gc);
+                  if (c->stem())
+                        n += elementSize(c->stem());
+                  if (c->hook())
+                        n += elementSize(c->hook());
+                  }
+                  // fall through
+            case Element::Type::REST: {
+                  const ChordRest* cr = static_cast<const ChordRest*>(e);
+                  for (const Articulation* a : cr->articulations())
+                        n += elementSize(a);
+                  }
+                  break;
+            case Element::Type::NOTE: {
+                  const Note* note = static_cast<const Note*>(e);
+                  if (note->accidental())
+                        n += elementSize(note->accidental());
+                  for (const Element* el : note->el())
+                        n += elementMemoryUsage(el);
+                  }
+                  break;
+            case Element::Type::SEGMENT: {
+                  const Segment* s = static_cast<const Segment*>(e);
+                  for (const Element* el : s->elist()) {
+                        if (el)
+                              n += elementMemoryUsage(el);
+                        }
+                  for (const Element* el : s->annotations())
+                        n += elementMemoryUsage(el);
+                  }
+                  break;
+            case Element::Type::MEASURE:
+                  for (const Segment* s = static_cast<const Measure*>(e)->first(); s; s = s->next())
+                        n += elementMemoryUsage(s);
+                  break;
+            default:
+                  break;
+            }
+      return n;
+      }
+
+//---------------------------------------------------------
+//   memoryUsage
+//---------------------------------------------------------
+
+int AddElement::memoryUsage() const
+      {
+      return UndoCommand::memoryUsage() + elementMemoryUsage(element);
+      }
+
+int RemoveElement::memoryUsage() const
+      {
+      return UndoCommand::memoryUsage() + elementMemoryUsage(element);
+      }
+
 //---------------------------------------------------------
 //   endUndoRedo
 //---------------------------------------------------------
@@ -1697,6 +2126,16 @@ RemoveElement::RemoveElement(Element* e)
             }
       }
 
+
+//---------------------------------------------------------
+//   RemoveElement::layoutTickRange
+//---------------------------------------------------------
+
+bool RemoveElement::layoutTickRange(int* stick, int* etick) const
+      {
+      return elementLayoutRange(element, stick, etick);
+      }
+
 //---------------------------------------------------------
 //   AddElement::cleanup
 //---------------------------------------------------------
@@ -1949,6 +2388,11 @@ ChangePitch::ChangePitch(Note* _note, int _pitch, int _tpc1, int _tpc2)
       tpc2  = _tpc2;
       }
 
+bool ChangePitch::layoutTickRange(int* stick, int* etick) const
+      {
+      return elementLayoutRange(note, stick, etick);
+      }
+
 void ChangePitch::flip()
       {
       int f_pitch = note->pitch();
@@ -3407,6 +3851,51 @@ void ChangeStaffUserDist::flip()
       staff->score()->setLayoutAll(true);
       }
 
+//---------------------------------------------------------
+//   ChangeProperty::layoutTickRange
+//---------------------------------------------------------
+
+bool ChangeProperty::layoutTickRange(int* stick, int* etick) const
+      {
+      if (id == P_ID::SPANNER_TICK || id == P_ID::SPANNER_TICKS)
+            return false;
+      return elementLayoutRange(dynamic_cast<Element*>(element), stick, etick);
+      }
+
+//---------------------------------------------------------
+//   ChangeProperty::memoryUsage
+//---------------------------------------------------------
+
+int ChangeProperty::memoryUsage() const
+      {
+      int n = UndoCommand::memoryUsage();
+      switch (property.type()) {
+            case QVariant::String:
+                  n += property.toString().size() * int(sizeof(QChar));
+                  break;
+            case QVariant::ByteArray:
+                  n += property.toByteArray().size();
+                  break;
+            case QVariant::List:
+                  n += property.toList().size() * int(sizeof(QVariant));
+                  break;
+            default:
+                  break;
+            }
+      return n;
+      }
+
+//---------------------------------------------------------
+//   ChangeProperty::canMerge
+//    a change of the same property of the same element
+//---------------------------------------------------------
+
+bool ChangeProperty::canMerge(const UndoCommand* c) const
+      {
+      const ChangeProperty* cp = dynamic_cast<const ChangeProperty*>(c);
+      return cp && cp->element == element && cp->id == id;
+      }
+
 //---------------------------------------------------------
 //   ChangeProperty::flip
 //---------------------------------------------------------
@@ -84,9 +84,10 @@ enum class PlayEventType : char;
 // #define DEBUG_UNDO
 
 #ifdef DEBUG_UNDO
-#define UNDO_NAME(a)  virtual const char* name() const { return a; }
+#define UNDO_NAME(a)  virtual const char* name() const { return a; } \
+                      virtual int objectSize() const { return sizeof(*this); }
 #else
-#define UNDO_NAME(a)
+#define UNDO_NAME(a)  virtual int objectSize() const { return sizeof(*this); }
 #endif
 
 enum class LayoutMode : char;
@@ -100,6 +101,7 @@ class UndoCommand {
 
    protected:
       virtual void flip() {}
+      virtual int objectSize() const     { return sizeof(*this); }
 
    public:
       virtual ~UndoCommand();
@@ -108,8 +110,13 @@ class UndoCommand {
       void appendChild(UndoCommand* cmd) { childList.append(cmd);       }
       UndoCommand* removeChild()         { return childList.takeLast(); }
       int childCount() const             { return childList.size();     }
+      const QList<UndoCommand*>& commands() const { return childList; }
       void unwind();
       virtual void cleanup(bool undo);
+      virtual bool layoutTickRange(int* /*stick*/, int* /*etick*/) const { return false; }
+      virtual int memoryUsage() const;
+      virtual bool canMerge(const UndoCommand*) const { return false; }
+      virtual void merge(const UndoCommand*) {}     ///< take the redo state of a merged command
 #ifdef DEBUG_UNDO
       virtual const char* name() const  { return "UndoCommand"; }
 #endif
@@ -122,8 +129,32 @@ class UndoCommand {
 class UndoStack {
       UndoCommand* curCmd;
       QList<UndoCommand*> list;
+      QList<int> sizeList;          ///< memoryUsage() of the commands in list
       int curIdx;
       int cleanIdx;
+      qint64 _memoryUsage;
+      QElapsedTimer _lastMacro;     ///< end of the last macro, invalid if it must not be merged
+
+      // tick range touched by the commands of the current macro
+      // or of the last undone or redone one; used to restrict
+      // layout and the rendering of playback events
+      int _layoutStartTick;
+      int _layoutEndTick;
+      bool _layoutRangeAll;         ///< a command without known tick range was pushed
+
+      // tick ranges of the last macros, undos and redos for the
+      // playback event caches of the scores, see changes()
+      QList<QPair<int,int>> _changes;     ///< (-1, -1): unknown range
+      int _changeStamp;                   ///< number of changes so far
+
+      void addLayoutRange(const UndoCommand*);
+      void setLayoutRange(const UndoCommand* macro);
+      void addChange(int stick, int etick);
+      void addMacroChange();
+      bool mergeMacro();
+      void removeFirst();
+      void removeLast();
+      void trim();
 
    public:
       UndoStack();
@@ -143,6 +174,15 @@ class UndoStack {
       UndoCommand* current() const  { return curCmd;               }
       void undo();
       void redo();
+
+      int count() const             { return list.size();          }
+      qint64 memoryUsage() const    { return _memoryUsage;         }
+
+      void setLayoutRangeAll()      { _layoutRangeAll = true;      }
+      bool layoutRange(int* stick, int* etick) const;
+
+      int changeStamp() const       { return _changeStamp;         }
+      bool changes(int stamp, QList<QPair<int,int>>* ranges) const;
       };
 
 //---------------------------------------------------------
@@ -160,6 +200,9 @@ class SaveState : public UndoCommand {
       SaveState(Score*);
       virtual void undo();
       virtual void redo();
+      virtual int memoryUsage() const;
+      virtual bool canMerge(const UndoCommand* c) const { return dynamic_cast<const SaveState*>(c) != 0; }
+      virtual void merge(const UndoCommand*);
       UNDO_NAME("SaveState")
       };
 
@@ -316,6 +359,7 @@ class ChangePitch : public UndoCommand {
 
    public:
       ChangePitch(Note* note, int pitch, int tpc1, int tpc2);
+      virtual bool layoutTickRange(int* stick, int* etick) const;
       UNDO_NAME("ChangePitch")
       };
 
@@ -574,6 +618,9 @@ class AddElement : public UndoCommand {
       virtual void undo();
       virtual void redo();
       virtual void cleanup(bool);
+      virtual bool layoutTickRange(int* stick, int* etick) const;
+      virtual int memoryUsage() const;
+      virtual int objectSize() const { return sizeof(*this); }
 #ifdef DEBUG_UNDO
       virtual const char* name() const;
 #endif
@@ -591,6 +638,9 @@ class RemoveElement : public UndoCommand {
       virtual void undo();
       virtual void redo();
       virtual void cleanup(bool);
+      virtual bool layoutTickRange(int* stick, int* etick) const;
+      virtual int memoryUsage() const;
+      virtual int objectSize() const { return sizeof(*this); }
 #ifdef DEBUG_UNDO
       virtual const char* name() const;
 #endif
@@ -1097,6 +1147,9 @@ class ChangeProperty : public UndoCommand {
       ChangeProperty(ScoreElement* e, P_ID i, const QVariant& v, PropertyStyle ps = PropertyStyle::NOSTYLE)
          : element(e), id(i), property(v), propertyStyle(ps) {}
       P_ID getId() const  { return id; }
+      virtual bool layoutTickRange(int* stick, int* etick) const;
+      virtual int memoryUsage() const;
+      virtual bool canMerge(const UndoCommand*) const;
       UNDO_NAME("ChangeProperty")
       };
 
@@ -46,17 +46,13 @@ Measure* Score::tick2measure(int tick) const
       {
       if (tick == -1)
             return lastMeasure();
-      Measure* lm = 0;
-
-      for (Measure* m = firstMeasure(); m; m = m->nextMeasure()) {
-            if (tick < m->tick())
-                  return lm;
-            lm = m;
-            }
+      Measure* lm = _measures.tick2measure(tick);
+      if (!lm || lm->nextMeasure())
+            return lm;
       // check last measure
-      if (lm && (tick >= lm->tick()) && (tick <= lm->endTick()))
+      if ((tick >= lm->tick()) && (tick <= lm->endTick()))
             return lm;
-      qDebug("tick2measure %d (max %d) not found", tick, lm ? lm->tick() : -1);
+      qDebug("tick2measure %d (max %d) not found", tick, lm->tick());
       return 0;
       }
 
@@ -68,18 +64,23 @@ Measure* Score::tick2measureMM(int tick) const
       {
       if (tick == -1)
             return lastMeasureMM();
-      Measure* lm = 0;
-
-      for (Measure* m = firstMeasureMM(); m; m = m->nextMeasureMM()) {
-            if (tick < m->tick())
-                  return lm;
-            lm = m;
+      Measure* lm = _measures.tick2measure(tick);
+      if (!lm)
+            return 0;
+      if (!lm->nextMeasure() && tick > lm->endTick()) {
+            qDebug("tick2measureMM %d (max %d) not found", tick, lm->tick());
+            return 0;
             }
-      // check last measure
-      if (lm && (tick >= lm->tick()) && (tick <= lm->endTick()))
-            return lm;
-      qDebug("tick2measureMM %d (max %d) not found", tick, lm ? lm->tick() : -1);
-      return 0;
+      if (styleB(StyleIdx::createMultiMeasureRests)) {
+            // a measure covered by a mm rest is represented by the
+            // mm rest which starts with the first measure of the range
+            Measure* m = lm;
+            while (m->mmRestCount() < 0 && m->prevMeasure())
+                  m = m->prevMeasure();
+            if (m->hasMMRest())
+                  return m->mmRest();
+            }
+      return lm;
       }
 
 //---------------------------------------------------------
@@ -129,15 +130,17 @@ Segment* Score::tick2segment(int tick, bool first, Segment::Type st, bool useMMr
             if (pm)
                   m = pm;
             }
-      for (Segment* segment = m->first(st); segment;) {
-            int t1 = segment->tick();
-            Segment* nsegment = segment->next(st);
-            int t2 = nsegment ? nsegment->tick() : INT_MAX;
-            if ((tick == t1) && (first || (tick < t2)))
-                  return segment;
-            segment = nsegment;
+      // binary search for the segments at tick; return the first
+      // or last one of type st
+      Segment* found = 0;
+      for (Segment* segment = m->segments()->lowerBound(tick - m->tick()); segment && segment->tick() == tick; segment = segment->next()) {
+            if (!(segment->segmentType() & st))
+                  continue;
+            found = segment;
+            if (first)
+                  break;
             }
-      return 0;
+      return found;
       }
 
 //---------------------------------------------------------
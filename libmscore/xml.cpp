@@ -29,16 +29,15 @@ QString docName;
 
 int XmlReader::intAttribute(const char* s, int _default) const
       {
-      if (attributes().hasAttribute(s))
-            // return attributes().value(s).toString().toInt();
-            return attributes().value(s).toInt();
-      else
-            return _default;
+      const XmlStreamAttributes a = attributes();
+      QStringRef v = a.value(QLatin1String(s));
+      return v.isNull() ? _default : v.toInt();
       }
 
 int XmlReader::intAttribute(const char* s) const
       {
-      return attributes().value(s).toInt();
+      const XmlStreamAttributes a = attributes();
+      return a.value(QLatin1String(s)).toInt();
       }
 
 //---------------------------------------------------------
@@ -47,15 +46,15 @@ int XmlReader::intAttribute(const char* s) const
 
 double XmlReader::doubleAttribute(const char* s) const
       {
-      return attributes().value(s).toDouble();
+      const XmlStreamAttributes a = attributes();
+      return a.value(QLatin1String(s)).toDouble();
       }
 
 double XmlReader::doubleAttribute(const char* s, double _default) const
       {
-      if (attributes().hasAttribute(s))
-            return attributes().value(s).toDouble();
-      else
-            return _default;
+      const XmlStreamAttributes a = attributes();
+      QStringRef v = a.value(QLatin1String(s));
+      return v.isNull() ? _default : v.toDouble();
       }
 
 //---------------------------------------------------------
@@ -64,10 +63,9 @@ double XmlReader::doubleAttribute(const char* s, double _default) const
 
 QString XmlReader::attribute(const char* s, const QString& _default) const
       {
-      if (attributes().hasAttribute(s))
-            return attributes().value(s).toString();
-      else
-            return _default;
+      const XmlStreamAttributes a = attributes();
+      QStringRef v = a.value(QLatin1String(s));
+      return v.isNull() ? _default : v.toString();
       }
 
 //---------------------------------------------------------
@@ -76,7 +74,207 @@ QString XmlReader::attribute(const char* s, const QString& _default) const
 
 bool XmlReader::hasAttribute(const char* s) const
       {
-      return attributes().hasAttribute(s);
+      return attributes().hasAttribute(QLatin1String(s));
+      }
+
+//---------------------------------------------------------
+//   tagList
+//    always: tagList[int(id)].id == id
+//---------------------------------------------------------
+
+struct XmlTagName {
+      XmlTag id;
+      const char* name;
+      };
+
+static const XmlTagName tagList[] = {
+      { XmlTag::ACCIDENTAL,                "Accidental" },
+      { XmlTag::AMBITUS,                   "Ambitus" },
+      { XmlTag::BAR_LINE,                  "BarLine" },
+      { XmlTag::BEAM,                      "Beam" },
+      { XmlTag::BEND,                      "Bend" },
+      { XmlTag::BREATH,                    "Breath" },
+      { XmlTag::CHORD,                     "Chord" },
+      { XmlTag::CLEF,                      "Clef" },
+      { XmlTag::DYNAMIC,                   "Dynamic" },
+      { XmlTag::EVENTS,                    "Events" },
+      { XmlTag::FIGURED_BASS,              "FiguredBass" },
+      { XmlTag::FINGERING,                 "Fingering" },
+      { XmlTag::FRET_DIAGRAM,              "FretDiagram" },
+      { XmlTag::GLISSANDO,                 "Glissando" },
+      { XmlTag::HAIR_PIN,                  "HairPin" },
+      { XmlTag::HARMONY,                   "Harmony" },
+      { XmlTag::IMAGE,                     "Image" },
+      { XmlTag::INSTRUMENT_CHANGE,         "InstrumentChange" },
+      { XmlTag::JUMP,                      "Jump" },
+      { XmlTag::KEY_SIG,                   "KeySig" },
+      { XmlTag::LAYOUT_BREAK,              "LayoutBreak" },
+      { XmlTag::LYRICS,                    "Lyrics" },
+      { XmlTag::MARKER,                    "Marker" },
+      { XmlTag::MEASURE_NUMBER,            "MeasureNumber" },
+      { XmlTag::NOTE_DOT,                  "NoteDot" },
+      { XmlTag::OTTAVA,                    "Ottava" },
+      { XmlTag::PEDAL,                     "Pedal" },
+      { XmlTag::REHEARSAL_MARK,            "RehearsalMark" },
+      { XmlTag::REPEAT_MEASURE,            "RepeatMeasure" },
+      { XmlTag::REST,                      "Rest" },
+      { XmlTag::SEGMENT,                   "Segment" },
+      { XmlTag::SLUR,                      "Slur" },
+      { XmlTag::STAFF_STATE,               "StaffState" },
+      { XmlTag::STAFF_TEXT,                "StaffText" },
+      { XmlTag::SYMBOL,                    "Symbol" },
+      { XmlTag::TEMPO,                     "Tempo" },
+      { XmlTag::TEXT,                      "Text" },
+      { XmlTag::TEXT_LINE,                 "TextLine" },
+      { XmlTag::TIE,                       "Tie" },
+      { XmlTag::TIME_SIG,                  "TimeSig" },
+      { XmlTag::TREMOLO_BAR,               "TremoloBar" },
+      { XmlTag::TRILL,                     "Trill" },
+      { XmlTag::TUPLET,                    "Tuplet" },
+      { XmlTag::VOLTA,                     "Volta" },
+      { XmlTag::BREAK_MULTI_MEASURE_REST,  "breakMultiMeasureRest" },
+      { XmlTag::DOT_POSITION,              "dotPosition" },
+      { XmlTag::END_REPEAT,                "endRepeat" },
+      { XmlTag::END_SPANNER,               "endSpanner" },
+      { XmlTag::FIXED,                     "fixed" },
+      { XmlTag::FIXED_LINE,                "fixedLine" },
+      { XmlTag::FRET,                      "fret" },
+      { XmlTag::GHOST,                     "ghost" },
+      { XmlTag::HEAD,                      "head" },
+      { XmlTag::HEAD_TYPE,                 "headType" },
+      { XmlTag::IRREGULAR,                 "irregular" },
+      { XmlTag::LINE,                      "line" },
+      { XmlTag::MEASURE_NUMBER_MODE,       "measureNumberMode" },
+      { XmlTag::MIRROR,                    "mirror" },
+      { XmlTag::MOVE,                      "move" },
+      { XmlTag::MULTI_MEASURE_REST,        "multiMeasureRest" },
+      { XmlTag::NO_OFFSET,                 "noOffset" },
+      { XmlTag::OFF_TIME_OFFSET,           "offTimeOffset" },
+      { XmlTag::OFF_TIME_TYPE,             "offTimeType" },
+      { XmlTag::OFFSET,                    "offset" },
+      { XmlTag::ON_TIME_OFFSET,            "onTimeOffset" },
+      { XmlTag::ON_TIME_TYPE,              "onTimeType" },
+      { XmlTag::PITCH,                     "pitch" },
+      { XmlTag::PLAY,                      "play" },
+      { XmlTag::SLASH_STYLE,               "slashStyle" },
+      { XmlTag::SMALL,                     "small" },
+      { XmlTag::START_REPEAT,              "startRepeat" },
+      { XmlTag::STRETCH,                   "stretch" },
+      { XmlTag::STRING,                    "string" },
+      { XmlTag::SYS_INIT_BAR_LINE_TYPE,    "sysInitBarLineType" },
+      { XmlTag::TICK,                      "tick" },
+      { XmlTag::TPC,                       "tpc" },
+      { XmlTag::TPC2,                      "tpc2" },
+      { XmlTag::TUNING,                    "tuning" },
+      { XmlTag::USER_ACCIDENTAL,           "userAccidental" },
+      { XmlTag::VELO_TYPE,                 "veloType" },
+      { XmlTag::VELOCITY,                  "velocity" },
+      { XmlTag::VISIBLE,                   "visible" },
+      { XmlTag::VSPACER,                   "vspacer" },
+      { XmlTag::VSPACER_DOWN,              "vspacerDown" },
+      { XmlTag::VSPACER_UP,                "vspacerUp" },
+      };
+
+//---------------------------------------------------------
+//   tagId
+//    id of the current element name, XmlTag::UNKNOWN for
+//    names not in tagList
+//---------------------------------------------------------
+
+XmlTag XmlReader::tagId() const
+      {
+      const QStringRef tag(name());
+      int l = 0;
+      int h = int(XmlTag::UNKNOWN) - 1;
+      while (l <= h) {
+            int m = (l + h) / 2;
+            int c = tag.compare(QLatin1String(tagList[m].name));
+            if (c == 0)
+                  return tagList[m].id;
+            if (c < 0)
+                  h = m - 1;
+            else
+                  l = m + 1;
+            }
+      return XmlTag::UNKNOWN;
+      }
+
+//---------------------------------------------------------
+//   readNumber
+//    convert the text of the current element; the usual
+//    single chunk of text is converted where the reader
+//    holds it, without building a QString as
+//    readElementText() does
+//---------------------------------------------------------
+
+template <typename T, typename F>
+static T readNumber(XmlReader& e, F convert)
+      {
+      if (!e.isStartElement())
+            return convert(QStringRef());
+      QVarLengthArray<QChar, 32> chunk;
+      XmlStreamReader::TokenType tt = e.readNext();
+      if (tt == XmlStreamReader::EndElement)
+            return convert(QStringRef());
+      if (tt == XmlStreamReader::Characters) {
+            QStringRef t = e.text();
+            T val = convert(t);
+            chunk.append(t.unicode(), t.size());
+            tt = e.readNext();
+            if (tt == XmlStreamReader::EndElement)
+                  return val;
+            }
+      // text with entities or comments: collect it all
+      QString s(chunk.constData(), chunk.size());
+      for (;; tt = e.readNext()) {
+            switch (tt) {
+                  case XmlStreamReader::Characters:
+                  case XmlStreamReader::EntityReference:
+                        s += e.text();
+                        break;
+                  case XmlStreamReader::EndElement:
+                        return convert(QStringRef(&s));
+                  case XmlStreamReader::ProcessingInstruction:
+                  case XmlStreamReader::Comment:
+                        break;
+                  default:
+                        if (!e.hasError())
+                              e.raiseError(QObject::tr("Expected character data."));
+                        return convert(QStringRef(&s));
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   readInt
+//---------------------------------------------------------
+
+int XmlReader::readInt()
+      {
+      return readNumber<int>(*this, [](const QStringRef& s) { return s.toInt(); });
+      }
+
+int XmlReader::readInt(bool* ok)
+      {
+      return readNumber<int>(*this, [ok](const QStringRef& s) { return s.toInt(ok); });
+      }
+
+//---------------------------------------------------------
+//   readIntHex
+//---------------------------------------------------------
+
+int XmlReader::readIntHex()
+      {
+      return readNumber<int>(*this, [](const QStringRef& s) { return s.toInt(0, 16); });
+      }
+
+//---------------------------------------------------------
+//   readDouble
+//---------------------------------------------------------
+
+double XmlReader::readDouble()
+      {
+      return readNumber<double>(*this, [](const QStringRef& s) { return s.toDouble(); });
       }
 
 //---------------------------------------------------------
@@ -206,7 +404,7 @@ void XmlReader::addTuplet(Tuplet* s)
 
 double XmlReader::readDouble(double min, double max)
       {
-      double val = readElementText().toDouble();
+      double val = readDouble();
       if (val < min)
             val = min;
       else if (val > max)
@@ -18,6 +18,7 @@
 #include "interval.h"
 #include "element.h"
 #include "select.h"
+#include "xmltag.h"
 
 namespace Ms {
 
@@ -68,9 +69,10 @@ class XmlReader : public XmlStreamReader {
       XmlReader(const QString& d, const QString& s = QString()) : XmlStreamReader(d), docName(s) {}
 
       void unknown();
+      XmlTag tagId() const;
 
       // attribute helper routines:
-      QString attribute(const char* s) const { return attributes().value(s).toString(); }
+      QString attribute(const char* s) const { return attributes().value(QLatin1String(s)).toString(); }
       QString attribute(const char* s, const QString&) const;
       int intAttribute(const char* s) const;
       int intAttribute(const char* s, int _default) const;
@@ -78,11 +80,11 @@ class XmlReader : public XmlStreamReader {
       double doubleAttribute(const char* s, double _default) const;
       bool hasAttribute(const char* s) const;
 
-      // helper routines based on readElementText():
-      int readInt()         { return readElementText().toInt();      }
-      int readInt(bool* ok) { return readElementText().toInt(ok);    }
-      int readIntHex()      { return readElementText().toInt(0, 16); }
-      double readDouble()   { return readElementText().toDouble();   }
+      // helper routines reading the element text:
+      int readInt();
+      int readInt(bool* ok);
+      int readIntHex();
+      double readDouble();
       double readDouble(double min, double max);
       bool readBool();
       QPointF readPoint();
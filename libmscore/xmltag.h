@@ -0,0 +1,116 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __XMLTAG_H__
+#define __XMLTAG_H__
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   XmlTag
+//    element names read in the inner loops of score
+//    reading. The order is the order of the names as
+//    strings, see tagList in xml.cpp.
+//---------------------------------------------------------
+
+enum class XmlTag : unsigned short {
+      ACCIDENTAL,
+      AMBITUS,
+      BAR_LINE,
+      BEAM,
+      BEND,
+      BREATH,
+      CHORD,
+      CLEF,
+      DYNAMIC,
+      EVENTS,
+      FIGURED_BASS,
+      FINGERING,
+      FRET_DIAGRAM,
+      GLISSANDO,
+      HAIR_PIN,
+      HARMONY,
+      IMAGE,
+      INSTRUMENT_CHANGE,
+      JUMP,
+      KEY_SIG,
+      LAYOUT_BREAK,
+      LYRICS,
+      MARKER,
+      MEASURE_NUMBER,
+      NOTE_DOT,
+      OTTAVA,
+      PEDAL,
+      REHEARSAL_MARK,
+      REPEAT_MEASURE,
+      REST,
+      SEGMENT,
+      SLUR,
+      STAFF_STATE,
+      STAFF_TEXT,
+      SYMBOL,
+      TEMPO,
+      TEXT,
+      TEXT_LINE,
+      TIE,
+      TIME_SIG,
+      TREMOLO_BAR,
+      TRILL,
+      TUPLET,
+      VOLTA,
+      BREAK_MULTI_MEASURE_REST,
+      DOT_POSITION,
+      END_REPEAT,
+      END_SPANNER,
+      FIXED,
+      FIXED_LINE,
+      FRET,
+      GHOST,
+      HEAD,
+      HEAD_TYPE,
+      IRREGULAR,
+      LINE,
+      MEASURE_NUMBER_MODE,
+      MIRROR,
+      MOVE,
+      MULTI_MEASURE_REST,
+      NO_OFFSET,
+      OFF_TIME_OFFSET,
+      OFF_TIME_TYPE,
+      OFFSET,
+      ON_TIME_OFFSET,
+      ON_TIME_TYPE,
+      PITCH,
+      PLAY,
+      SLASH_STYLE,
+      SMALL,
+      START_REPEAT,
+      STRETCH,
+      STRING,
+      SYS_INIT_BAR_LINE_TYPE,
+      TICK,
+      TPC,
+      TPC2,
+      TUNING,
+      USER_ACCIDENTAL,
+      VELO_TYPE,
+      VELOCITY,
+      VISIBLE,
+      VSPACER,
+      VSPACER_DOWN,
+      VSPACER_UP,
+      UNKNOWN
+      };
+
+}     // namespace Ms
+#endif
+
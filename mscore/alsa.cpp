@@ -26,6 +26,7 @@
 
 #ifdef USE_ALSA
 #include <sys/time.h>
+#include <sys/mman.h>
 #include "alsa.h"
 #include "libmscore/score.h"
 #include "musescore.h"
@@ -96,16 +97,16 @@ bool AlsaDriver::init()
 
       switch (_play_format) {
             case SND_PCM_FORMAT_S32_LE:
-                  _play_func  = play_32le;
-                  _clear_func = clear_32le;
+                  _sampleFormat = SampleFormat::S32_LE;
+                  _clear_func   = clear_32le;
                   break;
             case SND_PCM_FORMAT_S24_3LE:
-                  _play_func  = play_24le;
-                  _clear_func = clear_24le;
+                  _sampleFormat = SampleFormat::S24_3LE;
+                  _clear_func   = clear_24le;
                   break;
             case SND_PCM_FORMAT_S16_LE:
-                  _play_func  = play_16le;
-                  _clear_func = clear_16le;
+                  _sampleFormat = SampleFormat::S16_LE;
+                  _clear_func   = clear_16le;
                   break;
             default:
                   qDebug ("Alsa_driver: can't handle playback sample format.");
@@ -116,6 +117,8 @@ bool AlsaDriver::init()
             qDebug ("Alsa_driver: interface requires more than %d pollfd", MAXPFD);
             return false;
             }
+      if (!mmappedInterface)
+            _rwBuffer.resize(_frsize * _play_nchan * sampleBytes(_sampleFormat));
       _stat = 0;
       return true;
       }
@@ -410,75 +413,6 @@ bool AlsaDriver::recover()
       return pcmStart();
       }
 
-//---------------------------------------------------------
-//   play_16le
-//---------------------------------------------------------
-
-char* AlsaDriver::play_16le (const float* src, char* dst, int step, int nfrm)
-      {
-      while (nfrm--) {
-            short d;
-            float s = *src++;
-            if (s >  1)
-                  d = 0x7fff;
-            else if (s < -1)
-                  d = 0x8001;
-            else
-                  d = (short)(0x7fff * s);
-            *((short*) dst) = d;
-            dst += step;
-            }
-      return dst;
-      }
-
-//---------------------------------------------------------
-//   play_24le
-//---------------------------------------------------------
-
-char* AlsaDriver::play_24le(const float* src, char* dst, int step, int nfrm)
-      {
-      float   s;
-      int     d;
-
-      while (nfrm--) {
-            s = *src++;
-            if (s >  1)
-                  d = 0x007fffff;
-            else if (s < -1)
-                  d = 0x00800001;
-            else
-                  d = (int)(0x007fffff * s);
-            dst [0] = d;
-            dst [1] = d >> 8;
-            dst [2] = d >> 16;
-            dst += step;
-            }
-      return dst;
-      }
-
-//---------------------------------------------------------
-//   play_32le
-//---------------------------------------------------------
-
-char* AlsaDriver::play_32le(const float* src, char* dst, int step, int nfrm)
-      {
-      float   s;
-      int     d;
-
-      while (nfrm--) {
-            s = *src++;
-            if (s >  1)
-                  d = 0x007fffff;
-            else if (s < -1)
-                  d = 0x00800001;
-            else
-                  d = (int)(0x007fffff * s);
-            *((int *) dst) = d << 8;
-            dst += step;
-            }
-      return dst;
-      }
-
 //---------------------------------------------------------
 //   clear_16le
 //---------------------------------------------------------
@@ -522,9 +456,12 @@ char* AlsaDriver::clear_32le(char* dst, int step, int nfrm)
 
 //---------------------------------------------------------
 //   write
+//    write n frames of interleaved stereo; with the mmap
+//    interface the samples are converted straight into
+//    the buffer of the device
 //---------------------------------------------------------
 
-void AlsaDriver::write(int n, float* l, float* r)
+void AlsaDriver::write(int n, const float* buffer)
       {
       for (;;) {
             int err = snd_pcm_wait(_play_handle, -1);
@@ -541,36 +478,39 @@ void AlsaDriver::write(int n, float* l, float* r)
             else if (avail >= n)
                   break;
             }
+      const int bytes = sampleBytes(_sampleFormat);
       if (mmappedInterface) {
-            playInit(n);
-            _play_ptr[0] = _play_func(l, _play_ptr[0], _play_step, n);
-            _play_ptr[1] = _play_func(r, _play_ptr[1], _play_step, n);
-            snd_pcm_mmap_commit(_play_handle, _play_offs, n);
+            // the mmap area can end before n frames
+            while (n > 0) {
+                  int len = playInit(n);
+                  if (len <= 0)
+                        return;
+                  if (_play_step == 2 * bytes && _play_ptr[1] == _play_ptr[0] + bytes)
+                        convertSamples(_sampleFormat, buffer, 1, _play_ptr[0], bytes, len * 2);
+                  else {
+                        for (unsigned i = 0; i < _play_nchan; ++i)
+                              convertSamples(_sampleFormat, buffer + i, 2, _play_ptr[i], _play_step, len);
+                        }
+                  snd_pcm_mmap_commit(_play_handle, _play_offs, len);
+                  buffer += len * 2;
+                  n      -= len;
+                  }
             }
       else {
-            //
-            //  tested only INTERLEAVED and S16 format
-            //
             int err;
+            char* p = _rwBuffer.data();
             if (_play_access == SND_PCM_ACCESS_RW_NONINTERLEAVED) {
-                  //
-                  // untested
-                  //
-                  short lbuffer[n];
-                  short rbuffer[n];
-                  _play_func(l, (char*)lbuffer, 2, n);
-                  _play_func(r, (char*)rbuffer, 2, n);
                   void* bp[2];
-                  bp[0] = lbuffer;
-                  bp[1] = rbuffer;
+                  for (unsigned i = 0; i < _play_nchan; ++i) {
+                        bp[i] = p + i * n * bytes;
+                        convertSamples(_sampleFormat, buffer + i, 2, (char*)bp[i], bytes, n);
+                        }
                   if ((err = snd_pcm_writen(_play_handle, bp, n)) < 0)
                         qDebug("AlsaDriver::write(): failed (%s)", snd_strerror(err));
                   }
             else if (_play_access == SND_PCM_ACCESS_RW_INTERLEAVED) {
-                  short buffer[n * 2];
-                  _play_func(l, (char*)buffer, 4, n);
-                  _play_func(r, (char*)(buffer + 1), 4, n);
-                  if ((err = snd_pcm_writei(_play_handle, buffer, n)) < 0)
+                  convertSamples(_sampleFormat, buffer, 1, p, bytes, n * 2);
+                  if ((err = snd_pcm_writei(_play_handle, p, n)) < 0)
                         qDebug("AlsaDriver::write(): failed (%s)", snd_strerror(err));
                   }
             else {
@@ -643,6 +583,36 @@ bool AlsaAudio::init(bool hot)
       return true;
       }
 
+//---------------------------------------------------------
+//   lockMemory
+//    keep the period buffer and the top of the stack of
+//    the audio thread in memory, so that the thread does
+//    not wait for page faults; returns true if the buffer
+//    was locked
+//---------------------------------------------------------
+
+static bool lockMemory(const std::vector<float>& buffer)
+      {
+      static const size_t STACK_LOCK = 32 * 1024;
+
+      bool locked = mlock(buffer.data(), buffer.size() * sizeof(float)) == 0;
+      if (!locked)
+            qDebug("AlsaAudio: cannot lock buffer: %s", strerror(errno));
+      pthread_attr_t attr;
+      if (pthread_getattr_np(pthread_self(), &attr) == 0) {
+            void* addr;
+            size_t size;
+            if (pthread_attr_getstack(&attr, &addr, &size) == 0) {
+                  // the stack grows down from addr + size
+                  size_t n = qMin(size, STACK_LOCK);
+                  if (mlock(static_cast<char*>(addr) + size - n, n) != 0)
+                        qDebug("AlsaAudio: cannot lock stack: %s", strerror(errno));
+                  }
+            pthread_attr_destroy(&attr);
+            }
+      return locked;
+      }
+
 //---------------------------------------------------------
 //   alsaLoop
 //---------------------------------------------------------
@@ -666,8 +636,8 @@ void AlsaAudio::alsaLoop()
       memset(&rt_param, 0, sizeof(rt_param));
       rt_param.sched_priority = 50;
       int rv = pthread_setschedparam(pthread_self(), SCHED_FIFO, &rt_param);
-      if (rv == -1)
-            perror("Set realtime scheduler failed");
+      if (rv != 0)
+            qDebug("AlsaAudio: set realtime scheduler failed: %s", strerror(rv));
 
       if (!alsa->pcmStart()) {
             alsa->pcmStop();
@@ -675,22 +645,16 @@ void AlsaAudio::alsaLoop()
             return;
             }
       int size = alsa->fsize();
-      float buffer[size * 2];
+      std::vector<float> buffer(size * 2);
+      bool locked = lockMemory(buffer);
       runAlsa = 2;
       while (runAlsa == 2) {
-            seq->process(size, buffer);
-            float l[size];
-            float r[size];
-            float* lp = l;
-            float* rp = r;
-            float* sp = buffer;
-            for (int i = 0; i < size; ++i) {
-                  *lp++ = *sp++;
-                  *rp++ = *sp++;
-                  }
-            alsa->write(size, l, r);
+            seq->process(size, buffer.data());
+            alsa->write(size, buffer.data());
             }
       alsa->pcmStop();
+      if (locked)
+            munlock(buffer.data(), buffer.size() * sizeof(float));
       runAlsa = 0;
       }
 
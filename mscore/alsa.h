@@ -27,10 +27,12 @@
 
 #include <alsa/asoundlib.h>
 #include <poll.h>
+#include <vector>
 
 #include "config.h"
 #include "driver.h"
 #include "mididriver.h"
+#include "synthesizer/sampleconv.h"
 
 typedef struct pollfd PollFd;
 
@@ -48,7 +50,6 @@ enum class Transport : char;
 
 class AlsaDriver {
       QString _name;
-      typedef char* (*play_function)(const float*, char*, int, int);
       typedef char* (*clear_function)(char*, int, int);
 
       enum { MAXPFD = 8, MAXPLAY = 4 };
@@ -76,15 +77,13 @@ class AlsaDriver {
       int                    _pcnt;
       bool                   _xrun;
       clear_function         _clear_func;
-      play_function          _play_func;
+      SampleFormat           _sampleFormat;
+      std::vector<char>      _rwBuffer;         // converted samples for the rw interface
       bool                   mmappedInterface;
 
       static char* clear_32le(char* dst, int step, int nfrm);
       static char* clear_24le(char* dst, int step, int nfrm);
       static char* clear_16le(char* dst, int step, int nfrm);
-      static char* play_32le(const float* src, char* dst, int step, int nfrm);
-      static char* play_24le(const float* src, char* dst, int step, int nfrm);
-      static char* play_16le(const float* src, char* dst, int step, int nfrm);
       int playInit(snd_pcm_uframes_t len);
       snd_pcm_sframes_t pcmWait();
       snd_pcm_t* playHandle() const   { return _play_handle; }
@@ -101,7 +100,7 @@ class AlsaDriver {
       int pcmStop();
       snd_pcm_uframes_t fsize() const { return _frsize;      }
       unsigned int sampleRate() const { return _rate; }
-      void write(int n, float* l, float* r);
+      void write(int n, const float* buffer);
       };
 
 //---------------------------------------------------------
@@ -13,6 +13,7 @@
 #include "config.h"
 #include "preferences.h"
 #include "driver.h"
+#include "nulldriver.h"
 
 #ifdef USE_JACK
 #include "jackaudio.h"
@@ -34,7 +35,7 @@ extern Driver* getPulseAudioDriver(Seq*);
 
 //---------------------------------------------------------
 //   driverFactory
-//    driver can be: jack alsa pulse portaudio
+//    driver can be: jack alsa pulse portaudio null
 //---------------------------------------------------------
 
 Driver* driverFactory(Seq* seq, QString driverName)
@@ -45,6 +46,7 @@ Driver* driverFactory(Seq* seq, QString driverName)
       bool useAlsaFlag       = preferences.useAlsaAudio;
       bool usePortaudioFlag  = preferences.usePortaudioAudio;
       bool usePulseAudioFlag = preferences.usePulseAudio;
+      bool useNullFlag       = false;
 
       if (!driverName.isEmpty()) {
             driverName        = driverName.toLower();
@@ -60,6 +62,8 @@ Driver* driverFactory(Seq* seq, QString driverName)
                   usePulseAudioFlag = true;
             else if (driverName == "portaudio")
                   usePortaudioFlag = true;
+            else if (driverName == "null")
+                  useNullFlag = true;
             }
 
       useALSA       = false;
@@ -67,6 +71,11 @@ Driver* driverFactory(Seq* seq, QString driverName)
       usePortaudio  = false;
       usePulseAudio = false;
 
+      if (useNullFlag) {
+            // no audio device, periods are processed at the pace of a sound card
+            driver = new NullDriver(seq);
+            driver->init();
+            }
 #ifdef USE_PULSEAUDIO
       if (usePulseAudioFlag) {
             driver = getPulseAudioDriver(seq);
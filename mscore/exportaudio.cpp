@@ -25,11 +25,180 @@
 #include "libmscore/part.h"
 #include "libmscore/mscore.h"
 #include "synthesizer/msynthesizer.h"
+#include "synthesizer/loudness.h"
+#include "synthesizer/spillbuffer.h"
 #include "musescore.h"
 #include "preferences.h"
 
 namespace Ms {
 
+//---------------------------------------------------------
+//   renderAudio
+//    run the synthesizer once over the whole score and keep
+//    the output in buffer; peak and loudness are measured on
+//    the way so the gain can be applied while encoding
+//    updateProgress is called with values in range [0, 1]
+//---------------------------------------------------------
+
+bool MuseScore::renderAudio(Score* score, AudioSpillBuffer* buffer, LoudnessMeter* meter, std::function<bool(float)> updateProgress)
+      {
+      EventMap events;
+      score->renderMidi(&events);
+      if (events.size() == 0)
+            return false;
+
+      QElapsedTimer timer;
+      timer.start();
+
+      MasterSynthesizer* synti = synthesizerFactory();
+      synti->setOffline(true);
+      synti->init();
+      int sampleRate = preferences.exportAudioSampleRate;
+      synti->setSampleRate(sampleRate);
+      if (MScore::noGui) { // use score settings if possible
+            bool r = synti->setState(score->synthesizerState());
+            if (!r)
+                  synti->init();
+            }
+      else { // use current synth settings
+            bool r = synti->setState(mscore->synthesizerState());
+            if (!r)
+                  synti->init();
+            }
+
+      int oldSampleRate  = MScore::sampleRate;
+      MScore::sampleRate = sampleRate;
+
+      EventMap::const_iterator endPos = events.cend();
+      --endPos;
+      const int et = (score->utick2utime(endPos->first) + 1) * MScore::sampleRate;
+      const int maxEndTime = (score->utick2utime(endPos->first) + 3) * MScore::sampleRate;
+
+      synti->allSoundsOff(-1);
+
+      //
+      // init instruments
+      //
+      foreach(Part* part, score->parts()) {
+            const InstrumentList* il = part->instruments();
+            for(auto i = il->begin(); i!= il->end(); i++) {
+                  foreach(const Channel* a, i->second->channel()) {
+                        a->updateInitList();
+                        foreach(MidiCoreEvent e, a->init) {
+                              if (e.type() == ME_INVALID)
+                                    continue;
+                              e.setChannel(a->channel);
+                              int syntiIdx= synti->index(score->midiMapping(a->channel)->articulation->synti);
+                              synti->play(e, syntiIdx);
+                              }
+                        }
+                  }
+            }
+
+      static const unsigned FRAMES = 512;
+      float audio[FRAMES * 2];
+      int playTime = 0;
+      bool ok      = true;
+      EventMap::const_iterator playPos = events.cbegin();
+
+      for (;;) {
+            unsigned frames = FRAMES;
+            //
+            // collect events for one segment
+            //
+            memset(audio, 0, sizeof(float) * FRAMES * 2);
+            int endTime = playTime + frames;
+            float* p = audio;
+            for (; playPos != events.cend(); ++playPos) {
+                  int f = score->utick2utime(playPos->first) * MScore::sampleRate;
+                  if (f >= endTime)
+                        break;
+                  int n = f - playTime;
+                  if (n) {
+                        synti->process(n, p);
+                        p += 2 * n;
+                        }
+
+                  playTime  += n;
+                  frames    -= n;
+                  const NPlayEvent& e = playPos->second;
+                  if (e.isChannelEvent()) {
+                        int channelIdx = e.channel();
+                        Channel* c = score->midiMapping(channelIdx)->articulation;
+                        if (!c->mute) {
+                              synti->play(e, synti->index(c->synti));
+                              }
+                        }
+                  }
+            if (frames) {
+                  synti->process(frames, p);
+                  playTime += frames;
+                  }
+            float max = 0.0;
+            for (unsigned i = 0; i < FRAMES * 2; ++i)
+                  max = qMax(max, qAbs(audio[i]));
+            if (!buffer->write(audio, FRAMES)) {
+                  ok = false;
+                  break;
+                  }
+            meter->process(audio, FRAMES);
+
+            playTime = endTime;
+            if (updateProgress && !updateProgress(qMin(1.0, double(playTime) / et))) {
+                  ok = false;
+                  break;
+                  }
+            if (playTime >= et)
+                  synti->allNotesOff(-1);
+            // create sound until the sound decays
+            if (playTime >= et && max * buffer->peak() < 0.000001)
+                  break;
+            // hard limit
+            if (playTime > maxEndTime)
+                  break;
+            }
+      ok = buffer->finish() && ok;
+
+      MScore::sampleRate = oldSampleRate;
+      delete synti;
+
+      _audioExportStats            = AudioExportStats();
+      _audioExportStats.duration   = double(buffer->frames()) / sampleRate;
+      _audioExportStats.renderTime = timer.elapsed();
+      _audioExportStats.spilled    = buffer->spilled();
+      _audioExportStats.peak       = buffer->peak();
+      _audioExportStats.loudness   = meter->integratedLoudness();
+      qDebug("audio export: %.1f s rendered in %.2f s (%.1fx realtime)%s",
+         _audioExportStats.duration, _audioExportStats.renderTime / 1000.0,
+         _audioExportStats.realtimeFactor(), buffer->spilled() ? ", spilled to disk" : "");
+      return ok;
+      }
+
+//---------------------------------------------------------
+//   audioExportGain
+//    gain to apply to the rendered audio according to
+//    preferences.exportAudioNormalize
+//---------------------------------------------------------
+
+double MuseScore::audioExportGain(const AudioSpillBuffer& buffer, const LoudnessMeter& meter) const
+      {
+      double peakGain = buffer.peak() > 0.0 ? 0.99 / buffer.peak() : 1.0;
+      switch (preferences.exportAudioNormalize) {
+            case AudioNormalize::GAIN:
+                  return pow(10.0, preferences.exportAudioGain / 20.0);
+            case AudioNormalize::LOUDNESS: {
+                  double loudness = meter.integratedLoudness();
+                  if (loudness == -HUGE_VAL)
+                        break;
+                  // do not raise the level beyond the peak normalized gain
+                  return qMin(peakGain, pow(10.0, (preferences.exportAudioLoudness - loudness) / 20.0));
+                  }
+            case AudioNormalize::PEAK:
+                  break;
+            }
+      return peakGain;
+      }
+
 ///
 /// \brief Function to synthesize audio and output it into a generic QIODevice
 /// \param The score to output
@@ -39,6 +208,10 @@ namespace Ms {
 ///
 /// If the callback function is non zero an returns false the export will be canceled.
 ///
+/// The score is synthesized only once. The output is kept in an AudioSpillBuffer
+/// (a memory mapped temporary file for long scores) and written to the device
+/// with the gain applied.
+///
 bool MuseScore::saveAudio(Score* score, QIODevice *device, std::function<bool(float)> updateProgress)
     {
     if (!device) {
@@ -51,144 +224,57 @@ bool MuseScore::saveAudio(Score* score, QIODevice *device, std::function<bool(fl
         return false;
     }
 
-    EventMap events;
-    score->renderMidi(&events);
-    if(events.size() == 0)
-          return false;
+    // rendering takes most of the time, encoding the rest
+    static const float RENDER_PROGRESS = 0.9;
 
-    MasterSynthesizer* synti = synthesizerFactory();
-    synti->init();
-    int sampleRate = preferences.exportAudioSampleRate;
-    synti->setSampleRate(sampleRate);
-    if (MScore::noGui) { // use score settings if possible
-          bool r = synti->setState(score->synthesizerState());
-          if (!r)
-                synti->init();
+    AudioSpillBuffer buffer;
+    LoudnessMeter meter(preferences.exportAudioSampleRate);
+    std::function<bool(float)> renderProgress = nullptr;
+    if (updateProgress)
+          renderProgress = [&updateProgress](float v) { return updateProgress(v * RENDER_PROGRESS); };
+    if (!renderAudio(score, &buffer, &meter, renderProgress)) {
+          device->close();
+          return false;
           }
-    else { // use current synth settings
-          bool r = synti->setState(mscore->synthesizerState());
-          if (!r)
-                synti->init();
+    if (buffer.peak() == 0.0) {
+          qDebug("song is empty");
+          device->close();
+          return true;
           }
 
-    int oldSampleRate  = MScore::sampleRate;
-    MScore::sampleRate = sampleRate;
-
-    float peak  = 0.0;
-    double gain = 1.0;
-    EventMap::const_iterator endPos = events.cend();
-    --endPos;
-    const int et = (score->utick2utime(endPos->first) + 1) * MScore::sampleRate;
-    const int maxEndTime = (score->utick2utime(endPos->first) + 3) * MScore::sampleRate;
-
-    bool cancelled = false;
-    for (int pass = 0; pass < 2; ++pass) {
-          EventMap::const_iterator playPos;
-          playPos = events.cbegin();
-          synti->allSoundsOff(-1);
-
-          //
-          // init instruments
-          //
-          foreach(Part* part, score->parts()) {
-                const InstrumentList* il = part->instruments();
-                for(auto i = il->begin(); i!= il->end(); i++) {
-                      foreach(const Channel* a, i->second->channel()) {
-                            a->updateInitList();
-                            foreach(MidiCoreEvent e, a->init) {
-                                  if (e.type() == ME_INVALID)
-                                        continue;
-                                  e.setChannel(a->channel);
-                                  int syntiIdx= synti->index(score->midiMapping(a->channel)->articulation->synti);
-                                  synti->play(e, syntiIdx);
-                                  }
-                            }
-                      }
-                }
-
-          static const unsigned FRAMES = 512;
-          float buffer[FRAMES * 2];
-          int playTime = 0;
-
-          for (;;) {
-                unsigned frames = FRAMES;
-                //
-                // collect events for one segment
-                //
-                float max = 0.0;
-                memset(buffer, 0, sizeof(float) * FRAMES * 2);
-                int endTime = playTime + frames;
-                float* p = buffer;
-                for (; playPos != events.cend(); ++playPos) {
-                      int f = score->utick2utime(playPos->first) * MScore::sampleRate;
-                      if (f >= endTime)
-                            break;
-                      int n = f - playTime;
-                      if (n) {
-                            synti->process(n, p);
-                            p += 2 * n;
-                            }
-
-                      playTime  += n;
-                      frames    -= n;
-                      const NPlayEvent& e = playPos->second;
-                      if (e.isChannelEvent()) {
-                            int channelIdx = e.channel();
-                            Channel* c = score->midiMapping(channelIdx)->articulation;
-                            if (!c->mute) {
-                                  synti->play(e, synti->index(c->synti));
-                                  }
-                            }
-                      }
-                if (frames) {
-                      synti->process(frames, p);
-                      playTime += frames;
-                      }
-                if (pass == 1) {
-                      for (unsigned i = 0; i < FRAMES * 2; ++i) {
-                            max = qMax(max, qAbs(buffer[i]));
-                            buffer[i] *= gain;
-                            }
-                      device->write(reinterpret_cast<const char*>(buffer), 2 * FRAMES * sizeof(float));
-                      }
-                else {
-                      for (unsigned i = 0; i < FRAMES * 2; ++i) {
-                            max = qMax(max, qAbs(buffer[i]));
-                            peak = qMax(peak, qAbs(buffer[i]));
-                            }
-                      }
-                playTime = endTime;
-                if (updateProgress) {
-                    // normalize to [0, 1] range
-                    if (!updateProgress((pass * et + playTime) / 2.0 / et)) {
-                        cancelled = true;
-                        break;
-                    }
-                      }
-                if (playTime >= et)
-                      synti->allNotesOff(-1);
-                // create sound until the sound decays
-                if (playTime >= et && max*peak < 0.000001)
-                      break;
-                // hard limit
-                if (playTime > maxEndTime)
-                      break;
+    QElapsedTimer timer;
+    timer.start();
+    const double gain = audioExportGain(buffer, meter);
+    _audioExportStats.gain = gain;
+
+    static const int FRAMES = 4096;
+    float audio[FRAMES * 2];
+    bool ok = true;
+    for (long long pos = 0; pos < buffer.frames(); pos += FRAMES) {
+          int n = buffer.read(pos, audio, FRAMES);
+          if (n == 0) {
+                qDebug("reading rendered audio failed");
+                ok = false;
+                break;
                 }
-          if (cancelled)
+          for (int i = 0; i < n * 2; ++i)
+                audio[i] *= gain;
+          qint64 bytes = 2 * n * sizeof(float);
+          if (device->write(reinterpret_cast<const char*>(audio), bytes) != bytes) {
+                qDebug("writing audio failed: %s", qPrintable(device->errorString()));
+                ok = false;
                 break;
-          if (pass == 0 && peak == 0.0) {
-                qDebug("song is empty");
+                }
+          if (updateProgress && !updateProgress(RENDER_PROGRESS + (1.0 - RENDER_PROGRESS) * (pos + n) / buffer.frames())) {
+                ok = false;
                 break;
                 }
-          gain = 0.99 / peak;
           }
-
-    MScore::sampleRate = oldSampleRate;
-    delete synti;
+    _audioExportStats.encodeTime = timer.elapsed();
 
     device->close();
 
-    return !cancelled;
+    return ok;
 }
 
 #ifdef HAS_AUDIOFILE
@@ -229,8 +315,10 @@ bool MuseScore::saveAudio(Score* score, const QString& name)
 
         virtual qint64 writeData(const char *data, qint64 len) override final {
             int trueFrames = len / sizeof(float) / 2;
-            sf_writef_float(sf, reinterpret_cast<const float*>(data), trueFrames);
-            return trueFrames * 2 * sizeof(float);
+            sf_count_t written = sf_writef_float(sf, reinterpret_cast<const float*>(data), trueFrames);
+            if (written != trueFrames)
+                  setErrorString(sf_strerror(sf));
+            return written * 2 * sizeof(float);
         }
 
         bool open(QIODevice::OpenMode mode) {
@@ -242,6 +330,8 @@ bool MuseScore::saveAudio(Score* score, const QString& name)
                   qDebug("open soundfile failed: %s", sf_strerror(sf));
                   return false;
             }
+            // a fixed export gain may exceed full scale
+            sf_command(sf, SFC_SET_CLIPPING, nullptr, SF_TRUE);
             return QIODevice::open(mode);
         }
         void close() {
@@ -264,24 +354,7 @@ bool MuseScore::saveAudio(Score* score, const QString& name)
             return false;
             }
 
-      EventMap events;
-      score->renderMidi(&events);
-      if(events.size() == 0)
-            return false;
-
-      MasterSynthesizer* synti = synthesizerFactory();
-      synti->init();
-      int sampleRate = preferences.exportAudioSampleRate;
-      synti->setSampleRate(sampleRate);
-      bool r = synti->setState(score->synthesizerState());
-      if (!r)
-          synti->init();
-
-      int oldSampleRate  = MScore::sampleRate;
-      MScore::sampleRate = sampleRate;
-
-
-      SoundFileDevice device(sampleRate, format, name);
+      SoundFileDevice device(preferences.exportAudioSampleRate, format, name);
 
       // dummy callback function that will be used if there is no gui
       std::function<bool(float)> progressCallback = [](float) {return true;};
@@ -316,13 +389,9 @@ bool MuseScore::saveAudio(Score* score, const QString& name)
       // Save the audio to the SoundFile device
       bool result = saveAudio(score, &device, progressCallback);
 
-      bool wasCanceled = progress.wasCanceled();
       progress.close();
 
-      MScore::sampleRate = oldSampleRate;
-      delete synti;
-
-      if (wasCanceled)
+      if (!result)
             QFile::remove(name);
 
       return result;
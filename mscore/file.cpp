@@ -2374,31 +2374,27 @@ static QRect trim(QImage source, int margin)
 #endif
 
 //---------------------------------------------------------
-//   savePng
-//    return true on success
+//   PageExport
+//    a page of an image export and its file
 //---------------------------------------------------------
 
-bool MuseScore::savePng(Score* score, const QString& name)
-      {
-      return savePng(score, name, false, preferences.pngTransparent, converterDpi, trimMargin, QImage::Format_ARGB32_Premultiplied);
-      }
+struct PageExport {
+      Page* page;
+      int no;
+      QString fileName;
+      bool ok;
+      };
 
 //---------------------------------------------------------
-//   savePng with options
-//    return true on success
+//   pageExports
+//    the pages of score to write to files name-<n>.<ext>;
+//    asks before existing files are replaced unless in
+//    converter mode
 //---------------------------------------------------------
 
-bool MuseScore::savePng(Score* score, const QString& name, bool screenshot, bool transparent, double convDpi, int trimMargin, QImage::Format format)
+static QList<PageExport> pageExports(Score* score, const QString& name, const QString& ext)
       {
-      bool rv = true;
-      score->setPrinting(!screenshot);    // dont print page break symbols etc.
-
-      QImage::Format f;
-      if (format != QImage::Format_Indexed8)
-          f = format;
-      else
-          f = QImage::Format_ARGB32_Premultiplied;
-
+      QList<PageExport> pel;
       const QList<Page*>& pl = score->pages();
       int pages = pl.size();
 
@@ -2406,67 +2402,22 @@ bool MuseScore::savePng(Score* score, const QString& name, bool screenshot, bool
       bool overwrite = false;
       bool noToAll = false;
       for (int pageNumber = 0; pageNumber < pages; ++pageNumber) {
-            Page* page = pl.at(pageNumber);
-
-            QRectF r;
-            if (trimMargin >= 0) {
-                  QMarginsF margins(trimMargin, trimMargin, trimMargin, trimMargin);
-                  r = page->tbbox() + margins;
-                  }
-            else
-                  r = page->abbox();
-            int w = lrint(r.width()  * convDpi / DPI);
-            int h = lrint(r.height() * convDpi / DPI);
-
-            QImage printer(w, h, f);
-            printer.setDotsPerMeterX(lrint((convDpi * 1000) / INCH));
-            printer.setDotsPerMeterY(lrint((convDpi * 1000) / INCH));
-
-            printer.fill(transparent ? 0 : 0xffffffff);
-
-            double mag = convDpi / DPI;
-            QPainter p(&printer);
-            p.setRenderHint(QPainter::Antialiasing, true);
-            p.setRenderHint(QPainter::TextAntialiasing, true);
-            p.scale(mag, mag);
-            if (trimMargin >= 0)
-                  p.translate(-r.topLeft());
-
-            QList<const Element*> pel = page->elements();
-            qStableSort(pel.begin(), pel.end(), elementLessThan);
-            paintElements(p, pel);
-
-            if (format == QImage::Format_Indexed8) {
-                  //convert to grayscale & respect alpha
-                  QVector<QRgb> colorTable;
-                  colorTable.push_back(QColor(0, 0, 0, 0).rgba());
-                  if (!transparent) {
-                        for (int i = 1; i < 256; i++)
-                              colorTable.push_back(QColor(i, i, i).rgb());
-                        }
-                  else {
-                        for (int i = 1; i < 256; i++)
-                              colorTable.push_back(QColor(0, 0, 0, i).rgba());
-                        }
-                  printer = printer.convertToFormat(QImage::Format_Indexed8, colorTable);
-                  }
-
             QString fileName(name);
-            if (fileName.endsWith(".png"))
-                  fileName = fileName.left(fileName.size() - 4);
-            fileName += QString("-%1.png").arg(pageNumber+1, padding, 10, QLatin1Char('0'));
+            if (fileName.endsWith("." + ext))
+                  fileName = fileName.left(fileName.size() - ext.size() - 1);
+            fileName += QString("-%1.%2").arg(pageNumber + 1, padding, 10, QLatin1Char('0')).arg(ext);
             if (!converterMode) {
                   QFileInfo fip(fileName);
                   if(fip.exists() && !overwrite) {
                         if(noToAll)
                               continue;
-                        QMessageBox msgBox( QMessageBox::Question, tr("Confirm Replace"),
-                              tr("\"%1\" already exists.\nDo you want to replace it?\n").arg(QDir::toNativeSeparators(fileName)),
+                        QMessageBox msgBox( QMessageBox::Question, MuseScore::tr("Confirm Replace"),
+                              MuseScore::tr("\"%1\" already exists.\nDo you want to replace it?\n").arg(QDir::toNativeSeparators(fileName)),
                               QMessageBox::Yes |  QMessageBox::YesToAll | QMessageBox::No |  QMessageBox::NoToAll);
-                        msgBox.setButtonText(QMessageBox::Yes, tr("Replace"));
-                        msgBox.setButtonText(QMessageBox::No, tr("Skip"));
-                        msgBox.setButtonText(QMessageBox::YesToAll, tr("Replace All"));
-                        msgBox.setButtonText(QMessageBox::NoToAll, tr("Skip All"));
+                        msgBox.setButtonText(QMessageBox::Yes, MuseScore::tr("Replace"));
+                        msgBox.setButtonText(QMessageBox::No, MuseScore::tr("Skip"));
+                        msgBox.setButtonText(QMessageBox::YesToAll, MuseScore::tr("Replace All"));
+                        msgBox.setButtonText(QMessageBox::NoToAll, MuseScore::tr("Skip All"));
                         int sb = msgBox.exec();
                         if(sb == QMessageBox::YesToAll) {
                               overwrite = true;
@@ -2479,10 +2430,137 @@ bool MuseScore::savePng(Score* score, const QString& name, bool screenshot, bool
                               continue;
                         }
                   }
-            rv = printer.save(fileName, "png");
-            if (!rv)
-                  break;
+            pel.append({ pl.at(pageNumber), pageNumber, fileName, false });
+            }
+      return pel;
+      }
+
+//---------------------------------------------------------
+//   exportPages
+//    call f for every page; pages are independent, the
+//    laid out score is only read, so they are rendered in
+//    parallel unless --render-threads 1 was given. The
+//    workers run on a pool of their own and draw glyphs
+//    from the atlas page images, never from pixmaps.
+//---------------------------------------------------------
+
+static bool exportPages(QList<PageExport>& pel, std::function<void(PageExport&)> f, ImageExportStats* stats)
+      {
+      QElapsedTimer timer;
+      timer.start();
+      *stats = ImageExportStats();
+      stats->pages = pel.size();
+      if (renderThreads == 1 || pel.size() < 2) {
+            for (PageExport& pe : pel)
+                  f(pe);
+            }
+      else {
+            QThreadPool pool;
+            if (renderThreads > 0)
+                  pool.setMaxThreadCount(renderThreads);
+            stats->threads = qMin(pel.size(), pool.maxThreadCount());
+
+            QList<PageExport*> pages;
+            for (PageExport& pe : pel)
+                  pages.append(&pe);
+            QAtomicInt next(0);
+            QList<QFuture<void>> workers;
+            for (int i = 0; i < stats->threads; ++i) {
+                  workers.append(QtConcurrent::run(&pool, [&pages, &next, &f]() {
+                        for (int idx; (idx = next.fetchAndAddRelaxed(1)) < pages.size();)
+                              f(*pages.at(idx));
+                        }));
+                  }
+            for (QFuture<void>& w : workers)
+                  w.waitForFinished();
+            }
+      stats->renderTime = timer.elapsed();
+      for (const PageExport& pe : pel) {
+            if (!pe.ok)
+                  return false;
             }
+      return true;
+      }
+
+//---------------------------------------------------------
+//   renderPage
+//---------------------------------------------------------
+
+static QImage renderPage(Page* page, bool transparent, double convDpi, int trimMargin, QImage::Format format)
+      {
+      QImage::Format f;
+      if (format != QImage::Format_Indexed8)
+          f = format;
+      else
+          f = QImage::Format_ARGB32_Premultiplied;
+
+      QRectF r;
+      if (trimMargin >= 0) {
+            QMarginsF margins(trimMargin, trimMargin, trimMargin, trimMargin);
+            r = page->tbbox() + margins;
+            }
+      else
+            r = page->abbox();
+      int w = lrint(r.width()  * convDpi / DPI);
+      int h = lrint(r.height() * convDpi / DPI);
+
+      QImage printer(w, h, f);
+      printer.setDotsPerMeterX(lrint((convDpi * 1000) / INCH));
+      printer.setDotsPerMeterY(lrint((convDpi * 1000) / INCH));
+
+      printer.fill(transparent ? 0 : 0xffffffff);
+
+      double mag = convDpi / DPI;
+      QPainter p(&printer);
+      p.setRenderHint(QPainter::Antialiasing, true);
+      p.setRenderHint(QPainter::TextAntialiasing, true);
+      p.scale(mag, mag);
+      if (trimMargin >= 0)
+            p.translate(-r.topLeft());
+
+      paintElements(p, page->drawList());
+      p.end();
+
+      if (format == QImage::Format_Indexed8) {
+            //convert to grayscale & respect alpha
+            QVector<QRgb> colorTable;
+            colorTable.push_back(QColor(0, 0, 0, 0).rgba());
+            if (!transparent) {
+                  for (int i = 1; i < 256; i++)
+                        colorTable.push_back(QColor(i, i, i).rgb());
+                  }
+            else {
+                  for (int i = 1; i < 256; i++)
+                        colorTable.push_back(QColor(0, 0, 0, i).rgba());
+                  }
+            printer = printer.convertToFormat(QImage::Format_Indexed8, colorTable);
+            }
+      return printer;
+      }
+
+//---------------------------------------------------------
+//   savePng
+//    return true on success
+//---------------------------------------------------------
+
+bool MuseScore::savePng(Score* score, const QString& name)
+      {
+      return savePng(score, name, false, preferences.pngTransparent, converterDpi, trimMargin, QImage::Format_ARGB32_Premultiplied);
+      }
+
+//---------------------------------------------------------
+//   savePng with options
+//    return true on success
+//---------------------------------------------------------
+
+bool MuseScore::savePng(Score* score, const QString& name, bool screenshot, bool transparent, double convDpi, int trimMargin, QImage::Format format)
+      {
+      score->setPrinting(!screenshot);    // dont print page break symbols etc.
+      QList<PageExport> pel = pageExports(score, name, "png");
+      bool rv = exportPages(pel, [=](PageExport& pe) {
+            QImage printer = renderPage(pe.page, transparent, convDpi, trimMargin, format);
+            pe.ok = printer.save(pe.fileName, "png");
+            }, &_imageExportStats);
       score->setPrinting(false);
       return rv;
       }
@@ -2580,6 +2658,122 @@ QString MuseScore::getWallpaper(const QString& caption)
       return QString();
       }
 
+//---------------------------------------------------------
+//   saveSvgPage
+//---------------------------------------------------------
+
+static bool saveSvgPage(Score* score, Page* page, const QString& title, const QString& fileName)
+      {
+      SvgGenerator printer;
+      printer.setTitle(title);
+      printer.setFileName(fileName);
+
+      QRectF r;
+      if (trimMargin >= 0) {
+            QMarginsF margins(trimMargin, trimMargin, trimMargin, trimMargin);
+            r = page->tbbox() + margins;
+            }
+      else
+            r = page->abbox();
+      qreal w = r.width();
+      qreal h = r.height();
+
+      printer.setSize(QSize(w, h));
+      printer.setViewBox(QRectF(0, 0, w, h));
+      QPainter p(&printer);
+      p.setRenderHint(QPainter::Antialiasing, true);
+      p.setRenderHint(QPainter::TextAntialiasing, true);
+      if (trimMargin >= 0)
+            p.translate(-r.topLeft());
+      // 1st pass: StaffLines
+      for  (System* s : *page->systems()) {
+            for (int i = 0, n = s->staves()->size(); i < n; i++) {
+                  if (score->staff(i)->invisible() || !score->staff(i)->show())
+                        continue;  // ignore invisible staves
+                  if (s->staves()->isEmpty() || !s->staff(i)->show())
+                        continue;
+                  if (!s->firstMeasure())
+                        continue;
+
+                  // The goal here is to draw SVG staff lines more efficiently.
+                  // MuseScore draws staff lines by measure, but for SVG they can
+                  // generally be drawn once for each system. This makes a big
+                  // difference for scores that scroll horizontally on a single
+                  // page. But there are exceptions to this rule:
+                  //
+                  //   ~ One (or more) invisible measure(s) in a system/staff ~
+                  //   ~ One (or more) elements of type HBOX or VBOX          ~
+                  //
+                  // In these cases the SVG staff lines for the system/staff
+                  // are drawn by measure.
+                  //
+                  bool byMeasure = false;
+                  MeasureBase* mb = nullptr;
+                  for (mb = s->firstMeasure(); mb != 0; mb = s->nextMeasure(mb)) {
+                        if (mb->type() == Element::Type::HBOX
+                         || mb->type() == Element::Type::VBOX
+                         || (!static_cast<Measure*>(mb)->visible(i) && mb->system() == s)) {
+                              byMeasure = true;
+                              break;
+                              }
+                        }
+                  if (mb && mb->type() == Element::Type::VBOX) // no need for staff lines
+                        byMeasure = false;
+                  if (!byMeasure && (!s->lastMeasure() || !s->lastMeasure()->system()))
+                        byMeasure = true;
+                  if (byMeasure) { // Draw visible staff lines by measure
+                        for (MeasureBase* mb = s->firstMeasure(); mb != 0; mb = s->nextMeasure(mb)) {
+                              if (mb->type() != Element::Type::HBOX
+                               && mb->type() != Element::Type::VBOX
+                               && static_cast<Measure*>(mb)->visible(i)) {
+                                    Measure* m = static_cast<Measure*>(mb);
+                                    if (score->styleB(StyleIdx::createMultiMeasureRests) && m->hasMMRest())
+                                          m = m->mmRest();
+                                    StaffLines* sl = m->staffLines(i);
+                                    if (sl->measure()->system()) {
+                                          printer.setElement(sl);
+                                          paintElement(p, sl);
+                                          }
+                                    }
+                              }
+                        }
+                  else { // Draw staff lines once per system
+                        StaffLines* firstSL = s->firstMeasure()->staffLines(i)->clone();
+                        StaffLines*  lastSL =  s->lastMeasure()->staffLines(i);
+                        firstSL->bbox().setRight(lastSL->bbox().right()
+                                              + lastSL->pagePos().x()
+                                              - firstSL->pagePos().x());
+                        printer.setElement(firstSL);
+                        paintElement(p, firstSL);
+                        delete firstSL;
+                  }
+            }
+      }
+      // 2nd pass: the rest of the elements
+      Element::Type eType;
+      for (const Element* e : page->drawList()) {
+            // Always exclude invisible elements
+            if (!e->visible())
+                  continue;
+
+            eType = e->type();
+            switch (eType) { // In future sub-type code, this switch() grows, and eType gets used
+            case Element::Type::STAFF_LINES : // Handled in the 1st pass above
+                  continue; // Exclude from 2nd pass
+                  break;
+            default:
+                  break;
+            } // switch(eType)
+
+            // Set the Element pointer inside SvgGenerator/SvgPaintEngine
+            printer.setElement(e);
+
+            // Paint it
+            paintElement(p, e);
+      }
+      return p.end(); // Writes MuseScore SVG file to disk, finally
+      }
+
 //---------------------------------------------------------
 //   MuseScore::saveSvg
 //---------------------------------------------------------
@@ -2600,158 +2794,18 @@ bool MuseScore::saveSvg(Score* score, const QString& saveName)
       score->setPrinting(true);
       MScore::pdfPrinting = true;
       MScore::svgPrinting = true;
-      const QList<Page*>& pl = score->pages();
-      int pages = pl.size();
-      int padding = QString("%1").arg(pages).size();
-      bool overwrite = false;
-      bool noToAll = false;
-      for (int pageNumber = 0; pageNumber < pages; ++pageNumber) {
-            Page* page = pl.at(pageNumber);
-            SvgGenerator printer;
-            printer.setTitle(pages > 1 ? QString("%1 (%2)").arg(title).arg(pageNumber + 1) : title);
-
-            QString fileName(saveName);
-            if (fileName.endsWith(".svg"))
-                  fileName = fileName.left(fileName.size() - 4);
-            fileName += QString("-%1.svg").arg(pageNumber + 1, padding, 10, QLatin1Char('0'));
-            if (!converterMode) {
-                  QFileInfo fip(fileName);
-                  if(fip.exists() && !overwrite) {
-                        if(noToAll)
-                              continue;
-                        QMessageBox msgBox( QMessageBox::Question, tr("Confirm Replace"),
-                              tr("\"%1\" already exists.\nDo you want to replace it?\n").arg(QDir::toNativeSeparators(fileName)),
-                              QMessageBox::Yes |  QMessageBox::YesToAll | QMessageBox::No |  QMessageBox::NoToAll);
-                        msgBox.setButtonText(QMessageBox::Yes, tr("Replace"));
-                        msgBox.setButtonText(QMessageBox::No, tr("Skip"));
-                        msgBox.setButtonText(QMessageBox::YesToAll, tr("Replace All"));
-                        msgBox.setButtonText(QMessageBox::NoToAll, tr("Skip All"));
-                        int sb = msgBox.exec();
-                        if(sb == QMessageBox::YesToAll) {
-                              overwrite = true;
-                              }
-                        else if (sb == QMessageBox::NoToAll) {
-                              noToAll = true;
-                              continue;
-                              }
-                        else if (sb == QMessageBox::No)
-                              continue;
-                        }
-                  }
-            printer.setFileName(fileName);
-
-            QRectF r;
-            if (trimMargin >= 0) {
-                  QMarginsF margins(trimMargin, trimMargin, trimMargin, trimMargin);
-                  r = page->tbbox() + margins;
-                  }
-            else
-                  r = page->abbox();
-            qreal w = r.width();
-            qreal h = r.height();
-
-            printer.setSize(QSize(w, h));
-            printer.setViewBox(QRectF(0, 0, w, h));
-            QPainter p(&printer);
-            p.setRenderHint(QPainter::Antialiasing, true);
-            p.setRenderHint(QPainter::TextAntialiasing, true);
-            if (trimMargin >= 0)
-                  p.translate(-r.topLeft());
-            // 1st pass: StaffLines
-            for  (System* s : *page->systems()) {
-                  for (int i = 0, n = s->staves()->size(); i < n; i++) {
-                        if (score->staff(i)->invisible() || !score->staff(i)->show())
-                              continue;  // ignore invisible staves
-                        if (s->staves()->isEmpty() || !s->staff(i)->show())
-                              continue;
-                        if (!s->firstMeasure())
-                              continue;
-
-                        // The goal here is to draw SVG staff lines more efficiently.
-                        // MuseScore draws staff lines by measure, but for SVG they can
-                        // generally be drawn once for each system. This makes a big
-                        // difference for scores that scroll horizontally on a single
-                        // page. But there are exceptions to this rule:
-                        //
-                        //   ~ One (or more) invisible measure(s) in a system/staff ~
-                        //   ~ One (or more) elements of type HBOX or VBOX          ~
-                        //
-                        // In these cases the SVG staff lines for the system/staff
-                        // are drawn by measure.
-                        //
-                        bool byMeasure = false;
-                        MeasureBase* mb = nullptr;
-                        for (mb = s->firstMeasure(); mb != 0; mb = s->nextMeasure(mb)) {
-                              if (mb->type() == Element::Type::HBOX
-                               || mb->type() == Element::Type::VBOX
-                               || (!static_cast<Measure*>(mb)->visible(i) && mb->system() == s)) {
-                                    byMeasure = true;
-                                    break;
-                                    }
-                              }
-                        if (mb && mb->type() == Element::Type::VBOX) // no need for staff lines
-                              byMeasure = false;
-                        if (!byMeasure && (!s->lastMeasure() || !s->lastMeasure()->system()))
-                              byMeasure = true;
-                        if (byMeasure) { // Draw visible staff lines by measure
-                              for (MeasureBase* mb = s->firstMeasure(); mb != 0; mb = s->nextMeasure(mb)) {
-                                    if (mb->type() != Element::Type::HBOX
-                                     && mb->type() != Element::Type::VBOX
-                                     && static_cast<Measure*>(mb)->visible(i)) {
-                                          Measure* m = static_cast<Measure*>(mb);
-                                          if (score->styleB(StyleIdx::createMultiMeasureRests) && m->hasMMRest())
-                                                m = m->mmRest();
-                                          StaffLines* sl = m->staffLines(i);
-                                          if (sl->measure()->system()) {
-                                                printer.setElement(sl);
-                                                paintElement(p, sl);
-                                                }
-                                          }
-                                    }
-                              }
-                        else { // Draw staff lines once per system
-                              StaffLines* firstSL = s->firstMeasure()->staffLines(i)->clone();
-                              StaffLines*  lastSL =  s->lastMeasure()->staffLines(i);
-                              firstSL->bbox().setRight(lastSL->bbox().right()
-                                                    + lastSL->pagePos().x()
-                                                    - firstSL->pagePos().x());
-                              printer.setElement(firstSL);
-                              paintElement(p, firstSL);
-                        }
-                  }
-            }
-            // 2nd pass: the rest of the elements
-            QList<const Element*> pel = page->elements();
-            qStableSort(pel.begin(), pel.end(), elementLessThan);
-            Element::Type eType;
-            for (const Element* e : pel) {
-                  // Always exclude invisible elements
-                  if (!e->visible())
-                        continue;
-
-                  eType = e->type();
-                  switch (eType) { // In future sub-type code, this switch() grows, and eType gets used
-                  case Element::Type::STAFF_LINES : // Handled in the 1st pass above
-                        continue; // Exclude from 2nd pass
-                        break;
-                  default:
-                        break;
-                  } // switch(eType)
-
-                  // Set the Element pointer inside SvgGenerator/SvgPaintEngine
-                  printer.setElement(e);
-
-                  // Paint it
-                  paintElement(p, e);
-            }
-            p.end(); // Writes MuseScore SVG file to disk, finally
-      }
+      int pages = score->pages().size();
+      QList<PageExport> pel = pageExports(score, saveName, "svg");
+      bool rv = exportPages(pel, [=](PageExport& pe) {
+            QString t = pages > 1 ? QString("%1 (%2)").arg(title).arg(pe.no + 1) : title;
+            pe.ok = saveSvgPage(score, pe.page, t, pe.fileName);
+            }, &_imageExportStats);
 
       // Clean up and return
       score->setPrinting(false);
       MScore::pdfPrinting = false;
       MScore::svgPrinting = false;
-      return true;
+      return rv;
       }
 
 //---------------------------------------------------------
@@ -34,6 +34,7 @@ extern bool pluginMode;
 extern double converterDpi;
 extern double guiScaling;
 extern int trimMargin;
+extern int renderThreads;     ///< pages rendered in parallel on image export, 0: one per core
 extern bool noWebView;
 extern bool ignoreWarnings;
 
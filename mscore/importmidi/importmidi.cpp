@@ -210,22 +210,23 @@ void quantizeAllTracks(std::multimap<int, MTrack> &tracks,
       {
       auto &opers = preferences.midiImportOperations;
 
-      for (auto &track: tracks) {
-            MTrack &mtrack = track.second;
-            if (mtrack.chords.empty())
-                  continue;
-                        // pass current track index through MidiImportOperations
-                        // for further usage
-            MidiOperations::CurrentTrackSetter setCurrentTrack{opers, mtrack.indexOfOperation};
-
-            if (opers.data()->processingsOfOpenedFile == 0) {
+                  // operations are changed here, before the tracks
+                  // are processed in parallel and only read them
+      if (opers.data()->processingsOfOpenedFile == 0) {
+            for (const auto &track: tracks) {
+                  const MTrack &mtrack = track.second;
+                  if (mtrack.chords.empty())
+                        continue;
                   opers.data()->trackOpers.isDrumTrack.setValue(
-                                          opers.currentTrack(), mtrack.mtrack->drumTrack());
+                                          mtrack.indexOfOperation, mtrack.mtrack->drumTrack());
                   if (mtrack.mtrack->drumTrack()) {
                         opers.data()->trackOpers.maxVoiceCount.setValue(
-                                          opers.currentTrack(), MidiOperations::VoiceCount::V_1);
+                                          mtrack.indexOfOperation, MidiOperations::VoiceCount::V_1);
                         }
                   }
+            }
+
+      MidiTracks::forEachTrack(tracks, [&](MTrack &mtrack) {
             const auto basicQuant = Quantize::quantValueToFraction(
                         opers.data()->trackOpers.quantValue.value(mtrack.indexOfOperation));
 
@@ -239,7 +240,7 @@ void quantizeAllTracks(std::multimap<int, MTrack> &tracks,
             else
                   MidiTuplet::findAllTuplets(mtrack.tuplets, mtrack.chords, sigmap, basicQuant);
 
-            Q_ASSERT_X(!doNotesOverlap(track.second),
+            Q_ASSERT_X(!doNotesOverlap(mtrack),
                        "quantizeAllTracks",
                        "There are overlapping notes of the same voice that is incorrect");
 
@@ -252,7 +253,7 @@ void quantizeAllTracks(std::multimap<int, MTrack> &tracks,
             Q_ASSERT_X(MidiTuplet::areTupletRangesOk(mtrack.chords, mtrack.tuplets),
                        "quantizeAllTracks", "Tuplet chord/note is outside tuplet "
                         "or non-tuplet chord/note is inside tuplet");
-            }
+            });
       }
 
 //---------------------------------------------------------
@@ -1070,8 +1071,42 @@ ReducedFraction findLastChordTick(const std::multimap<int, MTrack> &tracks)
       return lastTick;
       }
 
+//---------------------------------------------------------
+//   StageTimer
+//    reports the time of every import stage and the total
+//    in debug mode (-d)
+//---------------------------------------------------------
+
+class StageTimer
+      {
+   public:
+      StageTimer()
+            {
+            _total.start();
+            _stage.start();
+            }
+
+      void stageDone(const char *stage)
+            {
+            if (MScore::debugMode)
+                  qDebug("midi import: %-20s %8.1f ms", stage, _stage.nsecsElapsed() / 1e6);
+            _stage.restart();
+            }
+
+      ~StageTimer()
+            {
+            if (MScore::debugMode)
+                  qDebug("midi import: %-20s %8.1f ms on %d threads", "total",
+                         _total.nsecsElapsed() / 1e6, QThreadPool::globalInstance()->maxThreadCount());
+            }
+   private:
+      QElapsedTimer _total;
+      QElapsedTimer _stage;
+      };
+
 void convertMidi(Score *score, const MidiFile *mf)
       {
+      StageTimer timer;
       auto *sigmap = score->sigmap();
 
       auto tracks = createMTrackList(sigmap, mf);
@@ -1090,6 +1125,8 @@ void convertMidi(Score *score, const MidiFile *mf)
                   }
             MidiLyrics::extractLyricsToMidiData(mf);
             }
+      timer.stageDone("create tracks");
+
                   // for newly opened MIDI file - detect if it is a human performance
                   // if so - detect beats and set initial time signature
       if (opers.data()->processingsOfOpenedFile == 0)
@@ -1103,9 +1140,12 @@ void convertMidi(Score *score, const MidiFile *mf)
                           != ReducedFraction(0, 1) : true,
                  "convertMidi", "Null time signature for human-performed MIDI file");
 
+      timer.stageDone("beat detection");
+
       MChord::collectChords(tracks, {2, 1}, {1, 2});
       MidiBeat::adjustChordsToBeats(tracks);
       MChord::mergeChordsWithEqualOnTimeAndVoice(tracks);
+      timer.stageDone("collect chords");
 
                   // for newly opened MIDI file
       if (opers.data()->processingsOfOpenedFile == 0
@@ -1121,8 +1161,11 @@ void convertMidi(Score *score, const MidiFile *mf)
       LRHand::splitIntoLeftRightHands(tracks);
       MidiDrum::splitDrumVoices(tracks);
       MidiDrum::splitDrumTracks(tracks);
+      timer.stageDone("split staves");
+
       ReducedFraction lastTick = findLastChordTick(tracks);
       quantizeAllTracks(tracks, sigmap, lastTick);
+      timer.stageDone("quantize, tuplets");
       MChord::removeOverlappingNotes(tracks);
 
       Q_ASSERT_X(!doNotesOverlap(tracks),
@@ -1136,12 +1179,14 @@ void convertMidi(Score *score, const MidiFile *mf)
             Simplify::simplifyDurationsNotDrums(tracks, sigmap);    // again
       Simplify::simplifyDurationsForDrums(tracks, sigmap);
       MChord::splitUnequalChords(tracks);
+      timer.stageDone("voices, simplify");
                   // no more track insertion/reordering/deletion from now
       QList<MTrack> trackList = prepareTrackList(tracks);
       MidiInstr::setGrandStaffProgram(trackList);
       MidiInstr::findInstrumentsForAllTracks(trackList);
       MidiInstr::createInstruments(score, trackList);
       MidiDrum::setStaffBracketForDrums(trackList);
+      timer.stageDone("instruments");
 
       const auto firstTick = findFirstChordTick(trackList);
 
@@ -1160,6 +1205,7 @@ void convertMidi(Score *score, const MidiFile *mf)
       MidiLyrics::setLyricsToScore(trackList);
       MidiTempo::setTempo(tracks, score);
       MidiChordName::setChordNames(trackList);
+      timer.stageDone("create score");
       }
 
 void loadMidiData(MidiFile &mf)
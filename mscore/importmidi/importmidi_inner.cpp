@@ -278,4 +278,33 @@ double durationCount(const QList<std::pair<ReducedFraction, TDuration> > &durati
       }
 
 } // namespace MidiDuration
+
+namespace MidiTracks {
+
+void forEachTrack(std::multimap<int, MTrack> &tracks, const std::function<void(MTrack &)> &f)
+      {
+      QList<MTrack *> trackList;
+      for (auto &track: tracks) {
+            if (!track.second.chords.empty())
+                  trackList.append(&track.second);
+            }
+
+      auto process = [&f](MTrack *mtrack) {
+                        // pass current track index through MidiImportOperations
+                        // for further usage; it is set for this thread only
+            MidiOperations::CurrentTrackSetter setCurrentTrack{
+                              preferences.midiImportOperations, mtrack->indexOfOperation};
+            f(*mtrack);
+            };
+
+      if (trackList.size() < 2 || QThreadPool::globalInstance()->maxThreadCount() == 1) {
+            for (MTrack *mtrack: trackList)
+                  process(mtrack);
+            }
+      else {
+            QtConcurrent::blockingMap(trackList, process);
+            }
+      }
+
+} // namespace MidiTracks
 } // namespace Ms
@@ -6,6 +6,8 @@
 #include "importmidi_operation.h"
 
 #include <vector>
+#include <map>
+#include <functional>
 #include <cstddef>
 #include <utility>
 
@@ -150,6 +152,15 @@ namespace MidiDuration {
 double durationCount(const QList<std::pair<ReducedFraction, TDuration> > &durations);
 
 } // namespace MidiDuration
+
+namespace MidiTracks {
+
+            // call f for every track with chords; tracks are independent,
+            // so they are processed in parallel on the global thread pool,
+            // each one with its own index as current track of the thread
+void forEachTrack(std::multimap<int, MTrack> &tracks, const std::function<void(MTrack &)> &f);
+
+} // namespace MidiTracks
 } // namespace Ms
 
 
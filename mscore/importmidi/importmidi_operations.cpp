@@ -268,6 +268,8 @@ bool Data::hasMidiFile(const QString &fileName)
       return _data.find(fileName) != _data.end();
       }
 
+thread_local int Data::_currentTrack = -1;
+
 int Data::currentTrack() const
       {
 
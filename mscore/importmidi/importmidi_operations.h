@@ -222,12 +222,13 @@ class Data
 
       QString _currentMidiFile;
       QString _midiOperationsFile;
-      int _currentTrack = -1;
+                  // one per thread: tracks are processed in parallel
+      static thread_local int _currentTrack;
 
       std::map<QString, FileData> _data;    // <file name, tracks data>
       };
 
-// scoped setter of current track
+// scoped setter of current track of the calling thread
 class CurrentTrackSetter
       {
    public:
@@ -47,6 +47,20 @@ class TupletErrorResult
             return value < 0;
             }
 
+            // false if no result with values within these bounds
+            // can be less than this one; the margin covers
+            // the rounding of the bounds
+      bool canBeImprovedBy(double minAverageError,
+                           double maxRelativeUsedChordPlaces,
+                           double minSumLengthOfRests) const
+            {
+            double value = div(minAverageError, tupletAverageError)
+                         - div(maxRelativeUsedChordPlaces, relativeUsedChordPlaces)
+                         + div(minSumLengthOfRests,
+                               sumLengthOfRests.numerator() * 1.0 / sumLengthOfRests.denominator());
+            return value <= 1e-9;
+            }
+
    private:
       static double div(double val1, double val2)
             {
@@ -229,18 +243,72 @@ bool isInCommonIndexes(
       return false;
       }
 
+// chords of tuplets are numbered and their quant errors are found only once
+// for the whole search; the buffers are reused by the error calculations
+
+class TupletCache
+      {
+   public:
+      TupletCache(const std::vector<TupletInfo> &tuplets, const ReducedFraction &basicQuant)
+            : tupletChords_(tuplets.size())
+            , tupletErrors_(tuplets.size())
+            , usedTuplets_(tuplets.size())
+            {
+            std::map<std::pair<const ReducedFraction, MidiChord> *, int> chordIndexes;
+            for (size_t i = 0; i != tuplets.size(); ++i) {
+                  for (const auto &chord: tuplets[i].chords) {
+                        const auto it = chordIndexes.insert({&*chord.second, (int)quantErrors_.size()});
+                        if (it.second) {
+                              quantErrors_.push_back(
+                                    Quantize::findOnTimeQuantError(*chord.second, basicQuant));
+                              }
+                        tupletChords_[i].push_back(it.first->second);
+                        }
+                  tupletErrors_[i] = toDouble(tuplets[i].tupletSumError);
+                  }
+            usedChords_.resize(quantErrors_.size());
+            }
+
+      const std::vector<int>& chords(int tupletIndex) const { return tupletChords_[tupletIndex]; }
+      const ReducedFraction& quantError(int chordIndex) const { return quantErrors_[chordIndex]; }
+      double tupletError(int tupletIndex) const { return tupletErrors_[tupletIndex]; }
+
+      std::vector<char>& clearedUsedChords()
+            {
+            std::fill(usedChords_.begin(), usedChords_.end(), 0);
+            return usedChords_;
+            }
+      std::vector<char>& clearedUsedTuplets()
+            {
+            std::fill(usedTuplets_.begin(), usedTuplets_.end(), 0);
+            return usedTuplets_;
+            }
+
+      static double toDouble(const ReducedFraction &f)
+            {
+            return f.numerator() * 1.0 / f.denominator();
+            }
+
+   private:
+      std::vector<std::vector<int>> tupletChords_;
+      std::vector<ReducedFraction> quantErrors_;
+      std::vector<double> tupletErrors_;
+      std::vector<char> usedChords_;
+      std::vector<char> usedTuplets_;
+      };
+
 TupletErrorResult findTupletError(
             const std::vector<int> &tupletIndexes,
             const std::vector<TupletInfo> &tuplets,
             size_t voiceCount,
-            const ReducedFraction &basicQuant)
+            TupletCache &cache)
       {
       ReducedFraction sumError{0, 1};
       ReducedFraction sumLengthOfRests{0, 1};
       int sumChordCount = 0;
       int sumChordPlaces = 0;
-      std::set<std::pair<const ReducedFraction, MidiChord> *> usedChords;
-      std::vector<char> usedIndexes(tuplets.size(), 0);
+      auto &usedChords = cache.clearedUsedChords();
+      auto &usedIndexes = cache.clearedUsedTuplets();
 
       for (int i: tupletIndexes) {
             const auto &tuplet = tuplets[i];
@@ -251,18 +319,17 @@ TupletErrorResult findTupletError(
             sumChordPlaces += tuplet.tupletNumber;
 
             usedIndexes[i] = 1;
-            for (const auto &chord: tuplet.chords)
-                  usedChords.insert(&*chord.second);
+            for (int chord: cache.chords(i))
+                  usedChords[chord] = 1;
             }
                   // add quant error of all chords excluded from tuplets
       for (size_t i = 0; i != tuplets.size(); ++i) {
             if (usedIndexes[i])
                   continue;
-            const auto &tuplet = tuplets[i];
-            for (const auto &chord: tuplet.chords) {
-                  if (usedChords.find(&*chord.second) != usedChords.end())
+            for (int chord: cache.chords(i)) {
+                  if (usedChords[chord])
                         continue;
-                  sumError += Quantize::findOnTimeQuantError(*chord.second, basicQuant);
+                  sumError += cache.quantError(chord);
                   }
             }
 
@@ -435,11 +502,10 @@ void tryUpdateBestIndexes(
             const std::vector<int> &selectedTuplets,
             const std::vector<TupletInfo> &tuplets,
             const std::map<int, std::vector<std::pair<ReducedFraction, ReducedFraction>>> &voiceIntervals,
-            const ReducedFraction &basicQuant)
+            TupletCache &cache)
       {
       const size_t voiceCount = voiceIntervals.size();
-      const auto error = findTupletError(selectedTuplets, tuplets,
-                                         voiceCount, basicQuant);
+      const auto error = findTupletError(selectedTuplets, tuplets, voiceCount, cache);
       if (!minCurrentError.isInitialized() || error < minCurrentError) {
             minCurrentError = error;
             bestTupletIndexes = selectedTuplets;
@@ -529,6 +595,76 @@ class ValidTuplets
       };
 
 
+// all tuplet selections that can be found from the selected tuplets
+// consist of selected and valid tuplets; the error of such a selection
+// cannot be less than the one with the bounds found here:
+// - chords of tuplets that are neither selected nor valid and that
+//   are not in any selected or valid tuplet remain non-tuplet chords
+// - relative used chord places are not more than the max value
+//   of the selected tuplets together and of every valid tuplet
+// - rests of the selected tuplets remain
+// so the search can skip the selections if the bounds are not better
+// than the current min error
+
+bool canErrorBeImproved(
+            const TupletErrorResult &minCurrentError,
+            const std::vector<int> &selectedTuplets,
+            const ValidTuplets &validTuplets,
+            const std::vector<TupletInfo> &tuplets,
+            TupletCache &cache)
+      {
+      if (!minCurrentError.isInitialized())
+            return true;
+
+      auto &usedChords = cache.clearedUsedChords();
+      auto &usedIndexes = cache.clearedUsedTuplets();
+      double sumError = 0;
+      double sumLengthOfRests = 0;
+      int sumChordCount = 0;
+      int sumChordPlaces = 0;
+
+      for (int i: selectedTuplets) {
+            const auto &tuplet = tuplets[i];
+
+            sumError += cache.tupletError(i);
+            sumLengthOfRests += TupletCache::toDouble(tuplet.sumLengthOfRests);
+            sumChordCount += tuplet.chords.size();
+            sumChordPlaces += tuplet.tupletNumber;
+
+            usedIndexes[i] = 1;
+            for (int chord: cache.chords(i))
+                  usedChords[chord] = 1;
+            }
+      int maxChordCount = sumChordCount;
+      double maxRelativePlaces = (sumChordPlaces > 0)
+                  ? sumChordCount * 1.0 / sumChordPlaces : 0.0;
+
+      for (int i = validTuplets.first(); validTuplets.isValid(i); i = validTuplets.next(i)) {
+            const auto &tuplet = tuplets[i];
+
+            maxChordCount += tuplet.chords.size();
+            maxRelativePlaces = qMax(maxRelativePlaces,
+                                     tuplet.chords.size() * 1.0 / tuplet.tupletNumber);
+            usedIndexes[i] = 1;
+            for (int chord: cache.chords(i))
+                  usedChords[chord] = 1;
+            }
+      if (maxChordCount == 0)
+            return true;
+
+      for (size_t i = 0; i != tuplets.size(); ++i) {
+            if (usedIndexes[i])
+                  continue;
+            for (int chord: cache.chords(i)) {
+                  if (!usedChords[chord])
+                        sumError += TupletCache::toDouble(cache.quantError(chord));
+                  }
+            }
+
+      return minCurrentError.canBeImprovedBy(sumError / maxChordCount,
+                                             maxRelativePlaces, sumLengthOfRests);
+      }
+
 void findNextTuplet(
             std::vector<int> &selectedTuplets,
             ValidTuplets &validTuplets,
@@ -538,9 +674,13 @@ void findNextTuplet(
             const std::vector<TupletInfo> &tuplets,
             const std::vector<std::pair<ReducedFraction, ReducedFraction> > &tupletIntervals,
             size_t commonsSize,
-            const ReducedFraction &basicQuant)
+            TupletCache &cache)
       {
       while (!validTuplets.empty()) {
+            if (!canErrorBeImproved(minCurrentError, selectedTuplets,
+                                    validTuplets, tuplets, cache)) {
+                  return;
+                  }
             size_t index = validTuplets.first();
 
             bool isCommonGroupBegins = (selectedTuplets.empty() && index == commonsSize);
@@ -575,7 +715,7 @@ void findNextTuplet(
                         }
                   if (!canAddMoreIndexes) {
                         tryUpdateBestIndexes(bestTupletIndexes, minCurrentError,
-                                             selectedTuplets, tuplets, voiceIntervals, basicQuant);
+                                             selectedTuplets, tuplets, voiceIntervals, cache);
                         }
                   return;
                   }
@@ -611,12 +751,12 @@ void findNextTuplet(
                         }
                   if (!canAddMoreIndexes) {
                         tryUpdateBestIndexes(bestTupletIndexes, minCurrentError,
-                                             selectedTuplets, tuplets, voiceIntervals, basicQuant);
+                                             selectedTuplets, tuplets, voiceIntervals, cache);
                         }
                   }
             else {
                   findNextTuplet(selectedTuplets, validTuplets, bestTupletIndexes, minCurrentError,
-                                 tupletCommons, tuplets, tupletIntervals, commonsSize, basicQuant);
+                                 tupletCommons, tuplets, tupletIntervals, commonsSize, cache);
                   }
 
             selectedTuplets.pop_back();
@@ -653,9 +793,10 @@ std::vector<int> findBestTuplets(
       const auto tupletIntervals = findTupletIntervals(tuplets, basicQuant);
 
       ValidTuplets validTuplets(tuplets.size());
+      TupletCache cache(tuplets, basicQuant);
 
       findNextTuplet(selectedTuplets, validTuplets, bestTupletIndexes, minCurrentError,
-                     tupletCommons, tuplets, tupletIntervals, commonsSize, basicQuant);
+                     tupletCommons, tuplets, tupletIntervals, commonsSize, cache);
 
       return bestTupletIndexes;
       }
@@ -23,6 +23,7 @@
 
 #include "thirdparty/qzip/qzipreader_p.h"
 #include "importmxml.h"
+#include "preferences.h"
 
 namespace Ms {
 
@@ -92,6 +93,25 @@ static bool initMusicXmlSchema(QXmlSchema& schema)
       return true;
       }
 
+//---------------------------------------------------------
+//   musicXmlSchema
+//    the compiled MusicXML schema, built on first use and
+//    kept for the lifetime of the process;
+//    return 0 on error
+//---------------------------------------------------------
+
+static const QXmlSchema* musicXmlSchema()
+      {
+      static QXmlSchema schema;
+      static bool valid = initMusicXmlSchema(schema);
+      static QString error = MScore::lastError;
+      if (!valid) {
+            MScore::lastError = error;
+            return 0;
+            }
+      return &schema;
+      }
+
 
 //---------------------------------------------------------
 //   musicXMLValidationErrorDialog
@@ -173,36 +193,59 @@ static bool extractRootfile(QFile* qf, QByteArray& data)
 
 
 //---------------------------------------------------------
-//   doValidate
+//   validate
 //---------------------------------------------------------
 
 /**
- Validate MusicXML data from file \a name contained in QIODevice \a dev.
+ Validate MusicXML data from file \a name contained in QIODevice \a dev against the schema.
+ Return false if the data is invalid or the schema is not available, store the
+ validation errors in \a errors.
  */
 
-static Score::FileError doValidate(const QString& name, QIODevice* dev)
+static bool validate(const QString& name, QIODevice* dev, QString* errors)
       {
       QTime t;
       t.start();
 
-      // initialize the schema
-      ValidatorMessageHandler messageHandler;
-      QXmlSchema schema;
-      schema.setMessageHandler(&messageHandler);
-      if (!initMusicXmlSchema(schema))
-            return Score::FileError::FILE_BAD_FORMAT;  // appropriate error message has been printed by initMusicXmlSchema
+      // get the schema
+      const QXmlSchema* schema = musicXmlSchema();
+      if (!schema)
+            return false;  // appropriate error message has been printed by initMusicXmlSchema
 
       // validate the data
-      QXmlSchemaValidator validator(schema);
+      ValidatorMessageHandler messageHandler;
+      QXmlSchemaValidator validator(*schema);
+      validator.setMessageHandler(&messageHandler);
+      dev->seek(0);
       bool valid = validator.validate(dev, QUrl::fromLocalFile(name));
       //qDebug("Validation time elapsed: %d ms", t.elapsed());
 
       if (!valid) {
             qDebug("importMusicXml() file '%s' is not a valid MusicXML file", qPrintable(name));
             MScore::lastError = QObject::tr("File '%1' is not a valid MusicXML file").arg(name);
+            *errors = messageHandler.getErrors();
+            }
+      return valid;
+      }
+
+//---------------------------------------------------------
+//   doValidate
+//---------------------------------------------------------
+
+/**
+ Validate MusicXML data from file \a name contained in QIODevice \a dev.
+ */
+
+static Score::FileError doValidate(const QString& name, QIODevice* dev)
+      {
+      if (!musicXmlSchema())
+            return Score::FileError::FILE_BAD_FORMAT;  // appropriate error message has been printed by initMusicXmlSchema
+
+      QString errors;
+      if (!validate(name, dev, &errors)) {
             if (MScore::noGui)
                   return Score::FileError::FILE_NO_ERROR;   // might as well try anyhow in converter mode
-            if (musicXMLValidationErrorDialog(MScore::lastError, messageHandler.getErrors()) != QMessageBox::Yes)
+            if (musicXMLValidationErrorDialog(MScore::lastError, errors) != QMessageBox::Yes)
                   return Score::FileError::FILE_USER_ABORT;
             }
 
@@ -216,6 +259,9 @@ static Score::FileError doValidate(const QString& name, QIODevice* dev)
 
 /**
  Validate and import MusicXML data from file \a name contained in QIODevice \a dev into score \a score.
+ The data is read into memory once, validation and both import passes parse the
+ in-memory copy. Depending on preferences.musicxmlImportValidation the data is validated
+ before the import, only if the import fails (to report why), or not at all.
  */
 
 static Score::FileError doValidateAndImport(Score* score, const QString& name, QIODevice* dev)
@@ -223,14 +269,39 @@ static Score::FileError doValidateAndImport(Score* score, const QString& name, Q
       // verify tuplet TDuration::DurationType dependencies
       tupletAssert();
 
-      // validate the file
-      Score::FileError res;
-      res = doValidate(name, dev);
-      if (res != Score::FileError::FILE_NO_ERROR)
-            return res;
+      QByteArray data;
+      QBuffer buffer;
+      if (!qobject_cast<QBuffer*>(dev)) {
+            data = dev->readAll();
+            buffer.setBuffer(&data);
+            buffer.open(QIODevice::ReadOnly);
+            dev = &buffer;
+            }
 
-      // actually do the import
-      importMusicXMLfromBuffer(score, name, dev);
+      Score::FileError res = Score::FileError::FILE_NO_ERROR;
+      switch (preferences.musicxmlImportValidation) {
+            case MusicxmlValidation::FULL:
+                  // validate the file
+                  res = doValidate(name, dev);
+                  if (res != Score::FileError::FILE_NO_ERROR)
+                        return res;
+
+                  // actually do the import
+                  importMusicXMLfromBuffer(score, name, dev);
+                  break;
+            case MusicxmlValidation::ON_ERROR:
+                  // validate only to report why the import failed
+                  res = importMusicXMLfromBuffer(score, name, dev);
+                  if (res != Score::FileError::FILE_NO_ERROR) {
+                        QString errors;
+                        if (!validate(name, dev, &errors))
+                              MScore::lastError += "\n" + errors;
+                        }
+                  break;
+            case MusicxmlValidation::NO:
+                  res = importMusicXMLfromBuffer(score, name, dev);
+                  break;
+            }
       //qDebug("importMusicXml() return %d", int(res));
       return res;
       }
@@ -42,6 +42,7 @@
 #include "libmscore/note.h"
 #include "libmscore/staff.h"
 #include "driver.h"
+#include "nulldriver.h"
 #include "libmscore/harmony.h"
 #include "magbox.h"
 #include "libmscore/sig.h"
@@ -101,6 +102,8 @@
 #include "synthesizer/synthesizer.h"
 #include "synthesizer/synthesizergui.h"
 #include "synthesizer/msynthesizer.h"
+#include "synthesizer/loudness.h"
+#include "synthesizer/spillbuffer.h"
 #include "fluid/fluid.h"
 #include "qmlplugin.h"
 #include "accessibletoolbutton.h"
@@ -145,6 +148,7 @@ double converterDpi = 0;
 double guiScaling = 0.0;
 static double userDPI = 0.0;
 int trimMargin = -1;
+int renderThreads = 0;
 bool noWebView = false;
 bool exportScoreParts = false;
 bool ignoreWarnings = false;
@@ -153,6 +157,10 @@ QString mscoreGlobalShare;
 
 static QString outFileName;
 static QString jsonFileName;
+static int jobWorkers = 1;
+static bool playbackBenchmark = false;
+static int benchmarkPeriod = 0;
+static bool benchmarkWallClock = false;
 static QString audioDriver;
 static QString pluginName;
 static QString styleFile;
@@ -2377,10 +2385,140 @@ static bool convert(const QString& inFile, const QString& outFile, const QString
       }
 
 //---------------------------------------------------------
-//   doProcessJob
+//   ConvertJob
+//    one entry of a json job file; a score is read and
+//    laid out once for all its output files
 //---------------------------------------------------------
 
-static bool doProcessJob(QString jsonFile)
+struct ConvertJob {
+      QString inFile;
+      QStringList outFiles;
+      QString plugin;
+      };
+
+//---------------------------------------------------------
+//   printJobReport
+//    write one line of json to stdout
+//---------------------------------------------------------
+
+static void printJobReport(const QJsonObject& obj)
+      {
+      QByteArray ba = QJsonDocument(obj).toJson(QJsonDocument::Compact);
+      ba.append('\n');
+      fwrite(ba.constData(), 1, ba.size(), stdout);
+      fflush(stdout);
+      }
+
+//---------------------------------------------------------
+//   processConvertJob
+//---------------------------------------------------------
+
+static bool processConvertJob(const ConvertJob& job, int worker)
+      {
+      QJsonObject report;
+      report["in"]     = job.inFile;
+      report["worker"] = worker;
+
+      QElapsedTimer timer;
+      timer.start();
+      fprintf(stderr, "convert <%s> to <%s>\n", qPrintable(job.inFile), qPrintable(job.outFiles.join(", ")));
+      Score* score = job.inFile.isEmpty() ? 0 : mscore->readScore(job.inFile);
+      report["loadTime"] = timer.elapsed();
+      if (!score) {
+            report["success"] = false;
+            report["error"]   = QString("cannot read <%1>").arg(job.inFile);
+            printJobReport(report);
+            return false;
+            }
+
+      bool rv = true;
+      QJsonArray outputs;
+      QString plugin = job.plugin;
+      QStringList outFiles = job.outFiles;
+      if (outFiles.isEmpty())
+            outFiles.append(QString());        // plugin only
+      for (const QString& outFile : outFiles) {
+            QJsonObject output;
+            output["file"] = outFile;
+            timer.restart();
+            bool ok = doConvert(score, outFile, plugin);
+            output["time"]    = timer.elapsed();
+            output["success"] = ok;
+            QString suffix = QFileInfo(outFile).suffix().toLower();
+            if (ok && (suffix == "wav" || suffix == "ogg" || suffix == "flac" || suffix == "mp3")) {
+                  const AudioExportStats& st = mscore->audioExportStats();
+                  QJsonObject audio;
+                  audio["duration"]       = st.duration;
+                  audio["renderTime"]     = st.renderTime;
+                  audio["encodeTime"]     = st.encodeTime;
+                  audio["realtimeFactor"] = st.realtimeFactor();
+                  audio["spilled"]        = st.spilled;
+                  audio["peak"]           = st.peak;
+                  audio["gain"]           = st.gain;
+                  if (qIsFinite(st.loudness))
+                        audio["loudness"] = st.loudness;
+                  output["audio"] = audio;
+                  }
+            else if (ok && (suffix == "png" || suffix == "svg")) {
+                  const ImageExportStats& st = mscore->imageExportStats();
+                  QJsonObject image;
+                  image["pages"]          = st.pages;
+                  image["threads"]        = st.threads;
+                  image["renderTime"]     = st.renderTime;
+                  image["pagesPerSecond"] = st.pagesPerSecond();
+                  output["image"] = image;
+                  }
+            outputs.append(output);
+            plugin.clear();                     // run a plugin only once
+            rv = rv && ok;
+            }
+      delete score;
+
+      report["outputs"] = outputs;
+      report["success"] = rv;
+      printJobReport(report);
+      return rv;
+      }
+
+//---------------------------------------------------------
+//   readConvertJob
+//    one object of a job file
+//---------------------------------------------------------
+
+static bool readConvertJob(const QJsonObject& obj, ConvertJob* job)
+      {
+      for (const auto& key : obj.keys()) {
+            QJsonValue val = obj.value(key);
+            if (key == "in")
+                  job->inFile = val.toString();
+            else if (key == "out") {
+                  // "out" is a file name or an array of file names
+                  if (val.isArray()) {
+                        for (const auto o : val.toArray())
+                              job->outFiles.append(o.toString());
+                        }
+                  else
+                        job->outFiles.append(val.toString());
+                  }
+            else if (key == "plugin")
+                  job->plugin = val.toString();
+            else {
+                  fprintf(stderr, "unknown key <%s>\n", qPrintable(key));
+                  return false;
+                  }
+            }
+      if (job->inFile.isEmpty() || (job->outFiles.isEmpty() && job->plugin.isEmpty())) {
+            fprintf(stderr, "cannot convert <%s> to <%s>\n", qPrintable(job->inFile), qPrintable(job->outFiles.join(", ")));
+            return false;
+            }
+      return true;
+      }
+
+//---------------------------------------------------------
+//   readConvertJobs
+//---------------------------------------------------------
+
+static bool readConvertJobs(const QString& jsonFile, QList<ConvertJob>* jobs)
       {
       QFile f(jsonFile);
       if (!f.open(QIODevice::ReadOnly)) {
@@ -2400,33 +2538,346 @@ static bool doProcessJob(QString jsonFile)
             }
       QJsonArray a = doc.array();
       for (const auto i : a) {
-            QString inFile;
-            QString outFile;
-            QString plugin;
             if (!i.isObject()) {
                   fprintf(stderr, "array value is not an object\n");
                   return false;
                   }
             QJsonObject obj = i.toObject();
-            for (const auto& key : obj.keys()) {
-                  QString val = obj.value(key).toString();
-                  if (key == "in")
-                        inFile = val;
-                  else if (key == "out")
-                        outFile = val;
-                  else if (key == "plugin")
-                        plugin = val;
-                  else {
-                        fprintf(stderr, "unknown key <%s>\n", qPrintable(key));
-                        return false;
-                        }
-                  }
-            if (!convert(inFile, outFile, plugin))
+            if (obj.isEmpty())            // allow a trailing {} entry
+                  continue;
+            ConvertJob job;
+            if (!readConvertJob(obj, &job))
                   return false;
+            jobs->append(job);
             }
       return true;
       }
 
+//---------------------------------------------------------
+//   jobWorkerArguments
+//    the command line of this process without the job
+//    file and the number of workers
+//---------------------------------------------------------
+
+static QStringList jobWorkerArguments()
+      {
+      static const QStringList valueOptions { "-j", "--job", "-J", "--job-workers" };
+      QStringList args;
+      QStringList al = QCoreApplication::arguments().mid(1);
+      for (int i = 0; i < al.size(); ++i) {
+            const QString& a = al[i];
+            if (valueOptions.contains(a)) {
+                  ++i;                          // skip the value
+                  continue;
+                  }
+            if (a.startsWith("--job=") || a.startsWith("--job-workers=")
+               || (!a.startsWith("--") && (a.startsWith("-j") || a.startsWith("-J"))))
+                  continue;
+            args.append(a);
+            }
+      return args;
+      }
+
+//---------------------------------------------------------
+//   convertJobLine
+//    a job as one line of json for a worker
+//---------------------------------------------------------
+
+static QByteArray convertJobLine(const ConvertJob& job)
+      {
+      QJsonObject obj;
+      obj["in"] = job.inFile;
+      if (!job.outFiles.isEmpty())
+            obj["out"] = QJsonArray::fromStringList(job.outFiles);
+      if (!job.plugin.isEmpty())
+            obj["plugin"] = job.plugin;
+      return QJsonDocument(obj).toJson(QJsonDocument::Compact).append('\n');
+      }
+
+//---------------------------------------------------------
+//   processJobLines
+//    worker side of runJobWorkers(): convert the jobs
+//    read from stdin one line at a time until the input is
+//    closed. Every job, also an invalid one, answers with
+//    exactly one report line, which asks for the next job.
+//---------------------------------------------------------
+
+static bool processJobLines()
+      {
+      QFile in;
+      if (!in.open(stdin, QIODevice::ReadOnly)) {
+            fprintf(stderr, "cannot read jobs from stdin\n");
+            return false;
+            }
+      int worker = qgetenv("MSCORE_JOB_WORKER").toInt();
+      bool rv = true;
+      for (;;) {
+            QByteArray line = in.readLine();
+            if (line.isEmpty())
+                  break;
+            ConvertJob job;
+            if (!readConvertJob(QJsonDocument::fromJson(line).object(), &job)) {
+                  QJsonObject report;
+                  report["in"]      = job.inFile;
+                  report["worker"]  = worker;
+                  report["success"] = false;
+                  report["error"]   = QString("invalid job");
+                  printJobReport(report);
+                  rv = false;
+                  continue;
+                  }
+            rv = processConvertJob(job, worker) && rv;
+            }
+      return rv;
+      }
+
+//---------------------------------------------------------
+//   runJobWorkers
+//    start the workers as new mscore processes with the
+//    same options and hand out the jobs one at a time:
+//    a worker gets the next job as soon as it reported the
+//    last one, so a slow score does not hold up the jobs
+//    behind it. The report lines of the workers are passed
+//    to stdout whole.
+//---------------------------------------------------------
+
+static bool runJobWorkers(const QList<ConvertJob>& jobs, int workers)
+      {
+      QStringList args = jobWorkerArguments() << "-j" << "-";
+      QEventLoop loop;
+      QList<QProcess*> processes;
+      QList<QByteArray> buffers;
+      int next    = 0;
+      int running = 0;
+      bool rv     = true;
+
+      auto sendJob = [&jobs, &next](QProcess* p) {
+            if (next < jobs.size())
+                  p->write(convertJobLine(jobs[next++]));
+            else
+                  p->closeWriteChannel();       // the worker quits at the end of its input
+            };
+
+      for (int worker = 0; worker < workers; ++worker) {
+            QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+            env.insert("MSCORE_JOB_WORKER", QString::number(worker));
+            QProcess* p = new QProcess;
+            p->setProcessEnvironment(env);
+            p->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+            int idx = processes.size();
+            processes.append(p);
+            buffers.append(QByteArray());
+
+            QObject::connect(p, &QProcess::readyReadStandardOutput, [&, p, idx]() {
+                  QByteArray& buffer = buffers[idx];
+                  buffer.append(p->readAllStandardOutput());
+                  int n;
+                  while ((n = buffer.indexOf('\n')) != -1) {
+                        QByteArray line = buffer.left(n + 1);
+                        buffer.remove(0, n + 1);
+                        fwrite(line.constData(), 1, line.size(), stdout);
+                        fflush(stdout);
+                        if (QJsonDocument::fromJson(line).isObject())
+                              sendJob(p);
+                        }
+                  });
+            QObject::connect(p, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
+               [&, idx](int exitCode, QProcess::ExitStatus exitStatus) {
+                  if (exitStatus != QProcess::NormalExit || exitCode != 0) {
+                        fprintf(stderr, "worker %d failed\n", idx);
+                        rv = false;
+                        }
+                  if (--running == 0)
+                        loop.quit();
+                  });
+
+            p->start(QCoreApplication::applicationFilePath(), args);
+            if (!p->waitForStarted(-1)) {
+                  fprintf(stderr, "cannot start worker: %s\n", qPrintable(p->errorString()));
+                  rv = false;
+                  continue;
+                  }
+            ++running;
+            sendJob(p);
+            }
+      if (running)
+            loop.exec();
+      if (next < jobs.size()) {
+            fprintf(stderr, "%d jobs not converted\n", jobs.size() - next);
+            rv = false;
+            }
+      for (int i = 0; i < processes.size(); ++i) {
+            if (!buffers[i].isEmpty())          // output without final newline
+                  fwrite(buffers[i].constData(), 1, buffers[i].size(), stdout);
+            delete processes[i];
+            }
+      fflush(stdout);
+      return rv;
+      }
+
+//---------------------------------------------------------
+//   doProcessJob
+//    with more than one worker, the jobs are converted by
+//    worker processes, see runJobWorkers(); a worker itself
+//    reads its jobs from stdin ("-j -").
+//    Every job prints one line of json with timing and
+//    result to stdout.
+//---------------------------------------------------------
+
+static bool doProcessJob(QString jsonFile)
+      {
+      if (jsonFile == "-")
+            return processJobLines();
+
+      QList<ConvertJob> jobs;
+      if (!readConvertJobs(jsonFile, &jobs))
+            return false;
+
+      int workers = qBound(1, jobWorkers, qMax(1, jobs.size()));
+      if (workers > 1)
+            return runJobWorkers(jobs, workers);
+
+      bool rv = true;
+      for (const ConvertJob& job : jobs)
+            rv = processConvertJob(job, 0) && rv;
+      return rv;
+      }
+
+//---------------------------------------------------------
+//   doPlaybackBenchmark
+//    play every score through sequencer and synthesizer
+//    with the null driver and print one line of json per
+//    score with realtime factor, callback durations, load
+//    and voice counts. Without wall clock the periods are
+//    processed as fast as possible.
+//---------------------------------------------------------
+
+static bool doPlaybackBenchmark(const QStringList& files)
+      {
+      if (files.isEmpty()) {
+            fprintf(stderr, "no score to play\n");
+            return false;
+            }
+      // play every score exactly once
+      getAction("loop")->setChecked(false);
+      getAction("countin")->setChecked(false);
+
+      Seq* s             = new Seq();
+      NullDriver* driver = new NullDriver(s, benchmarkWallClock);
+      if (benchmarkPeriod > 0)
+            driver->setPeriodSize(benchmarkPeriod);
+      MasterSynthesizer* synti = synthesizerFactory();
+      MScore::sampleRate = driver->sampleRate();
+      synti->setSampleRate(MScore::sampleRate);
+      synti->init();
+      s->setDriver(driver);
+      s->setMasterSynthesizer(synti);
+      seq         = s;
+      MScore::seq = s;
+
+      bool rv = true;
+      for (const QString& file : files) {
+            QJsonObject report;
+            report["in"] = file;
+            Score* score = mscore->readScore(file);
+            if (!score) {
+                  report["success"] = false;
+                  report["error"]   = QString("cannot read <%1>").arg(file);
+                  printJobReport(report);
+                  rv = false;
+                  continue;
+                  }
+            if (!synti->setState(score->synthesizerState()))
+                  synti->init();
+            s->setScore(score);
+            if (!s->canStart()) {
+                  report["success"] = false;
+                  report["error"]   = QString("nothing to play in <%1>").arg(file);
+                  printJobReport(report);
+                  s->setScore(0);
+                  delete score;
+                  rv = false;
+                  continue;
+                  }
+
+            driver->resetStats();
+            QElapsedTimer timer;
+            timer.start();
+            s->start();
+            // the sequencer follows the transport state of the driver
+            // in the next period
+            do {
+                  driver->pull();
+                  } while (driver->getState() == Transport::PLAY || s->isPlaying());
+            qint64 elapsed = timer.nsecsElapsed();
+            // every event is played once and in order
+            int events     = s->playlistSize();
+            int dispatched = s->dispatched();
+            int unordered  = s->unordered();
+            s->setScore(0);
+            delete score;
+
+            const DriverStats& st = driver->stats();
+            double duration       = st.duration(driver->sampleRate());
+            report["sampleRate"]     = driver->sampleRate();
+            report["periodSize"]     = driver->bufferSize();
+            report["wallClock"]      = driver->wallClock();
+            report["duration"]       = duration;
+            report["time"]           = elapsed / 1000000.0;
+            report["realtimeFactor"] = st.wallTime ? duration * 1e9 / st.wallTime : 0.0;
+            report["periods"]        = st.periods;
+            report["xruns"]          = st.xruns;
+            report["cpuTime"]        = st.cpuTime / 1000000.0;
+            report["load"]           = duration > 0.0 ? st.wallTime / (duration * 1e9) : 0.0;
+
+            QJsonObject callback;
+            callback["avg"] = st.periods ? st.wallTime / 1000.0 / st.periods : 0.0;
+            callback["max"] = st.maxCallback / 1000.0;
+            report["callback"] = callback;
+
+            QJsonObject voices;
+            voices["avg"] = st.periods ? double(st.voices) / st.periods : 0.0;
+            voices["max"] = st.maxVoices;
+            report["voices"] = voices;
+
+            // buckets are given by their lower limit
+            QJsonArray latency;
+            for (int i = 0; i < DriverStats::LATENCY_BUCKETS; ++i) {
+                  QJsonObject bucket;
+                  bucket["us"]    = i ? DriverStats::latencyBucketLimit(i - 1) : 0;
+                  bucket["count"] = st.latency[i];
+                  latency.append(bucket);
+                  }
+            report["latencyHistogram"] = latency;
+            QJsonArray load;
+            for (int i = 0; i < DriverStats::LOAD_BUCKETS; ++i) {
+                  QJsonObject bucket;
+                  bucket["percent"] = i * 10;
+                  bucket["count"]   = st.load[i];
+                  load.append(bucket);
+                  }
+            report["loadHistogram"] = load;
+            report["events"]        = events;
+            report["dispatched"]    = dispatched;
+            report["unordered"]     = unordered;
+            if (dispatched != events || unordered) {
+                  report["success"] = false;
+                  report["error"]   = QString("%1 of %2 events played, %3 out of order").arg(dispatched).arg(events).arg(unordered);
+                  rv = false;
+                  }
+            else
+                  report["success"] = true;
+            printJobReport(report);
+            }
+
+      s->exit();
+      seq         = 0;
+      MScore::seq = 0;
+      delete s;
+      delete synti;
+      return rv;
+      }
+
 //---------------------------------------------------------
 //   processNonGui
 //---------------------------------------------------------
@@ -2459,6 +2910,8 @@ static bool processNonGui(const QStringList& argv)
             }
       bool rv = true;
       if (converterMode) {
+            if (playbackBenchmark)
+                  return doPlaybackBenchmark(argv);
             if (processJob)
                   return doProcessJob(jsonFileName);
             else
@@ -2522,6 +2975,8 @@ MasterSynthesizer* synthesizerFactory()
       // ms->registerEffect(1, new Freeverb);
       ms->setEffect(0, 1);
       ms->setEffect(1, 0);
+      ms->setRenderThreads(preferences.synthesizerThreads);
+      FluidS::Fluid::setSampleCacheSize(preferences.soundFontCacheSize);
       return ms;
       }
 
@@ -5097,11 +5552,6 @@ bool MuseScore::saveMp3(Score* score, const QString& name)
 #ifndef USE_LAME
       return false;
 #else
-      EventMap events;
-      score->renderMidi(&events);
-      if(events.size() == 0)
-            return false;
-
       MP3Exporter exporter;
       if (!exporter.loadLibrary(MP3Exporter::AskUser::MAYBE)) {
             QSettings settings;
@@ -5168,21 +5618,6 @@ bool MuseScore::saveMp3(Score* score, const QString& name)
 
       int bufferSize   = exporter.getOutBufferSize();
       uchar* bufferOut = new uchar[bufferSize];
-      MasterSynthesizer* synti = synthesizerFactory();
-      synti->init();
-      synti->setSampleRate(sampleRate);
-      if (MScore::noGui) { // use score settings if possible
-            bool r = synti->setState(score->synthesizerState());
-            if (!r)
-                  synti->init();
-            }
-      else { // use current synth settings
-            bool r = synti->setState(mscore->synthesizerState());
-            if (!r)
-                  synti->init();
-            }
-
-      MScore::sampleRate = sampleRate;
 
       QProgressDialog progress(this);
       progress.setWindowFlags(Qt::WindowFlags(Qt::Dialog | Qt::FramelessWindowHint | Qt::WindowTitleHint));
@@ -5192,168 +5627,94 @@ bool MuseScore::saveMp3(Score* score, const QString& name)
       progress.setLabelText(tr("Exporting..."));
       if (!MScore::noGui)
             progress.show();
+      progress.setRange(0, 1000);
 
-      static const int FRAMES = 512;
-      float bufferL[FRAMES];
-      float bufferR[FRAMES];
-
-      float  peak = 0.0;
-      double gain = 1.0;
-      EventMap::const_iterator endPos = events.cend();
-      --endPos;
-      const int et = (score->utick2utime(endPos->first) + 1) * MScore::sampleRate;
-      const int maxEndTime = (score->utick2utime(endPos->first) + 3) * MScore::sampleRate;
-      progress.setRange(0, et);
-
-      for (int pass = 0; pass < 2; ++pass) {
-            EventMap::const_iterator playPos;
-            playPos = events.cbegin();
-            synti->allSoundsOff(-1);
-
-            //
-            // init instruments
-            //
-            foreach(Part* part, score->parts()) {
-                  const InstrumentList* il = part->instruments();
-                  for(auto i = il->begin(); i!= il->end(); i++) {
-                        foreach(const Channel* a, i->second->channel()) {
-                              a->updateInitList();
-                              foreach(MidiCoreEvent e, a->init) {
-                                    if (e.type() == ME_INVALID)
-                                          continue;
-                                    e.setChannel(a->channel);
-                                    int syntiIdx= synti->index(score->midiMapping(a->channel)->articulation->synti);
-                                    synti->play(e, syntiIdx);
-                                    }
-                              }
-                        }
-                  }
-
-            int playTime = 0.0;
-
-            for (;;) {
-                  unsigned frames = FRAMES;
-                  float max = 0;
-                  //
-                  // collect events for one segment
-                  //
-                  memset(bufferL, 0, sizeof(float) * FRAMES);
-                  memset(bufferR, 0, sizeof(float) * FRAMES);
-                  double endTime = playTime + frames;
-
-                  float* l = bufferL;
-                  float* r = bufferR;
-
-                  for (; playPos != events.cend(); ++playPos) {
-                        double f = score->utick2utime(playPos->first) * MScore::sampleRate;
-                        if (f >= endTime)
-                              break;
-                        int n = f - playTime;
-                        if (n) {
-                              float bu[n * 2];
-                              memset(bu, 0, sizeof(float) * 2 * n);
+      // the first 90% of the bar tracks synthesis, the remainder the encoder
+      static const float RENDER_PROGRESS = 0.9;
+      auto updateProgress = [&progress](float v) -> bool {
+            if (MScore::noGui)
+                  return true;
+            if (progress.wasCanceled())
+                  return false;
+            progress.setValue(v * 1000);
+            qApp->processEvents();
+            return true;
+            };
 
-                              synti->process(n, bu);
-                              float* sp = bu;
-                              for (int i = 0; i < n; ++i) {
-                                    *l++ = *sp++;
-                                    *r++ = *sp++;
-                                    }
-                              playTime  += n;
-                              frames    -= n;
-                              }
-                        const NPlayEvent& e = playPos->second;
-                        if (e.isChannelEvent()) {
-                              int channelIdx = e.channel();
-                              Channel* c = score->midiMapping(channelIdx)->articulation;
-                              if (!c->mute) {
-                                    synti->play(e, synti->index(c->synti));
-                                    }
-                              }
+      AudioSpillBuffer buffer;
+      LoudnessMeter meter(sampleRate);
+      bool ok = renderAudio(score, &buffer, &meter, [&updateProgress](float v) { return updateProgress(v * RENDER_PROGRESS); });
+      if (ok && buffer.peak() == 0.0)
+            qDebug("song is empty");
+      else if (ok) {
+            QElapsedTimer timer;
+            timer.start();
+            const double gain = audioExportGain(buffer, meter);
+            _audioExportStats.gain = gain;
+
+            static const int FRAMES = 512;
+            float audio[FRAMES * 2];
+            float bufferL[FRAMES];
+            float bufferR[FRAMES];
+            for (long long pos = 0; pos < buffer.frames(); pos += FRAMES) {
+                  int n = buffer.read(pos, audio, FRAMES);
+                  if (n == 0) {
+                        qDebug("exportmp3: reading rendered audio failed");
+                        ok = false;
+                        break;
                         }
-                  if (frames) {
-                        float bu[frames * 2];
-                        memset(bu, 0, sizeof(float) * 2 * frames);
-                        synti->process(frames, bu);
-                        float* sp = bu;
-                        for (unsigned i = 0; i < frames; ++i) {
-                              *l++ = *sp++;
-                              *r++ = *sp++;
-                              }
-                        playTime += frames;
+                  // the encoder always takes FRAMES samples
+                  memset(bufferL, 0, sizeof(bufferL));
+                  memset(bufferR, 0, sizeof(bufferR));
+                  for (int i = 0; i < n; ++i) {
+                        bufferL[i] = audio[i * 2] * gain;
+                        bufferR[i] = audio[i * 2 + 1] * gain;
                         }
-
-                  if (pass == 1) {
-                        for (int i = 0; i < FRAMES; ++i) {
-                              max = qMax(max, qAbs(bufferL[i]));
-                              max = qMax(max, qAbs(bufferR[i]));
-                              bufferL[i] *= gain;
-                              bufferR[i] *= gain;
-                              }
-                        long bytes;
-                        if (FRAMES < inSamples)
-                              bytes = exporter.encodeRemainder(bufferL, bufferR,  FRAMES , bufferOut);
-                        else
-                              bytes = exporter.encodeBuffer(bufferL, bufferR, bufferOut);
-                        if (bytes < 0) {
-                              if (MScore::noGui)
-                                    qDebug("exportmp3: error from encoder: %ld", bytes);
-                              else
-                                    QMessageBox::warning(0,
-                                       tr("Encoding Error"),
-                                       tr("Error %1 returned from MP3 encoder").arg(bytes),
-                                       QString::null, QString::null);
-                              break;
-                              }
+                  long bytes;
+                  if (FRAMES < inSamples)
+                        bytes = exporter.encodeRemainder(bufferL, bufferR,  FRAMES , bufferOut);
+                  else
+                        bytes = exporter.encodeBuffer(bufferL, bufferR, bufferOut);
+                  if (bytes < 0) {
+                        if (MScore::noGui)
+                              qDebug("exportmp3: error from encoder: %ld", bytes);
                         else
-                              file.write((char*)bufferOut, bytes);
-                        }
-                  else {
-                        for (int i = 0; i < FRAMES; ++i) {
-                              max = qMax(max, qAbs(bufferL[i]));
-                              max = qMax(max, qAbs(bufferR[i]));
-                              peak = qMax(peak, qAbs(bufferL[i]));
-                              peak = qMax(peak, qAbs(bufferR[i]));
-                              }
-                        }
-                  playTime = endTime;
-                  if (!MScore::noGui) {
-                        if (progress.wasCanceled())
-                              break;
-                        progress.setValue((pass * et + playTime) / 2);
-                        qApp->processEvents();
+                              QMessageBox::warning(0,
+                                 tr("Encoding Error"),
+                                 tr("Error %1 returned from MP3 encoder").arg(bytes),
+                                 QString::null, QString::null);
+                        ok = false;
+                        break;
                         }
-                  if (playTime >= et)
-                        synti->allNotesOff(-1);
-                  // create sound until the sound decays
-                  if (playTime >= et && max * peak < 0.000001)
+                  if (file.write((char*)bufferOut, bytes) != bytes) {
+                        qDebug("exportmp3: writing <%s> failed: %s", qPrintable(name), qPrintable(file.errorString()));
+                        ok = false;
                         break;
-                  // hard limit
-                  if (playTime > maxEndTime)
+                        }
+                  if (!updateProgress(RENDER_PROGRESS + (1.0 - RENDER_PROGRESS) * (pos + n) / buffer.frames()))
                         break;
                   }
-            if (progress.wasCanceled())
-                  break;
-            if (pass == 0 && peak == 0.0) {
-                  qDebug("song is empty");
-                  break;
-                  }
-            gain = 0.99 / peak;
+            _audioExportStats.encodeTime = timer.elapsed();
             }
 
       long bytes = exporter.finishStream(bufferOut);
-      if (bytes > 0L)
-            file.write((char*)bufferOut, bytes);
+      if (bytes > 0L && file.write((char*)bufferOut, bytes) != bytes) {
+            qDebug("exportmp3: writing <%s> failed: %s", qPrintable(name), qPrintable(file.errorString()));
+            ok = false;
+            }
+      if (ok && !file.flush()) {          // a full disk shows up here at the latest
+            qDebug("exportmp3: writing <%s> failed: %s", qPrintable(name), qPrintable(file.errorString()));
+            ok = false;
+            }
 
       bool wasCanceled = progress.wasCanceled();
       progress.close();
-      delete synti;
       delete[] bufferOut;
       file.close();
-      if (wasCanceled)
+      if (wasCanceled || !ok)
             file.remove();
       MScore::sampleRate = oldSampleRate;
-      return true;
+      return ok && !wasCanceled;
 #endif
       }
 
@@ -5410,13 +5771,14 @@ int main(int argc, char* av[])
       parser.addOption(QCommandLineOption({"L", "layout-debug"}, "Layout debug mode"));
       parser.addOption(QCommandLineOption({"s", "no-synthesizer"}, "No internal synthesizer"));
       parser.addOption(QCommandLineOption({"m", "no-midi"}, "No MIDI"));
-      parser.addOption(QCommandLineOption({"a", "use-audio"}, "Use audio driver: jack, alsa, pulse, or portaudio", "driver"));
+      parser.addOption(QCommandLineOption({"a", "use-audio"}, "Use audio driver: jack, alsa, pulse, portaudio, or null", "driver"));
       parser.addOption(QCommandLineOption({"n", "new-score"}, "Start with new score"));
       parser.addOption(QCommandLineOption({"I", "dump-midi-in"}, "Dump midi input"));
       parser.addOption(QCommandLineOption({"O", "dump-midi-out"}, "Dump midi output"));
       parser.addOption(QCommandLineOption({"o", "export-to"}, "Export to 'file'. Format depends on file's extension", "file"));
       parser.addOption(QCommandLineOption({"r", "image-resolution"}, "Used with '-o <file>.png'. Set output resolution for image export", "DPI"));
       parser.addOption(QCommandLineOption({"T", "trim-image"}, "Used with '-o <file>.png' and '-o <file.svg>'. Trim exported image with specified margin (in pixels)", "margin"));
+      parser.addOption(QCommandLineOption(      "render-threads", "Used with '-o <file>.png' and '-o <file>.svg'. Number of pages rendered in parallel, 1 renders one page after the other", "count"));
       parser.addOption(QCommandLineOption({"x", "gui-scaling"}, "Set scaling factor for GUI elements", "factor"));
       parser.addOption(QCommandLineOption({"D", "monitor-resolution"}, "Specify monitor resolution", "DPI"));
       parser.addOption(QCommandLineOption({"S", "style"}, "Load style file", "style"));
@@ -5426,6 +5788,10 @@ int main(int argc, char* av[])
       parser.addOption(QCommandLineOption({"R", "revert-settings"}, "Revert to default preferences"));
       parser.addOption(QCommandLineOption({"i", "load-icons"}, "Load icons from INSTALLPATH/icons"));
       parser.addOption(QCommandLineOption({"j", "job"}, "Process a conversion job", "file"));
+      parser.addOption(QCommandLineOption({"J", "job-workers"}, "Used with '-j <file>', number of parallel worker processes", "count"));
+      parser.addOption(QCommandLineOption(      "benchmark-playback", "Play the score files through sequencer and synthesizer without audio device and print timing as json"));
+      parser.addOption(QCommandLineOption(      "benchmark-period", "Used with '--benchmark-playback', frames per period", "frames"));
+      parser.addOption(QCommandLineOption(      "benchmark-wall-clock", "Used with '--benchmark-playback', process the periods at the pace of a sound card instead of as fast as possible"));
       parser.addOption(QCommandLineOption({"e", "experimental"}, "Enable experimental features"));
       parser.addOption(QCommandLineOption({"c", "config-folder"}, "Override configuration and settings folder", "dir"));
       parser.addOption(QCommandLineOption({"t", "test-mode"}, "Set test mode flag for all files"));
@@ -5434,6 +5800,10 @@ int main(int argc, char* av[])
       parser.addOption(QCommandLineOption({"P", "export-score-parts"}, "Used with '-o <file>.pdf', export score and parts"));
       parser.addOption(QCommandLineOption({"f", "force"}, "Used with '-o <file>', ignore warnings reg. score being corrupted or from wrong version"));
       parser.addOption(QCommandLineOption({"b", "bitrate"}, "Used with '-o <file>.mp3', sets bitrate", "bitrate"));
+      parser.addOption(QCommandLineOption(      "audio-gain", "Used with '-o <file>.wav|.ogg|.flac|.mp3', apply a fixed gain instead of normalizing", "dB"));
+      parser.addOption(QCommandLineOption(      "audio-loudness", "Used with '-o <file>.wav|.ogg|.flac|.mp3', normalize to an integrated loudness target", "LUFS"));
+      parser.addOption(QCommandLineOption(      "skip-validation", "Import MusicXML files without validating them"));
+      parser.addOption(QCommandLineOption(      "lazy-validation", "Validate MusicXML files only if their import fails"));
 
       parser.addPositionalArgument("scorefiles", "The files to open", "[scorefile...]");
 
@@ -5473,6 +5843,28 @@ int main(int argc, char* av[])
                   parser.showHelp(EXIT_FAILURE);
                   }
             }
+      if (parser.isSet("J")) {
+            QString temp = parser.value("J");
+            if (temp.isEmpty() || !processJob)
+                   parser.showHelp(EXIT_FAILURE);
+            bool ok = false;
+            jobWorkers = temp.toInt(&ok);
+            if (!ok || jobWorkers < 1)
+                   parser.showHelp(EXIT_FAILURE);
+            }
+      if ((playbackBenchmark = parser.isSet("benchmark-playback"))) {
+            MScore::noGui = true;
+            converterMode = true;
+            }
+      if (parser.isSet("benchmark-period")) {
+            bool ok = false;
+            benchmarkPeriod = parser.value("benchmark-period").toInt(&ok);
+            if (!ok || benchmarkPeriod < 1 || !playbackBenchmark)
+                   parser.showHelp(EXIT_FAILURE);
+            }
+      benchmarkWallClock = parser.isSet("benchmark-wall-clock");
+      if (benchmarkWallClock && !playbackBenchmark)
+            parser.showHelp(EXIT_FAILURE);
       if ((pluginMode = parser.isSet("p"))) {
             MScore::noGui = true;
             pluginName = parser.value("p");
@@ -5495,6 +5887,12 @@ int main(int argc, char* av[])
             if (!ok)
                   trimMargin = -1;
            }
+      if (parser.isSet("render-threads")) {
+            bool ok = false;
+            renderThreads = parser.value("render-threads").toInt(&ok);
+            if (!ok || renderThreads < 0)
+                   parser.showHelp(EXIT_FAILURE);
+            }
       if (parser.isSet("x")) {
             QString temp = parser.value("x");
             if (temp.isEmpty())
@@ -5553,6 +5951,24 @@ int main(int argc, char* av[])
             if (!ok)
                   preferences.exportMp3BitRate = 128;
            }
+      double audioGain = 0.0;
+      bool useAudioGain = parser.isSet("audio-gain");
+      if (useAudioGain) {
+            bool ok = false;
+            audioGain = parser.value("audio-gain").toDouble(&ok);
+            if (!ok)
+                   parser.showHelp(EXIT_FAILURE);
+            }
+      double audioLoudness = 0.0;
+      bool useAudioLoudness = parser.isSet("audio-loudness");
+      if (useAudioLoudness) {
+            bool ok = false;
+            audioLoudness = parser.value("audio-loudness").toDouble(&ok);
+            if (!ok)
+                   parser.showHelp(EXIT_FAILURE);
+            }
+      bool skipValidation = parser.isSet("skip-validation");
+      bool lazyValidation = parser.isSet("lazy-validation");
 
       QStringList argv = parser.positionalArguments();
 
@@ -5656,6 +6072,18 @@ int main(int argc, char* av[])
 
       if (converterDpi == 0)
             converterDpi = preferences.pngResolution;
+      if (useAudioGain) {
+            preferences.exportAudioGain      = audioGain;
+            preferences.exportAudioNormalize = AudioNormalize::GAIN;
+            }
+      if (useAudioLoudness) {
+            preferences.exportAudioLoudness  = audioLoudness;
+            preferences.exportAudioNormalize = AudioNormalize::LOUDNESS;
+            }
+      if (skipValidation)
+            preferences.musicxmlImportValidation = MusicxmlValidation::NO;
+      else if (lazyValidation)
+            preferences.musicxmlImportValidation = MusicxmlValidation::ON_ERROR;
 
       QSplashScreen* sc = 0;
       QTimer* stimer = 0;
@@ -90,6 +90,8 @@ class Driver;
 class Seq;
 class ImportMidiPanel;
 class Startcenter;
+class AudioSpillBuffer;
+class LoudnessMeter;
 class HelpBrowser;
 
 struct PluginDescription;
@@ -110,6 +112,36 @@ struct IconAction {
       const char* action;
       };
 
+//---------------------------------------------------------
+//   AudioExportStats
+//    timing and level of the last audio export
+//---------------------------------------------------------
+
+struct AudioExportStats {
+      double duration   { 0.0 };          // seconds of audio
+      qint64 renderTime { 0 };            // ms
+      qint64 encodeTime { 0 };            // ms
+      bool spilled      { false };        // rendered audio did not fit into memory
+      float peak        { 0.0 };
+      double loudness   { 0.0 };          // LUFS
+      double gain       { 1.0 };
+
+      double realtimeFactor() const { return renderTime ? duration * 1000.0 / renderTime : 0.0; }
+      };
+
+//---------------------------------------------------------
+//   ImageExportStats
+//    timing of the last png or svg export
+//---------------------------------------------------------
+
+struct ImageExportStats {
+      int pages         { 0 };
+      int threads       { 1 };            // pages rendered in parallel
+      qint64 renderTime { 0 };            // ms, including writing the files
+
+      double pagesPerSecond() const { return renderTime ? pages * 1000.0 / renderTime : 0.0; }
+      };
+
 //---------------------------------------------------------
 //   LanguageItem
 //---------------------------------------------------------
@@ -220,6 +252,8 @@ class MuseScore : public QMainWindow, public MuseScoreCore {
       ImportMidiPanel* importmidiPanel     { 0 };
       QFrame* importmidiShowPanel;
       QSplitter* mainWindow;
+      AudioExportStats _audioExportStats;
+      ImageExportStats _imageExportStats;
 
       QMenu* menuView;
       QMenu* menuToolbars;
@@ -479,6 +513,8 @@ class MuseScore : public QMainWindow, public MuseScoreCore {
       void selectionChanged(SelState);
       void createNewWorkspace();
       void changeWorkspace(Workspace* p);
+      bool renderAudio(Score*, AudioSpillBuffer*, LoudnessMeter*, std::function<bool(float)> updateProgress);
+      double audioExportGain(const AudioSpillBuffer&, const LoudnessMeter&) const;
 
    public:
       MuseScore();
@@ -610,8 +646,10 @@ class MuseScore : public QMainWindow, public MuseScoreCore {
       bool saveAudio(Score*, const QString& name);
       bool canSaveMp3();
       bool saveMp3(Score*, const QString& name);
+      const AudioExportStats& audioExportStats() const { return _audioExportStats; }
       bool saveSvg(Score*, const QString& name);
       bool savePng(Score*, const QString& name);
+      const ImageExportStats& imageExportStats() const { return _imageExportStats; }
 //      bool saveLilypond(Score*, const QString& name);
       bool saveMidi(Score* score, const QString& name);
 
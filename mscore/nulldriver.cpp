@@ -0,0 +1,210 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <time.h>
+#include "seq.h"
+#include "nulldriver.h"
+#include "preferences.h"
+#include "synthesizer/msynthesizer.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   threadCpuTime
+//    cpu time of the calling thread in ns, 0 if the
+//    system cannot tell
+//---------------------------------------------------------
+
+static qint64 threadCpuTime()
+      {
+#ifdef CLOCK_THREAD_CPUTIME_ID
+      timespec ts;
+      if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+            return qint64(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+#endif
+      return 0;
+      }
+
+//---------------------------------------------------------
+//   add
+//    account one callback processing n frames; period is
+//    the audio duration of the frames in ns
+//---------------------------------------------------------
+
+void DriverStats::add(int n, qint64 wall, qint64 cpu, int voiceCount, qint64 period)
+      {
+      ++periods;
+      frames     += n;
+      wallTime   += wall;
+      cpuTime    += cpu;
+      maxCallback = qMax(maxCallback, wall);
+      if (wall > period)
+            ++xruns;
+      voices    += voiceCount;
+      maxVoices  = qMax(maxVoices, voiceCount);
+
+      int idx = 0;
+      while (idx < LATENCY_BUCKETS - 1 && wall >= latencyBucketLimit(idx) * 1000)
+            ++idx;
+      ++latency[idx];
+      ++load[qMin(int(wall * 10 / qMax(period, qint64(1))), LOAD_BUCKETS - 1)];
+      }
+
+//---------------------------------------------------------
+//   NullDriver
+//---------------------------------------------------------
+
+NullDriver::NullDriver(Seq* s, bool wallClock)
+   : Driver(s)
+      {
+      state       = Transport::STOP;
+      _sampleRate = preferences.alsaSampleRate;
+      _wallClock  = wallClock;
+      setPeriodSize(preferences.alsaPeriodSize);
+      }
+
+//---------------------------------------------------------
+//   ~NullDriver
+//---------------------------------------------------------
+
+NullDriver::~NullDriver()
+      {
+      stop();
+      }
+
+//---------------------------------------------------------
+//   init
+//---------------------------------------------------------
+
+bool NullDriver::init(bool)
+      {
+      return true;
+      }
+
+//---------------------------------------------------------
+//   start
+//    only a wall clock driver has a thread of its own
+//---------------------------------------------------------
+
+bool NullDriver::start(bool)
+      {
+      if (!_wallClock || running)
+            return true;
+      running = true;
+      thread  = std::thread(&NullDriver::run, this);
+      return true;
+      }
+
+//---------------------------------------------------------
+//   stop
+//---------------------------------------------------------
+
+bool NullDriver::stop()
+      {
+      if (running) {
+            running = false;
+            thread.join();
+            }
+      return true;
+      }
+
+//---------------------------------------------------------
+//   getState
+//---------------------------------------------------------
+
+Transport NullDriver::getState()
+      {
+      return state;
+      }
+
+//---------------------------------------------------------
+//   startTransport
+//---------------------------------------------------------
+
+void NullDriver::startTransport()
+      {
+      state = Transport::PLAY;
+      }
+
+//---------------------------------------------------------
+//   stopTransport
+//---------------------------------------------------------
+
+void NullDriver::stopTransport()
+      {
+      state = Transport::STOP;
+      }
+
+//---------------------------------------------------------
+//   setPeriodSize
+//    only while the driver thread is not running
+//---------------------------------------------------------
+
+void NullDriver::setPeriodSize(int n)
+      {
+      _periodSize = qBound(1, n, MasterSynthesizer::MAX_BUFFERSIZE / 2);
+      buffer.resize(_periodSize * 2);
+      }
+
+//---------------------------------------------------------
+//   periodLength
+//    in ns
+//---------------------------------------------------------
+
+qint64 NullDriver::periodLength() const
+      {
+      return qint64(_periodSize) * 1000000000LL / _sampleRate;
+      }
+
+//---------------------------------------------------------
+//   pull
+//    process one period in the calling thread; a wall
+//    clock driver then waits for the start of the next
+//    period. After a callback longer than its period
+//    the clock starts over, as a sound card does after
+//    an xrun.
+//---------------------------------------------------------
+
+void NullDriver::pull()
+      {
+      Clock::time_point t1 = Clock::now();
+      qint64 cpu = threadCpuTime();
+      seq->process(_periodSize, buffer.data());
+      cpu = threadCpuTime() - cpu;
+      Clock::time_point t2 = Clock::now();
+
+      qint64 wall = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+      MasterSynthesizer* synti = seq->synti();
+      _stats.add(_periodSize, wall, cpu, synti ? synti->voiceCount() : 0, periodLength());
+
+      if (_wallClock) {
+            deadline += std::chrono::nanoseconds(periodLength());
+            if (deadline < t2)
+                  deadline = t2;
+            else
+                  std::this_thread::sleep_until(deadline);
+            }
+      }
+
+//---------------------------------------------------------
+//   run
+//---------------------------------------------------------
+
+void NullDriver::run()
+      {
+      deadline = Clock::now();
+      while (running)
+            pull();
+      }
+
+}
+
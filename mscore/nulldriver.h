@@ -0,0 +1,101 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __NULLDRIVER_H__
+#define __NULLDRIVER_H__
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "driver.h"
+
+namespace Ms {
+
+enum class Transport : char;
+
+//---------------------------------------------------------
+//   DriverStats
+//    timing of the process callbacks of the null driver.
+//    Callback durations are counted in buckets of powers
+//    of two microseconds, the load in steps of 10% of
+//    the period length; the last bucket takes all longer
+//    callbacks.
+//---------------------------------------------------------
+
+struct DriverStats {
+      static const int LATENCY_BUCKETS = 16;
+      static const int LOAD_BUCKETS    = 11;
+
+      qint64 periods     { 0 };
+      qint64 frames      { 0 };
+      qint64 wallTime    { 0 };           // ns, sum of all callback durations
+      qint64 cpuTime     { 0 };           // ns, cpu time of the process thread in the callbacks
+      qint64 maxCallback { 0 };           // ns, worst case callback duration
+      qint64 xruns       { 0 };           // callbacks which took longer than their period
+      qint64 voices      { 0 };           // sum of the active voices of all periods
+      int maxVoices      { 0 };
+      qint64 latency[LATENCY_BUCKETS] { };
+      qint64 load[LOAD_BUCKETS]       { };
+
+      static qint64 latencyBucketLimit(int idx) { return 32LL << idx; }    ///< upper limit in us
+      void add(int n, qint64 wall, qint64 cpu, int voiceCount, qint64 period);
+      double duration(int sampleRate) const     { return double(frames) / sampleRate; }
+      };
+
+//---------------------------------------------------------
+//   NullDriver
+//    a driver without audio device. The sequencer is
+//    either pulled by the caller as fast as possible with
+//    pull(), or by the driver thread at the pace of a
+//    sound card ("wall clock"); the audio is discarded.
+//---------------------------------------------------------
+
+class NullDriver : public Driver {
+      typedef std::chrono::steady_clock Clock;
+
+      Transport state;
+      int _sampleRate;
+      int _periodSize;
+      bool _wallClock;
+      std::vector<float> buffer;
+      std::thread thread;
+      std::atomic<bool> running { false };
+      Clock::time_point deadline;
+      DriverStats _stats;
+
+      qint64 periodLength() const;
+      void run();
+
+   public:
+      NullDriver(Seq*, bool wallClock = true);
+      virtual ~NullDriver();
+      virtual bool init(bool hot = false) override;
+      virtual bool start(bool hotPlug = false) override;
+      virtual bool stop() override;
+      virtual Transport getState() override;
+      virtual void stopTransport() override;
+      virtual void startTransport() override;
+      virtual int sampleRate() const override   { return _sampleRate;         }
+      virtual int bufferSize() override         { return _periodSize;         }
+
+      void setPeriodSize(int n);
+      bool wallClock() const                    { return _wallClock;          }
+      void pull();
+
+      const DriverStats& stats() const          { return _stats;              }
+      void resetStats()                         { _stats = DriverStats();     }
+      };
+
+}
+#endif
+
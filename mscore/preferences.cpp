@@ -101,6 +101,8 @@ void Preferences::init()
       jackTimebaseMaster = false;
       usePortaudioAudio  = false;
       usePulseAudio      = false;
+      synthesizerThreads = 0;
+      soundFontCacheSize = 256;
 #if defined(Q_OS_MAC) || defined(Q_OS_WIN)
       usePortaudioAudio  = true;
       // Linux
@@ -139,11 +141,17 @@ void Preferences::init()
       midiExportRPNs           = false;
       MScore::playRepeats      = true;
       MScore::panPlayback      = true;
+      MScore::undoLimit         = 0;
+      MScore::undoMemoryLimit   = 512 * 1024 * 1024;
+      MScore::undoMergeInterval = 500;
+      MScore::incrementalLayout = true;
+      MScore::incrementalPlayback = true;
       instrumentList1          = ":/data/instruments.xml";
       instrumentList2          = "";
 
       musicxmlImportLayout     = true;
       musicxmlImportBreaks     = true;
+      musicxmlImportValidation = MusicxmlValidation::FULL;
       musicxmlExportLayout     = true;
       musicxmlExportBreaks     = MusicxmlExportBreaks::ALL;
 
@@ -205,6 +213,9 @@ void Preferences::init()
 #endif
       exportAudioSampleRate   = 44100;
       exportMp3BitRate        = 128;
+      exportAudioNormalize    = AudioNormalize::PEAK;
+      exportAudioGain         = 0.0;
+      exportAudioLoudness     = -16.0;
 
       workspace               = "Basic";
       exportPdfDpi            = 300;
@@ -254,6 +265,8 @@ void Preferences::write()
       s.setValue("jackTimebaseMaster", jackTimebaseMaster);
       s.setValue("usePortaudioAudio",  usePortaudioAudio);
       s.setValue("usePulseAudio",      usePulseAudio);
+      s.setValue("synthesizerThreads", synthesizerThreads);
+      s.setValue("soundFontCacheSize", soundFontCacheSize);
       s.setValue("rememberLastMidiConnections", rememberLastConnections);
 
       s.setValue("alsaDevice",         alsaDevice);
@@ -286,6 +299,11 @@ void Preferences::write()
 
       s.setValue("musicxmlImportLayout",  musicxmlImportLayout);
       s.setValue("musicxmlImportBreaks",  musicxmlImportBreaks);
+      switch(musicxmlImportValidation) {
+            case MusicxmlValidation::FULL:     s.setValue("musicxmlImportValidation", "full"); break;
+            case MusicxmlValidation::ON_ERROR: s.setValue("musicxmlImportValidation", "onerror"); break;
+            case MusicxmlValidation::NO:       s.setValue("musicxmlImportValidation", "no"); break;
+            }
       s.setValue("musicxmlExportLayout",  musicxmlExportLayout);
       switch(musicxmlExportBreaks) {
             case MusicxmlExportBreaks::ALL:     s.setValue("musicxmlExportBreaks", "all"); break;
@@ -315,6 +333,11 @@ void Preferences::write()
       s.setValue("importCharsetOve", importCharsetOve);
       s.setValue("importCharsetGP", importCharsetGP);
       s.setValue("warnPitchRange", MScore::warnPitchRange);
+      s.setValue("undoLimit", MScore::undoLimit);
+      s.setValue("undoMemoryLimit", int(MScore::undoMemoryLimit / (1024 * 1024)));    // MB
+      s.setValue("undoMergeInterval", MScore::undoMergeInterval);
+      s.setValue("incrementalLayout", MScore::incrementalLayout);
+      s.setValue("incrementalPlayback", MScore::incrementalPlayback);
       s.setValue("followSong", followSong);
 
       s.setValue("useOsc", useOsc);
@@ -336,6 +359,9 @@ void Preferences::write()
       s.setValue("nativeDialogs", nativeDialogs);
       s.setValue("exportAudioSampleRate", exportAudioSampleRate);
       s.setValue("exportMp3BitRate", exportMp3BitRate);
+      s.setValue("exportAudioNormalize", int(exportAudioNormalize));
+      s.setValue("exportAudioGain", exportAudioGain);
+      s.setValue("exportAudioLoudness", exportAudioLoudness);
 
       s.setValue("workspace", workspace);
       s.setValue("exportPdfDpi", exportPdfDpi);
@@ -424,6 +450,8 @@ void Preferences::read()
       useJackTransport   = s.value("useJackTransport",  useJackTransport).toBool();
       usePortaudioAudio  = s.value("usePortaudioAudio", usePortaudioAudio).toBool();
       usePulseAudio      = s.value("usePulseAudio", usePulseAudio).toBool();
+      synthesizerThreads = qBound(0, s.value("synthesizerThreads", synthesizerThreads).toInt(), QThread::idealThreadCount() - 1);
+      soundFontCacheSize = qMax(0, s.value("soundFontCacheSize", soundFontCacheSize).toInt());
 
       alsaDevice         = s.value("alsaDevice", alsaDevice).toString();
       alsaSampleRate     = s.value("alsaSampleRate", alsaSampleRate).toInt();
@@ -454,6 +482,13 @@ void Preferences::read()
 
       musicxmlImportLayout     = s.value("musicxmlImportLayout", musicxmlImportLayout).toBool();
       musicxmlImportBreaks     = s.value("musicxmlImportBreaks", musicxmlImportBreaks).toBool();
+      QString val(s.value("musicxmlImportValidation", "full").toString());
+      if (val == "full")
+            musicxmlImportValidation = MusicxmlValidation::FULL;
+      else if (val == "onerror")
+            musicxmlImportValidation = MusicxmlValidation::ON_ERROR;
+      else if (val == "no")
+            musicxmlImportValidation = MusicxmlValidation::NO;
       musicxmlExportLayout     = s.value("musicxmlExportLayout", musicxmlExportLayout).toBool();
       QString br(s.value("musicxmlExportBreaks", "all").toString());
       if (br == "all")
@@ -471,6 +506,11 @@ void Preferences::read()
       importCharsetOve          = s.value("importCharsetOve", importCharsetOve).toString();
       importCharsetGP          = s.value("importCharsetGP", importCharsetGP).toString();
       MScore::warnPitchRange = s.value("warnPitchRange", MScore::warnPitchRange).toBool();
+      MScore::undoLimit      = s.value("undoLimit", MScore::undoLimit).toInt();
+      MScore::undoMemoryLimit = qint64(s.value("undoMemoryLimit", int(MScore::undoMemoryLimit / (1024 * 1024))).toInt()) * 1024 * 1024;
+      MScore::undoMergeInterval = s.value("undoMergeInterval", MScore::undoMergeInterval).toInt();
+      MScore::incrementalLayout = s.value("incrementalLayout", MScore::incrementalLayout).toBool();
+      MScore::incrementalPlayback = s.value("incrementalPlayback", MScore::incrementalPlayback).toBool();
       followSong             = s.value("followSong", followSong).toBool();
 
       useOsc                 = s.value("useOsc", useOsc).toBool();
@@ -511,6 +551,9 @@ void Preferences::read()
       nativeDialogs    = s.value("nativeDialogs", nativeDialogs).toBool();
       exportAudioSampleRate = s.value("exportAudioSampleRate", exportAudioSampleRate).toInt();
       exportMp3BitRate   = s.value("exportMp3Bitrate", exportMp3BitRate).toInt();
+      exportAudioNormalize = AudioNormalize(s.value("exportAudioNormalize", int(exportAudioNormalize)).toInt());
+      exportAudioGain      = s.value("exportAudioGain", exportAudioGain).toDouble();
+      exportAudioLoudness  = s.value("exportAudioLoudness", exportAudioLoudness).toDouble();
 
       workspace          = s.value("workspace", workspace).toString();
       exportPdfDpi       = s.value("exportPdfDpi", exportPdfDpi).toInt();
@@ -66,6 +66,20 @@ enum class MusicxmlExportBreaks : char {
       ALL, MANUAL, NO
       };
 
+// MusicXML import validation
+enum class MusicxmlValidation : char {
+      FULL,       // validate before importing
+      ON_ERROR,   // validate only if the import fails
+      NO
+      };
+
+// audio export gain
+enum class AudioNormalize : char {
+      PEAK,       // normalize peak to -0.1 dBFS
+      GAIN,       // fixed gain in dB
+      LOUDNESS    // integrated loudness target in LUFS
+      };
+
 //---------------------------------------------------------
 //   PluginDescription
 //---------------------------------------------------------
@@ -106,6 +120,8 @@ struct Preferences {
       bool usePulseAudio;
       bool useJackMidi;
       bool useJackTransport;
+      int synthesizerThreads;       // worker threads for the synthesizer, 0 - render serially
+      int soundFontCacheSize;       // MB of decompressed SF3 samples kept for reuse
       bool jackTimebaseMaster;
       bool rememberLastConnections;
 
@@ -138,6 +154,7 @@ struct Preferences {
 
       bool musicxmlImportLayout;
       bool musicxmlImportBreaks;
+      MusicxmlValidation musicxmlImportValidation;
       bool musicxmlExportLayout;
       MusicxmlExportBreaks musicxmlExportBreaks;
 
@@ -179,6 +196,9 @@ struct Preferences {
 
       int exportAudioSampleRate;
       int exportMp3BitRate;
+      AudioNormalize exportAudioNormalize;
+      double exportAudioGain;             // dB
+      double exportAudioLoudness;         // LUFS
 
       QString workspace;
       int exportPdfDpi;
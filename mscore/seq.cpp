@@ -63,6 +63,11 @@ Seq* seq;
 static const int guiRefresh   = 10;       // Hz
 static const int peakHoldTime = 1400;     // msec
 static const int peakHold     = (peakHoldTime * guiRefresh) / 1000;
+
+// the real time thread shares its position with the gui in atomics,
+// which must not fall back to a lock (see Seq::playState)
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2, "lock free atomics needed");
+
 static OggVorbis_File vf;
 
 #if 0 // yet(?) unused
@@ -152,16 +157,26 @@ Seq::Seq()
       maxMidiOutPort  = 0;
 
       endUTick  = 0;
+      scoreEndUTick = 0;
+      periodStamped      = false;
+      periodLoopOutUTick = 0;
       state    = Transport::STOP;
       oggInit  = false;
       _driver  = 0;
-      playPos  = events.cbegin();
+      curTimeline = 0;
+      rtTimeline  = -1;
+      rtEvents    = 0;
+      playIdx  = 0;
       playFrame  = 0;
+      storePlayState(0, 0);
+      dispatchCount     = 0;
+      unorderedCount    = 0;
+      lastDispatchUTick = -1;
       metronomeVolume = 0.3;
       useJackTransportSavedFlag = false;
 
       inCountIn         = false;
-      countInPlayPos    = countInEvents.cbegin();
+      countInPlayIdx    = 0;
       countInPlayFrame  = 0;
 
       meterValue[0]     = 0.0;
@@ -213,12 +228,22 @@ void Seq::setScoreView(ScoreView* v)
             stopWait();
             }
       cv = v;
-      if (cs)
-            disconnect(cs, SIGNAL(playlistChanged()), this, SLOT(setPlaylistChanged()));
-      cs = cv ? cv->score() : 0;
-
       if (!heartBeatTimer->isActive())
             heartBeatTimer->start(20);    // msec
+      setScore(cv ? cv->score() : 0);
+      }
+
+//---------------------------------------------------------
+//   setScore
+//    play a score without a view, as the playback
+//    benchmark does; the sequencer must be stopped
+//---------------------------------------------------------
+
+void Seq::setScore(Score* s)
+      {
+      if (cs)
+            disconnect(cs, SIGNAL(playlistChanged()), this, SLOT(setPlaylistChanged()));
+      cs = s;
 
       playlistChanged = true;
       _synti->reset();
@@ -289,7 +314,7 @@ bool Seq::canStart()
             return false;
       if (playlistChanged)
             collectEvents();
-      return (!events.empty() && endUTick != 0);
+      return (!events().empty() && endUTick != 0);
       }
 
 //---------------------------------------------------------
@@ -306,6 +331,15 @@ void Seq::start()
 
       if (playlistChanged)
             collectEvents();
+      else if (!events().stamped(cs->tempomap()->relTempo(), MScore::sampleRate)) {
+            // the tempo was changed since the events were stamped
+            EventTimeline tl(events());
+            stampEvents(&tl);
+            publishEvents(&tl);
+            // guiPos pointed into the old slot; with JACK transport
+            // there is no seek() below to set it again
+            guiPos = events().lower_bound(cs->repeatList()->tick2utick(cs->playPos()));
+            }
       if (cs->playMode() == PlayMode::AUDIO) {
             if (!oggInit) {
                   vorbisData.pos  = 0;
@@ -451,8 +485,9 @@ void Seq::seqMessage(int msg, int arg)
             case '5': {
                   // Update the screen after seeking from the realtime thread
                   Segment* seg = cs->tick2segment(arg);
-                  if (seg)
-                        mscore->currentScoreView()->moveCursor(seg->tick());
+                  ScoreView* view = mscore->currentScoreView();
+                  if (seg && view)
+                        view->moveCursor(seg->tick());
                   cs->setPlayPos(arg);
                   cs->end();
                   break;
@@ -653,17 +688,22 @@ void Seq::addCountInClicks()
       if (m->isAnacrusis())         // ...measure is incomplete (anacrusis)
             endTick += timeSig.ticksPerMeasure() - m->ticks();
 
+      EventMap clicks;
       for (int tick = 0; tick < endTick; tick += clickTicks) {
             const int rtick = tick % timeSig.ticksPerMeasure();
-            countInEvents.insert(std::pair<int,NPlayEvent>(tick, NPlayEvent(timeSig.rtick2beatType(rtick))));
+            clicks.insert(std::pair<int,NPlayEvent>(tick, NPlayEvent(timeSig.rtick2beatType(rtick))));
             }
 
       NPlayEvent event;
       event.setType(ME_INVALID);
       event.setPitch(0);
-      countInEvents.insert( std::pair<int,NPlayEvent>(endTick, event));
+      clicks.insert( std::pair<int,NPlayEvent>(endTick, event));
+      countInEvents.assign(clicks);
+      // the clicks are played in the tempo of the start position
+      const qreal ticksPerSecond = curTempo() * cs->tempomap()->relTempo() * MScore::division;
+      countInEvents.stamp([ticksPerSecond](int tick) { return tick / ticksPerSecond; }, cs->tempomap()->relTempo(), MScore::sampleRate);
       // initialize play parameters to count-in events
-      countInPlayPos  = countInEvents.cbegin();
+      countInPlayIdx  = 0;
       countInPlayFrame = 0;
       }
 
@@ -677,10 +717,24 @@ void Seq::addCountInClicks()
 
 void Seq::process(unsigned framesPerPeriod, float* buffer)
       {
-      unsigned framesRemain = framesPerPeriod; // the number of frames remaining to be processed by this call to Seq::process
+      // the playlist of this period is not replaced before
+      // the period is done
+      rtEvents = acquireEvents();
+      processPeriod(framesPerPeriod, buffer);
+      rtEvents = 0;
+      rtTimeline.store(-1);
+      }
+
+//---------------------------------------------------------
+//   processPeriod
+//    realtime thread, see process()
+//---------------------------------------------------------
+
+void Seq::processPeriod(unsigned framesPerPeriod, float* buffer)
+      {
       Transport driverState = _driver->getState();
       // Checking for the reposition from JACK Transport
-      _driver->checkTransportSeek(playFrame, framesRemain, inCountIn);
+      _driver->checkTransportSeek(playFrame, framesPerPeriod, inCountIn);
 
       if (driverState != state) {
             // Got a message from JACK Transport panel: Play
@@ -726,9 +780,9 @@ void Seq::process(unsigned framesPerPeriod, float* buffer)
                   // Muting all notes
                   stopNotes(-1, true);
                   initInstruments(true);
-                  if (playPos == events.cend()) {
+                  if (playIdx.load() >= rtEvents->size()) {
                         if (mscore->loop()) {
-                              qDebug("Seq.cpp - Process - Loop whole score. playPos = %d, cs->pos() = %d", playPos->first, cs->pos());
+                              qDebug("Seq.cpp - Process - Loop whole score. cs->pos() = %d", cs->pos());
                               emit toGui('4');
                               return;
                               }
@@ -746,7 +800,6 @@ void Seq::process(unsigned framesPerPeriod, float* buffer)
             }
 
       memset(buffer, 0, sizeof(float) * framesPerPeriod * 2); // assume two channels
-      float* p = buffer;
 
       processMessages();
 
@@ -755,141 +808,29 @@ void Seq::process(unsigned framesPerPeriod, float* buffer)
                   return;
 
             // if currently in count-in, these pointers will reference data in the count-in
-            EventMap::const_iterator* pPlayPos   = &playPos;
-            EventMap*                 pEvents    = &events;
-            int*                      pPlayFrame = &playFrame;
+            std::atomic<int>*    pPlayIdx   = &playIdx;
+            const EventTimeline* pEvents    = rtEvents;
+            int*                 pPlayFrame = &playFrame;
             if (inCountIn) {
                   if (countInEvents.size() == 0)
                         addCountInClicks();
                   pEvents    = &countInEvents;
-                  pPlayPos   = &countInPlayPos;
+                  pPlayIdx   = &countInPlayIdx;
                   pPlayFrame = &countInPlayFrame;
                   }
 
             //
-            // play events for one segment
+            // play events for one period
             //
-            unsigned framePos = 0; // frame currently being processed relative to the first frame of this call to Seq::process
-            int periodEndFrame = *pPlayFrame + framesPerPeriod; // the ending frame (relative to start of playback) of the period being processed by this call to Seq::process
-            int scoreEndUTick = cs->repeatList()->tick2utick(cs->lastMeasure()->endTick());
-            while (*pPlayPos != pEvents->cend()) {
-                  int playPosUTick = (*pPlayPos)->first;
-                  int n; // current frame (relative to start of playback) that is being synthesized
-
-                  if (inCountIn) {
-                        qreal beatsPerSecond = curTempo() * cs->tempomap()->relTempo(); // relTempo needed here to ensure that bps changes as we slide the tempo bar
-                        qreal ticksPerSecond = beatsPerSecond * MScore::division;
-                        qreal playPosSeconds = playPosUTick / ticksPerSecond;
-                        int playPosFrame = playPosSeconds * MScore::sampleRate;
-                        if (playPosFrame >= periodEndFrame)
-                              break;
-                        n = playPosFrame - *pPlayFrame;
-                        if (n < 0) {
-                              qDebug("Count-in: playPosUTick %d: n = %d - %d", playPosUTick, playPosFrame, *pPlayFrame);
-                              n = 0;
-                              }
-                        }
-                  else {
-                        qreal playPosSeconds = cs->utick2utime(playPosUTick);
-                        int playPosFrame = playPosSeconds * MScore::sampleRate;
-                        if (playPosFrame >= periodEndFrame)
-                              break;
-                        n = playPosFrame - *pPlayFrame;
-                        if (n < 0) {
-                              qDebug("%d:  %d - %d", playPosUTick, playPosFrame, *pPlayFrame);
-                              n = 0;
-                              }
-                        if (mscore->loop()) {
-                              int loopOutUTick = cs->repeatList()->tick2utick(cs->loopOutTick());
-                              if (loopOutUTick < scoreEndUTick) {
-                                    // Also make sure we are not "before" the loop
-                                    if (playPosUTick >= loopOutUTick || cs->repeatList()->utick2tick(playPosUTick) < cs->loopInTick()) {
-                                          qDebug ("Process: playPosUTick = %d, cs->loopInTick() = %d, cs->loopOutTick() = %d, getCurTick() = %d, loopOutUTick = %d, playFrame = %d",
-                                                            playPosUTick,      cs->loopInTick(),      cs->loopOutTick(),      getCurTick(),      loopOutUTick,    *pPlayFrame);
-                                          if (preferences.useJackTransport) {
-                                                int loopInUTick = cs->repeatList()->tick2utick(cs->loopInTick());
-                                                _driver->seekTransport(loopInUTick);
-                                                if (loopInUTick != 0) {
-                                                      int seekto = loopInUTick - 2 * cs->utime2utick((qreal)_driver->bufferSize() / MScore::sampleRate);
-                                                      seekRT((seekto > 0) ? seekto : 0 );
-                                                      }
-                                                }
-                                          else {
-                                                emit toGui('3');
-                                                }
-                                          // Exit this function to avoid segmentation fault in Scoreview
-                                          return;
-                                          }
-                                    }
-                              }
-                        }
-                  if (n) {
-                        if (cs->playMode() == PlayMode::SYNTHESIZER) {
-                              metronome(n, p, inCountIn);
-                              _synti->process(n, p);
-                              p += n * 2;
-                              *pPlayFrame  += n;
-                              framesRemain -= n;
-                              framePos     += n;
-                              }
-                        else {
-                              while (n > 0) {
-                                    int section;
-                                    float** pcm;
-                                    long rn = ov_read_float(&vf, &pcm, n, &section);
-                                    if (rn == 0)
-                                          break;
-                                    for (int i = 0; i < rn; ++i) {
-                                          *p++ = pcm[0][i];
-                                          *p++ = pcm[1][i];
-                                          }
-                                    *pPlayFrame  += rn;
-                                    framesRemain -= rn;
-                                    framePos     += rn;
-                                    n            -= rn;
-                                    }
-                              }
-                        }
-                  const NPlayEvent& event = (*pPlayPos)->second;
-                  playEvent(event, framePos);
-                  if (event.type() == ME_TICK1) {
-                        tickRemain = tickLength;
-                        tickVolume = event.velo() ? qreal(event.value()) / 127.0 : 1.0;
-                        }
-                  else if (event.type() == ME_TICK2) {
-                        tackRemain = tackLength;
-                        tackVolume = event.velo() ? qreal(event.value()) / 127.0 : 1.0;
-                        }
-                  mutex.lock();
-                  ++(*pPlayPos);
-                  mutex.unlock();
-                  }
-            if (framesRemain) {
-                  if (cs->playMode() == PlayMode::SYNTHESIZER) {
-                        metronome(framesRemain, p, inCountIn);
-                        _synti->process(framesRemain, p);
-                        *pPlayFrame += framesRemain;
-                        }
-                  else {
-                        int n = framesRemain;
-                        while (n > 0) {
-                              int section;
-                              float** pcm;
-                              long rn = ov_read_float(&vf, &pcm, n, &section);
-                              if (rn == 0)
-                                    break;
-                              for (int i = 0; i < rn; ++i) {
-                                    *p++ = pcm[0][i];
-                                    *p++ = pcm[1][i];
-                                    }
-                              *pPlayFrame  += rn;
-                              framesRemain -= rn;
-                              framePos     += rn;
-                              n            -= rn;
-                              }
-                        }
-                  }
-            if (*pPlayPos == pEvents->cend()) {
+            // events are stamped with their frame unless the tempo was changed while playing
+            periodStamped      = pEvents->stamped(cs->tempomap()->relTempo(), MScore::sampleRate);
+            periodLoopOutUTick = mscore->loop() ? cs->repeatList()->tick2utick(cs->loopOutTick()) : 0;
+            if (!playPeriod(*pEvents, pPlayIdx, pPlayFrame, framesPerPeriod, buffer))
+                  return;
+            const int idx = pPlayIdx->load(std::memory_order_relaxed);
+            if (!inCountIn)
+                  storePlayState(idx, playFrame, std::memory_order_release);
+            if (idx == pEvents->size()) {
                   if (inCountIn) {
                         inCountIn = false;
                         // Connecting to JACK Transport if MuseScore was temporarily disconnected from it
@@ -918,9 +859,9 @@ void Seq::process(unsigned framesPerPeriod, float* buffer)
                         tackVolume = event.velo() ? qreal(event.value()) / 127.0 : 1.0;
                         }
                   }
-            if (framesRemain) {
-                  metronome(framesRemain, p, true);
-                  _synti->process(framesRemain, p);
+            if (framesPerPeriod) {
+                  metronome(framesPerPeriod, buffer, true);
+                  _synti->process(framesPerPeriod, buffer);
                   }
             }
       //
@@ -928,8 +869,8 @@ void Seq::process(unsigned framesPerPeriod, float* buffer)
       //
       qreal lv = 0.0f;
       qreal rv = 0.0f;
-      p = buffer;
-      for (unsigned i = 0; i < framesRemain; ++i) {
+      float* p = buffer;
+      for (unsigned i = 0; i < framesPerPeriod; ++i) {
             qreal val = *p;
             lv = qMax(lv, qAbs(val));
             p++;
@@ -950,6 +891,103 @@ void Seq::process(unsigned framesPerPeriod, float* buffer)
             }
       }
 
+//---------------------------------------------------------
+//   eventFrame
+//    realtime thread
+//---------------------------------------------------------
+
+int Seq::eventFrame(const EventTimeline& events, int idx) const
+      {
+      if (inCountIn || periodStamped)
+            return events.frame(idx);
+      return int(cs->utick2utime(events.at(idx).first) * MScore::sampleRate);
+      }
+
+//---------------------------------------------------------
+//   acceptEvent
+//    realtime thread; ends the period at the loop out
+//    position
+//---------------------------------------------------------
+
+bool Seq::acceptEvent(const EventTimeline& events, int idx)
+      {
+      if (inCountIn || !mscore->loop() || periodLoopOutUTick >= scoreEndUTick)
+            return true;
+      int playPosUTick = events.at(idx).first;
+      // Also make sure we are not "before" the loop
+      if (playPosUTick < periodLoopOutUTick && cs->repeatList()->utick2tick(playPosUTick) >= cs->loopInTick())
+            return true;
+      qDebug ("Process: playPosUTick = %d, cs->loopInTick() = %d, cs->loopOutTick() = %d, getCurTick() = %d, loopOutUTick = %d, playFrame = %d",
+                        playPosUTick,      cs->loopInTick(),      cs->loopOutTick(),      getCurTick(),      periodLoopOutUTick, playFrame);
+      if (preferences.useJackTransport) {
+            int loopInUTick = cs->repeatList()->tick2utick(cs->loopInTick());
+            _driver->seekTransport(loopInUTick);
+            if (loopInUTick != 0) {
+                  int seekto = loopInUTick - 2 * cs->utime2utick((qreal)_driver->bufferSize() / MScore::sampleRate);
+                  seekRT((seekto > 0) ? seekto : 0 );
+                  }
+            }
+      else {
+            emit toGui('3');
+            }
+      // Exit the period to avoid segmentation fault in Scoreview
+      return false;
+      }
+
+//---------------------------------------------------------
+//   render
+//    realtime thread
+//---------------------------------------------------------
+
+int Seq::render(int frames, float* p)
+      {
+      if (cs->playMode() == PlayMode::SYNTHESIZER) {
+            metronome(frames, p, inCountIn);
+            _synti->process(frames, p);
+            return frames;
+            }
+      int done = 0;
+      while (done < frames) {
+            int section;
+            float** pcm;
+            long rn = ov_read_float(&vf, &pcm, frames - done, &section);
+            if (rn <= 0)
+                  break;
+            for (int i = 0; i < rn; ++i) {
+                  *p++ = pcm[0][i];
+                  *p++ = pcm[1][i];
+                  }
+            done += rn;
+            }
+      return done;
+      }
+
+//---------------------------------------------------------
+//   dispatch
+//    realtime thread
+//---------------------------------------------------------
+
+void Seq::dispatch(const EventTimeline& events, int idx, int framePos)
+      {
+      const NPlayEvent& event = events.at(idx).second;
+      if (!inCountIn) {
+            int playPosUTick = events.at(idx).first;
+            if (playPosUTick < lastDispatchUTick)
+                  ++unorderedCount;
+            lastDispatchUTick = playPosUTick;
+            ++dispatchCount;
+            }
+      playEvent(event, framePos);
+      if (event.type() == ME_TICK1) {
+            tickRemain = tickLength;
+            tickVolume = event.velo() ? qreal(event.value()) / 127.0 : 1.0;
+            }
+      else if (event.type() == ME_TICK2) {
+            tackRemain = tackLength;
+            tackVolume = event.velo() ? qreal(event.value()) / 127.0 : 1.0;
+            }
+      }
+
 //---------------------------------------------------------
 //   initInstruments
 //---------------------------------------------------------
@@ -1007,23 +1045,74 @@ void Seq::collectEvents()
       //do not collect even while playing
       if (state ==  Transport::PLAY)
             return;
-      events.clear();
 
-      mutex.lock();
-      cs->renderMidi(&events);
+      EventMap em;
+      cs->renderMidi(&em);
+      EventTimeline tl;
+      tl.assign(em);
+      stampEvents(&tl);
+
+      publishEvents(&tl);
       endUTick = 0;
 
-      if (!events.empty()) {
-            auto e = events.cend();
+      if (!events().empty()) {
+            auto e = events().cend();
             --e;
             endUTick = e->first;
             }
-      playPos  = events.cbegin();
-      mutex.unlock();
+      scoreEndUTick = cs->lastMeasure() ? cs->repeatList()->tick2utick(cs->lastMeasure()->endTick()) : 0;
+      playIdx  = 0;
+      guiPos   = events().cbegin();
+      storePlayState(0, playFrame);
 
       playlistChanged = false;
       }
 
+//---------------------------------------------------------
+//   stampEvents
+//    compute the audio frames of the events for the
+//    current tempo; gui thread
+//---------------------------------------------------------
+
+void Seq::stampEvents(EventTimeline* tl)
+      {
+      tl->stamp([this](int utick) { return cs->utick2utime(utick); }, cs->tempomap()->relTempo(), MScore::sampleRate);
+      }
+
+//---------------------------------------------------------
+//   publishEvents
+//    make tl the playlist of the real time thread; tl gets
+//    the playlist before the current one. Waits at most one
+//    period if the real time thread still reads that one.
+//    gui thread
+//---------------------------------------------------------
+
+void Seq::publishEvents(EventTimeline* tl)
+      {
+      int next = 1 - curTimeline.load();
+      while (rtTimeline.load() == next)
+            QThread::yieldCurrentThread();
+      timelines[next].swap(*tl);
+      curTimeline.store(next);
+      }
+
+//---------------------------------------------------------
+//   acquireEvents
+//    announce the playlist the real time thread is going
+//    to read; it is not replaced until rtTimeline is reset
+//    realtime thread
+//---------------------------------------------------------
+
+const EventTimeline* Seq::acquireEvents()
+      {
+      int idx;
+      do {
+            idx = curTimeline.load();
+            rtTimeline.store(idx);
+            } while (idx != curTimeline.load());
+      return &timelines[idx];
+      }
+
 //---------------------------------------------------------
 //   getCurTick
 //---------------------------------------------------------
@@ -1056,17 +1145,19 @@ void Seq::setPos(int utick)
       stopNotes(-1, true);
 
       int ucur;
-      if (playPos != events.end())
-            ucur = cs->repeatList()->utick2tick(playPos->first);
+      int idx = playIdx.load();
+      if (idx < rtEvents->size())
+            ucur = cs->repeatList()->utick2tick(rtEvents->at(idx).first);
       else
             ucur = utick - 1;
       if (utick != ucur)
             updateSynthesizerState(ucur, utick);
 
       playFrame = cs->utick2utime(utick) * MScore::sampleRate;
-      mutex.lock();
-      playPos   = events.lower_bound(utick);
-      mutex.unlock();
+      playIdx.store(int(rtEvents->lower_bound(utick) - rtEvents->cbegin()), std::memory_order_release);
+      dispatchCount     = 0;
+      unorderedCount    = 0;
+      lastDispatchUTick = -1;
       }
 
 //---------------------------------------------------------
@@ -1089,7 +1180,7 @@ void Seq::seekCommon(int utick)
             ov_pcm_seek(&vf, sp);
             }
 
-      guiPos = events.lower_bound(utick);
+      guiPos = events().lower_bound(utick);
       mscore->setPos(cs->repeatList()->utick2tick(utick));
       unmarkNotes();
       }
@@ -1113,8 +1204,9 @@ void Seq::seek(int utick)
 
       int tick = cs->repeatList()->utick2tick(utick);
       Segment* seg = cs->tick2segment(tick);
-      if (seg)
-            mscore->currentScoreView()->moveCursor(seg->tick());
+      ScoreView* view = mscore->currentScoreView();     // none in the playback benchmark
+      if (seg && view)
+            view->moveCursor(seg->tick());
       cs->setPlayPos(tick);
       cs->end();
       guiToSeq(SeqMsg(SeqMsgId::SEEK, utick));
@@ -1130,6 +1222,8 @@ void Seq::seekRT(int utick)
       if (preferences.useJackTransport && utick > endUTick)
                   utick = 0;
       seekCommon(utick);
+      // seekCommon() may have published a new playlist
+      rtEvents = acquireEvents();
       setPos(utick);
       // Update the screen in GUI thread
       emit toGui('5', cs->repeatList()->utick2tick(utick));
@@ -1261,13 +1355,11 @@ void Seq::nextMeasure()
 
 void Seq::nextChord()
       {
-      int tick = guiPos->first;
-      for (auto i = guiPos; i != events.cend(); ++i) {
-            if (i->second.type() == ME_NOTEON && i->first > tick && i->second.velo()) {
-                  seek(i->first);
-                  break;
-                  }
-            }
+      if (guiPos == events().cend())
+            return;
+      int tick = events().nextNoteOn(guiPos->first);
+      if (tick != -1)
+            seek(tick);
       }
 
 //---------------------------------------------------------
@@ -1277,7 +1369,7 @@ void Seq::nextChord()
 void Seq::prevMeasure()
       {
       auto i = guiPos;
-      if (i == events.begin())
+      if (i == events().begin())
             return;
       --i;
       Measure* m = cs->tick2measure(i->first);
@@ -1294,37 +1386,14 @@ void Seq::prevMeasure()
 
 void Seq::prevChord()
       {
-      int tick  = playPos->first;
-      //find the chord just before playpos
-      EventMap::const_iterator i = events.upper_bound(cs->repeatList()->tick2utick(tick));
-      for (;;) {
-            if (i->second.type() == ME_NOTEON) {
-                  const NPlayEvent& n = i->second;
-                  if (i->first < tick && n.velo()) {
-                        tick = i->first;
-                        break;
-                        }
-                  }
-            if (i == events.cbegin())
-                  break;
-            --i;
-            }
-      //go the previous chord
-      if (i != events.cbegin()) {
-            i = playPos;
-            for (;;) {
-                  if (i->second.type() == ME_NOTEON) {
-                        const NPlayEvent& n = i->second;
-                        if (i->first < tick && n.velo()) {
-                              seek(i->first);
-                              break;
-                              }
-                        }
-                  if (i == events.cbegin())
-                        break;
-                  --i;
-                  }
-            }
+      // the chord just before playPos is sounding, go to the one before it
+      int tick = playPos() == events().cend() ? endUTick + 1 : playPos()->first;
+      tick = events().prevNoteOn(tick);
+      if (tick == -1)
+            return;
+      tick = events().prevNoteOn(tick);
+      if (tick != -1)
+            seek(tick);
       }
 
 //---------------------------------------------------------
@@ -1468,13 +1537,14 @@ void Seq::heartBeatTimeout()
       if (state != Transport::PLAY || inCountIn)
             return;
 
-      int endFrame = playFrame;
-
-      mutex.lock();
-      auto ppos = playPos;
-      if (ppos != events.cbegin())
+      if (events().empty())
+            return;
+      // a consistent snapshot of the position of the real time thread
+      PlayState ps = loadPlayState(std::memory_order_acquire);
+      int endFrame = ps.frame;
+      auto ppos = events().cbegin() + ps.idx;
+      if (ppos != events().cbegin())
             --ppos;
-      mutex.unlock();
 
       if (cs && cs->sigmap()->timesig(getCurTick()).nominal()!=prevTimeSig) {
             prevTimeSig = cs->sigmap()->timesig(getCurTick()).nominal();
@@ -1486,7 +1556,7 @@ void Seq::heartBeatTimeout()
             }
 
       QRectF r;
-      for (;guiPos != events.cend(); ++guiPos) {
+      for (;guiPos != events().cend(); ++guiPos) {
             if (guiPos->first > ppos->first)
                   break;
             if (mscore->loop())
@@ -1542,11 +1612,9 @@ void Seq::updateSynthesizerState(int tick1, int tick2)
       {
       if (tick1 > tick2)
             tick1 = 0;
-      // Making a local copy of events to avoid touching it
-      // from different threads at the same time
-      EventMap ev = events;
-      EventMap::const_iterator i1 = ev.lower_bound(tick1);
-      EventMap::const_iterator i2 = ev.upper_bound(tick2);
+      // the playlist of the period, see process()
+      EventTimeline::const_iterator i1 = rtEvents->lower_bound(tick1);
+      EventTimeline::const_iterator i2 = rtEvents->upper_bound(tick2);
 
       for (; i1 != i2; ++i1) {
             if (i1->second.type() == ME_CONTROLLER)
@@ -1560,7 +1628,7 @@ void Seq::updateSynthesizerState(int tick1, int tick2)
 
 double Seq::curTempo() const
       {
-      return cs->tempomap()->tempo(playPos->first);
+      return cs->tempomap()->tempo(playPos()->first);
       }
 
 //---------------------------------------------------------
@@ -1571,8 +1639,8 @@ void Seq::setLoopIn()
       {
       int tick;
       if (state == Transport::PLAY) {      // If in playback mode, set the In position where note is being played
-            auto ppos = playPos;
-            if (ppos != events.cbegin())
+            auto ppos = playPos();
+            if (ppos != events().cbegin())
                   --ppos;                 // We have to go back one pos to get the correct note that has just been played
             tick = cs->repeatList()->utick2tick(ppos->first);
             }
@@ -1591,7 +1659,7 @@ void Seq::setLoopOut()
       {
       int tick;
       if (state == Transport::PLAY) {    // If in playback mode, set the Out position where note is being played
-            tick = cs->repeatList()->utick2tick(playPos->first);
+            tick = cs->repeatList()->utick2tick(playPos()->first);
             }
       else
             tick = cs->pos() + cs->inputState().ticks();   // Otherwise, use the selected note.
@@ -21,9 +21,11 @@
 #ifndef __SEQ_H__
 #define __SEQ_H__
 
+#include <atomic>
 #include "libmscore/sequencer.h"
 #include "libmscore/fraction.h"
 #include "synthesizer/event.h"
+#include "synthesizer/eventplayer.h"
 #include "driver.h"
 #include "libmscore/fifo.h"
 #include "libmscore/tempo.h"
@@ -100,7 +102,7 @@ enum class Transport : char {
 //    sequencer
 //---------------------------------------------------------
 
-class Seq : public QObject, public Sequencer {
+class Seq : public QObject, public Sequencer, public EventPlayer {
       Q_OBJECT
 
       mutable QMutex mutex;
@@ -132,17 +134,49 @@ class Seq : public QObject, public Sequencer {
       double meterPeakValue[2];
       int peakTimer[2];
 
-      EventMap events;                    // playlist for playback mode (pre-rendered)
-      EventMap countInEvents;             // playlist of any metronome countin clicks
+      // playlists for playback mode (pre-rendered): the gui thread
+      // builds a new one in the unused slot and publishes it by
+      // switching curTimeline; the real time thread announces the
+      // slot it reads in rtTimeline for the time of one period
+      EventTimeline timelines[2];
+      std::atomic<int> curTimeline;
+      std::atomic<int> rtTimeline;        // -1: real time thread does not read
+      const EventTimeline* rtEvents;      // playlist of the current period, real time thread
+      EventTimeline countInEvents;        // playlist of any metronome countin clicks
       QQueue<NPlayEvent> _liveEventQueue; // playlist for score editing and note entry (rendered live)
 
       int playFrame;                      // current play position in samples, relative to the first frame of playback
       int countInPlayFrame;               // current play position in samples, relative to the first frame of countin
+      bool periodStamped;                 // events of the current period are stamped, real time thread
+      int periodLoopOutUTick;             // loop out position of the current period, real time thread
       int endUTick;                       // the final tick of midi events collected by collectEvents()
-
-      EventMap::const_iterator playPos;   // moved in real time thread
-      EventMap::const_iterator countInPlayPos;
-      EventMap::const_iterator guiPos;    // moved in gui thread
+      int scoreEndUTick;                  // the end of the last measure, set by collectEvents()
+
+      std::atomic<int> playIdx;           // next event of events, moved in real time thread
+      std::atomic<int> countInPlayIdx;
+      EventTimeline::const_iterator guiPos;    // moved in gui thread
+
+      // play position of the real time thread for the gui,
+      // published at the end of every period; both values are
+      // packed into one 64 bit word, so the atomic is lock free
+      struct PlayState {
+            int idx;                      // playIdx
+            int frame;                    // playFrame
+            };
+      std::atomic<quint64> playState;
+      void storePlayState(int idx, int frame, std::memory_order order = std::memory_order_seq_cst) {
+            playState.store(quint64(quint32(idx)) << 32 | quint32(frame), order);
+            }
+      PlayState loadPlayState(std::memory_order order = std::memory_order_seq_cst) const {
+            quint64 v = playState.load(order);
+            return { int(quint32(v >> 32)), int(quint32(v)) };
+            }
+
+      // playback events dispatched since the last seek, checked
+      // by the playback benchmark; real time thread
+      int dispatchCount;
+      int unorderedCount;                 // events with an earlier tick than the event before
+      int lastDispatchUTick;
 
       QList<const Note*> markedNotes;     // notes marked as sounding
 
@@ -158,6 +192,16 @@ class Seq : public QObject, public Sequencer {
       QTimer* noteTimer;
 
       void collectMeasureEvents(Measure*, int staffIdx);
+      const EventTimeline& events() const { return timelines[curTimeline.load(std::memory_order_acquire)]; }
+      EventTimeline::const_iterator playPos() const { return events().cbegin() + playIdx.load(); }
+      void stampEvents(EventTimeline*);
+      void publishEvents(EventTimeline*);
+      const EventTimeline* acquireEvents();
+      void processPeriod(unsigned framesPerPeriod, float* buffer);
+      virtual int eventFrame(const EventTimeline&, int idx) const override;
+      virtual bool acceptEvent(const EventTimeline&, int idx) override;
+      virtual int render(int frames, float* buffer) override;
+      virtual void dispatch(const EventTimeline&, int idx, int framePos) override;
 
       void setPos(int);
       void playEvent(const NPlayEvent&, unsigned framePos);
@@ -223,12 +267,16 @@ class Seq : public QObject, public Sequencer {
       void processMessages();
       void process(unsigned framesPerPeriod, float* buffer);
       int getEndUTick() const   { return endUTick;  }
+      int playlistSize() const  { return events().size(); }
+      int dispatched() const    { return dispatchCount;  }
+      int unordered() const     { return unorderedCount; }
       bool isRealtime() const   { return true;     }
       void sendMessage(SeqMsg&) const;
 
       void setController(int, int, int);
       virtual void sendEvent(const NPlayEvent&);
       void setScoreView(ScoreView*);
+      void setScore(Score*);
       Score* score() const   { return cs; }
       ScoreView* viewer() const { return cv; }
       void initInstruments(bool realTime = false);
@@ -107,6 +107,43 @@ class TestImportMidi : public QObject, public MTest
             data.trackOpers.showTempoText.setDefaultValue(false);
             mf(file);
             }
+      void serialTracks(const char *file)
+            {
+                        // tracks are processed one after another;
+                        // the result has to be the same as of the parallel import
+            preferences.midiImportOperations.excludeMidiFile(midiFilePath(file));
+            auto *pool = QThreadPool::globalInstance();
+            const int maxThreadCount = pool->maxThreadCount();
+            pool->setMaxThreadCount(1);
+            mf(file);
+            pool->setMaxThreadCount(maxThreadCount);
+            }
+      QString importTracks(const char *file, int threads) const
+            {
+            preferences.midiImportOperations.excludeMidiFile(midiFilePath(file));
+            auto *pool = QThreadPool::globalInstance();
+            const int maxThreadCount = pool->maxThreadCount();
+            pool->setMaxThreadCount(threads);
+            Score* score = new Score(mscore->baseStyle());
+            score->setName(file);
+            const QString mscorename = QString("%1-%2.mscx").arg(file).arg(threads);
+            const bool ok = importMidi(score, midiFilePath(file)) == Score::FileError::FILE_NO_ERROR
+                            && saveScore(score, mscorename);
+            delete score;
+            pool->setMaxThreadCount(maxThreadCount);
+            QFile f(mscorename);
+            if (!ok || !f.open(QIODevice::ReadOnly))
+                  return QString();
+            return QString::fromUtf8(f.readAll());
+            }
+      void serialParallelTracks(const char *file)
+            {
+                        // files without reference: the tracks processed one
+                        // after another and in parallel give the same score
+            const QString serial = importTracks(file, 1);
+            QVERIFY(!serial.isEmpty());
+            QCOMPARE(importTracks(file, 4), serial);
+            }
       void staffSplit(const char *file)
             {
             auto &opers = preferences.midiImportOperations;
@@ -176,6 +213,8 @@ class TestImportMidi : public QObject, public MTest
       void findTupletApproximation();
       void separateTupletVoices();
       void findLongestUncommonGroup();
+      void tupletSearch_data();
+      void tupletSearch();
 
       // metric bar analysis
       void metricDivisionsOfTuplet();
@@ -397,6 +436,9 @@ class TestImportMidi : public QObject, public MTest
       void instrumentChannels() { mf("instrument_channels"); }
       void instrument3StaffOrgan() { mf("instrument_3staff_organ"); }
       void instrumentClef() { noTempoText("instrument_clef"); }
+      void instrumentChannelsSerial() { serialTracks("instrument_channels"); }
+      void instrument3StaffOrganSerial() { serialTracks("instrument_3staff_organ"); }
+      void tracksTupletsVoicesSerial() { serialParallelTracks("tracks_tuplets_voices"); }   // tuplets and voices in three tracks
 
       // lyrics
       void lyricsTime0() { noTempoText("lyrics_time_0"); }
@@ -952,6 +994,38 @@ void TestImportMidi::separateTupletVoices()
       }
 
 
+//---------------------------------------------------------
+//  tupletSearch
+//    the scores of the tuplet files remain the same as with
+//    the search of all tuplet combinations; the benchmark
+//    gives the time of their import
+//---------------------------------------------------------
+
+void TestImportMidi::tupletSearch_data()
+      {
+      QTest::addColumn<QString>("file");
+      for (const char *file: { "tuplet_3-4", "tuplet_5_5_tuplets_rests", "tuplet_duplet",
+                               "tuplet_mars", "tuplet_quadruplet", "tuplet_septuplet",
+                               "tuplet_triplets_mixed", "tuplet_triplet", "tuplet_16th_8th",
+                               "tuplet_off_time_other_bar" }) {
+            QTest::newRow(file) << QString(file);
+            }
+      }
+
+void TestImportMidi::tupletSearch()
+      {
+      QFETCH(QString, file);
+      auto &opers = preferences.midiImportOperations;
+      opers.excludeMidiFile(midiFilePath(file));
+      dontSimplify(file.toStdString().c_str());
+
+      QBENCHMARK {
+            Score* score = new Score(mscore->baseStyle());
+            QCOMPARE(importMidi(score, midiFilePath(file)), Score::FileError::FILE_NO_ERROR);
+            delete score;
+            }
+      }
+
 //---------------------------------------------------------
 //  metric bar analysis
 //---------------------------------------------------------
@@ -14,6 +14,15 @@
 #include <QtTest/QtTest>
 #include "mtest/testutils.h"
 #include "libmscore/score.h"
+#include "libmscore/measure.h"
+#include "libmscore/segment.h"
+#include "libmscore/page.h"
+#include "libmscore/sym.h"
+#include "libmscore/staff.h"
+#include "libmscore/stafftype.h"
+#include "libmscore/chord.h"
+#include "libmscore/note.h"
+#include "libmscore/elementpool.h"
 
 #define DIR QString("libmscore/layout/")
 
@@ -31,14 +40,32 @@ class TestBenchmark : public QObject, public MTest
       {
       Q_OBJECT
 
-      Score* score;
+      Score* score { 0 };
       void beam(const char* path);
+      void loadScore(const QString& path);
 
    private slots:
       void initTestCase();
+      void cleanupTestCase();
       void benchmark3();
       void benchmark1();
       void benchmark2();
+      void tick2measureLinear();
+      void tick2measure();
+      void tick2segmentLinear();
+      void tick2segment();
+      void paintCold();
+      void paintWarm();
+      void renderPages_data();
+      void renderPages();
+      void glyphsSingle();
+      void glyphsList();
+      void layoutStandard();
+      void layoutUtPiano();
+      void utPianoMirror();
+      void loadCorpus_data();
+      void loadCorpus();
+      void loadCloneDestroy();
       };
 
 //---------------------------------------------------------
@@ -50,6 +77,25 @@ void TestBenchmark::initTestCase()
       initMTest();
       }
 
+void TestBenchmark::cleanupTestCase()
+      {
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   loadScore
+//    read and lay out the score of a benchmark; every
+//    benchmark loads its own so it can run alone
+//---------------------------------------------------------
+
+void TestBenchmark::loadScore(const QString& path)
+      {
+      delete score;
+      score = readScore(path);
+      QVERIFY(score);
+      score->doLayout();
+      }
+
 //---------------------------------------------------------
 //   benchmark
 //---------------------------------------------------------
@@ -57,18 +103,21 @@ void TestBenchmark::initTestCase()
 void TestBenchmark::benchmark3()
       {
       QString path = root + "/" + DIR + "goldberg.mscx";
-      score = new Score(mscore->baseStyle());
-      score->setName(path);
+      Score* s = new Score(mscore->baseStyle());
+      s->setName(path);
       MScore::testMode = true;
       QBENCHMARK {
-            score->loadMsc(path, false);
+            s->loadMsc(path, false);
             }
 //      Ms::dumpTags();
+      delete s;
       }
 
 void TestBenchmark::benchmark1()
       {
+      delete score;
       score = readScore(DIR + "goldberg.mscx");
+      QVERIFY(score);
       QBENCHMARK {                        // cold run
             score->doLayout();
             }
@@ -76,12 +125,370 @@ void TestBenchmark::benchmark1()
 
 void TestBenchmark::benchmark2()
       {
-      score->doLayout();
+      loadScore(DIR + "goldberg.mscx");
       QBENCHMARK {                        // warm run
             score->doLayout();
             }
       }
 
+//---------------------------------------------------------
+//   linearTick2measure
+//    reference: walk the measure list like the old
+//    Score::tick2measure() did
+//---------------------------------------------------------
+
+static Measure* linearTick2measure(Score* score, int tick)
+      {
+      Measure* lm = 0;
+      for (Measure* m = score->firstMeasure(); m; m = m->nextMeasure()) {
+            if (tick < m->tick())
+                  return lm;
+            lm = m;
+            }
+      return lm;
+      }
+
+//---------------------------------------------------------
+//   tick2measure
+//    look up every chord/rest tick of a large score
+//---------------------------------------------------------
+
+void TestBenchmark::tick2measureLinear()
+      {
+      loadScore(DIR + "goldberg.mscx");
+      QList<int> ticks;
+      for (Segment* s = score->firstSegment(Segment::Type::ChordRest); s; s = s->next1(Segment::Type::ChordRest))
+            ticks.append(s->tick());
+      QBENCHMARK {
+            for (int tick : ticks)
+                  linearTick2measure(score, tick);
+            }
+      }
+
+void TestBenchmark::tick2measure()
+      {
+      loadScore(DIR + "goldberg.mscx");
+      QList<int> ticks;
+      for (Segment* s = score->firstSegment(Segment::Type::ChordRest); s; s = s->next1(Segment::Type::ChordRest)) {
+            ticks.append(s->tick());
+            QCOMPARE(score->tick2measure(s->tick()), linearTick2measure(score, s->tick()));
+            }
+      QBENCHMARK {
+            for (int tick : ticks)
+                  score->tick2measure(tick);
+            }
+      }
+
+//---------------------------------------------------------
+//   tick2segment
+//---------------------------------------------------------
+
+void TestBenchmark::tick2segmentLinear()
+      {
+      loadScore(DIR + "goldberg.mscx");
+      QList<int> ticks;
+      for (Segment* s = score->firstSegment(Segment::Type::ChordRest); s; s = s->next1(Segment::Type::ChordRest))
+            ticks.append(s->tick());
+      QBENCHMARK {
+            for (int tick : ticks) {
+                  Measure* m = linearTick2measure(score, tick);
+                  for (Segment* s = m->first(Segment::Type::ChordRest); s; s = s->next(Segment::Type::ChordRest)) {
+                        if (s->tick() == tick)
+                              break;
+                        }
+                  }
+            }
+      }
+
+void TestBenchmark::tick2segment()
+      {
+      loadScore(DIR + "goldberg.mscx");
+      QList<int> ticks;
+      for (Segment* s = score->firstSegment(Segment::Type::ChordRest); s; s = s->next1(Segment::Type::ChordRest)) {
+            ticks.append(s->tick());
+            QCOMPARE(score->tick2segment(s->tick(), true, Segment::Type::ChordRest), s);
+            }
+      QBENCHMARK {
+            for (int tick : ticks)
+                  score->tick2segment(tick, true, Segment::Type::ChordRest);
+            }
+      }
+
+//---------------------------------------------------------
+//   paintPage
+//    render a page like the png export does
+//---------------------------------------------------------
+
+static void paintPage(Page* page, QImage& img)
+      {
+      img.fill(0xffffffff);
+      QPainter p(&img);
+      p.setRenderHint(QPainter::Antialiasing, true);
+      p.setRenderHint(QPainter::TextAntialiasing, true);
+      qreal mag = img.width() / page->abbox().width();
+      p.scale(mag, mag);
+      for (const Element* e : page->drawList()) {
+            if (!e->visible())
+                  continue;
+            QPointF pos(e->pagePos());
+            p.translate(pos);
+            e->draw(&p);
+            p.translate(-pos);
+            }
+      }
+
+static void paintPages(Score* score, QImage& img)
+      {
+      for (Page* page : score->pages())
+            paintPage(page, img);
+      }
+
+//---------------------------------------------------------
+//   paint
+//    cold: every run renders all glyphs again
+//---------------------------------------------------------
+
+void TestBenchmark::paintCold()
+      {
+      loadScore(DIR + "goldberg.mscx");
+      QImage img(1240, 1754, QImage::Format_ARGB32_Premultiplied);
+      QBENCHMARK {
+            score->scoreFont()->clearGlyphCache();
+            paintPages(score, img);
+            }
+      }
+
+void TestBenchmark::paintWarm()
+      {
+      loadScore(DIR + "goldberg.mscx");
+      QImage img(1240, 1754, QImage::Format_ARGB32_Premultiplied);
+      paintPages(score, img);
+      QBENCHMARK {
+            paintPages(score, img);
+            }
+      }
+
+//---------------------------------------------------------
+//   renderPages
+//    every page into an image of its own, one after the
+//    other and in parallel as the png export does
+//---------------------------------------------------------
+
+void TestBenchmark::renderPages_data()
+      {
+      QTest::addColumn<bool>("parallel");
+      QTest::newRow("serial")   << false;
+      QTest::newRow("parallel") << true;
+      }
+
+void TestBenchmark::renderPages()
+      {
+      QFETCH(bool, parallel);
+      loadScore("../demos/goldberg.mscz");
+      QList<Page*> pl = score->pages();
+      std::function<void(Page*)> render = [](Page* page) {
+            QImage img(1240, 1754, QImage::Format_ARGB32_Premultiplied);
+            paintPage(page, img);
+            };
+      for (Page* page : pl)               // fill the glyph cache
+            render(page);
+      QBENCHMARK {
+            if (parallel)
+                  QtConcurrent::blockingMap(pl, render);
+            else {
+                  for (Page* page : pl)
+                        render(page);
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   glyphs
+//    a page full of noteheads, drawn one by one and as
+//    rows of symbols
+//---------------------------------------------------------
+
+void TestBenchmark::glyphsSingle()
+      {
+      ScoreFont* f = ScoreFont::fontFactory(MScore::defaultStyle()->value(StyleIdx::MusicalSymbolFont).toString());
+      QImage img(1240, 1754, QImage::Format_ARGB32_Premultiplied);
+      QPainter p(&img);
+      p.scale(0.3, 0.3);
+      QBENCHMARK {
+            for (int row = 0; row < 200; ++row) {
+                  for (int col = 0; col < 100; ++col)
+                        f->draw(SymId::noteheadBlack, &p, 1.0, QPointF(col * 40.0, row * 30.0));
+                  }
+            }
+      }
+
+void TestBenchmark::glyphsList()
+      {
+      ScoreFont* f = ScoreFont::fontFactory(MScore::defaultStyle()->value(StyleIdx::MusicalSymbolFont).toString());
+      QImage img(1240, 1754, QImage::Format_ARGB32_Premultiplied);
+      QPainter p(&img);
+      p.scale(0.3, 0.3);
+      QList<SymId> ids;
+      for (int col = 0; col < 100; ++col)
+            ids.append(SymId::noteheadBlack);
+      QBENCHMARK {
+            for (int row = 0; row < 200; ++row)
+                  f->draw(ids, &p, 1.0, QPointF(0.0, row * 30.0));
+            }
+      }
+
+//---------------------------------------------------------
+//   setUtPiano
+//    turn the staves into UT-piano staves
+//---------------------------------------------------------
+
+static void setUtPiano(Score* score)
+      {
+      for (int staffIdx = 0; staffIdx < score->nstaves(); ++staffIdx) {
+            StaffTypes st = staffIdx % 2 ? StaffTypes::UTPIANO_LEFT : StaffTypes::UTPIANO_RIGHT;
+            score->staff(staffIdx)->setStaffType(StaffType::preset(st));
+            }
+      }
+
+//---------------------------------------------------------
+//   layoutStandard, layoutUtPiano
+//---------------------------------------------------------
+
+void TestBenchmark::layoutStandard()
+      {
+      loadScore(DIR + "goldberg.mscx");
+      QBENCHMARK {
+            score->doLayout();
+            }
+      }
+
+void TestBenchmark::layoutUtPiano()
+      {
+      loadScore(DIR + "goldberg.mscx");
+      setUtPiano(score);
+      score->doLayout();
+      QBENCHMARK {
+            score->doLayout();
+            }
+      }
+
+//---------------------------------------------------------
+//   utPianoMirror
+//    after layout, the whole measure pairwise conflict
+//    scan of the previous implementation must not change
+//    any mirror
+//---------------------------------------------------------
+
+void TestBenchmark::utPianoMirror()
+      {
+      loadScore(DIR + "goldberg.mscx");
+      setUtPiano(score);
+      score->doLayout();
+      QList<Note*> notes;
+      QList<bool> mirror;
+      for (Segment* s = score->firstSegment(Segment::Type::ChordRest); s; s = s->next1(Segment::Type::ChordRest)) {
+            for (int track = 0; track < score->ntracks(); ++track) {
+                  Element* e = s->element(track);
+                  if (e && e->isChord() && !score->staff(track / VOICES)->isTabStaff()) {
+                        for (Note* n : static_cast<Chord*>(e)->notes()) {
+                              notes.append(n);
+                              mirror.append(n->mirror());
+                              }
+                        }
+                  }
+            }
+      QVERIFY(!notes.isEmpty());
+      for (Segment* s = score->firstSegment(Segment::Type::ChordRest); s; s = s->next1(Segment::Type::ChordRest)) {
+            for (int i = 0; i < s->elist().size() - 1; ++i) {
+                  for (int j = i + 1; j < s->elist().size(); ++j) {
+                        Element* e1 = s->element(i);
+                        Element* e2 = s->element(j);
+                        if (!e1 || !e2 || !e1->isChord() || !e2->isChord())
+                              continue;
+                        for (Note* n1 : static_cast<Chord*>(e1)->notes()) {
+                              for (Note* n2 : static_cast<Chord*>(e2)->notes()) {
+                                    if (qAbs(n1->pitch() - n2->pitch()) >= 2 || !n1->visible() || !n2->visible())
+                                          continue;
+                                    if (n2->userMirror() == MScore::DirectionH::AUTO)
+                                          n2->setMirror(true);
+                                    else if (n2->userMirror() == MScore::DirectionH::LEFT && n1->userMirror() == n2->userMirror())
+                                          n2->setMirror(false);
+                                    }
+                              }
+                        }
+                  }
+            }
+      for (int i = 0; i < notes.size(); ++i)
+            QCOMPARE(notes[i]->mirror(), mirror[i]);
+      }
+
+//---------------------------------------------------------
+//   loadCorpus
+//    read and parse a set of scores
+//---------------------------------------------------------
+
+void TestBenchmark::loadCorpus_data()
+      {
+      QTest::addColumn<QString>("file");
+      QTest::newRow("goldberg.mscx")    << DIR + "goldberg.mscx";
+      QTest::newRow("goldberg.mscz")    << QString("../demos/goldberg.mscz");
+      QTest::newRow("Reunion.mscz")     << QString("../demos/Reunion.mscz");
+      QTest::newRow("Triumph.mscz")     << QString("../demos/Triumph.mscz");
+      QTest::newRow("All_Dudes.mscz")   << QString("../demos/All_Dudes.mscz");
+      }
+
+void TestBenchmark::loadCorpus()
+      {
+      QFETCH(QString, file);
+      QBENCHMARK {
+            Score* s = readScore(file);
+            QVERIFY(s);
+            delete s;
+            }
+      }
+
+//---------------------------------------------------------
+//   residentSize
+//    resident set size in KB, 0 if unknown
+//---------------------------------------------------------
+
+static qint64 residentSize()
+      {
+      QFile f("/proc/self/statm");
+      if (!f.open(QIODevice::ReadOnly))
+            return 0;
+      QList<QByteArray> l = f.readAll().split(' ');
+      return l.size() > 1 ? l[1].toLongLong() * 4 : 0;
+      }
+
+static void poolStatistics(const char* label)
+      {
+      qDebug("%s: rss %lld KB", label, residentSize());
+      for (const ElementPool* p : ElementPool::pools())
+            qDebug("   %-12s allocations %8lld  alive %7d  slabs %6lld KB",
+               p->name(), p->allocations(), p->used(), p->bytes() / 1024);
+      }
+
+//---------------------------------------------------------
+//   loadCloneDestroy
+//    load a large score, clone it and delete both; the
+//    pooled elements of the first round are reused
+//---------------------------------------------------------
+
+void TestBenchmark::loadCloneDestroy()
+      {
+      poolStatistics("start");
+      QBENCHMARK {
+            Score* s = readScore("../demos/goldberg.mscz");
+            QVERIFY(s);
+            s->doLayout();
+            Score* c = s->clone();
+            delete c;
+            delete s;
+            }
+      poolStatistics("end");
+      }
+
 QTEST_MAIN(TestBenchmark)
 #include "tst_benchmark.moc"
 
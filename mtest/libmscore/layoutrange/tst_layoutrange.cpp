@@ -0,0 +1,269 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/measure.h"
+#include "libmscore/segment.h"
+#include "libmscore/chord.h"
+#include "libmscore/note.h"
+#include "libmscore/system.h"
+#include "libmscore/page.h"
+#include "libmscore/undo.h"
+#include "libmscore/layoutbreak.h"
+#include "libmscore/timesig.h"
+#include "libmscore/excerpt.h"
+
+#define DIR QString("../vtest/")
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestLayoutRange
+//    compare the result of an incremental layout after
+//    an edit with a complete layout of the same score
+//---------------------------------------------------------
+
+class TestLayoutRange : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      QString snapshot(Score*);
+      Measure* middleMeasure(Score*);
+
+   private slots:
+      void initTestCase();
+      void cleanupTestCase();
+      void layoutRange_data();
+      void layoutRange();
+      void structuralEdit_data();
+      void structuralEdit();
+      void partScores();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestLayoutRange::initTestCase()
+      {
+      initMTest();
+      MScore::incrementalLayout = true;
+      }
+
+void TestLayoutRange::cleanupTestCase()
+      {
+      MScore::incrementalLayout = false;
+      }
+
+//---------------------------------------------------------
+//   snapshot
+//    dump page, system, measure and note positions
+//---------------------------------------------------------
+
+QString TestLayoutRange::snapshot(Score* score)
+      {
+      QString s;
+      QTextStream ts(&s);
+      ts.setRealNumberPrecision(2);
+      ts.setRealNumberNotation(QTextStream::FixedNotation);
+      for (Page* page : score->pages()) {
+            ts << "page " << page->no() << "\n";
+            for (System* system : *page->systems()) {
+                  ts << "  system " << system->pagePos().x() << " " << system->pagePos().y() << "\n";
+                  for (MeasureBase* mb : system->measures())
+                        ts << "    measure " << mb->tick() << " " << mb->pos().x() << " " << mb->width() << "\n";
+                  }
+            }
+      for (Segment* s = score->firstSegment(Segment::Type::ChordRest); s; s = s->next1(Segment::Type::ChordRest)) {
+            for (Element* e : s->elist()) {
+                  if (!e || e->type() != Element::Type::CHORD)
+                        continue;
+                  for (Note* n : static_cast<Chord*>(e)->notes())
+                        ts << "note " << s->tick() << " " << n->pagePos().x() << " " << n->pagePos().y() << "\n";
+                  }
+            }
+      return s;
+      }
+
+//---------------------------------------------------------
+//   middleMeasure
+//---------------------------------------------------------
+
+Measure* TestLayoutRange::middleMeasure(Score* score)
+      {
+      Measure* m = score->firstMeasure();
+      for (int i = score->nmeasures() / 2; i > 0 && m->nextMeasure(); --i)
+            m = m->nextMeasure();
+      return m;
+      }
+
+//---------------------------------------------------------
+//   layoutRange_data
+//---------------------------------------------------------
+
+void TestLayoutRange::layoutRange_data()
+      {
+      QTest::addColumn<QString>("file");
+
+      QTest::newRow("accidental-1")   << "accidental-1";
+      QTest::newRow("beams-1")        << "beams-1";
+      QTest::newRow("chord-layout-1") << "chord-layout-1";
+      QTest::newRow("emmentaler-1")   << "emmentaler-1";
+      QTest::newRow("lyrics-1")       << "lyrics-1";
+      QTest::newRow("slurs-1")        << "slurs-1";
+      QTest::newRow("system-1")       << "system-1";
+      QTest::newRow("tie-1")          << "tie-1";
+      QTest::newRow("tuplets-1")      << "tuplets-1";
+      }
+
+//---------------------------------------------------------
+//   layoutRange
+//    widen a measure in the middle of the score, which
+//    changes the line breaks, and force all stems up
+//---------------------------------------------------------
+
+void TestLayoutRange::layoutRange()
+      {
+      QFETCH(QString, file);
+
+      Score* score = readScore(DIR + file + ".mscz");
+      QVERIFY(score);
+      score->doLayout();
+
+      Measure* m = middleMeasure(score);
+
+      score->startCmd();
+      for (Segment* s = m->first(Segment::Type::ChordRest); s; s = s->next(Segment::Type::ChordRest)) {
+            s->undoChangeProperty(P_ID::LEADING_SPACE, 4.0);
+            for (Element* e : s->elist()) {
+                  if (e && e->type() == Element::Type::CHORD)
+                        e->undoChangeProperty(P_ID::STEM_DIRECTION, int(MScore::Direction::UP));
+                  }
+            }
+      int stick, etick;
+      QVERIFY(score->undo()->layoutRange(&stick, &etick));
+      QCOMPARE(stick, m->tick());
+      score->endCmd();
+      QString incremental = snapshot(score);
+
+      score->doLayout();
+      QString full = snapshot(score);
+
+      QCOMPARE(incremental, full);
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   structuralEdit
+//    edits which change the measures or the system and
+//    page breaks after them need a complete layout
+//---------------------------------------------------------
+
+void TestLayoutRange::structuralEdit_data()
+      {
+      QTest::addColumn<QString>("edit");
+
+      QTest::newRow("line break")     << "line break";
+      QTest::newRow("page break")     << "page break";
+      QTest::newRow("time signature") << "time signature";
+      QTest::newRow("insert measure") << "insert measure";
+      QTest::newRow("delete measure") << "delete measure";
+      }
+
+void TestLayoutRange::structuralEdit()
+      {
+      QFETCH(QString, edit);
+
+      Score* score = readScore(DIR + "system-1.mscz");
+      QVERIFY(score);
+      score->doLayout();
+      Measure* m = middleMeasure(score);
+
+      score->startCmd();
+      if (edit == "line break" || edit == "page break") {
+            LayoutBreak* lb = new LayoutBreak(score);
+            lb->setLayoutBreakType(edit == "line break" ? LayoutBreak::Type::LINE : LayoutBreak::Type::PAGE);
+            lb->setTrack(0);
+            lb->setParent(m);
+            score->undoAddElement(lb);
+            }
+      else if (edit == "time signature") {
+            TimeSig* ts = new TimeSig(score);
+            ts->setSig(Fraction(3, 4), TimeSigType::NORMAL);
+            score->cmdAddTimeSig(m, 0, ts, false);
+            }
+      else if (edit == "insert measure")
+            score->insertMeasure(Element::Type::MEASURE, m);
+      else if (edit == "delete measure") {
+            score->select(m);
+            score->cmdDeleteSelectedMeasures();
+            }
+      int stick, etick;
+      QVERIFY(!score->undo()->layoutRange(&stick, &etick));
+      score->endCmd();
+      QString incremental = snapshot(score);
+
+      score->doLayout();
+      QString full = snapshot(score);
+
+      QCOMPARE(incremental, full);
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   partScores
+//    an edit in a part score is laid out in the range of
+//    the shared undo stack in the main score and in all
+//    parts
+//---------------------------------------------------------
+
+void TestLayoutRange::partScores()
+      {
+      Score* score = readScore("libmscore/parts/part-all-parts.mscx");
+      QVERIFY(score);
+      QVERIFY(!score->excerpts().isEmpty());
+      for (Score* s : score->scoreList())
+            s->doLayout();
+
+      for (Excerpt* ex : score->excerpts()) {
+            Score* part = ex->partScore();
+            Measure* m = part->firstMeasure();        // has chords in all parts
+            part->startCmd();
+            for (Segment* s = m->first(Segment::Type::ChordRest); s; s = s->next(Segment::Type::ChordRest)) {
+                  for (Element* e : s->elist()) {
+                        if (!e || e->type() != Element::Type::CHORD)
+                              continue;
+                        bool up = e->getProperty(P_ID::STEM_DIRECTION).toInt() == int(MScore::Direction::UP);
+                        e->undoChangeProperty(P_ID::STEM_DIRECTION, int(up ? MScore::Direction::DOWN : MScore::Direction::UP));
+                        }
+                  }
+            int stick, etick;
+            QVERIFY(part->undo()->layoutRange(&stick, &etick));
+            part->endCmd();
+
+            QString incremental, full;
+            for (Score* s : score->scoreList())
+                  incremental += snapshot(s);
+            for (Score* s : score->scoreList()) {
+                  s->doLayout();
+                  full += snapshot(s);
+                  }
+            QCOMPARE(incremental, full);
+            }
+      delete score;
+      }
+
+QTEST_MAIN(TestLayoutRange)
+#include "tst_layoutrange.moc"
+
@@ -15,6 +15,7 @@
 #include <QFile>
 #include <QCoreApplication>
 #include <QTextStream>
+#include <QScopedValueRollback>
 #include "libmscore/mscore.h"
 #include "libmscore/score.h"
 #include "libmscore/durationtype.h"
@@ -23,6 +24,9 @@
 #include "libmscore/chord.h"
 #include "libmscore/note.h"
 #include "libmscore/keysig.h"
+#include "libmscore/dynamic.h"
+#include "libmscore/undo.h"
+#include "libmscore/eventcache.h"
 #include "mscore/exportmidi.h"
 #include "mscore/preferences.h"
 #include <QIODevice>
@@ -53,6 +57,9 @@ class TestMidi : public QObject, public MTest
       void midi03();
       void events_data();
       void events();
+      void eventCache_data();
+      void eventCache();
+      void staffTextRepeatInstrumentChange();
       void midiBendsExport1() { midiExportTestRef("testBends1"); }
       void midiBendsExport2() { midiExportTestRef("testBends2"); }      // Play property test
       void midiPortExport()   { midiExportTestRef("testMidiPort"); }
@@ -398,6 +405,166 @@ void TestMidi::events()
      // QVERIFY(saveCompareScore(score, writeFile, reference));
       }
 
+//---------------------------------------------------------
+//   eventList
+//    the events as text, for comparison
+//---------------------------------------------------------
+
+static QStringList eventList(const EventMap& events)
+      {
+      QStringList sl;
+      for (const auto& e : events) {
+            sl.append(QString("%1 %2 %3 %4 %5 %6").arg(e.first).arg(e.second.type()).arg(e.second.channel())
+               .arg(e.second.dataA()).arg(e.second.dataB()).arg(e.second.discard()));
+            }
+      return sl;
+      }
+
+//---------------------------------------------------------
+//   firstChord
+//    the first chord in or after measure m
+//---------------------------------------------------------
+
+static Chord* firstChord(Measure* m)
+      {
+      for (Segment* s = m->first(Segment::Type::ChordRest); s; s = s->next1(Segment::Type::ChordRest)) {
+            for (int track = 0; track < s->score()->ntracks(); ++track) {
+                  Element* e = s->element(track);
+                  if (e && e->type() == Element::Type::CHORD)
+                        return static_cast<Chord*>(e);
+                  }
+            }
+      return 0;
+      }
+
+//---------------------------------------------------------
+//   eventCache
+//    the events rendered with the cache must be the same
+//    as the events of a full rendering after each edit,
+//    and a change of one note must render only the
+//    measures around it again
+//---------------------------------------------------------
+
+void TestMidi::eventCache_data()
+      {
+      QTest::addColumn<QString>("file");
+      QTest::newRow("testPausesRepeats") << "testPausesRepeats";
+      QTest::newRow("testSwing8thTies")  << "testSwing8thTies";
+      QTest::newRow("testGraceBefore")   << "testGraceBefore";
+      QTest::newRow("testTieTrill")      << "testTieTrill";
+      QTest::newRow("testPedal")         << "testPedal";
+      }
+
+void TestMidi::eventCache()
+      {
+      QFETCH(QString, file);
+
+      QScopedValueRollback<bool> incremental(MScore::incrementalPlayback, true);
+      QScopedPointer<Score> score(readScore(DIR + file + ".mscx"));
+      QVERIFY(score);
+      score->doLayout();
+
+      auto compare = [&score]() {
+            EventMap cached;
+            score->renderMidi(&cached);
+            EventMap full;
+            score->renderMidi(&full, true, MScore::playRepeats);
+            return eventList(cached) == eventList(full);
+            };
+      QVERIFY(compare());
+      const EventCache* cache = score->eventCache();
+      QVERIFY(cache);
+      int rendered = cache->renderCount();
+      int hits     = cache->hitCount();
+
+      // nothing changed: nothing is rendered again, every
+      // measure of every pass comes from the cache
+      QVERIFY(compare());
+      QCOMPARE(cache->renderCount(), rendered);
+      int passes = cache->hitCount() - hits;
+      QCOMPARE(passes, hits + rendered);
+
+      Measure* m = score->firstMeasure()->nextMeasure();
+      QVERIFY(m);
+      Chord* chord = firstChord(m);
+      QVERIFY(chord);
+
+      // change a pitch: the measure and its neighbours are rendered again
+      score->select(chord->upNote());
+      score->startCmd();
+      score->upDown(true, UpDownMode::CHROMATIC);
+      score->endCmd();
+      QVERIFY(compare());
+      int renderedAgain = cache->renderCount() - rendered;
+      QVERIFY(renderedAgain <= 3 * score->nstaves());
+      QVERIFY(renderedAgain > 0);
+      // all other measures come from the cache
+      QCOMPARE(cache->hitCount() - hits - passes, passes - renderedAgain);
+
+      // add a dynamic: the velocities of the staff change from there on
+      Dynamic* d = new Dynamic(score.data());
+      d->setDynamicType("ff");
+      d->setTrack(chord->track());
+      d->setParent(chord->segment());
+      score->startCmd();
+      score->undoAddElement(d);
+      score->endCmd();
+      QVERIFY(compare());
+
+      // delete a note
+      score->select(chord->upNote());
+      score->startCmd();
+      score->cmdDeleteSelection();
+      score->endCmd();
+      QVERIFY(compare());
+
+      // undo and redo
+      for (int i = 0; i < 3; ++i) {
+            score->undo()->undo();
+            score->endUndoRedo();
+            QVERIFY(compare());
+            }
+      for (int i = 0; i < 3; ++i) {
+            score->undo()->redo();
+            score->endUndoRedo();
+            QVERIFY(compare());
+            }
+      }
+
+//---------------------------------------------------------
+//   staffTextRepeatInstrumentChange
+//    a staff text midi action in a repeat before an
+//    instrument change must use the instrument at its
+//    position in the score on every pass
+//---------------------------------------------------------
+
+void TestMidi::staffTextRepeatInstrumentChange()
+      {
+      QScopedPointer<Score> score(readScore(DIR + "testStaffTextRepeatInstrumentChange.mscx"));
+      QVERIFY(score);
+      score->doLayout();
+      score->rebuildMidiMapping();
+
+      EventMap events;
+      score->renderMidi(&events, false, true);
+      QList<int> ticks;
+      for (const auto& e : events) {
+            if (e.second.type() != ME_CONTROLLER || e.second.dataA() != CTRL_VOLUME)
+                  continue;
+            QCOMPARE(e.second.dataB(), 10);     // the action of the first instrument
+            ticks.append(e.first);
+            }
+      QCOMPARE(ticks, QList<int>() << 1920 << 5760);
+
+      // the cached events are rendered without the repeat offset
+      QScopedValueRollback<bool> incremental(MScore::incrementalPlayback, true);
+      EventMap cached;
+      score->renderMidi(&cached);
+      EventMap full;
+      score->renderMidi(&full, true, MScore::playRepeats);
+      QCOMPARE(eventList(cached), eventList(full));
+      }
+
 //---------------------------------------------------------
 //   midiExportTest
 //   read a MuseScore mscx file, write to a MIDI file and verify against reference
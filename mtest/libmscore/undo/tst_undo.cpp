@@ -0,0 +1,227 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/segment.h"
+#include "libmscore/chord.h"
+#include "libmscore/note.h"
+#include "libmscore/undo.h"
+
+#define DIR QString("../vtest/")
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestUndo
+//    undo step limits and merging of property changes
+//---------------------------------------------------------
+
+class TestUndo : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      Score* score;
+      QList<Chord*> chords;
+
+      void setStem(Chord* c, MScore::Direction d);
+      MScore::Direction stem(Chord* c) const { return MScore::Direction(c->getProperty(P_ID::STEM_DIRECTION).toInt()); }
+
+   private slots:
+      void initTestCase();
+      void init();
+      void cleanup();
+      void mergeInMacro();
+      void mergeMacros();
+      void noMergeAfterUndo();
+      void noMergeIntoCleanState();
+      void stepLimit();
+      void memoryLimit();
+      void elementMemory();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestUndo::initTestCase()
+      {
+      initMTest();
+      }
+
+void TestUndo::init()
+      {
+      score = readScore(DIR + "chord-layout-1.mscz");
+      QVERIFY(score);
+      score->doLayout();
+      chords.clear();
+      for (Segment* s = score->firstSegment(Segment::Type::ChordRest); s; s = s->next1(Segment::Type::ChordRest)) {
+            Element* e = s->element(0);
+            if (e && e->type() == Element::Type::CHORD)
+                  chords.append(static_cast<Chord*>(e));
+            }
+      QVERIFY(chords.size() >= 5);
+      for (int i = 0; i < 5; ++i)
+            QCOMPARE(stem(chords[i]), MScore::Direction::AUTO);
+      }
+
+void TestUndo::cleanup()
+      {
+      MScore::undoLimit         = 0;
+      MScore::undoMemoryLimit   = 0;
+      MScore::undoMergeInterval = 0;
+      delete score;
+      }
+
+void TestUndo::setStem(Chord* c, MScore::Direction d)
+      {
+      score->startCmd();
+      c->undoChangeProperty(P_ID::STEM_DIRECTION, int(d));
+      score->endCmd();
+      }
+
+//---------------------------------------------------------
+//   mergeInMacro
+//    repeated changes of a property in one command keep
+//    only the first value
+//---------------------------------------------------------
+
+void TestUndo::mergeInMacro()
+      {
+      Chord* c = chords[0];
+      score->startCmd();
+      c->undoChangeProperty(P_ID::STEM_DIRECTION, int(MScore::Direction::UP));
+      c->undoChangeProperty(P_ID::STEM_DIRECTION, int(MScore::Direction::DOWN));
+      c->undoChangeProperty(P_ID::STEM_DIRECTION, int(MScore::Direction::UP));
+      QCOMPARE(score->undo()->current()->childCount(), 2);      // SaveState, ChangeProperty
+      score->endCmd();
+      QCOMPARE(stem(c), MScore::Direction::UP);
+      score->undo()->undo();
+      QCOMPARE(stem(c), MScore::Direction::AUTO);
+      score->undo()->redo();
+      QCOMPARE(stem(c), MScore::Direction::UP);
+      }
+
+//---------------------------------------------------------
+//   mergeMacros
+//    consecutive commands changing the same property are
+//    one undo step
+//---------------------------------------------------------
+
+void TestUndo::mergeMacros()
+      {
+      MScore::undoMergeInterval = 60000;
+      Chord* c = chords[0];
+      setStem(c, MScore::Direction::UP);
+      setStem(c, MScore::Direction::DOWN);
+      setStem(c, MScore::Direction::UP);
+      QCOMPARE(score->undo()->count(), 1);
+      setStem(chords[1], MScore::Direction::DOWN);
+      QCOMPARE(score->undo()->count(), 2);
+
+      score->undo()->undo();
+      QCOMPARE(stem(chords[1]), MScore::Direction::AUTO);
+      QCOMPARE(stem(c), MScore::Direction::UP);
+      score->undo()->undo();
+      QCOMPARE(stem(c), MScore::Direction::AUTO);
+      QVERIFY(!score->undo()->canUndo());
+      }
+
+void TestUndo::noMergeAfterUndo()
+      {
+      MScore::undoMergeInterval = 60000;
+      Chord* c = chords[0];
+      setStem(c, MScore::Direction::UP);
+      setStem(chords[1], MScore::Direction::UP);
+      score->undo()->undo();
+      setStem(c, MScore::Direction::DOWN);
+      QCOMPARE(score->undo()->count(), 2);
+      score->undo()->undo();
+      QCOMPARE(stem(c), MScore::Direction::UP);
+      }
+
+void TestUndo::noMergeIntoCleanState()
+      {
+      MScore::undoMergeInterval = 60000;
+      Chord* c = chords[0];
+      setStem(c, MScore::Direction::UP);
+      score->undo()->setClean();
+      setStem(c, MScore::Direction::DOWN);
+      QCOMPARE(score->undo()->count(), 2);
+      score->undo()->undo();
+      QVERIFY(score->undo()->isClean());
+      }
+
+//---------------------------------------------------------
+//   stepLimit
+//    the oldest steps are dropped, the state they
+//    produced stays
+//---------------------------------------------------------
+
+void TestUndo::stepLimit()
+      {
+      MScore::undoLimit = 3;
+      for (int i = 0; i < 5; ++i)
+            setStem(chords[i], MScore::Direction::UP);
+      QCOMPARE(score->undo()->count(), 3);
+      while (score->undo()->canUndo())
+            score->undo()->undo();
+      QCOMPARE(stem(chords[0]), MScore::Direction::UP);
+      QCOMPARE(stem(chords[1]), MScore::Direction::UP);
+      for (int i = 2; i < 5; ++i)
+            QCOMPARE(stem(chords[i]), MScore::Direction::AUTO);
+      QVERIFY(!score->undo()->isClean());
+      }
+
+//---------------------------------------------------------
+//   memoryLimit
+//---------------------------------------------------------
+
+void TestUndo::memoryLimit()
+      {
+      for (int i = 0; i < 4; ++i)
+            setStem(chords[i], MScore::Direction::UP);
+      QCOMPARE(score->undo()->count(), 4);
+      qint64 size = score->undo()->memoryUsage();
+      QVERIFY(size > 0);
+
+      MScore::undoMemoryLimit = size / 2;
+      setStem(chords[4], MScore::Direction::UP);
+      QVERIFY(score->undo()->count() < 4);
+      QVERIFY(score->undo()->memoryUsage() <= MScore::undoMemoryLimit);
+
+      MScore::undoMemoryLimit = 1;
+      setStem(chords[4], MScore::Direction::DOWN);
+      QCOMPARE(score->undo()->count(), 1);             // the last step is kept
+      score->undo()->undo();
+      QCOMPARE(stem(chords[4]), MScore::Direction::UP);
+      QCOMPARE(score->undo()->count(), 1);
+      }
+
+//---------------------------------------------------------
+//   elementMemory
+//    a removed note is owned by the undo stack and
+//    counted
+//---------------------------------------------------------
+
+void TestUndo::elementMemory()
+      {
+      qint64 size = score->undo()->memoryUsage();
+      score->startCmd();
+      score->deleteItem(chords[0]->notes().front());
+      score->endCmd();
+      QVERIFY(score->undo()->memoryUsage() - size >= qint64(sizeof(Note)));
+      }
+
+QTEST_MAIN(TestUndo)
+#include "tst_undo.moc"
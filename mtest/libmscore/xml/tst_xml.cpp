@@ -0,0 +1,96 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/xml.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestXml
+//    XmlReader tag ids and number conversion
+//---------------------------------------------------------
+
+class TestXml : public QObject, public MTest
+      {
+      Q_OBJECT
+
+   private slots:
+      void initTestCase();
+      void tagId();
+      void readNumbers();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestXml::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   tagId
+//    known tags map to their id, all others to
+//    XmlTag::UNKNOWN
+//---------------------------------------------------------
+
+void TestXml::tagId()
+      {
+      XmlReader e(QByteArray("<a><Accidental/><Chord/><velocity/><Chords/><aaa/><zzz/></a>"));
+      e.readNextStartElement();
+      XmlTag ids[] = { XmlTag::ACCIDENTAL, XmlTag::CHORD, XmlTag::VELOCITY,
+                       XmlTag::UNKNOWN, XmlTag::UNKNOWN, XmlTag::UNKNOWN };
+      for (XmlTag id : ids) {
+            QVERIFY(e.readNextStartElement());
+            QVERIFY(e.tagId() == id);
+            e.skipCurrentElement();
+            }
+      }
+
+//---------------------------------------------------------
+//   readNumbers
+//    readInt() etc. give the same values as the
+//    conversion of readElementText()
+//---------------------------------------------------------
+
+void TestXml::readNumbers()
+      {
+      XmlReader e(QByteArray("<a><i>42</i><i></i><i>1<!-- c -->2</i><i>&#51;4</i>"
+                             "<d>-0.25</d><h>ff</h><b>x</b></a>"));
+      e.readNextStartElement();
+      e.readNextStartElement();
+      QCOMPARE(e.readInt(), 42);
+      e.readNextStartElement();
+      bool ok = true;
+      QCOMPARE(e.readInt(&ok), 0);
+      QVERIFY(!ok);
+      e.readNextStartElement();
+      QCOMPARE(e.readInt(), 12);
+      e.readNextStartElement();
+      QCOMPARE(e.readInt(), 34);
+      e.readNextStartElement();
+      QCOMPARE(e.readDouble(), -0.25);
+      e.readNextStartElement();
+      QCOMPARE(e.readIntHex(), 255);
+      e.readNextStartElement();
+      QCOMPARE(e.readInt(&ok), 0);
+      QVERIFY(!ok);
+      QVERIFY(!e.readNextStartElement());
+      QVERIFY(!e.hasError());
+      }
+
+QTEST_MAIN(TestXml)
+#include "tst_xml.moc"
+
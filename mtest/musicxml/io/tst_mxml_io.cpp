@@ -42,6 +42,7 @@ class TestMxmlIO : public QObject, public MTest
       void mxmlMscxExportTestRef(const char* file);
       void mxmlReadTestCompr(const char* file);
       void mxmlReadWriteTestCompr(const char* file);
+      void mxmlIoTestValidation(const char* file, MusicxmlValidation validation);
 
 
       // The list of MusicXML regression tests
@@ -176,6 +177,8 @@ private slots:
       void words2() { mxmlIoTest("testWords2"); }
       void sound1() { mxmlIoTestRef("testSound1"); }
       void sound2() { mxmlIoTestRef("testSound2"); }
+      void validationOnError() { mxmlIoTestValidation("testVoicePiano1", MusicxmlValidation::ON_ERROR); }
+      void validationNo() { mxmlIoTestValidation("testVoicePiano1", MusicxmlValidation::NO); }
       };
 
 //---------------------------------------------------------
@@ -341,5 +344,18 @@ void TestMxmlIO::mxmlReadWriteTestCompr(const char* file)
       delete score;
       }
 
+//---------------------------------------------------------
+//   mxmlIoTestValidation
+//   read a MusicXML file validating it only on error or not at all,
+//   write to a new file and verify both files are identical
+//---------------------------------------------------------
+
+void TestMxmlIO::mxmlIoTestValidation(const char* file, MusicxmlValidation validation)
+      {
+      preferences.musicxmlImportValidation = validation;
+      mxmlIoTest(file);
+      preferences.musicxmlImportValidation = MusicxmlValidation::FULL;
+      }
+
 QTEST_MAIN(TestMxmlIO)
 #include "tst_mxml_io.moc"
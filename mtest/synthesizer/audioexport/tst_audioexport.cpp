@@ -0,0 +1,210 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include <cmath>
+#include "mtest/testutils.h"
+#include "synthesizer/loudness.h"
+#include "synthesizer/spillbuffer.h"
+
+using namespace Ms;
+
+static const int SAMPLE_RATE = 44100;
+
+//---------------------------------------------------------
+//   sine
+//    fill interleaved stereo buffer with a sine wave
+//---------------------------------------------------------
+
+static void sine(float* data, long long pos, int frames, double freq, double amplitude)
+      {
+      for (int i = 0; i < frames; ++i) {
+            float v = amplitude * sin(2.0 * M_PI * freq * (pos + i) / SAMPLE_RATE);
+            *data++ = v;
+            *data++ = v;
+            }
+      }
+
+//---------------------------------------------------------
+//   TestAudioExport
+//---------------------------------------------------------
+
+class TestAudioExport : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      double loudness(double amplitude, int seconds, int silence = 0);
+
+   private slots:
+      void initTestCase();
+      void loudnessSine();
+      void loudnessSilence();
+      void loudnessGating();
+      void spillBufferMemory();
+      void spillBufferFile();
+      void exportRealtimeFactor();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestAudioExport::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   loudness
+//    997Hz sine in both channels followed by silence
+//---------------------------------------------------------
+
+double TestAudioExport::loudness(double amplitude, int seconds, int silence)
+      {
+      LoudnessMeter meter(SAMPLE_RATE);
+      float data[1024 * 2];
+      long long frames = (long long)seconds * SAMPLE_RATE;
+      for (long long pos = 0; pos < frames; pos += 1024) {
+            sine(data, pos, 1024, 997.0, amplitude);
+            meter.process(data, 1024);
+            }
+      memset(data, 0, sizeof(data));
+      for (long long pos = 0; pos < (long long)silence * SAMPLE_RATE; pos += 1024)
+            meter.process(data, 1024);
+      return meter.integratedLoudness();
+      }
+
+//---------------------------------------------------------
+//   loudnessSine
+//    a full scale 997Hz sine in both channels of a stereo
+//    signal measures 0 LUFS (BS.1770 calibration)
+//---------------------------------------------------------
+
+void TestAudioExport::loudnessSine()
+      {
+      QVERIFY(qAbs(loudness(1.0, 5)) < 0.1);
+      QVERIFY(qAbs(loudness(0.1, 5) + 20.0) < 0.1);
+      }
+
+//---------------------------------------------------------
+//   loudnessSilence
+//---------------------------------------------------------
+
+void TestAudioExport::loudnessSilence()
+      {
+      QCOMPARE(loudness(0.0, 5), -HUGE_VAL);
+      }
+
+//---------------------------------------------------------
+//   loudnessGating
+//    trailing silence is removed by the absolute gate
+//---------------------------------------------------------
+
+void TestAudioExport::loudnessGating()
+      {
+      QVERIFY(qAbs(loudness(0.1, 5, 20) - loudness(0.1, 5)) < 0.25);
+      }
+
+//---------------------------------------------------------
+//   spillBufferMemory
+//---------------------------------------------------------
+
+void TestAudioExport::spillBufferMemory()
+      {
+      AudioSpillBuffer buffer;
+      float data[512 * 2];
+      for (int pos = 0; pos < SAMPLE_RATE; pos += 512) {
+            sine(data, pos, 512, 440.0, 0.5);
+            QVERIFY(buffer.write(data, 512));
+            }
+      QVERIFY(buffer.finish());
+      QVERIFY(!buffer.spilled());
+      QVERIFY(qAbs(buffer.peak() - 0.5) < 0.001);
+
+      float ref[512 * 2];
+      sine(ref, 1024, 512, 440.0, 0.5);
+      QCOMPARE(buffer.read(1024, data, 512), 512);
+      QVERIFY(memcmp(data, ref, sizeof(ref)) == 0);
+      }
+
+//---------------------------------------------------------
+//   spillBufferFile
+//    a buffer exceeding the memory limit is moved into a
+//    temporary file and read back unchanged
+//---------------------------------------------------------
+
+void TestAudioExport::spillBufferFile()
+      {
+      AudioSpillBuffer buffer(64 * 1024);
+      float data[500 * 2];
+      const long long frames = 3 * SAMPLE_RATE;
+      for (long long pos = 0; pos < frames; pos += 500) {
+            sine(data, pos, 500, 440.0, 0.25);
+            QVERIFY(buffer.write(data, 500));
+            }
+      QVERIFY(buffer.finish());
+      QVERIFY(buffer.spilled());
+      QCOMPARE(buffer.frames(), frames + (500 - frames % 500) % 500);
+
+      float ref[777 * 2];
+      float out[777 * 2];
+      for (long long pos = 0; pos < frames; pos += 50000) {
+            int n = buffer.read(pos, out, 777);
+            QCOMPARE(n, 777);
+            sine(ref, pos, 777, 440.0, 0.25);
+            QVERIFY(memcmp(out, ref, sizeof(ref)) == 0);
+            }
+      QCOMPARE(buffer.read(buffer.frames() - 10, out, 777), 10);
+      QCOMPARE(buffer.read(buffer.frames(), out, 777), 0);
+      }
+
+//---------------------------------------------------------
+//   exportRealtimeFactor
+//    cost of the export stage after synthesis: spill,
+//    loudness measurement and applying the gain for one
+//    minute of audio
+//---------------------------------------------------------
+
+void TestAudioExport::exportRealtimeFactor()
+      {
+      static const int FRAMES = 512;
+      const long long frames = 60LL * SAMPLE_RATE;
+      float data[FRAMES * 2];
+      QElapsedTimer timer;
+      timer.start();
+      QBENCHMARK_ONCE {
+            AudioSpillBuffer buffer(8 * 1024 * 1024);
+            LoudnessMeter meter(SAMPLE_RATE);
+            for (long long pos = 0; pos < frames; pos += FRAMES) {
+                  sine(data, pos, FRAMES, 440.0, 0.5);
+                  buffer.write(data, FRAMES);
+                  meter.process(data, FRAMES);
+                  }
+            buffer.finish();
+            double gain = pow(10.0, (-16.0 - meter.integratedLoudness()) / 20.0);
+            double sum  = 0.0;
+            for (long long pos = 0; pos < buffer.frames(); pos += FRAMES) {
+                  int n = buffer.read(pos, data, FRAMES);
+                  for (int i = 0; i < n * 2; ++i)
+                        sum += data[i] * gain;
+                  }
+            QVERIFY(buffer.spilled());
+            QVERIFY(qIsFinite(sum));
+            }
+      qint64 ms = timer.elapsed();
+      if (ms)
+            qDebug("export stage: %.0fx realtime", 60000.0 / ms);
+      }
+
+QTEST_MAIN(TestAudioExport)
+#include "tst_audioexport.moc"
+
@@ -0,0 +1,231 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include <cmath>
+#include "mtest/testutils.h"
+#include "fluid/dspkernel.h"
+
+using namespace Ms;
+using namespace FluidS;
+
+Q_DECLARE_METATYPE(FluidS::DspIsa)
+
+static const int ROWS        = 256;
+static const int SAMPLE_SIZE = 1 << 16;
+static const int PERIOD      = 64;
+
+//---------------------------------------------------------
+//   reference
+//    the per sample interpolation of dsp.cpp for one frame
+//---------------------------------------------------------
+
+static float reference(int taps, const short* d, const float* coeffs, float amp)
+      {
+      switch (taps) {
+            case 2:
+                  return amp * (coeffs[0] * d[0] + coeffs[1] * d[1]);
+            case 4:
+                  return amp * (coeffs[0] * d[0]
+                     + coeffs[1] * d[1]
+                     + coeffs[2] * d[2]
+                     + coeffs[3] * d[3]);
+            default:
+                  return amp * (coeffs[0] * (float)d[0]
+                     + coeffs[1] * (float)d[1]
+                     + coeffs[2] * (float)d[2]
+                     + coeffs[3] * (float)d[3]
+                     + coeffs[4] * (float)d[4]
+                     + coeffs[5] * (float)d[5]
+                     + coeffs[6] * (float)d[6]);
+            }
+      }
+
+static DspKernel kernel(DspIsa isa, int taps)
+      {
+      const DspKernels& k = dspKernels(isa);
+      return taps == 2 ? k.linear : (taps == 4 ? k.cubic : k.sinc7);
+      }
+
+//---------------------------------------------------------
+//   TestFluidDsp
+//---------------------------------------------------------
+
+class TestFluidDsp : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      std::vector<short> sample;
+      std::vector<float> table[3];
+
+      void isaData();
+
+   private slots:
+      void initTestCase();
+      void bitExact_data()          { isaData(); }
+      void bitExact();
+      void sampleEdges_data()       { isaData(); }
+      void sampleEdges();
+      void voiceThroughput_data();
+      void voiceThroughput();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//    a noisy sine and random coefficient tables
+//---------------------------------------------------------
+
+void TestFluidDsp::initTestCase()
+      {
+      initMTest();
+      qsrand(4711);
+      sample.resize(SAMPLE_SIZE);
+      for (int i = 0; i < SAMPLE_SIZE; ++i)
+            sample[i] = short(qBound(-32768.0, 30000.0 * sin(i * 0.013) + (qrand() % 4096) - 2048, 32767.0));
+      const int taps[3] = { 2, 4, 7 };
+      for (int t = 0; t < 3; ++t) {
+            table[t].resize(ROWS * taps[t]);
+            for (float& c : table[t])
+                  c = float(qrand()) / RAND_MAX * 2.0f - 1.0f;
+            }
+      }
+
+void TestFluidDsp::isaData()
+      {
+      QTest::addColumn<DspIsa>("isa");
+      QTest::newRow("scalar") << DspIsa::SCALAR;
+      QTest::newRow("sse2")   << DspIsa::SSE2;
+      QTest::newRow("avx2")   << DspIsa::AVX2;
+      }
+
+//---------------------------------------------------------
+//   bitExact
+//    every kernel gives the same bits as the per sample
+//    code, for random blocks of all lengths
+//---------------------------------------------------------
+
+void TestFluidDsp::bitExact()
+      {
+      QFETCH(DspIsa, isa);
+      if (!dspIsaSupported(isa))
+            QSKIP("instruction set not supported");
+      const int taps[3] = { 2, 4, 7 };
+      DspBlock block;
+      float out[DSP_BLOCK];
+      for (int run = 0; run < 3000; ++run) {
+            int frames = 1 + run % DSP_BLOCK;
+            for (int t = 0; t < 3; ++t) {
+                  for (int k = 0; k < frames; ++k) {
+                        block.index[k] = qrand() % (SAMPLE_SIZE - 8);
+                        block.row[k]   = (qrand() % ROWS) * taps[t];
+                        block.amp[k]   = float(qrand()) / RAND_MAX;
+                        }
+                  kernel(isa, taps[t])(out, sample.data(), table[t].data(), block, frames);
+                  for (int k = 0; k < frames; ++k) {
+                        float ref = reference(taps[t], sample.data() + block.index[k], table[t].data() + block.row[k], block.amp[k]);
+                        QCOMPARE(memcmp(&out[k], &ref, sizeof(float)), 0);
+                        }
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   sampleEdges
+//    frames using the first and last points of a sample
+//    must not read outside of it; the buffer has exactly
+//    the size of the sample, so a build with address
+//    sanitizer catches such reads
+//---------------------------------------------------------
+
+void TestFluidDsp::sampleEdges()
+      {
+      QFETCH(DspIsa, isa);
+      if (!dspIsaSupported(isa))
+            QSKIP("instruction set not supported");
+      const int taps[3] = { 2, 4, 7 };
+      for (int t = 0; t < 3; ++t) {
+            const int size = 16;
+            std::vector<short> buffer(sample.begin(), sample.begin() + size);
+            DspBlock block;
+            float out[DSP_BLOCK];
+            for (int k = 0; k < DSP_BLOCK; ++k) {
+                  block.index[k] = (k % 2) ? size - taps[t] : 0;
+                  block.row[k]   = (k % ROWS) * taps[t];
+                  block.amp[k]   = 0.5f;
+                  }
+            kernel(isa, taps[t])(out, buffer.data(), table[t].data(), block, DSP_BLOCK);
+            for (int k = 0; k < DSP_BLOCK; ++k) {
+                  float ref = reference(taps[t], buffer.data() + block.index[k], table[t].data() + block.row[k], 0.5f);
+                  QCOMPARE(memcmp(&out[k], &ref, sizeof(float)), 0);
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   voiceThroughput
+//    render one period of 64 frames for a number of voices
+//    at different pitches with the 4th order interpolation
+//    (the default) and the 7th order one
+//---------------------------------------------------------
+
+void TestFluidDsp::voiceThroughput_data()
+      {
+      QTest::addColumn<DspIsa>("isa");
+      QTest::addColumn<int>("taps");
+      QTest::addColumn<int>("voices");
+      const char* names[3] = { "scalar", "sse2", "avx2" };
+      for (int isa = 0; isa < 3; ++isa) {
+            for (int taps : { 4, 7 }) {
+                  for (int voices : { 32, 128, 512 }) {
+                        QByteArray name = QString("%1 %2 taps %3 voices").arg(names[isa]).arg(taps).arg(voices).toLatin1();
+                        QTest::newRow(name.constData()) << DspIsa(isa) << taps << voices;
+                        }
+                  }
+            }
+      }
+
+void TestFluidDsp::voiceThroughput()
+      {
+      QFETCH(DspIsa, isa);
+      QFETCH(int, taps);
+      QFETCH(int, voices);
+      if (!dspIsaSupported(isa))
+            QSKIP("instruction set not supported");
+      DspKernel k = kernel(isa, taps);
+      const float* coeffs = table[taps == 4 ? 1 : 2].data();
+      std::vector<double> phase(voices);
+      std::vector<double> incr(voices);
+      for (int v = 0; v < voices; ++v) {
+            phase[v] = 8.0 + v;
+            incr[v]  = pow(2.0, (v % 48 - 24) / 12.0);
+            }
+      std::vector<float> out(PERIOD);
+      DspBlock block;
+      QBENCHMARK {
+            for (int v = 0; v < voices; ++v) {
+                  for (int i = 0; i < PERIOD; ++i) {
+                        double p = phase[v] + i * incr[v];
+                        block.index[i] = int(p) - 3;
+                        block.row[i]   = int((p - floor(p)) * ROWS) * taps;
+                        block.amp[i]   = 0.25f;
+                        }
+                  phase[v] += PERIOD * incr[v];
+                  if (phase[v] > SAMPLE_SIZE - 512)
+                        phase[v] = 8.0;
+                  k(out.data(), sample.data(), coeffs, block, PERIOD);
+                  }
+            }
+      }
+
+QTEST_MAIN(TestFluidDsp)
+#include "tst_fluiddsp.moc"
+
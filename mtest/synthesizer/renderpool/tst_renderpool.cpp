@@ -0,0 +1,246 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include "mtest/testutils.h"
+#include "synthesizer/event.h"
+#include "synthesizer/renderpool.h"
+#include "fluid/fluid.h"
+
+using namespace Ms;
+
+static const int FRAMES = 64;
+static const int VOICES = 96;
+static const int BUSES  = 12;
+
+//---------------------------------------------------------
+//   Render
+//    stand in for a synthesizer: every bus renders a fixed
+//    slice of "voices" into its own buffer
+//---------------------------------------------------------
+
+struct Render {
+      std::atomic<int> runs[BUSES];
+      float bus[BUSES][FRAMES];
+      double phase[VOICES];
+      int period { 0 };
+
+      Render() {
+            for (int i = 0; i < VOICES; ++i)
+                  phase[i] = 0.0;
+            }
+      static void renderBus(void* context, int idx);
+      void process(RenderPool* pool, float* out);
+      };
+
+void Render::renderBus(void* context, int idx)
+      {
+      Render* r = static_cast<Render*>(context);
+      ++r->runs[idx];
+      memset(r->bus[idx], 0, sizeof(r->bus[idx]));
+      for (int v = idx * VOICES / BUSES; v < (idx + 1) * VOICES / BUSES; ++v) {
+            double inc = 0.01 + v * 0.001;
+            for (int i = 0; i < FRAMES; ++i) {
+                  r->bus[idx][i] += float(sin(r->phase[v]) / VOICES);
+                  r->phase[v] += inc;
+                  }
+            }
+      }
+
+void Render::process(RenderPool* pool, float* out)
+      {
+      for (int i = 0; i < BUSES; ++i)
+            runs[i] = 0;
+      pool->run(BUSES, renderBus, this);
+      memset(out, 0, FRAMES * sizeof(float));
+      for (int idx = 0; idx < BUSES; ++idx)
+            for (int i = 0; i < FRAMES; ++i)
+                  out[i] += bus[idx][i];
+      ++period;
+      }
+
+//---------------------------------------------------------
+//   TestRenderPool
+//---------------------------------------------------------
+
+class TestRenderPool : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      void render(int threads, int periods, std::vector<float>* out, bool* once);
+      void renderFluid(int threads, std::vector<float>* out, int* maxVoices);
+
+   private slots:
+      void initTestCase();
+      void everyTaskOnce();
+      void deterministic();
+      void fluidDeterministic();
+      void stress();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestRenderPool::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   render
+//---------------------------------------------------------
+
+void TestRenderPool::render(int threads, int periods, std::vector<float>* out, bool* once)
+      {
+      RenderPool pool(threads);
+      Render r;
+      out->resize(periods * FRAMES);
+      *once = true;
+      for (int p = 0; p < periods; ++p) {
+            r.process(&pool, out->data() + p * FRAMES);
+            for (int i = 0; i < BUSES; ++i)
+                  *once = *once && r.runs[i] == 1;
+            }
+      }
+
+//---------------------------------------------------------
+//   everyTaskOnce
+//---------------------------------------------------------
+
+void TestRenderPool::everyTaskOnce()
+      {
+      std::vector<float> out;
+      bool once;
+      render(3, 2000, &out, &once);
+      QVERIFY(once);
+      }
+
+//---------------------------------------------------------
+//   deterministic
+//    output does not depend on the number of workers
+//---------------------------------------------------------
+
+void TestRenderPool::deterministic()
+      {
+      std::vector<float> ref;
+      bool once;
+      render(0, 500, &ref, &once);
+      QVERIFY(once);
+      for (int threads = 1; threads <= 4; ++threads) {
+            std::vector<float> out;
+            render(threads, 500, &out, &once);
+            QVERIFY(once);
+            QVERIFY(out == ref);
+            }
+      }
+
+//---------------------------------------------------------
+//   renderFluid
+//    chords on eight channels of the default sound font,
+//    released while later ones still sound, so voices end
+//    in the middle of a parallel run. out holds the out,
+//    reverb and chorus buffers of every period.
+//---------------------------------------------------------
+
+static const int FLUID_PERIODS = 1500;
+static const int FLUID_CHORDS  = 120;       // one every 10 periods, held for 25
+
+void TestRenderPool::renderFluid(int threads, std::vector<float>* out, int* maxVoices)
+      {
+      RenderPool pool(threads);
+      FluidS::Fluid fluid;
+      fluid.init(44100);
+      QVERIFY(fluid.addSoundFont(TESTROOT "/share/sound/FluidR3Mono_GM.sf3"));
+      fluid.setOffline(true);             // load every sample at its note on
+      fluid.setRenderPool(&pool);
+
+      static const int programs[8] = { 0, 19, 24, 40, 48, 56, 73, 80 };
+      for (int ch = 0; ch < 8; ++ch)
+            fluid.play(PlayEvent(ME_CONTROLLER, ch, CTRL_PROGRAM, programs[ch]));
+
+      auto chord = [&fluid](int idx, int velo) {
+            for (int ch = 0; ch < 8; ++ch) {
+                  for (int k = 0; k < 3; ++k)
+                        fluid.play(PlayEvent(ME_NOTEON, ch, 48 + ch * 3 + k * 4 + idx % 12, velo));
+                  }
+            };
+
+      out->assign(FLUID_PERIODS * FRAMES * 6, 0.0f);
+      *maxVoices = 0;
+      for (int p = 0; p < FLUID_PERIODS; ++p) {
+            if (p % 10 == 0 && p / 10 < FLUID_CHORDS)
+                  chord(p / 10, 100);
+            if (p % 10 == 5 && p >= 25 && (p - 25) / 10 < FLUID_CHORDS)
+                  chord((p - 25) / 10, 0);
+            *maxVoices = qMax(*maxVoices, fluid.voiceCount());
+            float* o = out->data() + p * FRAMES * 6;
+            fluid.process(FRAMES, o, o + FRAMES * 2, o + FRAMES * 4);
+            }
+      fluid.setRenderPool(0);
+      }
+
+//---------------------------------------------------------
+//   fluidDeterministic
+//    Fluid through processParallel() gives the same bits
+//    whether the audio thread renders all buses alone or
+//    with up to four workers
+//---------------------------------------------------------
+
+void TestRenderPool::fluidDeterministic()
+      {
+      std::vector<float> ref;
+      int maxVoices = 0;
+      renderFluid(0, &ref, &maxVoices);
+      QVERIFY(maxVoices >= 4 * 8);              // several buses
+      QVERIFY(std::any_of(ref.begin(), ref.end(), [](float v) { return v != 0.0f; }));
+      for (int threads = 1; threads <= 4; ++threads) {
+            std::vector<float> out;
+            renderFluid(threads, &out, &maxVoices);
+            QVERIFY(out == ref);
+            }
+      }
+
+//---------------------------------------------------------
+//   stress
+//    many short runs of a varying number of tasks with idle
+//    gaps so workers go to sleep and wake up late
+//---------------------------------------------------------
+
+static std::atomic<int> hits[RenderPool::MAX_TASKS];
+
+static void countTask(void*, int task)
+      {
+      ++hits[task];
+      }
+
+void TestRenderPool::stress()
+      {
+      RenderPool pool(QThread::idealThreadCount());
+      for (int run = 0; run < 20000; ++run) {
+            int tasks = 2 + run % 40;
+            for (int i = 0; i < tasks; ++i)
+                  hits[i] = 0;
+            pool.run(tasks, countTask, 0);
+            for (int i = 0; i < tasks; ++i)
+                  QCOMPARE(int(hits[i]), 1);
+            if (run % 5000 == 0)
+                  QThread::msleep(20);
+            }
+      }
+
+QTEST_MAIN(TestRenderPool)
+#include "tst_renderpool.moc"
+
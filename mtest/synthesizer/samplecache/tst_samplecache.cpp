@@ -0,0 +1,167 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "fluid/samplecache.h"
+
+using namespace Ms;
+using namespace FluidS;
+
+static const QString FILE_A("a.sf3");
+static const QString FILE_B("b.sf3");
+
+//---------------------------------------------------------
+//   sample
+//    a decoded sample of n frames
+//---------------------------------------------------------
+
+static DecodedSamplePtr sample(int n)
+      {
+      DecodedSample* ds = new DecodedSample;
+      ds->data.resize(n);
+      ds->end   = n - 1;
+      ds->valid = true;
+      return DecodedSamplePtr(ds);
+      }
+
+//---------------------------------------------------------
+//   TestSampleCache
+//---------------------------------------------------------
+
+class TestSampleCache : public QObject, public MTest
+      {
+      Q_OBJECT
+
+   private slots:
+      void initTestCase()     { initMTest(); }
+      void sharedLookup();
+      void lruEviction();
+      void inUseNotEvicted();
+      void budget();
+      void sampleFile();
+      };
+
+//---------------------------------------------------------
+//   sharedLookup
+//    the same file and position give the same data, a
+//    second insert of it returns the first one
+//---------------------------------------------------------
+
+void TestSampleCache::sharedLookup()
+      {
+      SampleCache cache;
+      QVERIFY(!cache.find(FILE_A, 100));
+      DecodedSamplePtr s = sample(64);
+      QCOMPARE(cache.insert(FILE_A, 100, s), s);
+      QCOMPARE(cache.find(FILE_A, 100), s);
+      QVERIFY(!cache.find(FILE_A, 101));
+      QVERIFY(!cache.find(FILE_B, 100));
+      QCOMPARE(cache.insert(FILE_A, 100, sample(64)), s);
+      QCOMPARE(cache.size(), s->bytes());
+      }
+
+//---------------------------------------------------------
+//   lruEviction
+//    the least recently used sample is dropped first
+//---------------------------------------------------------
+
+void TestSampleCache::lruEviction()
+      {
+      SampleCache cache;
+      cache.setBudget(3 * 200);
+      cache.insert(FILE_A, 1, sample(100));
+      cache.insert(FILE_A, 2, sample(100));
+      cache.insert(FILE_A, 3, sample(100));
+      QCOMPARE(cache.size(), qint64(600));
+      QVERIFY(cache.find(FILE_A, 1));           // 2 is now the least recently used
+      cache.insert(FILE_A, 4, sample(100));
+      QCOMPARE(cache.size(), qint64(600));
+      QVERIFY(!cache.find(FILE_A, 2));
+      QVERIFY(cache.find(FILE_A, 1));
+      QVERIFY(cache.find(FILE_A, 3));
+      QVERIFY(cache.find(FILE_A, 4));
+      }
+
+//---------------------------------------------------------
+//   inUseNotEvicted
+//    samples referenced outside of the cache stay, even
+//    beyond the budget, and do not count as unused
+//---------------------------------------------------------
+
+void TestSampleCache::inUseNotEvicted()
+      {
+      SampleCache cache;
+      cache.setBudget(200);
+      DecodedSamplePtr a = cache.insert(FILE_A, 1, sample(100));
+      DecodedSamplePtr b = cache.insert(FILE_A, 2, sample(100));
+      QCOMPARE(cache.size(), qint64(400));
+      QCOMPARE(cache.unusedSize(), qint64(0));
+      QCOMPARE(cache.find(FILE_A, 1), a);
+      a.reset();
+      QCOMPARE(cache.unusedSize(), qint64(200));
+      cache.trim();
+      QCOMPARE(cache.unusedSize(), qint64(0));
+      QCOMPARE(cache.size(), qint64(200));
+      QVERIFY(!cache.find(FILE_A, 1));
+      QCOMPARE(cache.find(FILE_A, 2), b);
+      cache.clear();
+      QCOMPARE(cache.size(), qint64(200));
+      b.reset();
+      cache.clear();
+      QCOMPARE(cache.size(), qint64(0));
+      QCOMPARE(cache.budget(), qint64(200));
+      }
+
+//---------------------------------------------------------
+//   budget
+//    lowering the budget evicts at once
+//---------------------------------------------------------
+
+void TestSampleCache::budget()
+      {
+      SampleCache cache;
+      for (unsigned i = 0; i < 10; ++i)
+            cache.insert(FILE_B, i, sample(500));
+      QCOMPARE(cache.size(), qint64(10 * 1000));
+      cache.setBudget(2500);
+      QCOMPARE(cache.size(), qint64(2000));
+      QVERIFY(cache.find(FILE_B, 9));
+      QVERIFY(cache.find(FILE_B, 8));
+      QVERIFY(!cache.find(FILE_B, 7));
+      }
+
+//---------------------------------------------------------
+//   sampleFile
+//    all users of a file share one mapping
+//---------------------------------------------------------
+
+void TestSampleCache::sampleFile()
+      {
+      QTemporaryFile tmp;
+      QVERIFY(tmp.open());
+      QByteArray content(4096, 'x');
+      tmp.write(content);
+      tmp.flush();
+
+      QSharedPointer<SampleFile> f1 = SampleFile::open(tmp.fileName());
+      QSharedPointer<SampleFile> f2 = SampleFile::open(tmp.fileName());
+      QVERIFY(f1);
+      QCOMPARE(f1, f2);
+      QCOMPARE(f1->size(), qint64(content.size()));
+      QVERIFY(memcmp(f1->data(), content.constData(), content.size()) == 0);
+      QVERIFY(!SampleFile::open(tmp.fileName() + ".missing"));
+      }
+
+QTEST_MAIN(TestSampleCache)
+#include "tst_samplecache.moc"
+
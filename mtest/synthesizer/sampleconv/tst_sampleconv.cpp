@@ -0,0 +1,163 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "synthesizer/sampleconv.h"
+
+using namespace Ms;
+
+Q_DECLARE_METATYPE(Ms::SampleFormat)
+
+//---------------------------------------------------------
+//   TestSampleConv
+//---------------------------------------------------------
+
+class TestSampleConv : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      void formatData();
+
+   private slots:
+      void initTestCase();
+      void bitExact_data()          { formatData(); }
+      void bitExact();
+      void clipping_data()          { formatData(); }
+      void clipping();
+      void periodThroughput_data();
+      void periodThroughput();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestSampleConv::initTestCase()
+      {
+      initMTest();
+      qsrand(4711);
+      }
+
+void TestSampleConv::formatData()
+      {
+      QTest::addColumn<SampleFormat>("format");
+      QTest::newRow("s16") << SampleFormat::S16_LE;
+      QTest::newRow("s24") << SampleFormat::S24_3LE;
+      QTest::newRow("s32") << SampleFormat::S32_LE;
+      }
+
+//---------------------------------------------------------
+//   bitExact
+//    contiguous and interleaved input of all lengths
+//    converts to the same bytes as the scalar code; the
+//    input has exactly the size of the samples read, so a
+//    build with address sanitizer catches reads beyond
+//---------------------------------------------------------
+
+void TestSampleConv::bitExact()
+      {
+      QFETCH(SampleFormat, format);
+      const int bytes = sampleBytes(format);
+      for (int n = 0; n < 200; ++n) {
+            for (int srcStep = 1; srcStep <= 2; ++srcStep) {
+                  std::vector<float> src(n * srcStep);
+                  for (float& s : src)
+                        s = float(qrand()) / RAND_MAX * 2.5f - 1.25f;
+                  for (int channel = 0; channel < srcStep; ++channel) {
+                        std::vector<char> out(n * bytes + 1, 0x55);
+                        std::vector<char> ref(n * bytes + 1, 0x55);
+                        char* e1 = convertSamples(format, src.data() + channel, srcStep, out.data(), bytes, n);
+                        char* e2 = convertSamplesScalar(format, src.data() + channel, srcStep, ref.data(), bytes, n);
+                        QCOMPARE(int(e1 - out.data()), n * bytes);
+                        QCOMPARE(int(e2 - ref.data()), n * bytes);
+                        QVERIFY(out == ref);
+                        }
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   clipping
+//    full scale and beyond gives the largest values of
+//    the format, symmetric around zero
+//---------------------------------------------------------
+
+void TestSampleConv::clipping()
+      {
+      QFETCH(SampleFormat, format);
+      const int bytes = sampleBytes(format);
+      const float src[8] = { 1.0f, -1.0f, 2.0f, -2.0f, 0.0f, 1e10f, -1e10f, 0.5f };
+      char out[8 * 4];
+      convertSamples(format, src, 1, out, bytes, 8);
+      // S32 has 24 bit resolution
+      const int full = format == SampleFormat::S16_LE ? 0x7fff : 0x7fffff;
+      const int shift = format == SampleFormat::S32_LE ? 8 : 0;
+      for (int i = 0; i < 8; ++i) {
+            const uchar* p = reinterpret_cast<const uchar*>(out + i * bytes);
+            unsigned u = 0;
+            for (int k = bytes - 1; k >= 0; --k)
+                  u = (u << 8) | p[k];
+            int v = int(u << (4 - bytes) * 8) >> (4 - bytes) * 8;      // sign extend
+            int expected = src[i] >= 1.0f ? full : (src[i] <= -1.0f ? -full : int(src[i] * full));
+            QCOMPARE(v, expected * (1 << shift));
+            }
+      }
+
+//---------------------------------------------------------
+//   periodThroughput
+//    convert one interleaved stereo period into contiguous
+//    and into channel separated device buffers
+//---------------------------------------------------------
+
+void TestSampleConv::periodThroughput_data()
+      {
+      QTest::addColumn<SampleFormat>("format");
+      QTest::addColumn<int>("frames");
+      QTest::addColumn<bool>("interleaved");
+      const char* names[3] = { "s16", "s24", "s32" };
+      for (int f = 0; f < 3; ++f) {
+            for (int frames : { 64, 128, 1024 }) {
+                  for (bool interleaved : { true, false }) {
+                        QByteArray name = QString("%1 %2 frames %3").arg(names[f]).arg(frames)
+                           .arg(interleaved ? "interleaved" : "non interleaved").toLatin1();
+                        QTest::newRow(name.constData()) << SampleFormat(f) << frames << interleaved;
+                        }
+                  }
+            }
+      }
+
+void TestSampleConv::periodThroughput()
+      {
+      QFETCH(SampleFormat, format);
+      QFETCH(int, frames);
+      QFETCH(bool, interleaved);
+      const int bytes = sampleBytes(format);
+      std::vector<float> src(frames * 2);
+      for (float& s : src)
+            s = float(qrand()) / RAND_MAX * 2.0f - 1.0f;
+      std::vector<char> out(frames * 2 * bytes);
+      QBENCHMARK {
+            for (int i = 0; i < 1000; ++i) {
+                  if (interleaved)
+                        convertSamples(format, src.data(), 1, out.data(), bytes, frames * 2);
+                  else {
+                        convertSamples(format, src.data(), 2, out.data(), bytes, frames);
+                        convertSamples(format, src.data() + 1, 2, out.data() + frames * bytes, bytes, frames);
+                        }
+                  }
+            }
+      }
+
+QTEST_MAIN(TestSampleConv)
+#include "tst_sampleconv.moc"
+
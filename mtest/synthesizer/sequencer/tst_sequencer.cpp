@@ -0,0 +1,262 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/instrument.h"
+#include "libmscore/tempo.h"
+#include "synthesizer/event.h"
+#include "synthesizer/eventplayer.h"
+#include "fluid/fluid.h"
+
+using namespace Ms;
+
+static const int SAMPLE_RATE   = 44100;
+static const int PERIOD_FRAMES = 64;
+static const int PLAY_SECONDS  = 10;
+
+//---------------------------------------------------------
+//   FluidPlayer
+//    plays the timeline through Fluid the way Seq plays
+//    it through the master synthesizer
+//---------------------------------------------------------
+
+class FluidPlayer : public EventPlayer {
+      FluidS::Fluid* _fluid;
+      float _effect1[PERIOD_FRAMES * 2];
+      float _effect2[PERIOD_FRAMES * 2];
+
+   protected:
+      virtual int eventFrame(const EventTimeline& events, int idx) const override {
+            return events.frame(idx);
+            }
+      virtual int render(int frames, float* buffer) override {
+            _fluid->process(frames, buffer, _effect1, _effect2);
+            return frames;
+            }
+      virtual void dispatch(const EventTimeline& events, int idx, int) override {
+            if (idx != lastIdx + 1)
+                  ++unordered;
+            lastIdx = idx;
+            ++dispatched;
+            const NPlayEvent& event = events.at(idx).second;
+            if (event.type() == ME_NOTEON || event.type() == ME_CONTROLLER || event.type() == ME_PITCHBEND)
+                  _fluid->play(event);
+            }
+
+   public:
+      int dispatched { 0 };
+      int unordered  { 0 };               // events not played right after the one before
+      int lastIdx    { -1 };
+
+      FluidPlayer(FluidS::Fluid* fluid) : _fluid(fluid) {}
+      };
+
+//---------------------------------------------------------
+//   TestSequencer
+//---------------------------------------------------------
+
+class TestSequencer : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      Score* score { 0 };
+      EventMap eventMap;
+      EventTimeline events;
+
+   private slots:
+      void initTestCase();
+      void cleanupTestCase();
+      void frameStamps();
+      void renderEvents();
+      void seekEvents_data();
+      void seekEvents();
+      void iterateEvents_data();
+      void iterateEvents();
+      void playPeriods();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//    the playback events of goldberg with repeats
+//---------------------------------------------------------
+
+void TestSequencer::initTestCase()
+      {
+      initMTest();
+      score = readScore("../demos/goldberg.mscz");
+      QVERIFY(score);
+      score->doLayout();
+      score->renderMidi(&eventMap, true, true);
+      events.assign(eventMap);
+      events.stamp([this](int utick) { return score->utick2utime(utick); }, score->tempomap()->relTempo(), SAMPLE_RATE);
+      }
+
+void TestSequencer::cleanupTestCase()
+      {
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   frameStamps
+//    the stamped frames are the frames Seq::process()
+//    computed for every event
+//---------------------------------------------------------
+
+void TestSequencer::frameStamps()
+      {
+      QVERIFY(events.size() > 10000);
+      QVERIFY(events.stamped(score->tempomap()->relTempo(), SAMPLE_RATE));
+      QVERIFY(!events.stamped(score->tempomap()->relTempo() * 2.0, SAMPLE_RATE));
+      for (int i = 0; i < events.size(); ++i) {
+            QCOMPARE(events.frame(i), int(score->utick2utime(events.at(i).first) * SAMPLE_RATE));
+            if (i)
+                  QVERIFY(events.frame(i) >= events.frame(i - 1));
+            }
+      }
+
+//---------------------------------------------------------
+//   renderEvents
+//    render the playback events and build the timeline
+//    the sequencer plays
+//---------------------------------------------------------
+
+void TestSequencer::renderEvents()
+      {
+      QBENCHMARK {
+            EventMap em;
+            score->renderMidi(&em, true, true);
+            EventTimeline tl;
+            tl.assign(em);
+            }
+      }
+
+//---------------------------------------------------------
+//   seekEvents
+//    look up every 7th tick of the unrolled score in the
+//    event map and in the timeline
+//---------------------------------------------------------
+
+void TestSequencer::seekEvents_data()
+      {
+      QTest::addColumn<bool>("timeline");
+      QTest::newRow("map")      << false;
+      QTest::newRow("timeline") << true;
+      }
+
+void TestSequencer::seekEvents()
+      {
+      QFETCH(bool, timeline);
+      int endTick = eventMap.rbegin()->first;
+      for (int tick = -1; tick <= endTick + 1; tick += 7) {
+            QCOMPARE(int(std::distance(events.cbegin(), events.lower_bound(tick))), int(std::distance(eventMap.cbegin(), eventMap.lower_bound(tick))));
+            QCOMPARE(int(std::distance(events.cbegin(), events.upper_bound(tick))), int(std::distance(eventMap.cbegin(), eventMap.upper_bound(tick))));
+            }
+      int n = 0;
+      QBENCHMARK {
+            for (int tick = 0; tick <= endTick; tick += 7) {
+                  if (timeline)
+                        n += events.lower_bound(tick) != events.cend();
+                  else
+                        n += eventMap.lower_bound(tick) != eventMap.cend();
+                  }
+            }
+      QVERIFY(n > 0);
+      }
+
+//---------------------------------------------------------
+//   iterateEvents
+//    walk all events as the sequencer does when playing
+//---------------------------------------------------------
+
+void TestSequencer::iterateEvents_data()
+      {
+      QTest::addColumn<bool>("timeline");
+      QTest::newRow("map")      << false;
+      QTest::newRow("timeline") << true;
+      }
+
+void TestSequencer::iterateEvents()
+      {
+      QFETCH(bool, timeline);
+      QCOMPARE(events.size(), int(eventMap.size()));
+      int velo = 0;
+      QBENCHMARK {
+            if (timeline) {
+                  for (auto i = events.cbegin(); i != events.cend(); ++i)
+                        velo += i->second.velo();
+                  }
+            else {
+                  for (auto i = eventMap.cbegin(); i != eventMap.cend(); ++i)
+                        velo += i->second.velo();
+                  }
+            }
+      QVERIFY(velo > 0);
+      }
+
+//---------------------------------------------------------
+//   playPeriods
+//    play the start of goldberg through Fluid with the
+//    dispatch loop of the sequencer, pulled by a clock of
+//    64 frame periods like a sound card: no period may
+//    end after the next one is due, and every event is
+//    played once and in order
+//---------------------------------------------------------
+
+void TestSequencer::playPeriods()
+      {
+      FluidS::Fluid fluid;
+      fluid.init(SAMPLE_RATE);
+      QVERIFY(fluid.addSoundFont(TESTROOT "/share/sound/FluidR3Mono_GM.sf3"));
+      for (const MidiMapping& mm : *score->midiMapping())
+            fluid.play(PlayEvent(ME_CONTROLLER, mm.articulation->channel, CTRL_PROGRAM, mm.articulation->program));
+
+      FluidPlayer player(&fluid);
+      std::atomic<int> playIdx { 0 };
+      int playFrame = 0;
+      float buffer[PERIOD_FRAMES * 2];
+      const int periods = PLAY_SECONDS * SAMPLE_RATE / PERIOD_FRAMES;
+      const std::chrono::nanoseconds period(1000000000LL * PERIOD_FRAMES / SAMPLE_RATE);
+      std::chrono::steady_clock::duration longest { 0 };
+      int missed = 0;
+
+      const auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < periods; ++i) {
+            const auto due = start + i * period;
+            std::this_thread::sleep_until(due);
+            const auto begin = std::chrono::steady_clock::now();
+            memset(buffer, 0, sizeof(buffer));
+            QVERIFY(player.playPeriod(events, &playIdx, &playFrame, PERIOD_FRAMES, buffer));
+            const auto end = std::chrono::steady_clock::now();
+            if (end > due + period)
+                  ++missed;
+            longest = std::max(longest, end - begin);
+            }
+
+      QCOMPARE(playFrame, periods * PERIOD_FRAMES);
+      int played = 0;
+      while (played < events.size() && events.frame(played) < playFrame)
+            ++played;
+      QVERIFY(played > 0);
+      QCOMPARE(playIdx.load(), played);
+      QCOMPARE(player.dispatched, played);
+      QCOMPARE(player.unordered, 0);
+      QVERIFY2(missed == 0, qPrintable(QString("%1 of %2 periods missed their deadline, longest period %3 us")
+         .arg(missed).arg(periods).arg(std::chrono::duration_cast<std::chrono::microseconds>(longest).count())));
+      }
+
+QTEST_MAIN(TestSequencer)
+#include "tst_sequencer.moc"
@@ -0,0 +1,217 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+
+#include "mtest/testutils.h"
+
+#include "zerberus/instrument.h"
+#include "zerberus/zerberus.h"
+#include "zerberus/zone.h"
+#include "mscore/preferences.h"
+#include "synthesizer/event.h"
+
+using namespace Ms;
+
+static const int PERIOD = 64;
+
+//---------------------------------------------------------
+//   TestZoneLookup
+//---------------------------------------------------------
+
+class TestZoneLookup : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      QTemporaryDir dir;
+      Zerberus* piano;
+
+      void writeSfz(const QString& name, const QString& content);
+
+   private slots:
+      void initTestCase();
+      void cleanupTestCase()  { delete piano; }
+      void zoneIndex();
+      void roundRobin();
+      void offBy();
+      void denseChords();
+      };
+
+//---------------------------------------------------------
+//   writeSfz
+//---------------------------------------------------------
+
+void TestZoneLookup::writeSfz(const QString& name, const QString& content)
+      {
+      QFile f(dir.path() + "/" + name);
+      QVERIFY(f.open(QIODevice::WriteOnly));
+      f.write(content.toLatin1());
+      }
+
+//---------------------------------------------------------
+//   initTestCase
+//    a piano like instrument with 88 keys, 8 velocity
+//    layers, two round robin samples, release samples
+//    and pedal noise on controller 64
+//---------------------------------------------------------
+
+void TestZoneLookup::initTestCase()
+      {
+      initMTest();
+      QVERIFY(dir.isValid());
+      QVERIFY(QFile::copy(root + "/zerberus/sample.wav", dir.path() + "/sample.wav"));
+
+      QString sfz;
+      for (int key = 21; key <= 108; ++key) {
+            for (int layer = 0; layer < 8; ++layer) {
+                  for (int rr = 1; rr <= 2; ++rr) {
+                        sfz += QString("<region> lokey=%1 hikey=%1 pitch_keycenter=%1 lovel=%2 hivel=%3 seq_length=2 seq_position=%4 sample=sample.wav\n")
+                           .arg(key).arg(layer * 16).arg(layer * 16 + 15).arg(rr);
+                        }
+                  }
+            }
+      for (int key = 21; key <= 108; key += 12)
+            sfz += QString("<region> trigger=release lokey=%1 hikey=%2 sample=sample.wav\n").arg(key).arg(key + 11);
+      sfz += "<region> on_locc64=64 on_hicc64=127 sample=sample.wav\n";
+      sfz += "<region> on_locc64=0 on_hicc64=63 sample=sample.wav\n";
+      writeSfz("zonelookup.sfz", sfz);
+
+      writeSfz("offby.sfz",
+         "<region> key=42 group=1 sample=sample.wav\n"
+         "<region> key=44 group=1 sample=sample.wav\n"
+         "<region> key=46 group=2 off_by=1 loop_mode=loop_continuous sample=sample.wav\n");
+
+      Ms::preferences.mySoundfontsPath += ";" + dir.path();
+      piano = new Zerberus();
+      piano->init(44100);
+      QVERIFY(piano->loadInstrument("zonelookup.sfz"));
+      }
+
+//---------------------------------------------------------
+//   zoneIndex
+//    the index gives the zones passing the key, velocity
+//    and trigger checks of Zone::match(), in order
+//---------------------------------------------------------
+
+void TestZoneLookup::zoneIndex()
+      {
+      ZInstrument* i = piano->instrument(0);
+      QCOMPARE(i->zones().size(), (unsigned long) (88 * 8 * 2 + 8 + 2));
+      for (Trigger t : { Trigger::ATTACK, Trigger::RELEASE }) {
+            for (int key = 0; key < 128; ++key) {
+                  for (int velo = 0; velo < 128; ++velo) {
+                        std::vector<Zone*> expected;
+                        for (Zone* z : i->zones()) {
+                              if (z->trigger == t && key >= z->keyLo && key <= z->keyHi && velo >= z->veloLo && velo <= z->veloHi)
+                                    expected.push_back(z);
+                              }
+                        QVERIFY(i->zones(t, key, velo, -1) == expected);
+                        }
+                  }
+            }
+      QCOMPARE(i->zones(Trigger::ATTACK, 60, 100, -1).size(), size_t(2));
+      QCOMPARE(i->zones(Trigger::RELEASE, 60, 100, -1).size(), size_t(1));
+      QCOMPARE(i->zones(Trigger::CC, -1, -1, 64).size(), size_t(2));
+      QVERIFY(i->zones(Trigger::CC, -1, -1, 7).empty());
+      }
+
+//---------------------------------------------------------
+//   roundRobin
+//    of the two samples of a layer exactly one plays
+//    for every note on
+//---------------------------------------------------------
+
+void TestZoneLookup::roundRobin()
+      {
+      float data[PERIOD * 2];
+      for (int n = 0; n < 4; ++n) {
+            piano->play(PlayEvent(ME_NOTEON, 0, 60, 100));
+            int count = 0;
+            for (Voice* v = piano->getActiveVoices(); v; v = v->next())
+                  count += (v->key() == 60 && v->isPlaying()) ? 1 : 0;
+            QCOMPARE(count, 1);
+            piano->allNotesOff(-1);
+            for (int k = 0; k < 200; ++k)
+                  piano->process(PERIOD, data, nullptr, nullptr);
+            QVERIFY(!piano->getActiveVoices());
+            }
+      }
+
+//---------------------------------------------------------
+//   offBy
+//    a note of group 1 stops the playing voices with
+//    off_by=1, and only those
+//---------------------------------------------------------
+
+void TestZoneLookup::offBy()
+      {
+      Zerberus* synth = new Zerberus();
+      synth->init(44100);
+      QVERIFY(synth->loadInstrument("offby.sfz"));
+      float data[PERIOD * 2];
+
+      for (int n = 0; n < 3; ++n) {
+            synth->play(PlayEvent(ME_NOTEON, 0, 46, 100));
+            synth->play(PlayEvent(ME_NOTEON, 0, 42, 100));
+            for (Voice* v = synth->getActiveVoices(); v; v = v->next()) {
+                  if (v->key() == 46)
+                        QVERIFY(v->isStopped());
+                  else
+                        QVERIFY(!v->isStopped());
+                  }
+            // let the choked voices end so they leave the group list
+            for (int k = 0; k < 100; ++k)
+                  synth->process(PERIOD, data, nullptr, nullptr);
+            synth->play(PlayEvent(ME_NOTEON, 0, 46, 100));
+            synth->play(PlayEvent(ME_NOTEON, 0, 44, 100));
+            for (Voice* v = synth->getActiveVoices(); v; v = v->next()) {
+                  if (v->key() == 46)
+                        QVERIFY(v->isStopped());
+                  }
+            synth->allNotesOff(-1);
+            for (int k = 0; k < 200; ++k)
+                  synth->process(PERIOD, data, nullptr, nullptr);
+            QVERIFY(!synth->getActiveVoices());
+            }
+      delete synth;
+      }
+
+//---------------------------------------------------------
+//   denseChords
+//    ten note chords at changing velocities with one
+//    period rendered per chord
+//---------------------------------------------------------
+
+void TestZoneLookup::denseChords()
+      {
+      static const int chord[10] = { 36, 43, 48, 52, 55, 60, 64, 67, 72, 76 };
+      std::vector<float> data(PERIOD * 2);
+      int velo = 1;
+      QBENCHMARK {
+            for (int n = 0; n < 16; ++n) {
+                  for (int key : chord)
+                        piano->play(PlayEvent(ME_NOTEON, 0, key + n % 12, velo));
+                  piano->process(PERIOD, data.data(), nullptr, nullptr);
+                  for (int key : chord)
+                        piano->play(PlayEvent(ME_NOTEOFF, 0, key + n % 12, 0));
+                  piano->process(PERIOD, data.data(), nullptr, nullptr);
+                  velo = velo % 127 + 1;
+                  }
+            piano->allNotesOff(-1);
+            for (int k = 0; k < 40; ++k)
+                  piano->process(PERIOD, data.data(), nullptr, nullptr);
+            }
+      }
+
+QTEST_MAIN(TestZoneLookup)
+#include "tst_zonelookup.moc"
+
@@ -175,8 +175,8 @@ void Omr::process()
 
       int pages = 0;
       int n = _pages.size();
+      QtConcurrent::blockingMap(_pages, [](OmrPage* page) { page->read(); });
       for (int i = 0; i < n; ++i) {
-            _pages[i]->read();
             if (_pages[i]->systems().size() > 0) {
                   sp += _pages[i]->spatium();
                   ++pages;
@@ -197,12 +197,19 @@ void Omr::process()
       trebleclefPattern = new Pattern(trebleclefSym, &symbols[0][trebleclefSym],  _spatium);
       bassclefPattern   = new Pattern(bassclefSym, &symbols[0][bassclefSym],  _spatium);
 
-      for (int i = 0; i < n; ++i) {
-            OmrPage* page = _pages[i];
-            if (!page->systems().isEmpty()) {
-                  page->readBarLines(i);
-                  }
+      //
+      // the first page is done here as searching its clefs and
+      // time signature creates patterns, which needs fonts
+      //
+      QList<int> pageNumbers;
+      for (int i = 1; i < n; ++i) {
+            if (!_pages[i]->systems().isEmpty())
+                  pageNumbers.append(i);
             }
+      QFuture<void> bl = QtConcurrent::map(pageNumbers, [this](int i) { _pages[i]->readBarLines(i); });
+      if (n && !_pages[0]->systems().isEmpty())
+            _pages[0]->readBarLines(0);
+      bl.waitForFinished();
       }
 
 //---------------------------------------------------------
@@ -252,7 +252,7 @@ OmrPattern OmrPage::searchPattern(const std::vector<Pattern*>& pl, int y, int x1
             int hw = pattern->w();
 
             for (int x = x1; x < (x2 - hw); ++x) {
-                  double val1 = pattern->match(&image(), x - pattern->base().x(), y - pattern->base().y());
+                  double val1 = pattern->match(&image(), x - pattern->base().x(), y - pattern->base().y(), val);
                   if (val1 > val) {
                         val = val1;
                         xx  = x;
@@ -306,7 +306,7 @@ OmrTimesig* OmrPage::searchTimeSig(OmrSystem* system)
             QRect r;
 
             for (int x = x1; x < x2; ++x) {
-                  double val1 = pattern->match(&image(), x, y);
+                  double val1 = pattern->match(&image(), x, y, val);
                   if (val1 > val) {
                         val = val1;
                         r = QRect(x, y, hw, hh);
@@ -336,7 +336,7 @@ OmrTimesig* OmrPage::searchTimeSig(OmrSystem* system)
             QRect r;
 
             for (int x = x1; x < x2; ++x) {
-                  double val1 = pattern->match(&image(), x, y);
+                  double val1 = pattern->match(&image(), x, y, val);
                   if (val1 > val) {
                         val = val1;
                         r   = QRect(x, y, hw, hh);
@@ -383,7 +383,7 @@ void OmrPage::searchKeySig(OmrSystem* system, OmrStaff* staff)
             QRect r;
 
             for (int x = x1; x < x2; ++x) {
-                  double val1 = pattern->match(&image(), x, y - hh/2);
+                  double val1 = pattern->match(&image(), x, y - hh/2, val);
                   if (val1 > val) {
                         val = val1;
                         r = QRect(x, y, hw, hh);
@@ -1076,7 +1076,7 @@ void OmrSystem::searchNotes(QList<OmrNote*>* noteList, int x1, int x2, int y, in
             double val;
 
             for (int x = x1; x < (x2 - hw); ++x) {
-                  double val1 = pattern->match(&_page->image(), x, y - hh/2);
+                  double val1 = pattern->match(&_page->image(), x, y - hh/2, noteTH);
                   if (val1 >= noteTH) {
                         if (!found || (val1 > val)) {
                               xx1 = x;
@@ -54,25 +54,61 @@ double Pattern::match(const Pattern* a) const
       int k = 0;
       const uchar* p1 = image()->bits();
       const uchar* p2 = a->image()->bits();
-      for (int i = 0; i < n; ++i) {
-            uchar v = (*(p1++)) ^ (*(p2++));
+      int i = 0;
+      for (; i + 8 <= n; i += 8) {
+            quint64 v1, v2;
+            memcpy(&v1, p1 + i, 8);
+            memcpy(&v2, p2 + i, 8);
+            k += qPopulationCount(v1 ^ v2);
+            }
+      for (; i < n; ++i) {
+            uchar v = p1[i] ^ p2[i];
             k += Omr::bitsSetTable[v];
             }
       return 1.0 - (double(k) / (h() * w()));
       }
 
-double Pattern::match(const QImage* img, int col, int row) const
+//---------------------------------------------------------
+//   match
+//    compare the pattern with the image at col, row.
+//    Eight bytes of a row are compared at once: the image
+//    bytes are shifted in all eight lanes of a 64 bit word,
+//    the masks drop the bits shifted in from neighbour
+//    bytes, so every lane gets the same value as the byte
+//    wise comparison.
+//    The comparison stops after a row if the result is
+//    known to be less than bound; the (partial) result
+//    returned then is less than bound too.
+//---------------------------------------------------------
+
+double Pattern::match(const QImage* img, int col, int row, double bound) const
       {
       int rows      = h();
       int bytes     = ((w() + 7) / 8) - 1;
+      int words     = bytes / 8;
       int shift     = col & 7;
       int k         = 0;
       int eshift    = (col + w()) & 7;
+      double n      = h() * w();
+
+      const quint64 lanes = Q_UINT64_C(0x0101010101010101);
+      const quint64 lmask = lanes * uchar(0xff >> shift);
+      const quint64 hmask = lanes * uchar(0xff << (7 - shift));
 
       for (int y = 0; y < rows; ++y) {
             const uchar* p1 = image()->scanLine(y);
             const uchar* p2 = img->scanLine(row + y) + (col/8);
-            for (int x = 0; x < bytes; ++x) {
+            for (int x = 0; x < words; ++x) {
+                  quint64 a, b1, b2;
+                  memcpy(&a,  p1, 8);
+                  memcpy(&b1, p2, 8);
+                  memcpy(&b2, p2 + 1, 8);
+                  quint64 b = ((b1 >> shift) & lmask) | ((b2 << (7 - shift)) & hmask);
+                  k += qPopulationCount(a ^ b);
+                  p1 += 8;
+                  p2 += 8;
+                  }
+            for (int x = words * 8; x < bytes; ++x) {
                   uchar a = *p1++;
                   uchar b1 = *p2;
                   uchar b2 = *(p2 + 1);
@@ -87,8 +123,10 @@ double Pattern::match(const QImage* img, int col, int row) const
             uchar b  = (b1 >> shift) | (b2 << (7 - shift));
             uchar v = a ^ b;
             k += Omr::bitsSetTable[v];
+            if (1.0 - (double(k) / n) < bound)
+                  break;
             }
-      return 1.0 - (double(k) / (h() * w()));
+      return 1.0 - (double(k) / n);
       }
 
 //---------------------------------------------------------
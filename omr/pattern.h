@@ -44,7 +44,7 @@ class Pattern {
       Pattern(QImage*, int, int, int, int);
 
       double match(const Pattern*) const;
-      double match(const QImage* img, int col, int row) const;
+      double match(const QImage* img, int col, int row, double bound = -std::numeric_limits<double>::max()) const;
 
       void dump() const;
       const QImage* image() const { return &_image; }
@@ -417,4 +417,138 @@ void EventMap::fixupMIDI()
             free((void *)info);
       }
 
+//---------------------------------------------------------
+//   EventTimeline::assign
+//---------------------------------------------------------
+
+void EventTimeline::assign(const EventMap& events)
+      {
+      _events.assign(events.begin(), events.end());
+      _frames.clear();
+      _sampleRate = 0;
+
+      _index.clear();
+      if (!_events.empty() && _events.back().first >= 0) {
+            _index.resize((_events.back().first >> INDEX_SHIFT) + 1);
+            size_t i = 0;
+            for (size_t bucket = 0; bucket < _index.size(); ++bucket) {
+                  int tick = int(bucket << INDEX_SHIFT);
+                  while (i < _events.size() && _events[i].first < tick)
+                        ++i;
+                  _index[bucket] = int(i);
+                  }
+            }
+
+      _noteOnTicks.clear();
+      for (const value_type& e : _events) {
+            if (e.second.type() != ME_NOTEON || !e.second.velo())
+                  continue;
+            if (_noteOnTicks.empty() || _noteOnTicks.back() != e.first)
+                  _noteOnTicks.push_back(e.first);
+            }
+      }
+
+//---------------------------------------------------------
+//   EventTimeline::clear
+//---------------------------------------------------------
+
+void EventTimeline::clear()
+      {
+      _events.clear();
+      _index.clear();
+      _noteOnTicks.clear();
+      _frames.clear();
+      _sampleRate = 0;
+      }
+
+//---------------------------------------------------------
+//   EventTimeline::swap
+//---------------------------------------------------------
+
+void EventTimeline::swap(EventTimeline& tl)
+      {
+      _events.swap(tl._events);
+      _index.swap(tl._index);
+      _noteOnTicks.swap(tl._noteOnTicks);
+      _frames.swap(tl._frames);
+      std::swap(_relTempo, tl._relTempo);
+      std::swap(_sampleRate, tl._sampleRate);
+      }
+
+//---------------------------------------------------------
+//   EventTimeline::stamp
+//    compute the frame of every event from its time in
+//    seconds; relTempo is the relative tempo tick2time()
+//    uses
+//---------------------------------------------------------
+
+void EventTimeline::stamp(const std::function<qreal(int)>& tick2time, qreal relTempo, int sampleRate)
+      {
+      _frames.resize(_events.size());
+      int frame = 0;
+      for (size_t i = 0; i < _events.size(); ++i) {
+            if (i == 0 || _events[i].first != _events[i-1].first)
+                  frame = tick2time(_events[i].first) * sampleRate;
+            _frames[i] = frame;
+            }
+      _relTempo   = relTempo;
+      _sampleRate = sampleRate;
+      }
+
+//---------------------------------------------------------
+//   EventTimeline::lower_bound
+//    the first event at or after tick
+//---------------------------------------------------------
+
+EventTimeline::const_iterator EventTimeline::lower_bound(int tick) const
+      {
+      auto tickLess = [](const value_type& e, int t) { return e.first < t; };
+      if (_events.empty() || tick <= _events.front().first)
+            return _events.cbegin();
+      if (tick > _events.back().first)
+            return _events.cend();
+      if (tick <= 0 || _index.empty())
+            return std::lower_bound(_events.cbegin(), _events.cend(), tick, tickLess);
+      size_t bucket = size_t(tick >> INDEX_SHIFT);
+      auto first = _events.cbegin() + _index[bucket];
+      auto last  = bucket + 1 < _index.size() ? _events.cbegin() + _index[bucket + 1] : _events.cend();
+      return std::lower_bound(first, last, tick, tickLess);
+      }
+
+//---------------------------------------------------------
+//   EventTimeline::upper_bound
+//    the first event after tick
+//---------------------------------------------------------
+
+EventTimeline::const_iterator EventTimeline::upper_bound(int tick) const
+      {
+      if (_events.empty() || tick >= _events.back().first)
+            return _events.cend();
+      return lower_bound(tick + 1);
+      }
+
+//---------------------------------------------------------
+//   EventTimeline::nextNoteOn
+//    the tick of the first note on after tick, -1 if
+//    there is none
+//---------------------------------------------------------
+
+int EventTimeline::nextNoteOn(int tick) const
+      {
+      auto i = std::upper_bound(_noteOnTicks.begin(), _noteOnTicks.end(), tick);
+      return i == _noteOnTicks.end() ? -1 : *i;
+      }
+
+//---------------------------------------------------------
+//   EventTimeline::prevNoteOn
+//    the tick of the last note on before tick, -1 if
+//    there is none
+//---------------------------------------------------------
+
+int EventTimeline::prevNoteOn(int tick) const
+      {
+      auto i = std::lower_bound(_noteOnTicks.begin(), _noteOnTicks.end(), tick);
+      return i == _noteOnTicks.begin() ? -1 : *(i - 1);
+      }
+
 }
@@ -13,7 +13,9 @@
 #ifndef __EVENT_H__
 #define __EVENT_H__
 
+#include <functional>
 #include <map>
+#include <vector>
 
 namespace Ms {
 
@@ -324,6 +326,59 @@ class EventMap : public std::multimap<int, NPlayEvent> {
    public:
       void fixupMIDI();
       void registerChannel(int c) { if (c > _highestChannel) _highestChannel = c; }
+      int highestChannel() const  { return _highestChannel; }
+      };
+
+//---------------------------------------------------------
+//   EventTimeline
+//    the events of an EventMap in one sorted array, for
+//    playback. It is built once per rendering and not
+//    changed while it is played, so the audio thread can
+//    read it without locking. Seeking is a binary search
+//    within a bucket of the tick index.
+//
+//    stamp() computes the audio frame of every event, so
+//    the real time thread does not have to convert ticks
+//    while playing.
+//---------------------------------------------------------
+
+class EventTimeline {
+   public:
+      typedef std::pair<int, NPlayEvent> value_type;
+      typedef std::vector<value_type>::const_iterator const_iterator;
+
+   private:
+      static const int INDEX_SHIFT = 11;  // index buckets of 2048 ticks, about one 4/4 measure
+
+      std::vector<value_type> _events;    // in map order
+      std::vector<int> _index;            // _index[i]: first event at or after tick i << INDEX_SHIFT
+      std::vector<int> _noteOnTicks;      // ticks of all note on events, no duplicates
+      std::vector<int> _frames;           // frame of every event, see stamp()
+      qreal _relTempo  { 0.0 };           // relative tempo the frames were computed for
+      int _sampleRate  { 0 };             // 0: not stamped
+
+   public:
+      void assign(const EventMap&);
+      void clear();
+      void swap(EventTimeline&);
+      void stamp(const std::function<qreal(int)>& tick2time, qreal relTempo, int sampleRate);
+      bool stamped(qreal relTempo, int sampleRate) const {
+            return _sampleRate == sampleRate && _relTempo == relTempo;
+            }
+
+      bool empty() const             { return _events.empty();  }
+      int size() const               { return int(_events.size()); }
+      const_iterator begin() const   { return _events.cbegin(); }
+      const_iterator end() const     { return _events.cend();   }
+      const_iterator cbegin() const  { return _events.cbegin(); }
+      const_iterator cend() const    { return _events.cend();   }
+      const value_type& at(int idx) const { return _events[idx]; }
+      int frame(int idx) const       { return _frames[idx];     }
+
+      const_iterator lower_bound(int tick) const;
+      const_iterator upper_bound(int tick) const;
+      int nextNoteOn(int tick) const;
+      int prevNoteOn(int tick) const;
       };
 
 typedef EventList::iterator iEvent;
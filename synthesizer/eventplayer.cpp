@@ -0,0 +1,59 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "eventplayer.h"
+#include "event.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   playPeriod
+//    play the events of the next frames frames into buffer
+//    (two channels); playIdx and playFrame are moved along.
+//    Returns false if acceptEvent() ended the period, the
+//    rest of the buffer is not rendered then.
+//---------------------------------------------------------
+
+bool EventPlayer::playPeriod(const EventTimeline& events, std::atomic<int>* playIdx, int* playFrame, int frames, float* buffer)
+      {
+      float* p = buffer;
+      int framePos = 0;                               // frame relative to the start of the period
+      const int periodEndFrame = *playFrame + frames; // frame relative to the start of playback
+      // only this thread moves the play position while playing
+      int idx = playIdx->load(std::memory_order_relaxed);
+      const int nEvents = events.size();
+      while (idx < nEvents) {
+            int playPosFrame = eventFrame(events, idx);
+            if (playPosFrame >= periodEndFrame)
+                  break;
+            int n = playPosFrame - *playFrame;
+            if (n < 0) {
+                  qDebug("EventPlayer: event %d at frame %d before %d", idx, playPosFrame, *playFrame);
+                  n = 0;
+                  }
+            if (!acceptEvent(events, idx))
+                  return false;
+            if (n) {
+                  int rn = render(n, p);
+                  p          += rn * 2;
+                  *playFrame += rn;
+                  framePos   += rn;
+                  }
+            dispatch(events, idx, framePos);
+            playIdx->store(++idx, std::memory_order_release);
+            }
+      if (framePos < frames)
+            *playFrame += render(frames - framePos, p);
+      return true;
+      }
+
+}
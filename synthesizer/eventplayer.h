@@ -0,0 +1,52 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __EVENTPLAYER_H__
+#define __EVENTPLAYER_H__
+
+#include <atomic>
+
+namespace Ms {
+
+class EventTimeline;
+
+//---------------------------------------------------------
+//   EventPlayer
+//    plays an event timeline period by period in the
+//    real time thread
+//
+//    playPeriod() renders the frames up to the next event,
+//    dispatches the event and moves the play position,
+//    until the end of the period. Where an event sounds,
+//    how frames are rendered and what an event does is up
+//    to the player. No method may block or allocate.
+//---------------------------------------------------------
+
+class EventPlayer {
+   protected:
+      // frame of event idx, relative to the start of playback
+      virtual int eventFrame(const EventTimeline&, int idx) const = 0;
+      // false ends the period before event idx
+      virtual bool acceptEvent(const EventTimeline&, int /*idx*/) { return true; }
+      // renders up to frames stereo frames, returns the frames rendered
+      virtual int render(int frames, float* buffer) = 0;
+      // framePos: frame of the event relative to the start of the period
+      virtual void dispatch(const EventTimeline&, int idx, int framePos) = 0;
+
+   public:
+      virtual ~EventPlayer() {}
+      bool playPeriod(const EventTimeline&, std::atomic<int>* playIdx, int* playFrame, int frames, float* buffer);
+      };
+
+}     // namespace Ms
+#endif
+
@@ -0,0 +1,125 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <cmath>
+#include "loudness.h"
+
+namespace Ms {
+
+static const double ABSOLUTE_GATE = -70.0;      // LUFS
+static const double RELATIVE_GATE = -10.0;      // LU
+
+//---------------------------------------------------------
+//   process
+//    transposed direct form II
+//---------------------------------------------------------
+
+inline double LoudnessMeter::Biquad::process(double x, int channel)
+      {
+      double y    = b0 * x + z1[channel];
+      z1[channel] = b1 * x - a1 * y + z2[channel];
+      z2[channel] = b2 * x - a2 * y;
+      return y;
+      }
+
+//---------------------------------------------------------
+//   LoudnessMeter
+//    filter coefficients are derived for the actual
+//    sample rate from the analog prototypes of BS.1770
+//---------------------------------------------------------
+
+LoudnessMeter::LoudnessMeter(int sampleRate)
+      {
+      double f0 = 1681.974450955533;
+      double g  = 3.999843853973347;
+      double q  = 0.7071752369554196;
+      double k  = tan(M_PI * f0 / sampleRate);
+      double vh = pow(10.0, g / 20.0);
+      double vb = pow(vh, 0.4996667741545416);
+      double a0 = 1.0 + k / q + k * k;
+      _shelf.b0 = (vh + vb * k / q + k * k) / a0;
+      _shelf.b1 = 2.0 * (k * k - vh) / a0;
+      _shelf.b2 = (vh - vb * k / q + k * k) / a0;
+      _shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+      _shelf.a2 = (1.0 - k / q + k * k) / a0;
+
+      f0 = 38.13547087602444;
+      q  = 0.5003270373238773;
+      k  = tan(M_PI * f0 / sampleRate);
+      a0 = 1.0 + k / q + k * k;
+      _highpass.b0 = 1.0;
+      _highpass.b1 = -2.0;
+      _highpass.b2 = 1.0;
+      _highpass.a1 = 2.0 * (k * k - 1.0) / a0;
+      _highpass.a2 = (1.0 - k / q + k * k) / a0;
+
+      _subBlockFrames = sampleRate / 10;
+      }
+
+//---------------------------------------------------------
+//   process
+//    data is interleaved stereo
+//---------------------------------------------------------
+
+void LoudnessMeter::process(const float* data, int frames)
+      {
+      for (int i = 0; i < frames; ++i) {
+            for (int channel = 0; channel < 2; ++channel) {
+                  double v = _highpass.process(_shelf.process(*data++, channel), channel);
+                  _subBlockSum += v * v;
+                  }
+            if (++_subBlockPos < _subBlockFrames)
+                  continue;
+            _subBlocks[_subBlockCount % 4] = _subBlockSum;
+            ++_subBlockCount;
+            _subBlockPos = 0;
+            _subBlockSum = 0.0;
+            if (_subBlockCount >= 4) {
+                  double sum = _subBlocks[0] + _subBlocks[1] + _subBlocks[2] + _subBlocks[3];
+                  _blocks.push_back(sum / (4 * _subBlockFrames));
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   integratedLoudness
+//    returns -HUGE_VAL if all blocks are below the
+//    absolute gate
+//---------------------------------------------------------
+
+double LoudnessMeter::integratedLoudness() const
+      {
+      const double absoluteGate = pow(10.0, (ABSOLUTE_GATE + 0.691) / 10.0);
+      double sum = 0.0;
+      int n      = 0;
+      for (double z : _blocks) {
+            if (z > absoluteGate) {
+                  sum += z;
+                  ++n;
+                  }
+            }
+      if (n == 0)
+            return -HUGE_VAL;
+      const double relativeGate = (sum / n) * pow(10.0, RELATIVE_GATE / 10.0);
+      sum = 0.0;
+      n   = 0;
+      for (double z : _blocks) {
+            if (z > absoluteGate && z > relativeGate) {
+                  sum += z;
+                  ++n;
+                  }
+            }
+      return -0.691 + 10.0 * log10(sum / n);
+      }
+
+}     // namespace Ms
+
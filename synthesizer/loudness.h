@@ -0,0 +1,52 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __LOUDNESS_H__
+#define __LOUDNESS_H__
+
+#include <vector>
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   LoudnessMeter
+//    integrated loudness of an interleaved stereo stream
+//    according to ITU-R BS.1770 (K-weighting, 400ms blocks
+//    with 75% overlap, absolute and relative gating)
+//---------------------------------------------------------
+
+class LoudnessMeter {
+      struct Biquad {
+            double b0, b1, b2, a1, a2;
+            double z1[2] { 0.0, 0.0 };
+            double z2[2] { 0.0, 0.0 };
+            double process(double x, int channel);
+            };
+      Biquad _shelf;                // stage 1: head related high shelf
+      Biquad _highpass;             // stage 2: RLB high pass
+
+      int _subBlockFrames;          // 100ms
+      int _subBlockPos      { 0 };
+      double _subBlockSum   { 0.0 };
+      double _subBlocks[4]  { 0.0, 0.0, 0.0, 0.0 };
+      int _subBlockCount    { 0 };
+      std::vector<double> _blocks;  // mean square of every 400ms block
+
+   public:
+      LoudnessMeter(int sampleRate);
+      void process(const float* data, int frames);
+      double integratedLoudness() const;
+      };
+
+}     // namespace Ms
+#endif
+
@@ -15,6 +15,7 @@
 #include "synthesizer.h"
 #include "msynthesizer.h"
 #include "synthesizergui.h"
+#include "renderpool.h"
 #include "libmscore/xml.h"
 #include "midipatch.h"
 
@@ -61,6 +62,7 @@ void MasterSynthesizer::init()
 
 MasterSynthesizer::~MasterSynthesizer()
       {
+      delete _renderPool;
       for (Synthesizer* s : _synthesizer)
             delete s;
       for (int i = 0; i < MAX_EFFECTS; ++i) {
@@ -153,6 +155,18 @@ void MasterSynthesizer::allNotesOff(int channel)
             s->allNotesOff(channel);
       }
 
+//---------------------------------------------------------
+//   voiceCount
+//---------------------------------------------------------
+
+int MasterSynthesizer::voiceCount() const
+      {
+      int n = 0;
+      for (Synthesizer* s : _synthesizer)
+            n += s->voiceCount();
+      return n;
+      }
+
 //---------------------------------------------------------
 //   synth
 //---------------------------------------------------------
@@ -174,6 +188,49 @@ Synthesizer* MasterSynthesizer::synthesizer(const QString& name)
 void MasterSynthesizer::registerSynthesizer(Synthesizer* s)
       {
       _synthesizer.push_back(s);
+      s->setRenderPool(_renderPool);
+      }
+
+//---------------------------------------------------------
+//   setRenderThreads
+//    number of worker threads helping the audio thread,
+//    0 renders serially
+//---------------------------------------------------------
+
+void MasterSynthesizer::setRenderThreads(int n)
+      {
+      if (n == renderThreads())
+            return;
+      bool locked = lock2;
+      lock2 = true;
+      while (lock1)
+            sleep(1);
+      for (Synthesizer* s : _synthesizer)
+            s->setRenderPool(0);
+      delete _renderPool;
+      _renderPool = n > 0 ? new RenderPool(n) : 0;
+      for (Synthesizer* s : _synthesizer)
+            s->setRenderPool(_renderPool);
+      lock2 = locked;
+      }
+
+//---------------------------------------------------------
+//   setOffline
+//---------------------------------------------------------
+
+void MasterSynthesizer::setOffline(bool val)
+      {
+      for (Synthesizer* s : _synthesizer)
+            s->setOffline(val);
+      }
+
+//---------------------------------------------------------
+//   renderThreads
+//---------------------------------------------------------
+
+int MasterSynthesizer::renderThreads() const
+      {
+      return _renderPool ? _renderPool->threads() : 0;
       }
 
 //---------------------------------------------------------
@@ -24,6 +24,7 @@ class NPlayEvent;
 class Synthesizer;
 class Effect;
 class Xml;
+class RenderPool;
 
 //---------------------------------------------------------
 //   MasterSynthesizer
@@ -52,6 +53,7 @@ class MasterSynthesizer : public QObject {
 
       float effect1Buffer[MAX_BUFFERSIZE];
       float effect2Buffer[MAX_BUFFERSIZE];
+      RenderPool* _renderPool { 0 };
       int indexOfEffect(int ab, const QString& name);
 
    public slots:
@@ -66,6 +68,9 @@ class MasterSynthesizer : public QObject {
       MasterSynthesizer();
       ~MasterSynthesizer();
       void registerSynthesizer(Synthesizer*);
+      void setRenderThreads(int);
+      int renderThreads() const;
+      void setOffline(bool);
 
       void init();
 
@@ -94,6 +99,7 @@ class MasterSynthesizer : public QObject {
       void reset();
       void allSoundsOff(int channel);
       void allNotesOff(int channel);
+      int voiceCount() const;
 
       void setEffect(int ab, int idx);
       Effect* effect(int ab);
@@ -0,0 +1,154 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtGlobal>
+#include "renderpool.h"
+
+#ifdef Q_OS_UNIX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace Ms {
+
+// number of polls for a new run before an idle worker goes to
+// sleep; covers the gap between two audio periods
+static const int SPIN_COUNT = 20000;
+
+static inline uint32_t generationOf(uint64_t work) { return uint32_t(work >> 32);      }
+static inline int tasksOf(uint64_t work)           { return int((work >> 16) & 0xffff); }
+static inline int nextTaskOf(uint64_t work)        { return int(work & 0xffff);         }
+
+//---------------------------------------------------------
+//   RenderPool
+//---------------------------------------------------------
+
+RenderPool::RenderPool(int threads)
+      {
+      for (int i = 0; i < threads; ++i)
+            _threads.emplace_back(&RenderPool::worker, this);
+      }
+
+RenderPool::~RenderPool()
+      {
+      _quit = true;
+      uint32_t generation = generationOf(_work.load()) + 1;
+      _work.store(uint64_t(generation) << 32);
+      {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _wakeup.notify_all();
+      }
+      for (std::thread& t : _threads)
+            t.join();
+      }
+
+//---------------------------------------------------------
+//   runTasks
+//    take tasks of run generation until there are none
+//    left
+//---------------------------------------------------------
+
+void RenderPool::runTasks(uint32_t generation)
+      {
+      uint64_t work = _work.load(std::memory_order_acquire);
+      for (;;) {
+            if (generationOf(work) != generation || nextTaskOf(work) >= tasksOf(work))
+                  break;
+            if (!_work.compare_exchange_weak(work, work + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+                  continue;
+            _fn(_context, nextTaskOf(work));
+            _doneTasks.fetch_add(1, std::memory_order_release);
+            work = _work.load(std::memory_order_acquire);
+            }
+      }
+
+//---------------------------------------------------------
+//   worker
+//---------------------------------------------------------
+
+void RenderPool::worker()
+      {
+      uint32_t generation = generationOf(_work.load(std::memory_order_acquire));
+      int policy = -1;
+      for (;;) {
+#ifdef Q_OS_UNIX
+            // run with the scheduling of the audio thread; a worker with
+            // a higher priority would starve it while spinning
+            if (_policy.load(std::memory_order_acquire) != policy) {
+                  policy = _policy.load(std::memory_order_acquire);
+                  sched_param sp;
+                  sp.sched_priority = _priority.load(std::memory_order_acquire);
+                  pthread_setschedparam(pthread_self(), policy, &sp);
+                  }
+#endif
+            int spin = 0;
+            while (generationOf(_work.load(std::memory_order_acquire)) == generation) {
+                  if (++spin < SPIN_COUNT) {
+                        std::this_thread::yield();
+                        continue;
+                        }
+                  // a notification may get lost between the check and
+                  // the wait; the timeout bounds the damage, the audio
+                  // thread does the work meanwhile
+                  std::unique_lock<std::mutex> lock(_mutex);
+                  ++_sleeping;
+                  _wakeup.wait_for(lock, std::chrono::milliseconds(1), [this, generation] {
+                        return generationOf(_work.load(std::memory_order_acquire)) != generation;
+                        });
+                  --_sleeping;
+                  spin = 0;
+                  }
+            if (_quit)
+                  return;
+            generation = generationOf(_work.load(std::memory_order_acquire));
+            runTasks(generation);
+            }
+      }
+
+//---------------------------------------------------------
+//   run
+//    execute fn(context, task) for task 0..tasks-1 and
+//    wait for completion; called from the audio thread
+//---------------------------------------------------------
+
+void RenderPool::run(int tasks, RenderTask fn, void* context)
+      {
+      if (_threads.empty() || tasks < 2 || tasks > MAX_TASKS) {
+            for (int i = 0; i < tasks; ++i)
+                  fn(context, i);
+            return;
+            }
+#ifdef Q_OS_UNIX
+      if (_policy.load(std::memory_order_relaxed) == -1) {
+            int policy;
+            sched_param sp;
+            if (pthread_getschedparam(pthread_self(), &policy, &sp) == 0) {
+                  _priority.store(sp.sched_priority, std::memory_order_relaxed);
+                  _policy.store(policy, std::memory_order_release);
+                  }
+            }
+#endif
+      _fn      = fn;
+      _context = context;
+      _doneTasks.store(0, std::memory_order_relaxed);
+      uint32_t generation = generationOf(_work.load(std::memory_order_relaxed)) + 1;
+      _work.store((uint64_t(generation) << 32) | (uint64_t(tasks) << 16), std::memory_order_release);
+      if (_sleeping.load(std::memory_order_acquire))
+            _wakeup.notify_all();
+
+      runTasks(generation);
+      while (_doneTasks.load(std::memory_order_acquire) < tasks)
+            std::this_thread::yield();
+      }
+
+}     // namespace Ms
+
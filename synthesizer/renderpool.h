@@ -0,0 +1,77 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __RENDERPOOL_H__
+#define __RENDERPOOL_H__
+
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Ms {
+
+typedef void (*RenderTask)(void* context, int task);
+
+//---------------------------------------------------------
+//   RenderPool
+//    fixed set of worker threads for the audio thread
+//
+//    run() distributes tasks 0..n-1 to the workers and
+//    the calling thread and returns when all are done. It
+//    does not allocate or lock: a run is published as one
+//    atomic word (generation, task count, next task) and
+//    tasks are taken by compare and swap, so a worker which
+//    is late for a run can never take a task of the next
+//    one. The condition variable is only used by idle
+//    workers to sleep. The calling thread takes tasks
+//    itself, so a worker which wakes up late never stalls
+//    the audio thread for longer than the tasks it has
+//    already taken.
+//
+//    Which thread runs a task is not deterministic, so
+//    every task has to write into its own buffer.
+//---------------------------------------------------------
+
+class RenderPool {
+      std::vector<std::thread> _threads;
+
+      std::atomic<uint64_t> _work       { 0 };  // generation << 32 | tasks << 16 | next task
+      std::atomic<int> _doneTasks       { 0 };
+      std::atomic<int> _sleeping        { 0 };
+      std::atomic<bool> _quit           { false };
+      std::atomic<int> _policy          { -1 };  // scheduling of the audio thread
+      std::atomic<int> _priority        { 0 };
+      RenderTask _fn                    { 0 };
+      void* _context                    { 0 };
+
+      std::mutex _mutex;
+      std::condition_variable _wakeup;
+
+      void worker();
+      void runTasks(uint32_t generation);
+
+   public:
+      RenderPool(int threads);
+      ~RenderPool();
+
+      static const int MAX_TASKS = 0xffff;
+
+      int threads() const { return int(_threads.size()); }
+      void run(int tasks, RenderTask fn, void* context);
+      };
+
+}     // namespace Ms
+#endif
+
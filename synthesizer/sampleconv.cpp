@@ -0,0 +1,183 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <cstring>
+#include "sampleconv.h"
+
+//    The vector code clips to +-1 before scaling, which gives the
+//    same values as the scalar code clipping after the comparison;
+//    both truncate towards zero. SSE2 is part of x86_64, no check
+//    at run time is needed.
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__SSE2_MATH__))
+#define SAMPLECONV_SIMD
+#include <emmintrin.h>
+#endif
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   sampleBytes
+//---------------------------------------------------------
+
+int sampleBytes(SampleFormat f)
+      {
+      switch (f) {
+            case SampleFormat::S16_LE:  return 2;
+            case SampleFormat::S24_3LE: return 3;
+            case SampleFormat::S32_LE:  return 4;
+            }
+      return 0;
+      }
+
+//---------------------------------------------------------
+//   scalar conversion
+//---------------------------------------------------------
+
+static char* convert16(const float* src, int srcStep, char* dst, int dstStep, int n)
+      {
+      while (n--) {
+            short d;
+            float s = *src;
+            src += srcStep;
+            if (s >  1)
+                  d = 0x7fff;
+            else if (s < -1)
+                  d = -0x7fff;
+            else
+                  d = (short)(0x7fff * s);
+            memcpy(dst, &d, sizeof(short));
+            dst += dstStep;
+            }
+      return dst;
+      }
+
+static int toInt24(float s)
+      {
+      if (s >  1)
+            return 0x7fffff;
+      else if (s < -1)
+            return -0x7fffff;
+      return (int)(0x7fffff * s);
+      }
+
+static char* convert24(const float* src, int srcStep, char* dst, int dstStep, int n)
+      {
+      while (n--) {
+            int d = toInt24(*src);
+            src += srcStep;
+            dst[0] = d;
+            dst[1] = d >> 8;
+            dst[2] = d >> 16;
+            dst += dstStep;
+            }
+      return dst;
+      }
+
+static char* convert32(const float* src, int srcStep, char* dst, int dstStep, int n)
+      {
+      while (n--) {
+            int d = toInt24(*src) * 256;        // 24 bit resolution
+            src += srcStep;
+            memcpy(dst, &d, sizeof(int));
+            dst += dstStep;
+            }
+      return dst;
+      }
+
+char* convertSamplesScalar(SampleFormat f, const float* src, int srcStep, char* dst, int dstStep, int n)
+      {
+      switch (f) {
+            case SampleFormat::S16_LE:  return convert16(src, srcStep, dst, dstStep, n);
+            case SampleFormat::S24_3LE: return convert24(src, srcStep, dst, dstStep, n);
+            case SampleFormat::S32_LE:  return convert32(src, srcStep, dst, dstStep, n);
+            }
+      return dst;
+      }
+
+#ifdef SAMPLECONV_SIMD
+
+//---------------------------------------------------------
+//   load4
+//    four samples, every second one for interleaved input
+//---------------------------------------------------------
+
+static inline __m128 load4(const float* src, int srcStep)
+      {
+      if (srcStep == 1)
+            return _mm_loadu_ps(src);
+      __m128 a = _mm_loadu_ps(src);
+      __m128 b = _mm_loadu_ps(src + 4);
+      return _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+      }
+
+static inline __m128i toInt4(__m128 s, float scale)
+      {
+      s = _mm_min_ps(_mm_max_ps(s, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+      return _mm_cvttps_epi32(_mm_mul_ps(s, _mm_set1_ps(scale)));
+      }
+
+//---------------------------------------------------------
+//   convertSamples
+//---------------------------------------------------------
+
+char* convertSamples(SampleFormat f, const float* src, int srcStep, char* dst, int dstStep, int n)
+      {
+      if ((srcStep != 1 && srcStep != 2) || dstStep != sampleBytes(f))
+            return convertSamplesScalar(f, src, srcStep, dst, dstStep, n);
+
+      // interleaved input reads one float beyond the last sample
+      // of a block, which must not be beyond the last sample
+      const int last = n - 4 - (srcStep - 1);
+      int i = 0;
+      switch (f) {
+            case SampleFormat::S16_LE:
+                  for (; i <= last; i += 4) {
+                        __m128i d = toInt4(load4(src + i * srcStep, srcStep), float(0x7fff));
+                        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_packs_epi32(d, d));
+                        dst += 8;
+                        }
+                  break;
+            case SampleFormat::S24_3LE:
+                  for (; i <= last; i += 4) {
+                        int d[4];
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(d), toInt4(load4(src + i * srcStep, srcStep), float(0x7fffff)));
+                        for (int k = 0; k < 4; ++k) {
+                              dst[0] = d[k];
+                              dst[1] = d[k] >> 8;
+                              dst[2] = d[k] >> 16;
+                              dst += 3;
+                              }
+                        }
+                  break;
+            case SampleFormat::S32_LE:
+                  for (; i <= last; i += 4) {
+                        __m128i d = toInt4(load4(src + i * srcStep, srcStep), float(0x7fffff));
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_slli_epi32(d, 8));
+                        dst += 16;
+                        }
+                  break;
+            }
+      return convertSamplesScalar(f, src + i * srcStep, srcStep, dst, dstStep, n - i);
+      }
+
+#else
+
+char* convertSamples(SampleFormat f, const float* src, int srcStep, char* dst, int dstStep, int n)
+      {
+      return convertSamplesScalar(f, src, srcStep, dst, dstStep, n);
+      }
+
+#endif
+
+}     // namespace Ms
+
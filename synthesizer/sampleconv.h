@@ -0,0 +1,47 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __SAMPLECONV_H__
+#define __SAMPLECONV_H__
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   SampleFormat
+//    little endian integer formats of audio devices
+//---------------------------------------------------------
+
+enum class SampleFormat : char {
+      S16_LE, S24_3LE, S32_LE
+      };
+
+extern int sampleBytes(SampleFormat);
+
+//---------------------------------------------------------
+//   convertSamples
+//    convert n float samples, srcStep floats apart, to
+//    integer samples dstStep bytes apart; samples beyond
+//    +-1 are clipped. Returns the position after the last
+//    sample written.
+//
+//    Contiguous output from contiguous or stereo
+//    interleaved input is converted with vector
+//    instructions where available; the result is bit
+//    identical to convertSamplesScalar().
+//---------------------------------------------------------
+
+extern char* convertSamples(SampleFormat, const float* src, int srcStep, char* dst, int dstStep, int n);
+extern char* convertSamplesScalar(SampleFormat, const float* src, int srcStep, char* dst, int dstStep, int n);
+
+}     // namespace Ms
+#endif
+
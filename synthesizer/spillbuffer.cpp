@@ -0,0 +1,130 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <cmath>
+#include <cstring>
+#include <QTemporaryFile>
+#include <QDir>
+#include "spillbuffer.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   AudioSpillBuffer
+//---------------------------------------------------------
+
+AudioSpillBuffer::AudioSpillBuffer(long long memoryLimit)
+   : _memoryLimit(memoryLimit)
+      {
+      }
+
+AudioSpillBuffer::~AudioSpillBuffer()
+      {
+      delete _file;           // also unmaps and removes the file
+      }
+
+//---------------------------------------------------------
+//   spill
+//    move the memory buffer into a temporary file
+//---------------------------------------------------------
+
+bool AudioSpillBuffer::spill()
+      {
+      _file = new QTemporaryFile(QDir::tempPath() + "/mscore-audio-XXXXXX.raw");
+      if (!_file->open()) {
+            qDebug("AudioSpillBuffer: cannot create temporary file");
+            return false;
+            }
+      qint64 n = qint64(_data.size() * sizeof(float));
+      if (_file->write(reinterpret_cast<const char*>(_data.data()), n) != n)
+            return false;
+      std::vector<float>().swap(_data);
+      return true;
+      }
+
+//---------------------------------------------------------
+//   write
+//    append frames of interleaved stereo audio
+//---------------------------------------------------------
+
+bool AudioSpillBuffer::write(const float* data, int frames)
+      {
+      if (_error)
+            return false;
+      for (int i = 0; i < frames * 2; ++i)
+            _peak = qMax(_peak, std::abs(data[i]));
+      if (!_file && (long long)((_data.size() + frames * 2) * sizeof(float)) > _memoryLimit) {
+            if (!spill()) {
+                  _error = true;
+                  return false;
+                  }
+            }
+      if (_file) {
+            qint64 n = frames * 2 * sizeof(float);
+            if (_file->write(reinterpret_cast<const char*>(data), n) != n) {
+                  qDebug("AudioSpillBuffer: write to temporary file failed");
+                  _error = true;
+                  return false;
+                  }
+            }
+      else
+            _data.insert(_data.end(), data, data + frames * 2);
+      _frames += frames;
+      return true;
+      }
+
+//---------------------------------------------------------
+//   finish
+//    called after the last write; maps a spilled buffer
+//    into memory. If mapping fails, read() falls back to
+//    reading the file.
+//---------------------------------------------------------
+
+bool AudioSpillBuffer::finish()
+      {
+      if (!_file || _error)
+            return !_error;
+      if (!_file->flush()) {
+            _error = true;
+            return false;
+            }
+      if (_frames)
+            _map = reinterpret_cast<const float*>(_file->map(0, _frames * 2 * sizeof(float)));
+      return true;
+      }
+
+//---------------------------------------------------------
+//   read
+//    copy up to frames frames starting at frame pos,
+//    returns number of frames copied
+//---------------------------------------------------------
+
+int AudioSpillBuffer::read(long long pos, float* data, int frames) const
+      {
+      if (pos >= _frames)
+            return 0;
+      if (pos + frames > _frames)
+            frames = _frames - pos;
+      size_t n = frames * 2 * sizeof(float);
+      if (!_file)
+            memcpy(data, _data.data() + pos * 2, n);
+      else if (_map)
+            memcpy(data, _map + pos * 2, n);
+      else {
+            if (!_file->seek(pos * 2 * sizeof(float)) || _file->read(reinterpret_cast<char*>(data), n) != qint64(n))
+                  return 0;
+            }
+      return frames;
+      }
+
+}     // namespace Ms
+
@@ -0,0 +1,59 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __SPILLBUFFER_H__
+#define __SPILLBUFFER_H__
+
+#include <vector>
+
+class QTemporaryFile;
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   AudioSpillBuffer
+//    holds rendered interleaved stereo audio until it
+//    is encoded; everything beyond memoryLimit bytes is
+//    spilled into a temporary file which is memory mapped
+//    for reading
+//---------------------------------------------------------
+
+class AudioSpillBuffer {
+      long long _memoryLimit;
+      std::vector<float> _data;
+      QTemporaryFile* _file { 0 };
+      const float* _map     { 0 };
+      long long _frames     { 0 };
+      float _peak           { 0.0 };
+      bool _error           { false };
+
+      bool spill();
+
+   public:
+      static const long long DEFAULT_MEMORY_LIMIT = 64 * 1024 * 1024;
+
+      AudioSpillBuffer(long long memoryLimit = DEFAULT_MEMORY_LIMIT);
+      ~AudioSpillBuffer();
+
+      bool write(const float* data, int frames);
+      bool finish();
+      int read(long long pos, float* data, int frames) const;
+
+      long long frames() const { return _frames;      }
+      float peak() const       { return _peak;        }
+      bool spilled() const     { return _file != 0;   }
+      bool error() const       { return _error;       }
+      };
+
+}     // namespace Ms
+#endif
+
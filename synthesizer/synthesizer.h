@@ -21,6 +21,7 @@ struct MidiPatch;
 class PlayEvent;
 class Synth;
 class SynthesizerGui;
+class RenderPool;
 
 //---------------------------------------------------------
 //   Synthesizer
@@ -51,6 +52,12 @@ class Synthesizer {
       virtual QStringList soundFonts() const = 0;
 
       virtual void process(unsigned, float*, float*, float*) = 0;
+      // worker threads which may be used by process(), 0 for none;
+      // only set while process() is not running
+      virtual void setRenderPool(RenderPool*) {}
+      // offline rendering (audio export) may wait for sample
+      // data; the audio thread must not
+      virtual void setOffline(bool) {}
       virtual void play(const PlayEvent&) = 0;
 
       virtual const QList<MidiPatch*>& getPatchInfo() const = 0;
@@ -68,6 +75,10 @@ class Synthesizer {
       virtual void allSoundsOff(int /*channel*/) {}
       virtual void allNotesOff(int /*channel*/) {}
 
+      // number of sounding voices; only called from the
+      // thread calling process()
+      virtual int voiceCount() const { return 0; }
+
       virtual SynthesizerGui* gui()  { return _gui; }
       };
 
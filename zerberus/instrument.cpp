@@ -12,6 +12,7 @@
 
 #include <stdio.h>
 #include <math.h>
+#include <map>
 #include <QFile>
 #include <QFileInfo>
 #include <QStringList>
@@ -122,12 +123,97 @@ bool ZInstrument::load(const QString& path)
       instrumentPath = path;
       QFileInfo fi(path);
       _name = fi.completeBaseName();
+      bool rv = false;
       if (fi.isFile())
-            return loadFromFile(path);
-      if (fi.isDir())
-            return loadFromDir(path);
-      qDebug("not file nor dir %s", qPrintable(path));
-      return false;
+            rv = loadFromFile(path);
+      else if (fi.isDir())
+            rv = loadFromDir(path);
+      else
+            qDebug("not file nor dir %s", qPrintable(path));
+      if (rv)
+            buildZoneIndex();
+      return rv;
+      }
+
+//---------------------------------------------------------
+//   addZone
+//---------------------------------------------------------
+
+void ZInstrument::addZone(Zone* z)
+      {
+      _zones.push_back(z);
+      _allZones.push_back(z);
+      _zoneIndex.clear();
+      }
+
+//---------------------------------------------------------
+//   buildZoneIndex
+//    for every trigger, key and velocity collect the zones
+//    which can match a note on. Zone::match() has side
+//    effects (round robin), so the lists keep the order
+//    of the zones and must contain exactly the zones
+//    passing the key, velocity and trigger checks.
+//---------------------------------------------------------
+
+void ZInstrument::buildZoneIndex()
+      {
+      _zoneLists.clear();
+      _zoneIndex.clear();
+      for (std::vector<Zone*>& l : _ccZones)
+            l.clear();
+
+      std::map<std::vector<Zone*>, int> lists;
+      std::vector<int> index(int(Trigger::CC) * 128 * 128);
+      std::vector<Zone*> keyZones;
+      std::vector<Zone*> l;
+      for (int t = 0; t < int(Trigger::CC); ++t) {
+            for (int key = 0; key < 128; ++key) {
+                  keyZones.clear();
+                  for (Zone* z : _zones) {
+                        if (int(z->trigger) == t && key >= z->keyLo && key <= z->keyHi)
+                              keyZones.push_back(z);
+                        }
+                  for (int velo = 0; velo < 128; ++velo) {
+                        l.clear();
+                        for (Zone* z : keyZones) {
+                              if (velo >= z->veloLo && velo <= z->veloHi)
+                                    l.push_back(z);
+                              }
+                        auto i = lists.find(l);
+                        if (i == lists.end()) {
+                              i = lists.insert({ l, int(_zoneLists.size()) }).first;
+                              _zoneLists.push_back(l);
+                              }
+                        index[(t * 128 + key) * 128 + velo] = i->second;
+                        }
+                  }
+            }
+      for (Zone* z : _zones) {
+            if (z->trigger != Trigger::CC)
+                  continue;
+            for (int cc = 0; cc < 128; ++cc) {
+                  if (z->onHicc[cc] >= 0)
+                        _ccZones[cc].push_back(z);
+                  }
+            }
+      _zoneIndex.swap(index);
+      }
+
+//---------------------------------------------------------
+//   zones
+//    the zones which may match an event, in the order of
+//    zones()
+//---------------------------------------------------------
+
+const std::vector<Zone*>& ZInstrument::zones(Trigger t, int key, int velo, int cc) const
+      {
+      if (_zoneIndex.empty())
+            return _allZones;
+      if (t == Trigger::CC)
+            return (cc >= 0 && cc < 128) ? _ccZones[cc] : _allZones;
+      if (key < 0 || key > 127 || velo < 0 || velo > 127)
+            return _allZones;
+      return _zoneLists[_zoneIndex[(int(t) * 128 + key) * 128 + velo]];
       }
 
 //---------------------------------------------------------
@@ -14,6 +14,7 @@
 #define __MINSTRUMENT_H__
 
 #include <list>
+#include <vector>
 #include <QString>
 
 class Zerberus;
@@ -22,6 +23,7 @@ class MQZipReader;
 struct Zone;
 struct SfzRegion;
 class Sample;
+enum class Trigger : char;
 
 //---------------------------------------------------------
 //   ZInstrument
@@ -36,6 +38,12 @@ class ZInstrument {
       std::list<Zone*> _zones;
       int _setcc[128];
 
+      // zones which can match a note on, by trigger, key and velocity
+      std::vector<std::vector<Zone*>> _zoneLists;
+      std::vector<int> _zoneIndex;              // index into _zoneLists
+      std::vector<Zone*> _ccZones[128];         // zones triggered by a controller
+      std::vector<Zone*> _allZones;             // used while there is no index
+
       bool loadFromFile(const QString&);
       bool loadSfz(const QString&);
       bool loadFromDir(const QString&);
@@ -54,7 +62,9 @@ class ZInstrument {
       const std::list<Zone*>& zones() const { return _zones;  }
       std::list<Zone*>& zones()             { return _zones;  }
       Sample* readSample(const QString& s, MQZipReader* uz);
-      void addZone(Zone* z)                 { _zones.push_back(z); }
+      void addZone(Zone* z);
+      void buildZoneIndex();
+      const std::vector<Zone*>& zones(Trigger, int key, int velo, int cc) const;
       void addRegion(SfzRegion&);
       int getSetCC(int v)                   { return _setcc[v]; }
 
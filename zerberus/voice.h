@@ -114,6 +114,11 @@ class Voice {
       Voice* _next;
       Zerberus* _zerberus;
 
+      // voices of the same offBy group, see Zerberus::trigger()
+      Voice* _chokePrev = 0;
+      Voice* _chokeNext = 0;
+      int _chokeGroup   = -1;
+
       VoiceState _state = VoiceState::OFF;
       Channel* _channel;
       int _key;
@@ -204,6 +209,13 @@ class Voice {
 
       OffMode offMode() const     { return _offMode;  }
       int offBy() const           { return _offBy;    }
+
+      Voice* chokePrev() const          { return _chokePrev;  }
+      Voice* chokeNext() const          { return _chokeNext;  }
+      int chokeGroup() const            { return _chokeGroup; }
+      void setChokePrev(Voice* v)       { _chokePrev = v;     }
+      void setChokeNext(Voice* v)       { _chokeNext = v;     }
+      void setChokeGroup(int val)       { _chokeGroup = val;  }
       static void init();
       };
 
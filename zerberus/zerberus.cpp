@@ -96,7 +96,7 @@ void Zerberus::trigger(Channel* channel, int key, int velo, Trigger trigger, int
       {
       ZInstrument* i = channel->instrument();
       double random = (double) rand() / (double) RAND_MAX;
-      for (Zone* z : i->zones()) {
+      for (Zone* z : i->zones(trigger, key, velo, cc)) {
             if (z->match(channel, key, velo, trigger, random, cc, ccVal)) {
                   if (freeVoices.empty()) {
                         qDebug("Zerberus: out of voices...");
@@ -107,13 +107,15 @@ void Zerberus::trigger(Channel* channel, int key, int velo, Trigger trigger, int
                   voice->start(channel, key, velo, z, durSinceNoteOn);
                   voice->setNext(activeVoices);
                   activeVoices = voice;
+                  chokeLink(voice);
 
                   //
                   // handle offBy voices
                   //
                   if (z->group) {
-                        for (Voice* v = activeVoices; v; v = v->next()) {
-                              if (v->offBy() == z->group) {
+                        int idx = chokeGroups.value(z->group, -1);
+                        if (idx >= 0) {
+                              for (Voice* v = chokeVoices[idx]; v; v = v->chokeNext()) {
                                     if (v->offMode() == OffMode::FAST)
                                           v->stop(1);
                                     else
@@ -125,6 +127,61 @@ void Zerberus::trigger(Channel* channel, int key, int velo, Trigger trigger, int
             }
       }
 
+//---------------------------------------------------------
+//   addChokeGroups
+//    make room for the offBy groups of instrument i; not
+//    called while playing
+//---------------------------------------------------------
+
+void Zerberus::addChokeGroups(ZInstrument* i)
+      {
+      for (Zone* z : i->zones()) {
+            if (z->offBy && !chokeGroups.contains(z->offBy)) {
+                  chokeGroups.insert(z->offBy, int(chokeVoices.size()));
+                  chokeVoices.push_back(0);
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   chokeLink
+//    add a started voice to the list of its offBy group
+//---------------------------------------------------------
+
+void Zerberus::chokeLink(Voice* v)
+      {
+      int idx = v->offBy() ? chokeGroups.value(v->offBy(), -1) : -1;
+      v->setChokeGroup(idx);
+      if (idx < 0)
+            return;
+      Voice* head = chokeVoices[idx];
+      v->setChokePrev(0);
+      v->setChokeNext(head);
+      if (head)
+            head->setChokePrev(v);
+      chokeVoices[idx] = v;
+      }
+
+//---------------------------------------------------------
+//   chokeUnlink
+//---------------------------------------------------------
+
+void Zerberus::chokeUnlink(Voice* v)
+      {
+      int idx = v->chokeGroup();
+      if (idx < 0)
+            return;
+      if (v->chokePrev())
+            v->chokePrev()->setChokeNext(v->chokeNext());
+      else
+            chokeVoices[idx] = v->chokeNext();
+      if (v->chokeNext())
+            v->chokeNext()->setChokePrev(v->chokePrev());
+      v->setChokePrev(0);
+      v->setChokeNext(0);
+      v->setChokeGroup(-1);
+      }
+
 //---------------------------------------------------------
 //   processNoteOff
 //---------------------------------------------------------
@@ -222,6 +279,7 @@ void Zerberus::process(unsigned frames, float* p, float*, float*)
       while (v) {
             v->process(frames, p);
             if (v->isOff()) {
+                  chokeUnlink(v);
                   if (pv)
                         pv->setNext(v->next());
                   else
@@ -284,6 +342,18 @@ void Zerberus::allNotesOff(int channel)
       busy = false;
       }
 
+//---------------------------------------------------------
+//   voiceCount
+//---------------------------------------------------------
+
+int Zerberus::voiceCount() const
+      {
+      int n = 0;
+      for (Voice* v = activeVoices; v; v = v->next())
+            ++n;
+      return n;
+      }
+
 //---------------------------------------------------------
 //   loadSoundFonts
 //---------------------------------------------------------
@@ -414,6 +484,8 @@ bool Zerberus::loadInstrument(const QString& s)
             }
       for (ZInstrument* instr : globalInstruments) {
             if (QFileInfo(instr->path()).fileName() == fileName) {
+                  busy = true;
+                  addChokeGroups(instr);
                   instruments.push_back(instr);
                   instr->setRefCount(instr->refCount() + 1);
                   if (instruments.size() == 1) {
@@ -438,6 +510,7 @@ bool Zerberus::loadInstrument(const QString& s)
 
       try {
             if (instr->load(path)) {
+                  addChokeGroups(instr);
                   globalInstruments.push_back(instr);
                   instruments.push_back(instr);
                   instr->setRefCount(1);
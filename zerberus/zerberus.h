@@ -17,6 +17,7 @@
 #include <atomic>
 // #include <mutex>
 #include <list>
+#include <vector>
 
 #include "synthesizer/synthesizer.h"
 #include "synthesizer/event.h"
@@ -80,6 +81,10 @@ class Zerberus : public Ms::Synthesizer {
       int allocatedVoices = 0;
       VoiceFifo freeVoices;
       Voice* activeVoices = 0;
+
+      // active voices which can be stopped by a group, by offBy
+      QHash<int, int> chokeGroups;        // offBy -> index in chokeVoices
+      std::vector<Voice*> chokeVoices;
       int _loadProgress = 0;
       bool _loadWasCanceled = false;
 
@@ -87,6 +92,9 @@ class Zerberus : public Ms::Synthesizer {
       void trigger(Channel*, int key, int velo, Trigger, int cc, int ccVal, double durSinceNoteOn);
       void processNoteOff(Channel*, int pitch);
       void processNoteOn(Channel* cp, int key, int velo);
+      void addChokeGroups(ZInstrument*);
+      void chokeLink(Voice*);
+      void chokeUnlink(Voice*);
 
    public:
       Zerberus();
@@ -118,6 +126,7 @@ class Zerberus : public Ms::Synthesizer {
 
       virtual void allSoundsOff(int channel);
       virtual void allNotesOff(int channel);
+      virtual int voiceCount() const;
 
       virtual bool addSoundFont(const QString&);
       virtual bool removeSoundFont(const QString&);